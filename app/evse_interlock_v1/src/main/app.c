@@ -11,16 +11,24 @@
 
 #include <state_notifier/state_notifier.h>
 #include "main/app.h"
+#include "main/app_airtime.h"
 #include "main/app_ble_auth.h"
 #include "main/app_buttons.h"
+#include "main/app_delivery.h"
 #include "main/app_evse.h"
 #include "main/app_line_current.h"
 #include "main/app_gpio.h"
+#include "main/app_health.h"
+#include "main/app_outbox.h"
+#include "main/app_queue.h"
+#include "main/app_retain.h"
+#include "main/app_series.h"
+#include "main/app_telemetry.h"
 #include "sidewalk/sidewalk.h"
 #include <app_ble_config.h>
 #include <app_subGHz_config.h>
-#include <sid_hal_memory_ifc.h>
 #include <sid_hal_reset_ifc.h>
+#include <errno.h>
 #include <stdbool.h>
 #ifdef CONFIG_SIDEWALK_FILE_TRANSFER_DFU
 #include "sidewalk/sbdt/dfu_file_transfer.h"
@@ -43,8 +51,12 @@
 #include <string.h>
 #include "telemetry/evse.h"
 #include "sidewalk/sidewalk_msg.h"
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_envelope.h"
 #include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_fixed.h"
 #include "telemetry/telemetry_gpio.h"
+#include "telemetry/telemetry_health.h"
 #include "telemetry/telemetry_line_current.h"
 #include "sidewalk/time_sync.h"
 
@@ -54,15 +66,21 @@
 LOG_MODULE_REGISTER(app, CONFIG_SIDEWALK_LOG_LEVEL);
 
 #define APP_PERIODIC_SEND_INTERVAL K_SECONDS(30)
+/* [TELEMETRY] The periodic hello ("hello" + NUL, see app_btn_send_msg()). */
+#define APP_HELLO_LEN 6
 #define APP_DEVICE_ID CONFIG_SID_END_DEVICE_DEVICE_ID
 #define APP_DEVICE_TYPE CONFIG_SID_END_DEVICE_DEVICE_TYPE
 
 static uint32_t persistent_link_mask;
 static struct k_work_delayable periodic_send_work;
+static struct k_work announce_work;
+static struct telemetry_envelope app_envelope;
 static bool periodic_send_started;
 static bool app_sidewalk_ready;
 
+#if !defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
 static uint32_t app_event_seq;
+#endif
 
 static int64_t app_get_timestamp_ms(void)
 {
@@ -70,117 +88,373 @@ static int64_t app_get_timestamp_ms(void)
 	return time_sync_get_timestamp_ms(uptime_ms);
 }
 
-/* [BOILERPLATE] Event ID generator for telemetry correlation. */
-static void app_next_event_id(char *buf, size_t buf_len)
+/*
+ * [BOILERPLATE] Event ID generator for telemetry correlation: 32 random bits,
+ * then the event's sequence number (per device with retention, else per boot).
+ */
+static uint32_t app_next_event_id(char *buf, size_t buf_len)
 {
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
+	uint32_t seq = app_retain_next_seq();
+#else
 	uint32_t seq = ++app_event_seq;
+#endif
 	uint32_t rand = sys_rand32_get();
 	snprintf(buf, buf_len, "%08x%08x", rand, seq);
+	return seq;
 }
 
-#if defined(CONFIG_SID_END_DEVICE_GPIO_EVENTS) && defined(CONFIG_GPIO)
-static void app_gpio_send_event(const char *pin_alias, int state, gpio_edge_t edge)
+/* [TELEMETRY] Common record header captured once per event, reused on rebuild. */
+struct app_record_hdr {
+	int64_t timestamp_ms;
+	bool time_anomaly;
+	uint32_t seq;
+	char event_id[32];
+};
+
+static void app_record_hdr_init(struct app_record_hdr *hdr, int64_t timestamp_ms)
 {
-	/* [TELEMETRY] GPIO event payload construction + Sidewalk uplink. */
-	if (!app_sidewalk_ready) {
-		LOG_WRN("Sidewalk not ready; drop gpio event");
+	hdr->timestamp_ms = timestamp_ms;
+	hdr->time_anomaly = time_sync_time_anomaly();
+	hdr->seq = app_next_event_id(hdr->event_id, sizeof(hdr->event_id));
+}
+
+static void app_telemetry_log_submit(int err)
+{
+	if (err) {
+		LOG_ERR("Sidewalk send: err %d", err);
 		return;
 	}
+#if defined(CONFIG_STATE_NOTIFIER)
+	application_state_sending(&global_state_notifier, true);
+#endif
+}
 
-	int64_t timestamp_ms = app_get_timestamp_ms();
-	bool time_anomaly = time_sync_time_anomaly();
-	char event_id[32];
-	char payload[384];
-	app_next_event_id(event_id, sizeof(event_id));
-	int len = telemetry_build_gpio_payload_ex(payload, sizeof(payload), APP_DEVICE_ID,
-						  APP_DEVICE_TYPE, pin_alias, state, edge,
-						  timestamp_ms, NULL, event_id,
-						  time_anomaly);
-	if (len < 0) {
-		LOG_ERR("GPIO payload format failed");
-		return;
+/* [TELEMETRY] Queue sink: send now, or keep the record in the flash outbox until READY. */
+static int app_queue_deliver(const struct app_queue_record *item)
+{
+	const char *what = app_queue_class_name(item->cls);
+	int err;
+
+	if (app_sidewalk_ready) {
+		bool urgent = item->urgent;
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+		/* [TELEMETRY] Tight budget: hold low priority records, share frames. */
+		switch (app_airtime_admit(item->cls, item->rec.len)) {
+		case TELEMETRY_AIRTIME_DEFER:
+			return -EBUSY;
+		case TELEMETRY_AIRTIME_MERGE:
+			urgent = false;
+			break;
+		default:
+			break;
+		}
+#endif
+		err = item->frame ? app_telemetry_send_frame(item->rec.data, item->rec.len) :
+				    app_telemetry_submit_prebuilt(&item->rec, urgent);
+		if (!app_queue_retryable(err)) {
+			app_telemetry_log_submit(err);
+		}
+		return err;
 	}
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX)
+	err = item->frame ? app_outbox_store_frame(item->rec.data, item->rec.len) :
+			    app_outbox_store(telemetry_prebuilt_build, &item->rec);
+	if (err) {
+		LOG_WRN("Sidewalk not ready; drop %s record (outbox err %d)", what, err);
+	}
+	return err;
+#else
+	LOG_WRN("Sidewalk not ready; drop %s record", what);
+	return -ENOTCONN;
+#endif
+}
 
-	LOG_INF("GPIO event: %s state=%d edge=%s timestamp_ms=%" PRId64, pin_alias, state,
-		gpio_edge_str(edge), timestamp_ms);
+/*
+ * [EVSE-LOGIC] Every queue drop lands here. A build that owns a safety_gate
+ * passes it as ctx and calls safety_gate_set_queue_overflow() for the safety
+ * class; this app only reports, at 1, 2, 4, 8, ... drops per class.
+ */
+static void app_queue_overflow(void *ctx, enum telemetry_queue_class cls,
+			       const struct telemetry_queue_stats *stats)
+{
+	ARG_UNUSED(ctx);
+	if ((stats->dropped & (stats->dropped - 1)) == 0) {
+		LOG_WRN("Telemetry queue: %u %s record(s) dropped (%u too big), depth %u/%u",
+			stats->dropped, app_queue_class_name(cls), stats->too_big, stats->depth,
+			stats->high_water);
+	}
+}
 
-	int err = sidewalk_send_notify_json(payload, (size_t)len);
-	if (err) {
-		LOG_ERR("Sidewalk send: err %d", err);
-	} else {
-#if defined(CONFIG_STATE_NOTIFIER)
-		application_state_sending(&global_state_notifier, true);
+static void app_telemetry_enqueue(enum telemetry_queue_class cls, app_telemetry_build_t build,
+				  const void *arg, uint32_t seq, bool urgent)
+{
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
+	app_retain_store(seq, build, arg);
+#else
+	ARG_UNUSED(seq);
 #endif
-		LOG_INF("Sidewalk send: ok 0");
+	int err = app_queue_submit(cls, build, arg, urgent);
+
+	if (err == -EMSGSIZE) {
+		LOG_ERR("Telemetry %s record does not build", app_queue_class_name(cls));
 	}
 }
+
+#if defined(CONFIG_SID_END_DEVICE_GPIO_EVENTS) && defined(CONFIG_GPIO)
+struct app_gpio_record {
+	struct app_record_hdr hdr;
+	const char *pin_alias;
+	int state;
+	gpio_edge_t edge;
+};
+
+static int app_gpio_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			  const void *arg)
+{
+	const struct app_gpio_record *rec = arg;
+
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_gpio_payload_bin(buf, cap, rec->pin_alias, rec->state,
+							rec->edge, rec->hdr.timestamp_ms, NULL,
+							rec->hdr.event_id, rec->hdr.time_anomaly);
+	}
+	return telemetry_build_gpio_payload_env(buf, cap, &app_envelope, rec->pin_alias,
+						rec->state, rec->edge, rec->hdr.timestamp_ms, NULL,
+						rec->hdr.event_id, rec->hdr.time_anomaly);
+}
+
+static void app_gpio_send_event(const char *pin_alias, int state, gpio_edge_t edge)
+{
+	/* [TELEMETRY] GPIO event payload construction + Sidewalk uplink. */
+	struct app_gpio_record rec = {
+		.pin_alias = pin_alias,
+		.state = state,
+		.edge = edge,
+	};
+	app_record_hdr_init(&rec.hdr, app_get_timestamp_ms());
+
+	LOG_INF("GPIO event: %s state=%d edge=%s timestamp_ms=%" PRId64, pin_alias, state,
+		gpio_edge_str(edge), rec.hdr.timestamp_ms);
+
+	/* [EVSE-LOGIC] Interlock input edges are safety relevant; do not hold them back. */
+	app_telemetry_enqueue(TELEMETRY_QUEUE_SAFETY, app_gpio_build, &rec, rec.hdr.seq,
+			      IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_BATCH_URGENT_GPIO));
+}
 #endif
 
 #if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
-static void app_evse_send_event(const struct evse_event *evt, int64_t timestamp_ms)
+struct app_evse_record {
+	struct app_record_hdr hdr;
+	const struct evse_event *evt;
+};
+
+static int app_evse_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			  const void *arg)
 {
-	/* [TELEMETRY] EVSE event payload construction + Sidewalk uplink. */
-	if (!app_sidewalk_ready) {
-		LOG_WRN("Sidewalk not ready; drop evse event");
-		return;
+	const struct app_evse_record *rec = arg;
+
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_evse_payload_bin(buf, cap, rec->hdr.timestamp_ms, rec->evt,
+							rec->hdr.event_id, rec->hdr.time_anomaly);
 	}
+	return telemetry_build_evse_payload_env(buf, cap, &app_envelope, rec->hdr.timestamp_ms,
+						rec->evt, rec->hdr.event_id,
+						rec->hdr.time_anomaly);
+}
 
-	char event_id[32];
-	char payload[384];
-	app_next_event_id(event_id, sizeof(event_id));
-	int len = telemetry_build_evse_payload_ex(payload, sizeof(payload), APP_DEVICE_ID,
-						  APP_DEVICE_TYPE, timestamp_ms, evt, event_id,
-						  time_sync_time_anomaly());
-	if (len < 0) {
-		LOG_ERR("EVSE payload format failed");
-		return;
+struct app_session_record {
+	struct app_record_hdr hdr;
+	const struct evse_session_summary *summary;
+};
+
+static int app_session_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			     const void *arg)
+{
+	const struct app_session_record *rec = arg;
+
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_session_payload_bin(buf, cap, rec->hdr.timestamp_ms,
+							   rec->summary, rec->hdr.event_id,
+							   rec->hdr.time_anomaly);
 	}
+	return telemetry_build_session_payload_env(buf, cap, &app_envelope,
+						   rec->hdr.timestamp_ms, rec->summary,
+						   rec->hdr.event_id, rec->hdr.time_anomaly);
+}
 
-	LOG_INF("EVSE event: pilot=%c prox=%d duty=%.2f current=%.2fA energy=%.4f",
-		evse_pilot_state_to_char(evt->pilot_state), evt->proximity_detected,
-		(double)evt->pwm_duty_cycle, (double)evt->current_draw_a,
-		(double)evt->energy_kwh);
+static void app_evse_send_event(const struct evse_event *evt, int64_t timestamp_ms)
+{
+	/* [TELEMETRY] EVSE event payload construction + Sidewalk uplink. */
+	struct app_evse_record rec = {
+		.evt = evt,
+	};
+	app_record_hdr_init(&rec.hdr, timestamp_ms);
 
-	int err = sidewalk_send_notify_json(payload, (size_t)len);
-	if (err) {
-		LOG_ERR("Sidewalk send: err %d", err);
+	/* [TELEMETRY] Fixed-point log fields, so no float printf is linked. */
+	int duty_permille = (int)telemetry_fixed_from_float(evt->pwm_duty_cycle, 10);
+
+	LOG_INF("EVSE event: pilot=%c prox=%d duty=%d.%d%% current=%dmA energy=%dWh",
+		evse_pilot_state_to_char(evt->pilot_state), evt->proximity_detected,
+		duty_permille / 10, duty_permille % 10,
+		(int)telemetry_fixed_from_float(evt->current_draw_a, 1000),
+		(int)telemetry_fixed_from_float(evt->energy_kwh, 1000));
+
+	/*
+	 * [EVSE-LOGIC] Pilot error states (E/F) are safety records and flush
+	 * immediately; state changes and session boundaries coalesce.
+	 */
+	bool urgent = evt->pilot_state == EVSE_PILOT_E || evt->pilot_state == EVSE_PILOT_F;
+	enum telemetry_queue_class cls = urgent ? TELEMETRY_QUEUE_SAFETY : TELEMETRY_QUEUE_SESSION;
+	if (!evt->summary) {
+		app_telemetry_enqueue(cls, app_evse_build, &rec, rec.hdr.seq, urgent);
+		return;
 	}
+
+	/* [EVSE-LOGIC] session_end carries the session summary in the same frame. */
+	struct app_session_record session = {
+		.hdr = rec.hdr,
+		.summary = evt->summary,
+	};
+	LOG_INF("EVSE session: samples=%d p50=%dmA p95=%dmA max=%dmA",
+		evt->summary->samples,
+		(int)telemetry_fixed_from_float(evt->summary->current_p50_a, 1000),
+		(int)telemetry_fixed_from_float(evt->summary->current_p95_a, 1000),
+		(int)telemetry_fixed_from_float(evt->summary->current_max_a, 1000));
+	app_telemetry_enqueue(cls, app_evse_build, &rec, rec.hdr.seq, false);
+	app_telemetry_enqueue(cls, app_session_build, &session, session.hdr.seq, urgent);
 }
 #endif
 
 #if defined(CONFIG_SID_END_DEVICE_LINE_CURRENT_ENABLED)
+struct app_line_current_record {
+	struct app_record_hdr hdr;
+	const struct line_current_event *evt;
+};
+
+static int app_line_current_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+				  const void *arg)
+{
+	const struct app_line_current_record *rec = arg;
+
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_line_current_payload_bin(buf, cap, rec->hdr.timestamp_ms,
+								rec->evt, rec->hdr.event_id,
+								rec->hdr.time_anomaly);
+	}
+	return telemetry_build_line_current_payload_env(buf, cap, &app_envelope,
+							rec->hdr.timestamp_ms, rec->evt,
+							rec->hdr.event_id, rec->hdr.time_anomaly);
+}
+
 static void app_line_current_send_event(const struct line_current_event *evt, int64_t timestamp_ms)
 {
 	/* [TELEMETRY] Line current payload construction + Sidewalk uplink. */
-	if (!app_sidewalk_ready) {
-		LOG_WRN("Sidewalk not ready; drop line current event");
-		return;
+	struct app_line_current_record rec = {
+		.evt = evt,
+	};
+	app_record_hdr_init(&rec.hdr, timestamp_ms);
+
+	LOG_INF("Line current event: current=%dmA",
+		(int)telemetry_fixed_from_float(evt->current_a, 1000));
+
+	app_telemetry_enqueue(TELEMETRY_QUEUE_PERIODIC, app_line_current_build, &rec, rec.hdr.seq,
+			      false);
+}
+#endif
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_HEALTH)
+struct app_health_record {
+	struct app_record_hdr hdr;
+	const struct telemetry_health *health;
+};
+
+static int app_health_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			    const void *arg)
+{
+	const struct app_health_record *rec = arg;
+
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_health_payload_bin(buf, cap, rec->hdr.timestamp_ms,
+							  rec->health, rec->hdr.event_id,
+							  rec->hdr.time_anomaly);
 	}
+	return telemetry_build_health_payload_env(buf, cap, &app_envelope, rec->hdr.timestamp_ms,
+						  rec->health, rec->hdr.event_id,
+						  rec->hdr.time_anomaly);
+}
 
-	char event_id[32];
-	char payload[256];
-	app_next_event_id(event_id, sizeof(event_id));
-	int len = telemetry_build_line_current_payload_ex(payload, sizeof(payload), APP_DEVICE_ID,
-							  APP_DEVICE_TYPE, timestamp_ms, evt,
-							  event_id, time_sync_time_anomaly());
-	if (len < 0) {
-		LOG_ERR("Line current payload format failed");
+static void app_health_send_record(const struct telemetry_health *health)
+{
+	/* [TELEMETRY] Diagnostics ride with the periodic samples. */
+	struct app_health_record rec = {
+		.health = health,
+	};
+	app_record_hdr_init(&rec.hdr, app_get_timestamp_ms());
+
+	app_telemetry_enqueue(TELEMETRY_QUEUE_PERIODIC, app_health_build, &rec, rec.hdr.seq,
+			      false);
+}
+#endif
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_SERIES)
+static int app_series_send_block(const uint8_t *block, size_t len)
+{
+	/* [TELEMETRY] Series blocks are binary in either encoding and never batched. */
+	return app_queue_submit_frame(TELEMETRY_QUEUE_PERIODIC, block, len);
+}
+#endif
+
+/* [TELEMETRY] Announce is always JSON; it describes the JSON envelope. */
+static int app_announce_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			      const void *arg)
+{
+	const struct app_record_hdr *hdr = arg;
+
+	if (encoding != TELEMETRY_ENCODING_JSON) {
+		return -1;
+	}
+	return telemetry_build_announce_payload(buf, cap, &app_envelope, hdr->timestamp_ms,
+						hdr->event_id);
+}
+
+static void announce_work_handler(struct k_work *work)
+{
+	/* [TELEMETRY] Send the elided envelope fields once per READY transition. */
+	ARG_UNUSED(work);
+	if (app_envelope.mode != TELEMETRY_ENVELOPE_ELIDED || !app_sidewalk_ready ||
+	    app_telemetry_get_encoding() != TELEMETRY_ENCODING_JSON) {
 		return;
 	}
 
-	LOG_INF("Line current event: current=%.2fA", (double)evt->current_a);
+	struct app_record_hdr hdr;
+	app_record_hdr_init(&hdr, app_get_timestamp_ms());
 
-	int err = sidewalk_send_notify_json(payload, (size_t)len);
-	if (err) {
-		LOG_ERR("Sidewalk send: err %d", err);
+	LOG_INF("Telemetry announce: ctx=%04x", app_envelope.ctx_id);
+	/* Urgent so it is never held behind (or after) the frames that reference it. */
+	app_telemetry_log_submit(app_telemetry_submit(app_announce_build, &hdr, true));
+}
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME) ||                                       \
+	defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+static void app_on_msg_put(int32_t tag, sid_error_t err, const sidewalk_msg_t *msg)
+{
+	/* [TELEMETRY] Sidewalk thread, right after sid_put_msg(); every uplink lands here. */
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+	if (err == SID_ERROR_NONE) {
+		app_airtime_charge(msg->msg.size);
 	}
+#endif
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	app_delivery_put(tag, err, msg);
+#endif
 }
 #endif
 
 static void on_sidewalk_event(bool in_isr, void *context)
 {
 	/* [3P-GLUE] Sidewalk SDK callback entrypoint (signature required). */
-	int err = sidewalk_event_send(sidewalk_event_process, NULL, NULL);
+	int err = sidewalk_event_process_request();
 	if (err) {
 		LOG_ERR("Send event err %d", err);
 	};
@@ -213,6 +487,68 @@ static void app_handle_time_sync(const struct sid_msg *msg)
 	LOG_INF("Time sync applied: epoch_ms=%" PRId64, epoch_ms);
 }
 
+static void app_handle_telemetry_encoding(const struct sid_msg *msg)
+{
+	/* [TELEMETRY] Runtime switch between JSON and binary (schema v3) uplinks. */
+	if (!msg || !msg->data || msg->size == 0) {
+		return;
+	}
+
+	char buf[128];
+	size_t copy_len = MIN(msg->size, sizeof(buf) - 1);
+	memcpy(buf, msg->data, copy_len);
+	buf[copy_len] = '\0';
+
+	if (!strstr(buf, "\"cmd\":\"telemetry_encoding\"")) {
+		return;
+	}
+
+	if (strstr(buf, "\"encoding\":\"binary\"")) {
+		app_telemetry_set_encoding(TELEMETRY_ENCODING_BINARY);
+	} else if (strstr(buf, "\"encoding\":\"json\"")) {
+		app_telemetry_set_encoding(TELEMETRY_ENCODING_JSON);
+	} else {
+		LOG_WRN("Unknown telemetry encoding");
+		return;
+	}
+	LOG_INF("Telemetry encoding: %s",
+		app_telemetry_get_encoding() == TELEMETRY_ENCODING_BINARY ? "binary" : "json");
+}
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
+static void app_handle_resend(const struct sid_msg *msg)
+{
+	/* [TELEMETRY] Cloud asks for a sequence range it did not receive. */
+	if (!msg || !msg->data || msg->size == 0) {
+		return;
+	}
+
+	char buf[128];
+	size_t copy_len = MIN(msg->size, sizeof(buf) - 1);
+	memcpy(buf, msg->data, copy_len);
+	buf[copy_len] = '\0';
+
+	if (!strstr(buf, "\"cmd\":\"resend\"")) {
+		return;
+	}
+
+	char *from_ptr = strstr(buf, "\"from\":");
+	char *to_ptr = strstr(buf, "\"to\":");
+	if (!from_ptr || !to_ptr) {
+		LOG_WRN("Resend request without from/to");
+		return;
+	}
+
+	unsigned long from = strtoul(from_ptr + strlen("\"from\":"), NULL, 10);
+	unsigned long to = strtoul(to_ptr + strlen("\"to\":"), NULL, 10);
+	if (from > to || to > UINT32_MAX) {
+		LOG_WRN("Resend request %lu..%lu rejected", from, to);
+		return;
+	}
+	(void)app_retain_resend((uint32_t)from, (uint32_t)to);
+}
+#endif
+
 static void on_sidewalk_msg_received(const struct sid_msg_desc *msg_desc, const struct sid_msg *msg,
 				     void *context)
 {
@@ -225,6 +561,10 @@ static void on_sidewalk_msg_received(const struct sid_msg_desc *msg_desc, const
 	application_state_receiving(&global_state_notifier, false);
 #endif
 	app_handle_time_sync(msg);
+	app_handle_telemetry_encoding(msg);
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
+	app_handle_resend(msg);
+#endif
 
 #ifdef CONFIG_SID_END_DEVICE_ECHO_MSGS
 	if (msg_desc->type == SID_MSG_TYPE_GET || msg_desc->type == SID_MSG_TYPE_SET) {
@@ -255,6 +595,9 @@ static void on_sidewalk_msg_sent(const struct sid_msg_desc *msg_desc, void *cont
 	LOG_INF("Message send success");
 	printk(JSON_NEW_LINE(JSON_OBJ(JSON_NAME(
 		"on_msg_sent", JSON_OBJ(JSON_VAL_sid_msg_desc("sid_msg_desc", msg_desc, 0))))));
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	app_delivery_sent(msg_desc);
+#endif
 #if defined(CONFIG_STATE_NOTIFIER)
 	application_state_sending(&global_state_notifier, false);
 #endif
@@ -269,6 +612,10 @@ static void on_sidewalk_send_error(sid_error_t error, const struct sid_msg_desc
 		"on_send_error",
 		JSON_OBJ(JSON_LIST_2(JSON_VAL_sid_error_t("error", error),
 				     JSON_VAL_sid_msg_desc("sid_msg_desc", msg_desc, 0)))))));
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	/* [TELEMETRY] Correlate the failure with the tracked frame and schedule a resend. */
+	app_delivery_error(msg_desc);
+#endif
 #if defined(CONFIG_STATE_NOTIFIER)
 	application_state_sending(&global_state_notifier, false);
 #endif
@@ -288,23 +635,31 @@ static void on_sidewalk_factory_reset(void *context)
 #endif
 }
 
+BUILD_ASSERT(sizeof(struct sid_status) <= SIDEWALK_EVENT_INLINE_MAX,
+	     "CONFIG_SID_END_DEVICE_EVENT_INLINE_SIZE must hold struct sid_status");
+
 static void on_sidewalk_status_changed(const struct sid_status *status, void *context)
 {
 	/* [3P-GLUE] Sidewalk status callback; start/stop periodic telemetry. */
 	int err = 0;
 	uint32_t new_link_mask = status->detail.link_status_mask;
-	struct sid_status *new_status = sid_hal_malloc(sizeof(struct sid_status));
-	if (!new_status) {
-		LOG_ERR("Failed to allocate memory for new status value");
-	} else {
-		memcpy(new_status, status, sizeof(struct sid_status));
-	}
-	err = sidewalk_event_send(sidewalk_event_new_status, new_status, sid_hal_free);
+	/* [3P-GLUE] The status travels inside the queue entry: no allocation to fail. */
+	err = sidewalk_event_send_inline(SIDEWALK_EVENT_PRIO_CONTROL, sidewalk_event_new_status,
+					 status, sizeof(*status));
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+	app_airtime_set_links(new_link_mask);
+#endif
 
 #if defined(CONFIG_STATE_NOTIFIER)
 	switch (status->state) {
 	case SID_STATE_READY:
 	case SID_STATE_SECURE_CHANNEL_READY:
+		if (!app_sidewalk_ready) {
+			(void)k_work_submit(&announce_work);
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX)
+			app_outbox_set_ready(true);
+#endif
+		}
 		app_sidewalk_ready = true;
 		application_state_connected(&global_state_notifier, true);
 		LOG_INF("Status changed: ready");
@@ -315,6 +670,9 @@ static void on_sidewalk_status_changed(const struct sid_status *status, void *co
 		break;
 	case SID_STATE_NOT_READY:
 		app_sidewalk_ready = false;
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX)
+		app_outbox_set_ready(false);
+#endif
 		application_state_connected(&global_state_notifier, false);
 		LOG_INF("Status changed: not ready");
 		if (periodic_send_started) {
@@ -324,6 +682,9 @@ static void on_sidewalk_status_changed(const struct sid_status *status, void *co
 		break;
 	case SID_STATE_ERROR:
 		app_sidewalk_ready = false;
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX)
+		app_outbox_set_ready(false);
+#endif
 		application_state_error(&global_state_notifier, true);
 		LOG_INF("Status not changed: error");
 		if (periodic_send_started) {
@@ -368,6 +729,15 @@ static void on_sidewalk_status_changed(const struct sid_status *status, void *co
 static void periodic_send_work_handler(struct k_work *work)
 {
 	ARG_UNUSED(work);
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+	/* [TELEMETRY] The hello is a keepalive; skip a beat rather than spend a tight budget. */
+	if (app_airtime_admit(TELEMETRY_QUEUE_PERIODIC, APP_HELLO_LEN) ==
+	    TELEMETRY_AIRTIME_DEFER) {
+		LOG_DBG("Periodic hello deferred: airtime budget tight");
+		(void)k_work_schedule(&periodic_send_work, APP_PERIODIC_SEND_INTERVAL);
+		return;
+	}
+#endif
 	app_btn_send_msg(0U);
 	(void)k_work_schedule(&periodic_send_work, APP_PERIODIC_SEND_INTERVAL);
 }
@@ -384,6 +754,33 @@ void app_start(void)
 {
 	/* [BOILERPLATE] App init and periodic work scheduling. */
 	time_sync_init();
+	(void)telemetry_envelope_init(&app_envelope, APP_DEVICE_ID, APP_DEVICE_TYPE,
+				      IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_ELIDE_ENVELOPE) ?
+					      TELEMETRY_ENVELOPE_ELIDED :
+					      TELEMETRY_ENVELOPE_FULL);
+	app_telemetry_init(IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_ENCODING_BINARY) ?
+				   TELEMETRY_ENCODING_BINARY :
+				   TELEMETRY_ENCODING_JSON);
+	k_work_init(&announce_work, announce_work_handler);
+	app_queue_init(app_queue_deliver, app_queue_overflow, NULL);
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN)
+	app_retain_init();
+#endif
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+	app_airtime_init();
+#endif
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	app_delivery_init();
+#endif
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME) ||                                       \
+	defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	sidewalk_msg_set_put_hook(app_on_msg_put);
+#endif
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX)
+	if (app_outbox_init()) {
+		LOG_ERR("Telemetry outbox unavailable; offline events are dropped");
+	}
+#endif
 	if (app_buttons_init()) {
 		LOG_ERR("Cannot init buttons");
 	}
@@ -392,6 +789,14 @@ void app_start(void)
 	app_gpio_init(app_gpio_send_event);
 #endif
 
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_SERIES)
+	app_series_init(app_series_send_block);
+#endif
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_HEALTH)
+	app_health_init(app_health_send_record);
+#endif
+
 #if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
 	if (app_evse_init(app_evse_send_event)) {
 		LOG_ERR("EVSE init failed");
@@ -0,0 +1,137 @@
+/*
+ * [TELEMETRY] Airtime budget glue: admissions come from the system work queue
+ * (queue drain, periodic hello), charges from the Sidewalk thread, so every
+ * access goes through app_airtime_lock.
+ */
+#include "main/app_airtime.h"
+
+#include <sid_api.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_AIRTIME_OVERHEAD CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_OVERHEAD
+/* [3P-GLUE] Preamble + sync / access address bytes of the FSK and BLE PHYs. */
+#define APP_AIRTIME_FSK_PREAMBLE 8
+#define APP_AIRTIME_BLE_PREAMBLE 5
+
+static K_MUTEX_DEFINE(app_airtime_lock);
+static struct telemetry_airtime app_airtime;
+static bool app_airtime_was_tight;
+
+const char *app_airtime_link_name(enum telemetry_airtime_link link)
+{
+	switch (link) {
+	case TELEMETRY_AIRTIME_BLE:
+		return "BLE";
+	case TELEMETRY_AIRTIME_FSK:
+		return "FSK";
+	case TELEMETRY_AIRTIME_LORA:
+		return "LoRa";
+	default:
+		return "unknown";
+	}
+}
+
+void app_airtime_init(void)
+{
+	const struct telemetry_airtime_config cfg = {
+		.phy = {
+			[TELEMETRY_AIRTIME_BLE] = {
+				.bitrate_bps = 1000000,
+				.preamble = APP_AIRTIME_BLE_PREAMBLE,
+				.overhead = APP_AIRTIME_OVERHEAD,
+			},
+			[TELEMETRY_AIRTIME_FSK] = {
+				.bitrate_bps = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_FSK_BPS,
+				.preamble = APP_AIRTIME_FSK_PREAMBLE,
+				.overhead = APP_AIRTIME_OVERHEAD,
+			},
+			[TELEMETRY_AIRTIME_LORA] = {
+				.lora = true,
+				.sf = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_LORA_SF,
+				.bw_khz = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_LORA_BW_KHZ,
+				.cr = 1,
+				.preamble = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_LORA_PREAMBLE,
+				.overhead = APP_AIRTIME_OVERHEAD,
+			},
+		},
+		/* BLE is not duty-cycle limited. */
+		.duty_ppm = {
+			[TELEMETRY_AIRTIME_FSK] =
+				CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_FSK_DUTY_PPM,
+			[TELEMETRY_AIRTIME_LORA] =
+				CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_LORA_DUTY_PPM,
+		},
+		.burst_ms = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_BURST_MS,
+		.reserve_pct = CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME_RESERVE_PCT,
+	};
+
+	if (telemetry_airtime_init(&app_airtime, &cfg, k_uptime_get())) {
+		LOG_ERR("Airtime: invalid budget configuration");
+	}
+}
+
+void app_airtime_set_links(uint32_t link_status_mask)
+{
+	/* [3P-GLUE] SID_LINK_TYPE_ANY may use any up link; budget for the scarcest. */
+	enum telemetry_airtime_link link = (link_status_mask & SID_LINK_TYPE_3) ?
+						   TELEMETRY_AIRTIME_LORA :
+					   (link_status_mask & SID_LINK_TYPE_2) ?
+						   TELEMETRY_AIRTIME_FSK :
+						   TELEMETRY_AIRTIME_BLE;
+
+	k_mutex_lock(&app_airtime_lock, K_FOREVER);
+	if (link != app_airtime.link) {
+		LOG_INF("Airtime: budgeting %s", app_airtime_link_name(link));
+		telemetry_airtime_set_link(&app_airtime, link);
+	}
+	k_mutex_unlock(&app_airtime_lock);
+}
+
+enum telemetry_airtime_verdict app_airtime_admit(enum telemetry_queue_class cls, size_t len)
+{
+	int64_t now = k_uptime_get();
+
+	k_mutex_lock(&app_airtime_lock, K_FOREVER);
+	enum telemetry_airtime_verdict verdict =
+		telemetry_airtime_admit(&app_airtime, cls, len, now);
+	bool tight = telemetry_airtime_tight(&app_airtime, now);
+
+	if (tight != app_airtime_was_tight) {
+		const struct telemetry_airtime_stats *st = &app_airtime.stats[app_airtime.link];
+
+		LOG_INF("Airtime: %s budget %s, %lld ms left; %u merged, %u deferred",
+			app_airtime_link_name(app_airtime.link), tight ? "tight" : "recovered",
+			(long long)(telemetry_airtime_level_us(&app_airtime, now) / 1000),
+			st->merged, st->deferred);
+		app_airtime_was_tight = tight;
+	}
+	k_mutex_unlock(&app_airtime_lock);
+	return verdict;
+}
+
+void app_airtime_charge(size_t len)
+{
+	k_mutex_lock(&app_airtime_lock, K_FOREVER);
+	telemetry_airtime_charge(&app_airtime, len, k_uptime_get());
+	k_mutex_unlock(&app_airtime_lock);
+}
+
+void app_airtime_metrics(struct app_airtime_metrics *out)
+{
+	if (!out) {
+		return;
+	}
+	int64_t now = k_uptime_get();
+
+	k_mutex_lock(&app_airtime_lock, K_FOREVER);
+	out->link = app_airtime.link;
+	out->duty_ppm = app_airtime.cfg.duty_ppm[app_airtime.link];
+	out->burst_us = app_airtime.cfg.burst_ms * 1000U;
+	out->level_us = telemetry_airtime_level_us(&app_airtime, now);
+	out->tight = telemetry_airtime_tight(&app_airtime, now);
+	out->stats = app_airtime.stats[app_airtime.link];
+	k_mutex_unlock(&app_airtime_lock);
+}
@@ -0,0 +1,39 @@
+/*
+ * [TELEMETRY] Uplink airtime budget (telemetry_airtime.h) for the link in use.
+ * The queue sink asks before it hands a record to the uplink; every frame
+ * sid_put_msg() accepts is charged, whoever sent it.
+ */
+#ifndef APP_AIRTIME_H
+#define APP_AIRTIME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/telemetry_airtime.h"
+
+/* [TELEMETRY] Budget state of the current link, for logs and diagnostics. */
+struct app_airtime_metrics {
+	enum telemetry_airtime_link link;
+	uint32_t duty_ppm;
+	uint32_t burst_us;
+	int64_t level_us;
+	bool tight;
+	struct telemetry_airtime_stats stats;
+};
+
+void app_airtime_init(void);
+
+/* [TELEMETRY] Follow link_status_mask; charges go to the most constrained up link. */
+void app_airtime_set_links(uint32_t link_status_mask);
+
+enum telemetry_airtime_verdict app_airtime_admit(enum telemetry_queue_class cls, size_t len);
+
+/* [TELEMETRY] A frame of len bytes was accepted by sid_put_msg(); Sidewalk thread. */
+void app_airtime_charge(size_t len);
+
+void app_airtime_metrics(struct app_airtime_metrics *out);
+
+const char *app_airtime_link_name(enum telemetry_airtime_link link);
+
+#endif /* APP_AIRTIME_H */
@@ -0,0 +1,166 @@
+/*
+ * [TELEMETRY] Delivery tracking glue: the in-flight table is fed from the
+ * Sidewalk thread (put hook, send callbacks) and resends from the system work
+ * queue, so every access goes through app_delivery_lock.
+ * [3P-GLUE] Resends are fresh notifies tagged with their slot, so the put hook
+ * (app_delivery_put) moves the slot to the new message id.
+ */
+#include "main/app_delivery.h"
+
+#include "sidewalk/sidewalk_msg.h"
+#include "telemetry/telemetry_delivery.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_DELIVERY_SLOTS CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_SLOTS
+#define APP_DELIVERY_ITEM CONFIG_SID_END_DEVICE_TELEMETRY_BATCH_MTU
+#define APP_DELIVERY_REPORT_MS (CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_REPORT_S * 1000LL)
+
+static K_MUTEX_DEFINE(app_delivery_lock);
+static struct k_work_delayable app_delivery_work;
+static struct telemetry_delivery app_delivery;
+static struct telemetry_delivery_slot app_delivery_slots[APP_DELIVERY_SLOTS];
+static uint8_t app_delivery_storage[APP_DELIVERY_SLOTS * APP_DELIVERY_ITEM];
+static struct telemetry_delivery_stats app_delivery_reported;
+static int64_t app_delivery_report_ms;
+
+/* [TELEMETRY] Wake up for the next resend or timeout, or for the next report. */
+static void app_delivery_schedule_locked(void)
+{
+	int64_t due = MIN(telemetry_delivery_next_due(&app_delivery), app_delivery_report_ms);
+	int64_t delay = due - k_uptime_get();
+
+	(void)k_work_reschedule(&app_delivery_work, K_MSEC(MAX(delay, 0)));
+}
+
+void app_delivery_put(int32_t tag, sid_error_t err, const sidewalk_msg_t *msg)
+{
+	if (tag == SIDEWALK_MSG_UNTRACKED) {
+		return;
+	}
+	k_mutex_lock(&app_delivery_lock, K_FOREVER);
+	telemetry_delivery_put(&app_delivery, (uint16_t)tag, err == SID_ERROR_NONE, msg->desc.id,
+			       msg->msg.data, msg->msg.size, k_uptime_get());
+	app_delivery_schedule_locked();
+	k_mutex_unlock(&app_delivery_lock);
+}
+
+void app_delivery_sent(const struct sid_msg_desc *desc)
+{
+	k_mutex_lock(&app_delivery_lock, K_FOREVER);
+	telemetry_delivery_sent(&app_delivery, desc->id, k_uptime_get());
+	k_mutex_unlock(&app_delivery_lock);
+}
+
+void app_delivery_error(const struct sid_msg_desc *desc)
+{
+	k_mutex_lock(&app_delivery_lock, K_FOREVER);
+	uint32_t failed = app_delivery.stats.failed;
+	telemetry_delivery_error(&app_delivery, desc->id, k_uptime_get());
+	if (app_delivery.stats.failed != failed) {
+		LOG_WRN("Delivery: message %u given up after %u attempts", desc->id,
+			CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_MAX_ATTEMPTS);
+	}
+	app_delivery_schedule_locked();
+	k_mutex_unlock(&app_delivery_lock);
+}
+
+/* [TELEMETRY] Copy of the next record due, as a message tagged with its slot. */
+static sidewalk_msg_t *app_delivery_next_locked(int64_t now, int *slot, size_t *len)
+{
+	const void *data;
+
+	*slot = telemetry_delivery_next_resend(&app_delivery, now, &data, len);
+	if (*slot < 0) {
+		return NULL;
+	}
+	sidewalk_msg_t *msg = sidewalk_msg_reserve(*len);
+	if (!msg) {
+		telemetry_delivery_resend_failed(&app_delivery, (uint16_t)*slot, now);
+		return NULL;
+	}
+	memcpy(sidewalk_msg_payload(msg), data, *len);
+	sidewalk_msg_set_tag(msg, *slot);
+	return msg;
+}
+
+static void app_delivery_report_locked(void)
+{
+	const struct telemetry_delivery_stats *st = &app_delivery.stats;
+	uint32_t done = st->acked + st->failed;
+	uint32_t loss_pm = done ? (uint32_t)(((uint64_t)st->failed * 1000U) / done) : 0;
+	uint32_t ack_avg = st->acked ? (uint32_t)(st->ack_ms_total / st->acked) : 0;
+
+	LOG_INF("Delivery: %u tracked, %u acked, %u failed (%u.%u%% lost), %u retries, "
+		"%u timeouts, %u untracked; ack avg %u ms, max %u ms",
+		st->tracked, st->acked, st->failed, loss_pm / 10, loss_pm % 10, st->retries,
+		st->timeouts, st->untracked, ack_avg, st->ack_ms_max);
+	app_delivery_reported = *st;
+}
+
+void app_delivery_report(void)
+{
+	k_mutex_lock(&app_delivery_lock, K_FOREVER);
+	app_delivery_report_locked();
+	k_mutex_unlock(&app_delivery_lock);
+}
+
+static void app_delivery_work_handler(struct k_work *work)
+{
+	/* [TELEMETRY] Resend everything due, oldest first, then sleep until the next due. */
+	ARG_UNUSED(work);
+	size_t len;
+	int slot;
+
+	int64_t now = k_uptime_get();
+	for (;;) {
+		/* Commit outside the lock: the Sidewalk thread takes it in the put hook. */
+		k_mutex_lock(&app_delivery_lock, K_FOREVER);
+		sidewalk_msg_t *msg = app_delivery_next_locked(now, &slot, &len);
+		k_mutex_unlock(&app_delivery_lock);
+		if (slot < 0) {
+			break;
+		}
+		int err = msg ? sidewalk_msg_commit_notify(msg, len) : -ENOMEM;
+		if (err) {
+			LOG_WRN("Delivery: resend failed, err %d", err);
+			k_mutex_lock(&app_delivery_lock, K_FOREVER);
+			telemetry_delivery_resend_failed(&app_delivery, (uint16_t)slot, now);
+			k_mutex_unlock(&app_delivery_lock);
+		}
+	}
+
+	k_mutex_lock(&app_delivery_lock, K_FOREVER);
+	if (now >= app_delivery_report_ms) {
+		if (memcmp(&app_delivery_reported, &app_delivery.stats,
+			   sizeof(app_delivery_reported)) != 0) {
+			app_delivery_report_locked();
+		}
+		app_delivery_report_ms = now + APP_DELIVERY_REPORT_MS;
+	}
+	app_delivery_schedule_locked();
+	k_mutex_unlock(&app_delivery_lock);
+}
+
+void app_delivery_init(void)
+{
+	const struct telemetry_delivery_config cfg = {
+		.backoff_base_ms = CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_BACKOFF_MS,
+		.backoff_max_ms = MAX(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_BACKOFF_MAX_MS,
+				      CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_BACKOFF_MS),
+		.ack_timeout_ms = CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_ACK_TIMEOUT_MS,
+		.max_attempts = CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_MAX_ATTEMPTS,
+		.rand = sys_rand32_get,
+	};
+
+	k_work_init_delayable(&app_delivery_work, app_delivery_work_handler);
+	(void)telemetry_delivery_init(&app_delivery, app_delivery_slots, APP_DELIVERY_SLOTS,
+				      app_delivery_storage, APP_DELIVERY_ITEM, &cfg);
+	app_delivery_report_ms = k_uptime_get() + APP_DELIVERY_REPORT_MS;
+}
@@ -0,0 +1,24 @@
+/*
+ * [TELEMETRY] Uplink delivery tracking and retry (telemetry_delivery.h) wired to
+ * the Sidewalk put hook and the on_msg_sent / on_send_error callbacks.
+ */
+#ifndef APP_DELIVERY_H
+#define APP_DELIVERY_H
+
+#include <sid_api.h>
+
+#include "sidewalk/sidewalk_msg.h"
+
+void app_delivery_init(void);
+
+/* [TELEMETRY] Put hook share (sidewalk_msg_put_hook_t); untracked messages are ignored. */
+void app_delivery_put(int32_t tag, sid_error_t err, const sidewalk_msg_t *msg);
+
+/* [TELEMETRY] Sidewalk callbacks; run on the Sidewalk thread. */
+void app_delivery_sent(const struct sid_msg_desc *desc);
+void app_delivery_error(const struct sid_msg_desc *desc);
+
+/* [TELEMETRY] Log the success/failure/retry counts and time-to-ack now. */
+void app_delivery_report(void);
+
+#endif /* APP_DELIVERY_H */
@@ -5,6 +5,7 @@
  */
 
 #include "main/app_evse.h"
+#include "main/app_series.h"
 
 #include "telemetry/evse.h"
 #include "sidewalk/time_sync.h"
@@ -38,6 +39,10 @@ static void app_evse_work_handler(struct k_work *work)
 	if (evse_poll(&evt, ts_ms)) {
 		app_evse_event_handler(&evt, ts_ms);
 	}
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_SERIES)
+	/* [TELEMETRY] Every sample feeds the current_draw time series. */
+	app_series_add(TELEMETRY_SERIES_EVSE_CURRENT, ts_ms, evt.current_draw_a);
+#endif
 }
 
 static void app_evse_timer_handler(struct k_timer *timer)
@@ -0,0 +1,104 @@
+/*
+ * [TELEMETRY] Device health glue: reads the Sidewalk thread counters
+ * (sidewalk_event_queue_stats(), sidewalk_event_handler_stats()) from the
+ * system work queue; the counters have their own lock.
+ */
+#include "main/app_health.h"
+
+#include "sidewalk/sidewalk.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdint.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_HEALTH_PERIOD K_SECONDS(CONFIG_SID_END_DEVICE_TELEMETRY_HEALTH_PERIOD_S)
+
+static struct k_work_delayable app_health_work;
+static app_health_send_t app_health_send;
+
+static int32_t app_health_i32(uint64_t v)
+{
+	return v > INT32_MAX ? INT32_MAX : (int32_t)v;
+}
+
+static uint32_t app_health_avg(uint64_t total, uint32_t count)
+{
+	return count ? (uint32_t)(total / count) : 0;
+}
+
+void app_health_collect(struct telemetry_health *out)
+{
+	struct sidewalk_event_queue_stats control;
+	struct sidewalk_event_queue_stats bulk;
+	struct sidewalk_event_handler_stats hs;
+	uint32_t exec_max_us = 0;
+	const char *slow = "";
+
+	sidewalk_event_queue_stats(SIDEWALK_EVENT_PRIO_CONTROL, &control);
+	sidewalk_event_queue_stats(SIDEWALK_EVENT_PRIO_BULK, &bulk);
+	for (int i = 0; i < sidewalk_event_handler_count(); i++) {
+		if (sidewalk_event_handler_stats(i, &hs) == 0 && hs.dispatched &&
+		    hs.exec_max_us >= exec_max_us) {
+			exec_max_us = hs.exec_max_us;
+			slow = hs.name;
+		}
+	}
+
+	*out = (struct telemetry_health){
+		.queue_size = app_health_i32(control.depth_size),
+		.queue_depth_max = app_health_i32(control.depth_max),
+		.bulk_depth_max = app_health_i32(bulk.depth_max),
+		.enqueue_failed =
+			app_health_i32((uint64_t)control.enqueue_failed + bulk.enqueue_failed),
+		.latency_max_us = app_health_i32(control.latency_max_us),
+		.slow_handler = slow,
+		.exec_max_us = app_health_i32(exec_max_us),
+		.process_merged = app_health_i32(sidewalk_event_process_merged()),
+	};
+}
+
+void app_health_log(void)
+{
+	struct sidewalk_event_queue_stats st;
+	struct sidewalk_event_handler_stats hs;
+
+	for (int prio = 0; prio < SIDEWALK_EVENT_PRIO_COUNT; prio++) {
+		sidewalk_event_queue_stats((enum sidewalk_event_prio)prio, &st);
+		LOG_INF("Health: %s queue peak %u/%u, %u dropped, %u events, latency avg %u max %u us",
+			prio == SIDEWALK_EVENT_PRIO_CONTROL ? "control" : "bulk", st.depth_max,
+			st.depth_size, st.enqueue_failed, st.dispatched,
+			app_health_avg(st.latency_total_us, st.dispatched), st.latency_max_us);
+	}
+	for (int i = 0; i < sidewalk_event_handler_count(); i++) {
+		if (sidewalk_event_handler_stats(i, &hs) || !hs.dispatched) {
+			continue;
+		}
+		LOG_INF("Health: %s x%u, latency avg %u max %u us, run avg %u max %u us", hs.name,
+			hs.dispatched, app_health_avg(hs.latency_total_us, hs.dispatched),
+			hs.latency_max_us, app_health_avg(hs.exec_total_us, hs.dispatched),
+			hs.exec_max_us);
+	}
+	LOG_INF("Health: %u sid_process wakeups merged", sidewalk_event_process_merged());
+}
+
+static void app_health_work_handler(struct k_work *work)
+{
+	struct telemetry_health health;
+
+	ARG_UNUSED(work);
+	app_health_log();
+	app_health_collect(&health);
+	if (app_health_send) {
+		app_health_send(&health);
+	}
+	(void)k_work_schedule(&app_health_work, APP_HEALTH_PERIOD);
+}
+
+void app_health_init(app_health_send_t send)
+{
+	app_health_send = send;
+	k_work_init_delayable(&app_health_work, app_health_work_handler);
+	(void)k_work_schedule(&app_health_work, APP_HEALTH_PERIOD);
+}
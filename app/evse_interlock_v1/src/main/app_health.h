@@ -0,0 +1,21 @@
+/*
+ * [TELEMETRY] Periodic device health report. Every
+ * CONFIG_SID_END_DEVICE_TELEMETRY_HEALTH_PERIOD_S the Sidewalk thread queue
+ * counters are logged per handler and handed to the sender as one record.
+ */
+#ifndef APP_HEALTH_H
+#define APP_HEALTH_H
+
+#include "telemetry/telemetry_health.h"
+
+/* [TELEMETRY] Queue one health record; the struct is only valid during the call. */
+typedef void (*app_health_send_t)(const struct telemetry_health *health);
+
+void app_health_init(app_health_send_t send);
+
+/* [TELEMETRY] Current figures; slow_handler points at a static name. */
+void app_health_collect(struct telemetry_health *out);
+
+void app_health_log(void);
+
+#endif /* APP_HEALTH_H */
@@ -2,6 +2,7 @@
  * [LINE-CURRENT] Periodic sampling loop for upstream current clamp.
  */
 #include "main/app_line_current.h"
+#include "main/app_series.h"
 
 #include "telemetry/line_current.h"
 #include "sidewalk/time_sync.h"
@@ -35,6 +36,12 @@ static void app_line_current_work_handler(struct k_work *work)
 	if (line_current_poll(&evt)) {
 		app_line_current_event_handler(&evt, ts_ms);
 	}
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_SERIES)
+	/* [TELEMETRY] Every sample, not just threshold trips; event_type is unset on ADC error. */
+	if (evt.event_type) {
+		app_series_add(TELEMETRY_SERIES_LINE_CURRENT, ts_ms, evt.current_a);
+	}
+#endif
 }
 
 static void app_line_current_timer_handler(struct k_timer *timer)
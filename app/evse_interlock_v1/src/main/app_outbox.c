@@ -0,0 +1,261 @@
+/*
+ * [TELEMETRY] Flash-backed outbox glue: flash_area callbacks for telemetry_outbox
+ * and a rate-limited drain worker.
+ * [3P-GLUE] Stored records re-enter the uplink through app_telemetry, so they
+ * coalesce with live records and respect the link MTU.
+ */
+#include "main/app_outbox.h"
+
+#include "main/app_airtime.h"
+
+#include "telemetry/telemetry_outbox.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_OUTBOX_SECTOR_SIZE CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX_SECTOR_SIZE
+#define APP_OUTBOX_DRAIN_MS CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX_DRAIN_INTERVAL_MS
+#define APP_OUTBOX_DRAIN_BURST CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX_DRAIN_BURST
+#define APP_OUTBOX_ORDER                                                                   \
+	(IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_OUTBOX_LIFO) ? TELEMETRY_OUTBOX_LIFO :   \
+								   TELEMETRY_OUTBOX_FIFO)
+
+/*
+ * [TELEMETRY] First byte of a stored item: a standalone frame, or the record
+ * encoding, flagged PACKED when the record is stored with its binary form
+ * (telemetry_prebuilt.h). Unflagged records are bare, from older firmware.
+ */
+#define APP_OUTBOX_KIND_FRAME 0xFF
+#define APP_OUTBOX_KIND_PACKED 0x80
+#define APP_OUTBOX_ITEM_MAX                                                                \
+	(1 + TELEMETRY_PREBUILT_MAX(CONFIG_SID_END_DEVICE_TELEMETRY_MAX_PAYLOAD))
+
+static K_MUTEX_DEFINE(app_outbox_lock);
+static struct k_work_delayable app_outbox_drain_work;
+static const struct flash_area *app_outbox_fa;
+static struct telemetry_outbox_flash app_outbox_flash;
+static struct telemetry_outbox app_outbox;
+static bool app_outbox_mounted;
+static bool app_outbox_ready;
+/* [TELEMETRY] Drain attempts held back by a record no route fits on this link. */
+static uint32_t app_outbox_held;
+/* [TELEMETRY] One stored item (kind byte + record); used under app_outbox_lock. */
+static uint8_t app_outbox_item[APP_OUTBOX_ITEM_MAX];
+
+static int app_outbox_read(void *ctx, uint32_t off, void *buf, size_t len)
+{
+	return flash_area_read(ctx, off, buf, len);
+}
+
+static int app_outbox_write(void *ctx, uint32_t off, const void *buf, size_t len)
+{
+	return flash_area_write(ctx, off, buf, len);
+}
+
+static int app_outbox_erase(void *ctx, uint32_t off, size_t len)
+{
+	return flash_area_erase(ctx, off, len);
+}
+
+static int app_outbox_push_locked(size_t len)
+{
+	uint32_t dropped = app_outbox.dropped;
+
+	if (telemetry_outbox_push(&app_outbox, app_outbox_item, len) < 0) {
+		return -EIO;
+	}
+	if (app_outbox.dropped != dropped) {
+		LOG_WRN("Outbox full: %u oldest record(s) overwritten",
+			app_outbox.dropped - dropped);
+	}
+	return 0;
+}
+
+int app_outbox_store(app_telemetry_build_t build, const void *arg)
+{
+	enum telemetry_encoding encoding = app_telemetry_get_encoding();
+	int err;
+
+	if (!build) {
+		return -EINVAL;
+	}
+	k_mutex_lock(&app_outbox_lock, K_FOREVER);
+	if (!app_outbox_mounted) {
+		k_mutex_unlock(&app_outbox_lock);
+		return -ENODEV;
+	}
+	size_t cap = MIN(sizeof(app_outbox_item), telemetry_outbox_max_len(&app_outbox));
+	int len = telemetry_prebuilt_pack(app_outbox_item + 1, cap - 1, encoding, build, arg);
+	if (len < 0) {
+		err = -EMSGSIZE;
+	} else {
+		app_outbox_item[0] = APP_OUTBOX_KIND_PACKED | (uint8_t)encoding;
+		err = app_outbox_push_locked(1 + (size_t)len);
+	}
+	k_mutex_unlock(&app_outbox_lock);
+	return err;
+}
+
+int app_outbox_store_frame(const void *frame, size_t len)
+{
+	int err;
+
+	if (!frame || len == 0) {
+		return -EINVAL;
+	}
+	k_mutex_lock(&app_outbox_lock, K_FOREVER);
+	if (!app_outbox_mounted) {
+		err = -ENODEV;
+	} else if (1 + len > MIN(sizeof(app_outbox_item), telemetry_outbox_max_len(&app_outbox))) {
+		err = -EMSGSIZE;
+	} else {
+		app_outbox_item[0] = APP_OUTBOX_KIND_FRAME;
+		memcpy(app_outbox_item + 1, frame, len);
+		err = app_outbox_push_locked(1 + len);
+	}
+	k_mutex_unlock(&app_outbox_lock);
+	return err;
+}
+
+/*
+ * [TELEMETRY] Stored records go out like live ones: a record too big for the
+ * link as its binary form, whole or in fragments; a frame in fragments.
+ * Backlog is periodic traffic to the airtime budget: -EBUSY when deferred.
+ */
+static int app_outbox_send_locked(size_t len)
+{
+	uint8_t kind = app_outbox_item[0];
+
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_AIRTIME)
+	if (app_airtime_admit(TELEMETRY_QUEUE_PERIODIC, len - 1) == TELEMETRY_AIRTIME_DEFER) {
+		return -EBUSY;
+	}
+#endif
+	struct telemetry_prebuilt rec = {
+		.data = app_outbox_item + 1,
+		.len = len - 1,
+		.encoding = (enum telemetry_encoding)(kind & ~APP_OUTBOX_KIND_PACKED),
+	};
+
+	if (kind == APP_OUTBOX_KIND_FRAME) {
+		return app_telemetry_send_frame(rec.data, rec.len);
+	}
+	if ((kind & APP_OUTBOX_KIND_PACKED) &&
+	    telemetry_prebuilt_unpack(app_outbox_item + 1, len - 1, rec.encoding, &rec) < 0) {
+		LOG_WRN("Outbox record (%u bytes) malformed; dropped", (unsigned int)len);
+		return 0;
+	}
+	return app_telemetry_submit_prebuilt(&rec, false);
+}
+
+static void app_outbox_drain_work_handler(struct k_work *work)
+{
+	/* [TELEMETRY] At most one burst per interval, so live traffic keeps the link. */
+	ARG_UNUSED(work);
+	int sent = 0;
+
+	k_mutex_lock(&app_outbox_lock, K_FOREVER);
+	while (app_outbox_ready && sent < APP_OUTBOX_DRAIN_BURST) {
+		int len = telemetry_outbox_peek(&app_outbox, APP_OUTBOX_ORDER, app_outbox_item,
+						sizeof(app_outbox_item));
+		if (len <= 0) {
+			if (len < 0) {
+				LOG_ERR("Outbox read failed");
+			}
+			break;
+		}
+		int err = app_outbox_send_locked((size_t)len);
+		if (err == -EMSGSIZE) {
+			/*
+			 * No route fits this link, not even fragments. Keep the
+			 * record: a link with a larger MTU takes it later.
+			 */
+			app_outbox_held++;
+			if ((app_outbox_held & (app_outbox_held - 1)) == 0) {
+				LOG_WRN("Outbox record (%d bytes) does not fit the link; "
+					"kept, drain held %u time(s)",
+					len, app_outbox_held);
+			}
+			break;
+		} else if (err == -EBUSY) {
+			/* [TELEMETRY] Airtime budget tight: try again next interval. */
+			LOG_DBG("Outbox drain deferred: airtime budget tight");
+			break;
+		} else if (err) {
+			LOG_WRN("Outbox drain paused: err %d", err);
+			break;
+		}
+		(void)telemetry_outbox_pop(&app_outbox);
+		sent++;
+	}
+	uint32_t pending = app_outbox.pending;
+	bool ready = app_outbox_ready;
+	k_mutex_unlock(&app_outbox_lock);
+
+	if (sent) {
+		LOG_INF("Outbox drain: %d sent, %u pending", sent, pending);
+	}
+	if (ready && pending) {
+		(void)k_work_schedule(&app_outbox_drain_work, K_MSEC(APP_OUTBOX_DRAIN_MS));
+	}
+}
+
+void app_outbox_set_ready(bool ready)
+{
+	if (!app_outbox_mounted) {
+		return;
+	}
+	k_mutex_lock(&app_outbox_lock, K_FOREVER);
+	app_outbox_ready = ready;
+	k_mutex_unlock(&app_outbox_lock);
+
+	if (ready) {
+		/* One interval of grace: the announce and live records go first. */
+		(void)k_work_schedule(&app_outbox_drain_work, K_MSEC(APP_OUTBOX_DRAIN_MS));
+	} else {
+		(void)k_work_cancel_delayable(&app_outbox_drain_work);
+	}
+}
+
+int app_outbox_init(void)
+{
+	int err = flash_area_open(FIXED_PARTITION_ID(telemetry_outbox), &app_outbox_fa);
+
+	if (err) {
+		LOG_ERR("Outbox partition open: err %d", err);
+		return err;
+	}
+	if (app_outbox_fa->fa_size % APP_OUTBOX_SECTOR_SIZE ||
+	    flash_area_align(app_outbox_fa) > TELEMETRY_OUTBOX_ALIGN_MAX ||
+	    flash_area_erased_val(app_outbox_fa) != 0xFF) {
+		LOG_ERR("Outbox partition geometry not supported");
+		return -ENOTSUP;
+	}
+
+	app_outbox_flash = (struct telemetry_outbox_flash){
+		.read = app_outbox_read,
+		.write = app_outbox_write,
+		.erase = app_outbox_erase,
+		.ctx = (void *)app_outbox_fa,
+		.sector_size = APP_OUTBOX_SECTOR_SIZE,
+		.sector_count = app_outbox_fa->fa_size / APP_OUTBOX_SECTOR_SIZE,
+		.write_align = (uint8_t)flash_area_align(app_outbox_fa),
+	};
+	k_work_init_delayable(&app_outbox_drain_work, app_outbox_drain_work_handler);
+
+	k_mutex_lock(&app_outbox_lock, K_FOREVER);
+	app_outbox_mounted = telemetry_outbox_mount(&app_outbox, &app_outbox_flash) == 0;
+	k_mutex_unlock(&app_outbox_lock);
+	if (!app_outbox_mounted) {
+		LOG_ERR("Outbox mount failed");
+		return -EIO;
+	}
+	LOG_INF("Outbox: %u record(s) pending, %u sector(s)", app_outbox.pending,
+		app_outbox_flash.sector_count);
+	return 0;
+}
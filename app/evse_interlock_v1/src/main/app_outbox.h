@@ -0,0 +1,26 @@
+/*
+ * [TELEMETRY] Store-and-forward outbox for telemetry built while Sidewalk is
+ * down (boot, link switches, LoRa outages). Records go to the telemetry_outbox
+ * flash partition and drain at a bounded rate once the link is READY.
+ */
+#ifndef APP_OUTBOX_H
+#define APP_OUTBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main/app_telemetry.h"
+
+/* [TELEMETRY] Mount the partition; records left from before a reboot are kept. */
+int app_outbox_init(void);
+
+/* [TELEMETRY] Build one record in the current encoding and store it. */
+int app_outbox_store(app_telemetry_build_t build, const void *arg);
+
+/* [TELEMETRY] Store a prebuilt frame (e.g. a time-series block); it drains alone. */
+int app_outbox_store_frame(const void *frame, size_t len);
+
+/* [TELEMETRY] Start draining on READY, stop when the link goes away. */
+void app_outbox_set_ready(bool ready);
+
+#endif /* APP_OUTBOX_H */
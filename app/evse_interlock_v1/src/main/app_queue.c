@@ -0,0 +1,204 @@
+/*
+ * [TELEMETRY] Priority telemetry queue glue: slot storage, locking and the drain
+ * worker. All producers and the drain run on the system work queue; the lock
+ * also covers callers from other threads.
+ */
+#include "main/app_queue.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(app);
+
+/*
+ * [TELEMETRY] Slot item: kind byte (encoding or frame), flags byte, then the
+ * record packed with its binary form (telemetry_prebuilt.h) or the bare frame.
+ */
+#define APP_QUEUE_KIND_FRAME 0xFF
+#define APP_QUEUE_FLAG_URGENT BIT(0)
+#define APP_QUEUE_HDR 2
+#define APP_QUEUE_ITEM                                                                     \
+	(APP_QUEUE_HDR + TELEMETRY_PREBUILT_MAX(CONFIG_SID_END_DEVICE_TELEMETRY_MAX_PAYLOAD))
+#define APP_QUEUE_SLOTS(depth) ((depth) * TELEMETRY_QUEUE_SLOT_SIZE(APP_QUEUE_ITEM))
+#define APP_QUEUE_POLICY(drop_oldest)                                                      \
+	((drop_oldest) ? TELEMETRY_QUEUE_DROP_OLDEST : TELEMETRY_QUEUE_DROP_NEWEST)
+
+#define APP_QUEUE_SAFETY_DEPTH CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_SAFETY_DEPTH
+#define APP_QUEUE_SESSION_DEPTH CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_SESSION_DEPTH
+#define APP_QUEUE_PERIODIC_DEPTH CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_PERIODIC_DEPTH
+#define APP_QUEUE_RETRY_MS CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_RETRY_MS
+/* [TELEMETRY] A record the uplink refuses this many times in a row is given up. */
+#define APP_QUEUE_RETRY_MAX 16
+
+#define APP_QUEUE_SAFETY_POLICY                                                            \
+	APP_QUEUE_POLICY(IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_SAFETY_DROP_OLDEST))
+#define APP_QUEUE_SESSION_POLICY                                                           \
+	APP_QUEUE_POLICY(IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_SESSION_DROP_OLDEST))
+#define APP_QUEUE_PERIODIC_POLICY                                                          \
+	APP_QUEUE_POLICY(IS_ENABLED(CONFIG_SID_END_DEVICE_TELEMETRY_QUEUE_PERIODIC_DROP_OLDEST))
+
+static K_MUTEX_DEFINE(app_queue_lock);
+static struct k_work_delayable app_queue_drain_work;
+static struct telemetry_queue app_queue;
+static app_queue_sink_t app_queue_sink;
+static unsigned int app_queue_retries;
+static uint8_t app_queue_safety_slots[APP_QUEUE_SLOTS(APP_QUEUE_SAFETY_DEPTH)];
+static uint8_t app_queue_session_slots[APP_QUEUE_SLOTS(APP_QUEUE_SESSION_DEPTH)];
+static uint8_t app_queue_periodic_slots[APP_QUEUE_SLOTS(APP_QUEUE_PERIODIC_DEPTH)];
+/* [TELEMETRY] Build staging for one item; used under app_queue_lock. */
+static uint8_t app_queue_item[APP_QUEUE_ITEM];
+
+const char *app_queue_class_name(enum telemetry_queue_class cls)
+{
+	switch (cls) {
+	case TELEMETRY_QUEUE_SAFETY:
+		return "safety";
+	case TELEMETRY_QUEUE_SESSION:
+		return "session";
+	case TELEMETRY_QUEUE_PERIODIC:
+		return "periodic";
+	default:
+		return "unknown";
+	}
+}
+
+bool app_queue_retryable(int err)
+{
+	/* No message buffer, the Sidewalk thread queue is full, or held back. */
+	return err == -ENOMEM || err == -ENOMSG || err == -EAGAIN || err == -EBUSY;
+}
+
+static int app_queue_push_locked(enum telemetry_queue_class cls, size_t len)
+{
+	if (telemetry_queue_push(&app_queue, cls, app_queue_item, len) < 0) {
+		return -ENOBUFS;
+	}
+	/* Now, even if a held-back lower class record has the drain waiting. */
+	(void)k_work_reschedule(&app_queue_drain_work, K_NO_WAIT);
+	return 0;
+}
+
+int app_queue_submit(enum telemetry_queue_class cls, app_telemetry_build_t build,
+		     const void *arg, bool urgent)
+{
+	enum telemetry_encoding encoding = app_telemetry_get_encoding();
+	int err;
+
+	if (!build) {
+		return -EINVAL;
+	}
+	k_mutex_lock(&app_queue_lock, K_FOREVER);
+	int len = telemetry_prebuilt_pack(app_queue_item + APP_QUEUE_HDR,
+					  sizeof(app_queue_item) - APP_QUEUE_HDR, encoding, build,
+					  arg);
+	if (len <= 0) {
+		err = -EMSGSIZE;
+	} else {
+		app_queue_item[0] = (uint8_t)encoding;
+		app_queue_item[1] = urgent ? APP_QUEUE_FLAG_URGENT : 0;
+		err = app_queue_push_locked(cls, APP_QUEUE_HDR + (size_t)len);
+	}
+	k_mutex_unlock(&app_queue_lock);
+	return err;
+}
+
+int app_queue_submit_frame(enum telemetry_queue_class cls, const void *frame, size_t len)
+{
+	int err;
+
+	if (!frame || len == 0) {
+		return -EINVAL;
+	}
+	if (len > sizeof(app_queue_item) - APP_QUEUE_HDR) {
+		return -EMSGSIZE;
+	}
+	k_mutex_lock(&app_queue_lock, K_FOREVER);
+	app_queue_item[0] = APP_QUEUE_KIND_FRAME;
+	app_queue_item[1] = 0;
+	memcpy(app_queue_item + APP_QUEUE_HDR, frame, len);
+	err = app_queue_push_locked(cls, APP_QUEUE_HDR + len);
+	k_mutex_unlock(&app_queue_lock);
+	return err;
+}
+
+static void app_queue_drain_work_handler(struct k_work *work)
+{
+	/* [TELEMETRY] Highest class first; a full uplink leaves the record queued. */
+	ARG_UNUSED(work);
+	const void *data;
+	enum telemetry_queue_class cls;
+	size_t len;
+
+	k_mutex_lock(&app_queue_lock, K_FOREVER);
+	while ((len = telemetry_queue_peek(&app_queue, &cls, &data)) > 0) {
+		const uint8_t *item = data;
+		struct app_queue_record rec = {
+			.rec = {
+				.data = item + APP_QUEUE_HDR,
+				.len = len - APP_QUEUE_HDR,
+				.encoding = (enum telemetry_encoding)item[0],
+			},
+			.cls = cls,
+			.urgent = (item[1] & APP_QUEUE_FLAG_URGENT) != 0,
+			.frame = item[0] == APP_QUEUE_KIND_FRAME,
+		};
+		int err = -EINVAL;
+
+		if (rec.frame || telemetry_prebuilt_unpack(rec.rec.data, rec.rec.len,
+							   rec.rec.encoding, &rec.rec) == 0) {
+			err = app_queue_sink(&rec);
+		} else {
+			LOG_ERR("Telemetry queue: malformed %s record", app_queue_class_name(cls));
+		}
+		if (err == -EBUSY) {
+			/* Held back by the sink (airtime budget); not a refusal. */
+			(void)k_work_schedule(&app_queue_drain_work, K_MSEC(APP_QUEUE_RETRY_MS));
+			break;
+		}
+		if (app_queue_retryable(err) && ++app_queue_retries < APP_QUEUE_RETRY_MAX) {
+			LOG_DBG("Telemetry queue: uplink busy (err %d), %u queued", err,
+				(unsigned int)telemetry_queue_depth(&app_queue));
+			(void)k_work_schedule(&app_queue_drain_work, K_MSEC(APP_QUEUE_RETRY_MS));
+			break;
+		}
+		if (app_queue_retryable(err)) {
+			LOG_WRN("Telemetry queue: %s record refused %u times; dropped",
+				app_queue_class_name(cls), app_queue_retries);
+		}
+		app_queue_retries = 0;
+		(void)telemetry_queue_pop(&app_queue, cls);
+	}
+	k_mutex_unlock(&app_queue_lock);
+}
+
+void app_queue_stats(enum telemetry_queue_class cls, struct telemetry_queue_stats *out)
+{
+	if (!out) {
+		return;
+	}
+	k_mutex_lock(&app_queue_lock, K_FOREVER);
+	const struct telemetry_queue_stats *stats = telemetry_queue_stats(&app_queue, cls);
+	if (stats) {
+		*out = *stats;
+	}
+	k_mutex_unlock(&app_queue_lock);
+}
+
+void app_queue_init(app_queue_sink_t sink, telemetry_queue_overflow_t overflow,
+		    void *overflow_ctx)
+{
+	app_queue_sink = sink;
+	k_work_init_delayable(&app_queue_drain_work, app_queue_drain_work_handler);
+	(void)telemetry_queue_init(&app_queue, APP_QUEUE_ITEM, overflow, overflow_ctx);
+	(void)telemetry_queue_configure(&app_queue, TELEMETRY_QUEUE_SAFETY, app_queue_safety_slots,
+					APP_QUEUE_SAFETY_DEPTH, APP_QUEUE_SAFETY_POLICY);
+	(void)telemetry_queue_configure(&app_queue, TELEMETRY_QUEUE_SESSION,
+					app_queue_session_slots, APP_QUEUE_SESSION_DEPTH,
+					APP_QUEUE_SESSION_POLICY);
+	(void)telemetry_queue_configure(&app_queue, TELEMETRY_QUEUE_PERIODIC,
+					app_queue_periodic_slots, APP_QUEUE_PERIODIC_DEPTH,
+					APP_QUEUE_PERIODIC_POLICY);
+}
@@ -0,0 +1,49 @@
+/*
+ * [TELEMETRY] Priority queue between sensing and the uplink (telemetry_queue.h).
+ * Handlers build their record once into a class slot; a drain worker hands the
+ * records to the sink in priority order and keeps a record queued while the
+ * uplink has no room for it, instead of losing it.
+ */
+#ifndef APP_QUEUE_H
+#define APP_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "main/app_telemetry.h"
+#include "telemetry/telemetry_queue.h"
+
+struct app_queue_record {
+	struct telemetry_prebuilt rec;
+	enum telemetry_queue_class cls;
+	bool urgent;
+	/* A standalone prebuilt frame (time-series block), not a batchable record. */
+	bool frame;
+};
+
+/*
+ * [TELEMETRY] Deliver one record. -ENOMEM, -ENOMSG and -EAGAIN keep it queued
+ * for a retry; -EBUSY holds it back for as long as the sink says so (airtime
+ * budget) without counting as a refusal; any other result consumes it.
+ */
+typedef int (*app_queue_sink_t)(const struct app_queue_record *item);
+
+bool app_queue_retryable(int err);
+
+void app_queue_init(app_queue_sink_t sink, telemetry_queue_overflow_t overflow,
+		    void *overflow_ctx);
+
+/*
+ * [TELEMETRY] Build one record in the current encoding (plus its binary form
+ * for JSON, see telemetry_prebuilt.h) and queue it.
+ */
+int app_queue_submit(enum telemetry_queue_class cls, app_telemetry_build_t build,
+		     const void *arg, bool urgent);
+
+int app_queue_submit_frame(enum telemetry_queue_class cls, const void *frame, size_t len);
+
+void app_queue_stats(enum telemetry_queue_class cls, struct telemetry_queue_stats *out);
+
+const char *app_queue_class_name(enum telemetry_queue_class cls);
+
+#endif /* APP_QUEUE_H */
@@ -0,0 +1,163 @@
+/*
+ * [TELEMETRY] Resend glue: sequence numbers persisted through Zephyr settings,
+ * and the retention window behind app_retain_lock.
+ * [BOILERPLATE] Lock order is app_retain_lock, then the queue lock (resends are
+ * queued while the window is walked); nothing takes them the other way round.
+ */
+#include "main/app_retain.h"
+
+#include "main/app_queue.h"
+#include "telemetry/telemetry_retain.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#if defined(CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_RETAIN_SIZE CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN_SIZE
+#define APP_RETAIN_RESEND_MAX CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN_RESEND_MAX
+#define APP_RETAIN_SEQ_BLOCK CONFIG_SID_END_DEVICE_TELEMETRY_SEQ_BLOCK
+
+static K_MUTEX_DEFINE(app_retain_lock);
+static struct telemetry_retain app_retain;
+static uint32_t app_retain_storage[APP_RETAIN_SIZE / sizeof(uint32_t)];
+/*
+ * [TELEMETRY] One record being built for the window, packed with its binary
+ * form (telemetry_prebuilt.h); used under app_retain_lock.
+ */
+static uint8_t app_retain_item[TELEMETRY_PREBUILT_MAX(CONFIG_SID_END_DEVICE_TELEMETRY_MAX_PAYLOAD)];
+
+static struct k_spinlock app_seq_lock;
+static struct telemetry_seq app_seq;
+static struct k_work app_seq_persist_work;
+static uint32_t app_seq_stored;
+
+#if defined(CONFIG_SETTINGS)
+static int app_seq_settings_set(const char *key, size_t len, settings_read_cb read_cb,
+				void *cb_arg)
+{
+	if (strcmp(key, "limit") != 0 || len != sizeof(app_seq_stored)) {
+		return -ENOENT;
+	}
+	return read_cb(cb_arg, &app_seq_stored, sizeof(app_seq_stored)) < 0 ? -EIO : 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(app_seq, "app/seq", NULL, app_seq_settings_set, NULL, NULL);
+#endif
+
+static void app_seq_persist(uint32_t limit)
+{
+#if defined(CONFIG_SETTINGS)
+	int err = settings_save_one("app/seq/limit", &limit, sizeof(limit));
+
+	if (err) {
+		LOG_WRN("Sequence limit %u not saved: err %d", limit, err);
+	}
+#else
+	ARG_UNUSED(limit);
+#endif
+}
+
+/* [TELEMETRY] Flash writes leave the caller's context; the latest limit wins. */
+static void app_seq_persist_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	k_spinlock_key_t key = k_spin_lock(&app_seq_lock);
+	uint32_t limit = app_seq.limit;
+
+	k_spin_unlock(&app_seq_lock, key);
+	app_seq_persist(limit);
+}
+
+void app_retain_init(void)
+{
+#if defined(CONFIG_SETTINGS)
+	int err = settings_subsys_init();
+
+	if (!err) {
+		err = settings_load_subtree("app/seq");
+	}
+	if (err) {
+		LOG_WRN("Sequence settings unavailable (err %d); numbering restarts", err);
+	}
+#endif
+	uint32_t limit = telemetry_seq_init(&app_seq, app_seq_stored, APP_RETAIN_SEQ_BLOCK);
+
+	app_seq_persist(limit);
+	k_work_init(&app_seq_persist_work, app_seq_persist_work_handler);
+	(void)telemetry_retain_init(&app_retain, app_retain_storage, sizeof(app_retain_storage));
+	LOG_INF("Telemetry sequence starts at %u", app_seq.next);
+}
+
+uint32_t app_retain_next_seq(void)
+{
+	uint32_t persist;
+	k_spinlock_key_t key = k_spin_lock(&app_seq_lock);
+	uint32_t seq = telemetry_seq_take(&app_seq, &persist);
+
+	k_spin_unlock(&app_seq_lock, key);
+	if (persist) {
+		(void)k_work_submit(&app_seq_persist_work);
+	}
+	return seq;
+}
+
+void app_retain_store(uint32_t seq, app_telemetry_build_t build, const void *arg)
+{
+	enum telemetry_encoding encoding = app_telemetry_get_encoding();
+
+	k_mutex_lock(&app_retain_lock, K_FOREVER);
+	int len = telemetry_prebuilt_pack(app_retain_item, sizeof(app_retain_item), encoding,
+					  build, arg);
+
+	if (len > 0) {
+		(void)telemetry_retain_put(&app_retain, seq, (uint8_t)encoding, app_retain_item,
+					   (size_t)len);
+	}
+	k_mutex_unlock(&app_retain_lock);
+}
+
+int app_retain_resend(uint32_t from, uint32_t to)
+{
+	struct telemetry_retain_iter it;
+	struct telemetry_retain_entry e;
+	uint32_t oldest = 0;
+	int queued = 0;
+	int err = 0;
+
+	k_mutex_lock(&app_retain_lock, K_FOREVER);
+	(void)telemetry_retain_oldest(&app_retain, &oldest);
+	telemetry_retain_iter_init(&app_retain, &it);
+	while (queued < APP_RETAIN_RESEND_MAX &&
+	       telemetry_retain_next(&app_retain, &it, from, to, &e)) {
+		struct telemetry_prebuilt rec;
+
+		if (telemetry_prebuilt_unpack(e.data, e.len, (enum telemetry_encoding)e.tag,
+					      &rec) < 0) {
+			continue;
+		}
+		/*
+		 * [TELEMETRY] A record that does not build in the current encoding
+		 * (binary only, JSON in use) cannot share a frame; send it bare.
+		 */
+		err = app_queue_submit(TELEMETRY_QUEUE_PERIODIC, telemetry_prebuilt_build, &rec,
+				       false);
+		if (err == -EMSGSIZE) {
+			err = app_queue_submit_frame(TELEMETRY_QUEUE_PERIODIC, rec.data, rec.len);
+		}
+		if (err) {
+			break;
+		}
+		queued++;
+	}
+	k_mutex_unlock(&app_retain_lock);
+
+	LOG_INF("Resend %u..%u: %d record(s) queued, oldest retained %u%s", from, to, queued,
+		oldest, err ? " (queue full)" : "");
+	return queued;
+}
@@ -0,0 +1,32 @@
+/*
+ * [TELEMETRY] Selective resend: every record is numbered (low 32 bits of its
+ * event_id) and kept in a RAM retention window (telemetry_retain.h), so the
+ * cloud can ask for a range it missed with
+ *   {"cmd":"resend","from":<seq>,"to":<seq>}
+ * Resent records are byte-identical to the originals, event_id included.
+ */
+#ifndef APP_RETAIN_H
+#define APP_RETAIN_H
+
+#include <stdint.h>
+
+#include "main/app_telemetry.h"
+#include "telemetry/telemetry_queue.h"
+
+/* [TELEMETRY] Restores the sequence from settings; call before the first record. */
+void app_retain_init(void);
+
+/* [TELEMETRY] Next per-device sequence number; any thread. */
+uint32_t app_retain_next_seq(void);
+
+/* [TELEMETRY] Keep a copy of one record (built in the current encoding) under seq. */
+void app_retain_store(uint32_t seq, app_telemetry_build_t build, const void *arg);
+
+/*
+ * [TELEMETRY] Requeue the retained records with from <= seq <= to, at most
+ * CONFIG_SID_END_DEVICE_TELEMETRY_RETAIN_RESEND_MAX of them, in the periodic
+ * class. Returns the number queued.
+ */
+int app_retain_resend(uint32_t from, uint32_t to);
+
+#endif /* APP_RETAIN_H */
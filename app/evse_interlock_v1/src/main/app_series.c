@@ -0,0 +1,107 @@
+/*
+ * [TELEMETRY] Time-series block accumulation for the current sampling loops.
+ * Blocks are plain RAM (one per channel); a finished block is copied into a
+ * Sidewalk message by the ship handler, so a slow link never holds a sample.
+ */
+#include "main/app_series.h"
+
+#include "main/app_telemetry.h"
+#include "sidewalk/time_sync.h"
+#include "telemetry/telemetry_fixed.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_SERIES_PERIOD_MS ((int64_t)CONFIG_SID_END_DEVICE_TELEMETRY_SERIES_PERIOD_S * 1000)
+#define APP_SERIES_MAX_BYTES CONFIG_SID_END_DEVICE_TELEMETRY_SERIES_MAX_BYTES
+#define APP_SERIES_RESOLUTION_MA CONFIG_SID_END_DEVICE_TELEMETRY_SERIES_RESOLUTION_MA
+
+struct app_series_channel {
+	struct telemetry_series series;
+	uint32_t sample_ms;
+	bool open;
+	int64_t opened_ms;
+	uint8_t buf[APP_SERIES_MAX_BYTES];
+};
+
+static K_MUTEX_DEFINE(app_series_lock);
+static app_series_ship_t app_series_ship;
+static struct app_series_channel app_series[] = {
+#if defined(CONFIG_SID_END_DEVICE_LINE_CURRENT_ENABLED)
+	[TELEMETRY_SERIES_LINE_CURRENT] = {
+		.sample_ms = CONFIG_SID_END_DEVICE_LINE_CURRENT_SAMPLE_INTERVAL_MS,
+	},
+#endif
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+	[TELEMETRY_SERIES_EVSE_CURRENT] = {
+		.sample_ms = CONFIG_SID_END_DEVICE_EVSE_SAMPLE_INTERVAL_MS,
+	},
+#endif
+};
+
+static void app_series_ship_locked(struct app_series_channel *ch)
+{
+	uint16_t count = ch->series.count;
+	int len = telemetry_series_close(&ch->series);
+
+	ch->open = false;
+	if (len <= 0 || !app_series_ship) {
+		return;
+	}
+	LOG_INF("Series block: channel %d, %u sample(s), %d bytes", (int)ch->series.channel,
+		count, len);
+	int err = app_series_ship(ch->buf, (size_t)len);
+	if (err) {
+		LOG_WRN("Series block dropped: err %d", err);
+	}
+}
+
+static void app_series_open_locked(struct app_series_channel *ch,
+				   enum telemetry_series_channel channel)
+{
+	/* [TELEMETRY] Size the block to the link as it is when the block starts. */
+	size_t cap = MIN(sizeof(ch->buf), app_telemetry_frame_cap());
+
+	ch->open = telemetry_series_open(&ch->series, channel, ch->sample_ms,
+					 APP_SERIES_RESOLUTION_MA, time_sync_time_anomaly(),
+					 ch->buf, cap) == 0;
+	ch->opened_ms = k_uptime_get();
+}
+
+void app_series_add(enum telemetry_series_channel channel, int64_t timestamp_ms,
+		    float current_a)
+{
+	if ((size_t)channel >= ARRAY_SIZE(app_series) || app_series[channel].sample_ms == 0) {
+		return;
+	}
+
+	struct app_series_channel *ch = &app_series[channel];
+	int64_t ma = telemetry_fixed_from_float(current_a, 1000);
+	int32_t value_ma = (int32_t)CLAMP(ma, INT32_MIN, INT32_MAX);
+
+	k_mutex_lock(&app_series_lock, K_FOREVER);
+	/* A block never spans a time anomaly change; age is measured in uptime. */
+	if (ch->open && (k_uptime_get() - ch->opened_ms >= APP_SERIES_PERIOD_MS ||
+			 ch->series.time_anomaly != time_sync_time_anomaly())) {
+		app_series_ship_locked(ch);
+	}
+	if (!ch->open) {
+		app_series_open_locked(ch, channel);
+	}
+	if (ch->open && telemetry_series_add(&ch->series, timestamp_ms, value_ma) < 0) {
+		/* Full, or the clock jumped: ship and start over from this sample. */
+		app_series_ship_locked(ch);
+		app_series_open_locked(ch, channel);
+		if (ch->open) {
+			(void)telemetry_series_add(&ch->series, timestamp_ms, value_ma);
+		}
+	}
+	k_mutex_unlock(&app_series_lock);
+}
+
+void app_series_init(app_series_ship_t ship)
+{
+	app_series_ship = ship;
+}
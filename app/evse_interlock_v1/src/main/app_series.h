@@ -0,0 +1,22 @@
+/*
+ * [TELEMETRY] Per-channel time-series blocks of current samples.
+ * Every poll feeds one sample; a block ships when it is full or
+ * CONFIG_SID_END_DEVICE_TELEMETRY_SERIES_PERIOD_S old.
+ */
+#ifndef APP_SERIES_H
+#define APP_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/telemetry_series.h"
+
+/* [TELEMETRY] Send one finished block as its own uplink frame. */
+typedef int (*app_series_ship_t)(const uint8_t *block, size_t len);
+
+void app_series_init(app_series_ship_t ship);
+
+void app_series_add(enum telemetry_series_channel channel, int64_t timestamp_ms,
+		    float current_a);
+
+#endif /* APP_SERIES_H */
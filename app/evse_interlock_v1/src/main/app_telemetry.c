@@ -0,0 +1,348 @@
+/*
+ * [TELEMETRY] Uplink aggregator: coalesces telemetry records into shared frames.
+ * [3P-GLUE] Frames live in reserved Sidewalk messages (see sidewalk_msg.h).
+ */
+#include "main/app_telemetry.h"
+
+#include "sidewalk/sidewalk_msg.h"
+#include "telemetry/telemetry_batch.h"
+#include "telemetry/telemetry_delivery.h"
+#include "telemetry/telemetry_fragment.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_DECLARE(app);
+
+#define APP_TELEMETRY_WINDOW_MS CONFIG_SID_END_DEVICE_TELEMETRY_BATCH_WINDOW_MS
+#define APP_TELEMETRY_FRAME_MAX CONFIG_SID_END_DEVICE_TELEMETRY_BATCH_MTU
+
+static K_MUTEX_DEFINE(app_telemetry_lock);
+static struct k_work_delayable app_telemetry_flush_work;
+static struct telemetry_batch app_telemetry_batch;
+static sidewalk_msg_t *app_telemetry_msg;
+static enum telemetry_encoding app_telemetry_encoding;
+static uint8_t app_telemetry_frag_id;
+/* [TELEMETRY] Whole-record staging for fragmentation; used under app_telemetry_lock. */
+static uint8_t app_telemetry_scratch[CONFIG_SID_END_DEVICE_TELEMETRY_MAX_PAYLOAD];
+
+/* [TELEMETRY] Frame size: Kconfig ceiling, lowered to the active link MTU once known. */
+size_t app_telemetry_frame_cap(void)
+{
+	size_t mtu = sidewalk_msg_link_mtu();
+
+	if (mtu == 0 || mtu > APP_TELEMETRY_FRAME_MAX) {
+		return APP_TELEMETRY_FRAME_MAX;
+	}
+	return mtu;
+}
+
+/* [TELEMETRY] Telemetry frames are tracked until Sidewalk confirms or fails them. */
+static int app_telemetry_commit(sidewalk_msg_t *msg, size_t len)
+{
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY)
+	sidewalk_msg_set_tag(msg, TELEMETRY_DELIVERY_NEW);
+#endif
+	return sidewalk_msg_commit_notify(msg, len);
+}
+
+static int app_telemetry_flush_locked(void)
+{
+	sidewalk_msg_t *msg = app_telemetry_msg;
+
+	if (!msg) {
+		return 0;
+	}
+	app_telemetry_msg = NULL;
+	(void)k_work_cancel_delayable(&app_telemetry_flush_work);
+
+	uint16_t count = app_telemetry_batch.count;
+	int len = telemetry_batch_close(&app_telemetry_batch);
+	if (len <= 0) {
+		sidewalk_msg_abort(msg);
+		return 0;
+	}
+
+	LOG_INF("Telemetry flush: %u record(s), %d bytes", count, len);
+	int err = app_telemetry_commit(msg, (size_t)len);
+	if (err) {
+		LOG_ERR("Sidewalk send: err %d", err);
+	}
+	return err;
+}
+
+static int app_telemetry_open_locked(void)
+{
+	app_telemetry_msg = sidewalk_msg_reserve(app_telemetry_frame_cap());
+	if (!app_telemetry_msg) {
+		return -ENOMEM;
+	}
+	telemetry_batch_open(&app_telemetry_batch, app_telemetry_encoding,
+			     sidewalk_msg_payload(app_telemetry_msg),
+			     sidewalk_msg_capacity(app_telemetry_msg));
+	return 0;
+}
+
+/* [TELEMETRY] Try to add one record to the open frame; -1 if it does not fit. */
+static int app_telemetry_append_locked(app_telemetry_build_t build, const void *arg)
+{
+	size_t avail;
+	void *slot = telemetry_batch_slot(&app_telemetry_batch, &avail);
+
+	if (!slot) {
+		return -1;
+	}
+	int len = build(slot, avail, app_telemetry_encoding, arg);
+	if (len < 0) {
+		return -1;
+	}
+	return telemetry_batch_commit(&app_telemetry_batch, (size_t)len);
+}
+
+/* [TELEMETRY] Build into a fresh frame of at most cap bytes and send it alone. */
+static int app_telemetry_send_alone(app_telemetry_build_t build, const void *arg,
+				    enum telemetry_encoding encoding, size_t cap)
+{
+	sidewalk_msg_t *msg = sidewalk_msg_reserve(cap);
+
+	if (!msg) {
+		return -ENOMEM;
+	}
+	int len = build(sidewalk_msg_payload(msg), sidewalk_msg_capacity(msg), encoding, arg);
+	if (len < 0) {
+		sidewalk_msg_abort(msg);
+		return -EMSGSIZE;
+	}
+	return app_telemetry_commit(msg, (size_t)len);
+}
+
+/* [TELEMETRY] One frame of len bytes copied from frame; len fits the frame cap. */
+static int app_telemetry_send_copy(const void *frame, size_t len)
+{
+	sidewalk_msg_t *msg = sidewalk_msg_reserve(len);
+
+	if (!msg) {
+		return -ENOMEM;
+	}
+	memcpy(sidewalk_msg_payload(msg), frame, len);
+	return app_telemetry_commit(msg, len);
+}
+
+/*
+ * [TELEMETRY] Every fragment is reserved and built before any is committed, so
+ * a failure up to there sends nothing and the caller may retry. Once one is
+ * on its way a retry would duplicate it: a later commit failure aborts the
+ * rest and returns -EIO, which the queue does not retry.
+ */
+static int app_telemetry_send_fragments(size_t rec_len, size_t mtu)
+{
+	sidewalk_msg_t *msgs[TELEMETRY_FRAG_MAX_COUNT];
+	size_t lens[TELEMETRY_FRAG_MAX_COUNT];
+	int count = telemetry_fragment_count(rec_len, mtu);
+	uint8_t msg_id = app_telemetry_frag_id;
+	int built = 0;
+	int err = 0;
+
+	if (count < 0) {
+		return -EMSGSIZE;
+	}
+	for (; built < count; built++) {
+		sidewalk_msg_t *msg = sidewalk_msg_reserve(mtu);
+		if (!msg) {
+			err = -ENOMEM;
+			break;
+		}
+		int len = telemetry_fragment_build(sidewalk_msg_payload(msg),
+						   sidewalk_msg_capacity(msg),
+						   app_telemetry_scratch, rec_len, mtu, msg_id,
+						   (unsigned int)built);
+		if (len < 0) {
+			sidewalk_msg_abort(msg);
+			err = -EMSGSIZE;
+			break;
+		}
+		msgs[built] = msg;
+		lens[built] = (size_t)len;
+	}
+	if (err) {
+		while (built > 0) {
+			sidewalk_msg_abort(msgs[--built]);
+		}
+		return err;
+	}
+
+	app_telemetry_frag_id++;
+	for (int i = 0; i < count; i++) {
+		/* [TELEMETRY] A failed commit frees its own message. */
+		err = app_telemetry_commit(msgs[i], lens[i]);
+		if (!err) {
+			continue;
+		}
+		for (int j = i + 1; j < count; j++) {
+			sidewalk_msg_abort(msgs[j]);
+		}
+		if (i == 0) {
+			return err;
+		}
+		LOG_WRN("Telemetry record id %u: %d of %d fragment(s) sent, err %d; not retried",
+			msg_id, i, count, err);
+		return -EIO;
+	}
+	LOG_INF("Telemetry record %u bytes sent as %d fragment(s), id %u",
+		(unsigned int)rec_len, count, msg_id);
+	return 0;
+}
+
+/*
+ * [TELEMETRY] A record (in encoding) that does not fit an empty frame at the
+ * link MTU (telemetry_prebuilt_route):
+ * 1. with the link MTU unknown, send it alone at full size (pre-MTU behavior);
+ * 2. JSON that does not fit goes out as the binary record instead;
+ * 3. otherwise split the binary record (JSON without one) into fragments.
+ * Prebuilt records carry their binary form, so this holds for queued and
+ * stored records too. Nothing is dropped silently: every failure returns an
+ * error to the caller. Called with app_telemetry_lock held.
+ */
+static int app_telemetry_send_oversize(app_telemetry_build_t build, const void *arg,
+				       enum telemetry_encoding encoding)
+{
+	size_t mtu = sidewalk_msg_link_mtu();
+	size_t cap = encoding == TELEMETRY_ENCODING_BINARY ?
+			     TELEMETRY_BIN_MAX_LEN :
+			     CONFIG_SID_END_DEVICE_TELEMETRY_MAX_PAYLOAD;
+	size_t len = 0;
+
+	switch (telemetry_prebuilt_route(build, arg, encoding, mtu, app_telemetry_scratch,
+					 sizeof(app_telemetry_scratch), &len)) {
+	case TELEMETRY_PREBUILT_ALONE:
+		return app_telemetry_send_alone(build, arg, encoding, cap);
+	case TELEMETRY_PREBUILT_BINARY:
+		LOG_INF("Telemetry record sent as binary to fit link MTU %u", (unsigned int)mtu);
+		return app_telemetry_send_copy(app_telemetry_scratch, len);
+	case TELEMETRY_PREBUILT_FRAGMENTS:
+		return app_telemetry_send_fragments(len, mtu);
+	default:
+		return -EMSGSIZE;
+	}
+}
+
+int app_telemetry_submit(app_telemetry_build_t build, const void *arg, bool urgent)
+{
+	int err = 0;
+
+	if (!build) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&app_telemetry_lock, K_FOREVER);
+	if (!app_telemetry_msg) {
+		err = app_telemetry_open_locked();
+	}
+	if (!err && app_telemetry_append_locked(build, arg) < 0) {
+		/* Frame is full: ship what we have and retry on an empty frame. */
+		bool had_records = app_telemetry_batch.count > 0;
+		(void)app_telemetry_flush_locked();
+		err = had_records ? app_telemetry_open_locked() : -ENOSPC;
+		if (!err && app_telemetry_append_locked(build, arg) < 0) {
+			err = -ENOSPC;
+		}
+		if (err == -ENOSPC) {
+			(void)app_telemetry_flush_locked();
+			err = app_telemetry_send_oversize(build, arg, app_telemetry_encoding);
+			k_mutex_unlock(&app_telemetry_lock);
+			return err;
+		}
+	}
+	if (err) {
+		k_mutex_unlock(&app_telemetry_lock);
+		return err;
+	}
+
+	if (urgent || APP_TELEMETRY_WINDOW_MS == 0) {
+		err = app_telemetry_flush_locked();
+	} else if (app_telemetry_batch.count == 1) {
+		/* [TELEMETRY] Window starts at the first record of a frame. */
+		(void)k_work_schedule(&app_telemetry_flush_work, K_MSEC(APP_TELEMETRY_WINDOW_MS));
+	}
+	k_mutex_unlock(&app_telemetry_lock);
+	return err;
+}
+
+int app_telemetry_send_frame(const void *frame, size_t len)
+{
+	if (!frame || len == 0) {
+		return -EINVAL;
+	}
+	size_t cap = app_telemetry_frame_cap();
+	int err;
+
+	if (len <= cap) {
+		return app_telemetry_send_copy(frame, len);
+	}
+	/* [TELEMETRY] Over the link MTU: fragments, as for an oversize record. */
+	if (sidewalk_msg_link_mtu() == 0 || len > sizeof(app_telemetry_scratch)) {
+		return -EMSGSIZE;
+	}
+	k_mutex_lock(&app_telemetry_lock, K_FOREVER);
+	memcpy(app_telemetry_scratch, frame, len);
+	err = app_telemetry_send_fragments(len, cap);
+	k_mutex_unlock(&app_telemetry_lock);
+	return err;
+}
+
+int app_telemetry_submit_prebuilt(const struct telemetry_prebuilt *rec, bool urgent)
+{
+	int err;
+
+	if (!rec || !rec->data || rec->len == 0) {
+		return -EINVAL;
+	}
+	if (rec->encoding == app_telemetry_encoding ||
+	    (app_telemetry_encoding == TELEMETRY_ENCODING_BINARY && rec->bin)) {
+		return app_telemetry_submit(telemetry_prebuilt_build, rec, urgent);
+	}
+	if (rec->len <= app_telemetry_frame_cap()) {
+		return app_telemetry_send_copy(rec->data, rec->len);
+	}
+	k_mutex_lock(&app_telemetry_lock, K_FOREVER);
+	err = app_telemetry_send_oversize(telemetry_prebuilt_build, rec, rec->encoding);
+	k_mutex_unlock(&app_telemetry_lock);
+	return err;
+}
+
+void app_telemetry_flush(void)
+{
+	k_mutex_lock(&app_telemetry_lock, K_FOREVER);
+	(void)app_telemetry_flush_locked();
+	k_mutex_unlock(&app_telemetry_lock);
+}
+
+static void app_telemetry_flush_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	app_telemetry_flush();
+}
+
+void app_telemetry_set_encoding(enum telemetry_encoding encoding)
+{
+	/* [TELEMETRY] A frame never mixes encodings; flush before switching. */
+	k_mutex_lock(&app_telemetry_lock, K_FOREVER);
+	if (encoding != app_telemetry_encoding) {
+		(void)app_telemetry_flush_locked();
+		app_telemetry_encoding = encoding;
+	}
+	k_mutex_unlock(&app_telemetry_lock);
+}
+
+enum telemetry_encoding app_telemetry_get_encoding(void)
+{
+	return app_telemetry_encoding;
+}
+
+void app_telemetry_init(enum telemetry_encoding encoding)
+{
+	app_telemetry_encoding = encoding;
+	k_work_init_delayable(&app_telemetry_flush_work, app_telemetry_flush_work_handler);
+}
@@ -0,0 +1,51 @@
+/*
+ * [TELEMETRY] Uplink aggregator: coalesces telemetry records into shared frames.
+ * Records are built in place inside a reserved Sidewalk message and flushed when
+ * the coalescing window expires, the frame is full, or an urgent record arrives.
+ */
+#ifndef APP_TELEMETRY_H
+#define APP_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_prebuilt.h"
+
+/*
+ * [TELEMETRY] Build one record into buf (at most cap bytes) using the given
+ * encoding; return its length or -1. May be called again after a flush when the
+ * record did not fit, so it must not have side effects.
+ */
+typedef telemetry_build_t app_telemetry_build_t;
+
+/*
+ * [TELEMETRY] Submit a record built earlier (queue, outbox, retention). One
+ * of another encoding cannot join a frame and goes out as a frame of its own,
+ * unless its binary form fits the binary frames in use. A record too big for
+ * the link goes out as binary, whole or in fragments, like a live one.
+ */
+int app_telemetry_submit_prebuilt(const struct telemetry_prebuilt *rec, bool urgent);
+
+void app_telemetry_init(enum telemetry_encoding encoding);
+
+int app_telemetry_submit(app_telemetry_build_t build, const void *arg, bool urgent);
+
+/*
+ * [TELEMETRY] Send a prebuilt frame (e.g. a time-series block) on its own,
+ * outside the coalescing window. A frame over the link MTU goes out in
+ * fragments; -EMSGSIZE if it exceeds the frame cap with the MTU unknown, or
+ * needs more than TELEMETRY_FRAG_MAX_COUNT fragments.
+ */
+int app_telemetry_send_frame(const void *frame, size_t len);
+
+void app_telemetry_flush(void);
+
+/* [TELEMETRY] Current frame size limit (Kconfig ceiling or link MTU). */
+size_t app_telemetry_frame_cap(void);
+
+void app_telemetry_set_encoding(enum telemetry_encoding encoding);
+
+enum telemetry_encoding app_telemetry_get_encoding(void);
+
+#endif /* APP_TELEMETRY_H */
@@ -7,7 +7,6 @@
 #include "sidewalk/sbdt/dfu_file_transfer.h"
 #include "sidewalk/sbdt/scratch_buffer.h"
 #include "sidewalk/sidewalk.h"
-#include <sid_hal_memory_ifc.h>
 #include <json_printer/sidTypes2Json.h>
 #include <json_printer/sidTypes2str.h>
 #include <sidewalk_dfu/nordic_dfu_img.h>
@@ -139,18 +138,17 @@ static void on_data_received(const struct sid_bulk_data_transfer_desc *const des
 				      JSON_OBJ(JSON_VAL_sid_bulk_data_transfer_desc("desc", desc))),
 			    JSON_NAME("data_size", JSON_INT(buffer->size))))));
 
-	sidewalk_transfer_t *transfer =
-		(sidewalk_transfer_t *)sid_hal_malloc(sizeof(sidewalk_transfer_t));
-	if (!transfer) {
-		LOG_ERR("Fail transfer alloc");
-		return;
-	}
-	transfer->file_id = desc->file_id;
-	transfer->file_offset = desc->file_offset;
-	transfer->data = buffer->data;
-	transfer->data_size = buffer->size;
+	const sidewalk_transfer_t transfer = {
+		.file_id = desc->file_id,
+		.file_offset = desc->file_offset,
+		.data = buffer->data,
+		.data_size = buffer->size,
+	};
 
-	int err = sidewalk_event_send(sidewalk_event_file_transfer, transfer, sid_hal_free);
+	/* [3P-GLUE] Flash writes queue as bulk work, behind radio processing. */
+	int err = sidewalk_event_send_inline(SIDEWALK_EVENT_PRIO_BULK,
+					     sidewalk_event_file_transfer, &transfer,
+					     sizeof(transfer));
 	if (err) {
 		LOG_ERR("Event transfer err %d", err);
 		LOG_INF("Cancelig file transfer");
@@ -160,12 +158,11 @@ static void on_data_received(const struct sid_bulk_data_transfer_desc *const des
 		}
 		sid_error_t ret =
 			sid_bulk_data_transfer_cancel((struct sid_handle *)context,
-						      transfer->file_id,
+						      transfer.file_id,
 						      SID_BULK_DATA_TRANSFER_REJECT_REASON_GENERIC);
 		if (ret != SID_ERROR_NONE) {
 			LOG_ERR("Fail to cancel sbdt %d (%s)", ret, SID_ERROR_T_STR(ret));
 		}
-		sid_hal_free(transfer);
 	}
 }
 
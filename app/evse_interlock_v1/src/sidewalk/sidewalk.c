@@ -10,44 +10,238 @@
 #include <sid_api.h>
 #include <sid_error.h>
 #include "sidewalk/sidewalk.h"
+#ifdef CONFIG_SIDEWALK_FILE_TRANSFER_DFU
+#include "sidewalk/sbdt/dfu_file_transfer.h"
+#endif
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
 
 LOG_MODULE_REGISTER(sidewalk_app, CONFIG_SIDEWALK_LOG_LEVEL);
 
 static struct k_thread sid_thread;
 K_THREAD_STACK_DEFINE(sid_thread_stack, CONFIG_SIDEWALK_THREAD_STACK_SIZE);
 
-K_MSGQ_DEFINE(sidewalk_thread_msgq, sizeof(sidewalk_ctx_event_t), CONFIG_SIDEWALK_THREAD_QUEUE_SIZE,
+#define SIDEWALK_BULK_QUEUE_SIZE CONFIG_SID_END_DEVICE_EVENT_QUEUE_BULK_SIZE
+#define SIDEWALK_CONTROL_BURST CONFIG_SID_END_DEVICE_EVENT_QUEUE_CONTROL_BURST
+
+/*
+ * [BOILERPLATE] Queue entry: the event, its enqueue time for latency stats and
+ * room for an inline context (inline_len > 0 means ctx points at the copy).
+ */
+struct sidewalk_queued_event {
+	sidewalk_ctx_event_t event;
+	uint32_t enqueued;
+	uint32_t inline_len;
+	uint32_t inline_ctx[DIV_ROUND_UP(SIDEWALK_EVENT_INLINE_MAX, sizeof(uint32_t))];
+};
+
+/* [3P-GLUE] One queue per dispatch level; the semaphore counts events in both. */
+K_MSGQ_DEFINE(sidewalk_thread_msgq, sizeof(struct sidewalk_queued_event),
+	      CONFIG_SIDEWALK_THREAD_QUEUE_SIZE, 4);
+K_MSGQ_DEFINE(sidewalk_bulk_msgq, sizeof(struct sidewalk_queued_event), SIDEWALK_BULK_QUEUE_SIZE,
 	      4);
+K_SEM_DEFINE(sidewalk_thread_pending, 0,
+	     CONFIG_SIDEWALK_THREAD_QUEUE_SIZE + SIDEWALK_BULK_QUEUE_SIZE);
+
+static struct k_msgq *const sidewalk_level_msgq[SIDEWALK_EVENT_PRIO_COUNT] = {
+	[SIDEWALK_EVENT_PRIO_CONTROL] = &sidewalk_thread_msgq,
+	[SIDEWALK_EVENT_PRIO_BULK] = &sidewalk_bulk_msgq,
+};
+static const uint32_t sidewalk_level_size[SIDEWALK_EVENT_PRIO_COUNT] = {
+	[SIDEWALK_EVENT_PRIO_CONTROL] = CONFIG_SIDEWALK_THREAD_QUEUE_SIZE,
+	[SIDEWALK_EVENT_PRIO_BULK] = SIDEWALK_BULK_QUEUE_SIZE,
+};
+
+/* [3P-GLUE] Known handlers; the NULL entry catches the rest and must stay last. */
+static const struct {
+	event_handler_t handler;
+	const char *name;
+} sidewalk_handlers[] = {
+	{ sidewalk_event_process, "process" },
+	{ sidewalk_event_autostart, "autostart" },
+	{ sidewalk_event_factory_reset, "factory_reset" },
+	{ sidewalk_event_new_status, "new_status" },
+	{ sidewalk_event_send_msg, "send_msg" },
+	{ sidewalk_event_connect, "connect" },
+	{ sidewalk_event_link_switch, "link_switch" },
+	{ sidewalk_event_exit, "exit" },
+	{ sidewalk_event_reboot, "reboot" },
+	{ sidewalk_event_platform_init, "platform_init" },
+#ifdef CONFIG_SIDEWALK_FILE_TRANSFER_DFU
+	{ sidewalk_event_file_transfer, "file_transfer" },
+#endif
+	{ NULL, "other" },
+};
+
+static struct k_spinlock sidewalk_stats_lock;
+static struct sidewalk_event_queue_stats sidewalk_level_stats[SIDEWALK_EVENT_PRIO_COUNT];
+static struct sidewalk_event_handler_stats sidewalk_handler_stats[ARRAY_SIZE(sidewalk_handlers)];
 
 K_SEM_DEFINE(sid_thread_started, 0, 1);
 
+/* [3P-GLUE] At most one sid_process() request queued; further signals merge into it. */
+static atomic_t sidewalk_process_pending;
+static atomic_t sidewalk_process_merged;
+
+/*
+ * [3P-GLUE] Control first, so sid_process() never waits behind uplinks or file
+ * transfer chunks; after SIDEWALK_CONTROL_BURST control events in a row, a
+ * waiting bulk event gets its turn so bulk work is never starved.
+ */
+static int sidewalk_next_event(struct sidewalk_queued_event *qe, enum sidewalk_event_prio *prio)
+{
+	static unsigned int control_run;
+	enum sidewalk_event_prio first = control_run >= SIDEWALK_CONTROL_BURST ?
+						 SIDEWALK_EVENT_PRIO_BULK :
+						 SIDEWALK_EVENT_PRIO_CONTROL;
+
+	for (int i = 0; i < SIDEWALK_EVENT_PRIO_COUNT; i++) {
+		*prio = (enum sidewalk_event_prio)((first + i) % SIDEWALK_EVENT_PRIO_COUNT);
+		if (k_msgq_get(sidewalk_level_msgq[*prio], qe, K_NO_WAIT) == 0) {
+			control_run = *prio == SIDEWALK_EVENT_PRIO_CONTROL ? control_run + 1 : 0;
+			return 0;
+		}
+	}
+	return -ENOMSG;
+}
+
+static int sidewalk_handler_index(event_handler_t handler)
+{
+	int i = 0;
+
+	while (sidewalk_handlers[i].handler && sidewalk_handlers[i].handler != handler) {
+		i++;
+	}
+	return i;
+}
+
+const char *sidewalk_event_name(event_handler_t handler)
+{
+	return sidewalk_handlers[sidewalk_handler_index(handler)].name;
+}
+
+static void sidewalk_stats_max(uint32_t *max, uint32_t value)
+{
+	if (value > *max) {
+		*max = value;
+	}
+}
+
+static void sidewalk_event_account(enum sidewalk_event_prio prio, int handler, uint32_t enqueued,
+				   uint32_t started, uint32_t finished)
+{
+	uint32_t latency_us = k_cyc_to_us_floor32(started - enqueued);
+	uint32_t exec_us = k_cyc_to_us_floor32(finished - started);
+	k_spinlock_key_t key = k_spin_lock(&sidewalk_stats_lock);
+	struct sidewalk_event_queue_stats *st = &sidewalk_level_stats[prio];
+	struct sidewalk_event_handler_stats *hs = &sidewalk_handler_stats[handler];
+
+	st->dispatched++;
+	st->latency_total_us += latency_us;
+	sidewalk_stats_max(&st->latency_max_us, latency_us);
+	hs->dispatched++;
+	hs->latency_total_us += latency_us;
+	sidewalk_stats_max(&hs->latency_max_us, latency_us);
+	hs->exec_total_us += exec_us;
+	sidewalk_stats_max(&hs->exec_max_us, exec_us);
+	k_spin_unlock(&sidewalk_stats_lock, key);
+}
+
+/* [3P-GLUE] Called from any context, ISRs included, right after k_msgq_put(). */
+static void sidewalk_enqueue_account(enum sidewalk_event_prio prio, int result)
+{
+	uint32_t used = k_msgq_num_used_get(sidewalk_level_msgq[prio]);
+	uint32_t failed = 0;
+	k_spinlock_key_t key = k_spin_lock(&sidewalk_stats_lock);
+	struct sidewalk_event_queue_stats *st = &sidewalk_level_stats[prio];
+
+	if (result) {
+		failed = ++st->enqueue_failed;
+	} else {
+		sidewalk_stats_max(&st->depth_max, used);
+	}
+	k_spin_unlock(&sidewalk_stats_lock, key);
+
+	if (failed && (failed & (failed - 1)) == 0) {
+		LOG_WRN("Sidewalk %s queue full: %u events dropped",
+			prio == SIDEWALK_EVENT_PRIO_CONTROL ? "control" : "bulk", failed);
+	}
+}
+
+void sidewalk_event_queue_stats(enum sidewalk_event_prio prio,
+				struct sidewalk_event_queue_stats *out)
+{
+	if (!out || prio >= SIDEWALK_EVENT_PRIO_COUNT) {
+		return;
+	}
+	k_spinlock_key_t key = k_spin_lock(&sidewalk_stats_lock);
+	*out = sidewalk_level_stats[prio];
+	k_spin_unlock(&sidewalk_stats_lock, key);
+	out->depth_size = sidewalk_level_size[prio];
+}
+
+int sidewalk_event_handler_count(void)
+{
+	return ARRAY_SIZE(sidewalk_handlers);
+}
+
+int sidewalk_event_handler_stats(int idx, struct sidewalk_event_handler_stats *out)
+{
+	if (!out || idx < 0 || idx >= sidewalk_event_handler_count()) {
+		return -EINVAL;
+	}
+	k_spinlock_key_t key = k_spin_lock(&sidewalk_stats_lock);
+	*out = sidewalk_handler_stats[idx];
+	k_spin_unlock(&sidewalk_stats_lock, key);
+	out->name = sidewalk_handlers[idx].name;
+	return 0;
+}
+
 static void sid_thread_entry(void *context, void *unused, void *unused2)
 {
 	ARG_UNUSED(unused);
 	ARG_UNUSED(unused2);
 
 	sidewalk_ctx_t *sid = (sidewalk_ctx_t *)context;
-	sidewalk_ctx_event_t event = {};
+	struct sidewalk_queued_event qe = {};
+	enum sidewalk_event_prio prio;
 
 	k_sem_give(&sid_thread_started);
 
 	while (1) {
-		int err = k_msgq_get(&sidewalk_thread_msgq, &event, K_FOREVER);
+		(void)k_sem_take(&sidewalk_thread_pending, K_FOREVER);
+		int err = sidewalk_next_event(&qe, &prio);
 		switch (err) {
 		case 0: {
 			/* [3P-GLUE] Dispatch events to Sidewalk SDK callbacks. */
-			LOG_DBG("event received %p (%s) sidewalk workq usage (%d/%d) ( after get )",
-				(void *)(event.handler), EVENT_TO_NAME(event.handler),
+			sidewalk_ctx_event_t *event = &qe.event;
+			int handler = sidewalk_handler_index(event->handler);
+
+			if (qe.inline_len) {
+				event->ctx = qe.inline_ctx;
+			}
+
+			if (event->handler == sidewalk_event_process) {
+				/* Before sid_process(): a signal from now on needs another pass. */
+				atomic_clear(&sidewalk_process_pending);
+			}
+			LOG_DBG("event received %p (%s) sidewalk workq usage (%d/%d, bulk %d/%d) ( after get )",
+				(void *)(event->handler), sidewalk_handlers[handler].name,
 				k_msgq_num_used_get(&sidewalk_thread_msgq),
-				CONFIG_SIDEWALK_THREAD_QUEUE_SIZE);
-			if (event.handler) {
-				event.handler(sid, event.ctx);
+				CONFIG_SIDEWALK_THREAD_QUEUE_SIZE,
+				k_msgq_num_used_get(&sidewalk_bulk_msgq), SIDEWALK_BULK_QUEUE_SIZE);
+			uint32_t started = k_cycle_get_32();
+			if (event->handler) {
+				event->handler(sid, event->ctx);
 			}
-			if (event.ctx_free) {
-				event.ctx_free(event.ctx);
+			sidewalk_event_account(prio, handler, qe.enqueued, started,
+					       k_cycle_get_32());
+			if (event->ctx_free) {
+				event->ctx_free(event->ctx);
 			}
 			break;
 		}
@@ -74,28 +268,89 @@ void sidewalk_start(sidewalk_ctx_t *context)
 	k_sem_take(&sid_thread_started, K_FOREVER);
 }
 
-int sidewalk_event_send(event_handler_t event, void *ctx, ctx_free free)
+static int sidewalk_event_enqueue(enum sidewalk_event_prio prio, struct sidewalk_queued_event *qe)
 {
 	/* [BOILERPLATE] Message-queue based async dispatch into Sidewalk thread. */
-	sidewalk_ctx_event_t ctx_event = {
-		.handler = event,
-		.ctx = ctx,
-		.ctx_free = free,
-	};
-
 	k_timeout_t timeout = K_NO_WAIT;
 	int result = -EFAULT;
 
+	if (prio >= SIDEWALK_EVENT_PRIO_COUNT) {
+		return -EINVAL;
+	}
 #if defined(CONFIG_SIDEWALK_THREAD_QUEUE_TIMEOUT_VALUE) &&                                         \
 	CONFIG_SIDEWALK_THREAD_QUEUE_TIMEOUT_VALUE > 0
 	if (!k_is_in_isr()) {
 		timeout = K_MSEC(CONFIG_SIDEWALK_THREAD_QUEUE_TIMEOUT_VALUE);
 	}
 #endif /* CONFIG_SIDEWALK_THREAD_QUEUE_TIMEOUT_VALUE > 0 */
-	result = k_msgq_put(&sidewalk_thread_msgq, (void *)&ctx_event, timeout);
-	LOG_DBG("sidewalk_event_send event = %p (%s), context = %p, k_msgq_put result %d sidewalk workq usage (%d/%d) (after put)",
-		(void *)event, EVENT_TO_NAME(event), ctx, result,
-		k_msgq_num_used_get(&sidewalk_thread_msgq), CONFIG_SIDEWALK_THREAD_QUEUE_SIZE);
+	qe->enqueued = k_cycle_get_32();
+	result = k_msgq_put(sidewalk_level_msgq[prio], (void *)qe, timeout);
+	if (result == 0) {
+		k_sem_give(&sidewalk_thread_pending);
+	}
+	sidewalk_enqueue_account(prio, result);
+	LOG_DBG("sidewalk_event_send event = %p (%s), context = %p, prio %d, k_msgq_put result %d sidewalk workq usage (%d/%d) (after put)",
+		(void *)qe->event.handler, sidewalk_event_name(qe->event.handler), qe->event.ctx,
+		(int)prio, result, k_msgq_num_used_get(sidewalk_level_msgq[prio]),
+		sidewalk_level_size[prio]);
 
 	return result;
 }
+
+int sidewalk_event_send_prio(enum sidewalk_event_prio prio, event_handler_t event, void *ctx,
+			     ctx_free free)
+{
+	struct sidewalk_queued_event qe = {
+		.event = {
+			.handler = event,
+			.ctx = ctx,
+			.ctx_free = free,
+		},
+	};
+
+	return sidewalk_event_enqueue(prio, &qe);
+}
+
+int sidewalk_event_send_inline(enum sidewalk_event_prio prio, event_handler_t event,
+			       const void *data, size_t len)
+{
+	struct sidewalk_queued_event qe = {
+		.event = {
+			.handler = event,
+		},
+		.inline_len = len,
+	};
+
+	if (!data || len == 0) {
+		return -EINVAL;
+	}
+	if (len > SIDEWALK_EVENT_INLINE_MAX) {
+		return -EMSGSIZE;
+	}
+	memcpy(qe.inline_ctx, data, len);
+	return sidewalk_event_enqueue(prio, &qe);
+}
+
+int sidewalk_event_send(event_handler_t event, void *ctx, ctx_free free)
+{
+	return sidewalk_event_send_prio(SIDEWALK_EVENT_PRIO_CONTROL, event, ctx, free);
+}
+
+int sidewalk_event_process_request(void)
+{
+	/* [3P-GLUE] ISR safe; the SDK signals on every radio event. */
+	if (!atomic_cas(&sidewalk_process_pending, 0, 1)) {
+		atomic_inc(&sidewalk_process_merged);
+		return 0;
+	}
+	int err = sidewalk_event_send(sidewalk_event_process, NULL, NULL);
+	if (err) {
+		atomic_clear(&sidewalk_process_pending);
+	}
+	return err;
+}
+
+uint32_t sidewalk_event_process_merged(void)
+{
+	return (uint32_t)atomic_get(&sidewalk_process_merged);
+}
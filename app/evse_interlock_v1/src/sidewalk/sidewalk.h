@@ -52,6 +52,72 @@ void sidewalk_start(sidewalk_ctx_t *context);
 
 int sidewalk_event_send(event_handler_t event, void *ctx, ctx_free free);
 
+/*
+ * [3P-GLUE] Sidewalk thread dispatch levels. sidewalk_event_send() queues at
+ * CONTROL (sid_process() and SDK control); uplinks and file transfer chunks
+ * queue at BULK, which drains after CONTROL with a bounded wait.
+ */
+enum sidewalk_event_prio {
+	SIDEWALK_EVENT_PRIO_CONTROL = 0,
+	SIDEWALK_EVENT_PRIO_BULK,
+	SIDEWALK_EVENT_PRIO_COUNT,
+};
+
+int sidewalk_event_send_prio(enum sidewalk_event_prio prio, event_handler_t event, void *ctx,
+			     ctx_free free);
+
+/*
+ * [3P-GLUE] Copy len bytes (at most SIDEWALK_EVENT_INLINE_MAX) into the queue
+ * entry; the handler gets a 4-byte aligned pointer to the copy as ctx, valid
+ * until it returns. No heap, no ctx_free; -EMSGSIZE when the data is too big.
+ */
+#define SIDEWALK_EVENT_INLINE_MAX CONFIG_SID_END_DEVICE_EVENT_INLINE_SIZE
+
+int sidewalk_event_send_inline(enum sidewalk_event_prio prio, event_handler_t event,
+			       const void *data, size_t len);
+
+struct sidewalk_event_queue_stats {
+	uint32_t dispatched;
+	/* k_msgq_put() failures: the queue stayed full past the send timeout. */
+	uint32_t enqueue_failed;
+	/* Most events waiting at once, against the configured depth. */
+	uint32_t depth_max;
+	uint32_t depth_size;
+	/* Enqueue to handler start. */
+	uint32_t latency_max_us;
+	uint64_t latency_total_us;
+};
+
+void sidewalk_event_queue_stats(enum sidewalk_event_prio prio,
+				struct sidewalk_event_queue_stats *out);
+
+/*
+ * [3P-GLUE] Per-handler dispatch counters, indexed 0..sidewalk_event_handler_count()-1.
+ * Handlers the table does not know (application private ones) share the last
+ * entry, "other".
+ */
+struct sidewalk_event_handler_stats {
+	const char *name;
+	uint32_t dispatched;
+	/* Enqueue to handler start. */
+	uint32_t latency_max_us;
+	uint64_t latency_total_us;
+	/* Handler run time, ctx_free excluded. */
+	uint32_t exec_max_us;
+	uint64_t exec_total_us;
+};
+
+int sidewalk_event_handler_count(void);
+int sidewalk_event_handler_stats(int idx, struct sidewalk_event_handler_stats *out);
+const char *sidewalk_event_name(event_handler_t handler);
+
+/*
+ * [3P-GLUE] Queue sidewalk_event_process unless one is already waiting; the
+ * merged signals are counted. For the SDK on_event callback (ISR safe).
+ */
+int sidewalk_event_process_request(void);
+uint32_t sidewalk_event_process_merged(void);
+
 #ifdef CONFIG_SIDEWALK_LINK_MASK_BLE
 #define DEFAULT_LM (uint32_t)(SID_LINK_TYPE_1)
 #elif CONFIG_SIDEWALK_LINK_MASK_FSK
@@ -73,16 +139,4 @@ void sidewalk_event_exit(sidewalk_ctx_t *sid, void *ctx);
 void sidewalk_event_reboot(sidewalk_ctx_t *sid, void *ctx);
 void sidewalk_event_platform_init(sidewalk_ctx_t *sid, void *ctx);
 
-#define EVENT_TO_NAME(event)                                                                       \
-	event == sidewalk_event_process	      ? "sidewalk_event_process" :                         \
-	event == sidewalk_event_autostart     ? "sidewalk_event_autostart" :                       \
-	event == sidewalk_event_factory_reset ? "sidewalk_event_factory_reset" :                   \
-	event == sidewalk_event_new_status    ? "sidewalk_event_new_status" :                      \
-	event == sidewalk_event_send_msg      ? "sidewalk_event_send_msg" :                        \
-	event == sidewalk_event_connect	      ? "sidewalk_event_connect" :                         \
-	event == sidewalk_event_link_switch   ? "sidewalk_event_link_switch" :                     \
-	event == sidewalk_event_exit	      ? "sidewalk_event_exit" :                            \
-	event == sidewalk_event_reboot	      ? "sidewalk_event_reboot" :                          \
-	event == sidewalk_event_platform_init ? "sidewalk_event_platform_init" :                   \
-						"use addr2line to get name of event"
 #endif /* SIDEWALK_APP_H */
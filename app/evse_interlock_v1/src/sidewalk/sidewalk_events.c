@@ -10,6 +10,7 @@
 
 #include "json_printer/sidTypes2str.h"
 #include "sidewalk/sidewalk.h"
+#include "sidewalk/sidewalk_msg.h"
 #include <sid_error.h>
 #include <app_mfg_config.h>
 #include <sid_pal_common_ifc.h>
@@ -203,20 +204,29 @@ void sidewalk_event_new_status(sidewalk_ctx_t *sid, void *ctx)
 	}
 
 	memcpy(&sid->last_status, p_status, sizeof(struct sid_status));
+	sidewalk_msg_update_link_mtu(sid->handle, p_status->detail.link_status_mask);
 }
 void sidewalk_event_send_msg(sidewalk_ctx_t *sid, void *ctx)
 {
+	sidewalk_msg_t *p_msg = (sidewalk_msg_t *)ctx;
+	if (!p_msg) {
+		LOG_ERR("sid send msg is NULL");
+		return;
+	}
 	if (sid == NULL || sid->handle == NULL) {
 		LOG_INF("sidewalk need to be started first.");
+		sidewalk_msg_put_done(p_msg, SID_ERROR_INVALID_STATE);
 		return;
 	}
-	sidewalk_msg_t *p_msg = (sidewalk_msg_t *)ctx;
-	if (!p_msg) {
-		LOG_ERR("sid send msg is NULL");
+	if (!sidewalk_msg_fits_link(p_msg)) {
+		/* Telemetry fragments to the MTU upstream; anything else is reported, not sent. */
+		sidewalk_msg_put_done(p_msg, SID_ERROR_INVALID_ARGS);
 		return;
 	}
 
 	sid_error_t e = sid_put_msg(sid->handle, &p_msg->msg, &p_msg->desc);
+	/* [TELEMETRY] Delivery tracking and the airtime budget learn the outcome here. */
+	sidewalk_msg_put_done(p_msg, e);
 	if (e) {
 		LOG_ERR("sid send err %d", (int)e);
 		return;
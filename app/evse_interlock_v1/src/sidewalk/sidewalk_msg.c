@@ -7,12 +7,169 @@
 #include "sidewalk.h"
 
 #include <sid_hal_memory_ifc.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
 #include <errno.h>
 #include <string.h>
 
 LOG_MODULE_REGISTER(sidewalk_msg, CONFIG_SIDEWALK_LOG_LEVEL);
 
+#define SIDEWALK_MSG_POOL_COUNT CONFIG_SID_END_DEVICE_MSG_POOL_COUNT
+#define SIDEWALK_MSG_POOL_PAYLOAD CONFIG_SID_END_DEVICE_MSG_POOL_PAYLOAD
+
+/* [3P-GLUE] SDK-facing context first, then the delivery tag, then the payload. */
+struct sidewalk_msg_block {
+	sidewalk_msg_t msg;
+	int32_t tag;
+};
+
+/* [3P-GLUE] One block = message context + inline payload, as in sidewalk_msg_reserve(). */
+#define SIDEWALK_MSG_POOL_BLOCK                                                            \
+	ROUND_UP(sizeof(struct sidewalk_msg_block) + SIDEWALK_MSG_POOL_PAYLOAD, sizeof(void *))
+
+#if SIDEWALK_MSG_POOL_COUNT > 0
+K_MEM_SLAB_DEFINE_STATIC(sidewalk_msg_slab, SIDEWALK_MSG_POOL_BLOCK, SIDEWALK_MSG_POOL_COUNT,
+			 sizeof(void *));
+#endif
+
+static atomic_t sidewalk_msg_mtu;
+static atomic_t sidewalk_msg_oversize;
+static atomic_t sidewalk_msg_pool_in_use;
+static atomic_t sidewalk_msg_pool_high_water;
+static atomic_t sidewalk_msg_pool_exhausted;
+static atomic_t sidewalk_msg_pool_too_big;
+static atomic_t sidewalk_msg_heap_failed;
+static sidewalk_msg_put_hook_t sidewalk_msg_put_hook;
+
+size_t sidewalk_msg_link_mtu(void)
+{
+	return (size_t)atomic_get(&sidewalk_msg_mtu);
+}
+
+uint32_t sidewalk_msg_oversize_count(void)
+{
+	return (uint32_t)atomic_get(&sidewalk_msg_oversize);
+}
+
+void sidewalk_msg_update_link_mtu(struct sid_handle *handle, uint32_t link_status_mask)
+{
+	/* [3P-GLUE] SID_LINK_TYPE_ANY may pick any up link; size for the smallest. */
+	static const enum sid_link_type links[] = {
+		SID_LINK_TYPE_1,
+		SID_LINK_TYPE_2,
+		SID_LINK_TYPE_3,
+	};
+	size_t min_mtu = 0;
+
+	if (!handle) {
+		return;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(links); i++) {
+		size_t mtu = 0;
+
+		if (!(link_status_mask & links[i])) {
+			continue;
+		}
+		if (sid_get_mtu(handle, links[i], &mtu) != SID_ERROR_NONE || mtu == 0) {
+			continue;
+		}
+		if (min_mtu == 0 || mtu < min_mtu) {
+			min_mtu = mtu;
+		}
+	}
+
+	if ((size_t)atomic_set(&sidewalk_msg_mtu, (atomic_val_t)min_mtu) != min_mtu) {
+		LOG_INF("Link MTU: %u (link mask 0x%x)", (unsigned int)min_mtu, link_status_mask);
+	}
+}
+
+/* [3P-GLUE] Called on the Sidewalk thread right before sid_put_msg(). */
+bool sidewalk_msg_fits_link(const sidewalk_msg_t *msg)
+{
+	size_t mtu = sidewalk_msg_link_mtu();
+
+	if (mtu == 0 || msg->msg.size <= mtu) {
+		return true;
+	}
+	atomic_inc(&sidewalk_msg_oversize);
+	LOG_ERR("sid send: %u bytes exceeds link MTU %u", (unsigned int)msg->msg.size,
+		(unsigned int)mtu);
+	return false;
+}
+
+#if SIDEWALK_MSG_POOL_COUNT > 0
+static bool sidewalk_msg_from_pool(const void *block)
+{
+	const char *p = block;
+
+	return p >= sidewalk_msg_slab.buffer &&
+	       p < sidewalk_msg_slab.buffer + SIDEWALK_MSG_POOL_COUNT * SIDEWALK_MSG_POOL_BLOCK;
+}
+#endif
+
+/*
+ * [3P-GLUE] O(1) and ISR safe from the pool (K_NO_WAIT); the sid_hal heap is only
+ * a fallback for oversize messages or an exhausted pool, and both are counted.
+ */
+static sidewalk_msg_t *sidewalk_msg_alloc(size_t capacity)
+{
+#if SIDEWALK_MSG_POOL_COUNT > 0
+	void *block;
+
+	if (capacity > SIDEWALK_MSG_POOL_PAYLOAD) {
+		atomic_inc(&sidewalk_msg_pool_too_big);
+	} else if (k_mem_slab_alloc(&sidewalk_msg_slab, &block, K_NO_WAIT) == 0) {
+		atomic_val_t used = atomic_inc(&sidewalk_msg_pool_in_use) + 1;
+		atomic_val_t high = atomic_get(&sidewalk_msg_pool_high_water);
+
+		while (used > high &&
+		       !atomic_cas(&sidewalk_msg_pool_high_water, high, used)) {
+			high = atomic_get(&sidewalk_msg_pool_high_water);
+		}
+		return block;
+	} else {
+		atomic_val_t n = atomic_inc(&sidewalk_msg_pool_exhausted) + 1;
+
+		if (IS_POWER_OF_TWO(n)) {
+			LOG_WRN("Msg pool exhausted (%ld times); using heap", (long)n);
+		}
+	}
+#endif
+
+	sidewalk_msg_t *msg = sid_hal_malloc(sizeof(struct sidewalk_msg_block) + capacity);
+	if (!msg) {
+		atomic_inc(&sidewalk_msg_heap_failed);
+	}
+	return msg;
+}
+
+static void sidewalk_msg_release(sidewalk_msg_t *msg)
+{
+#if SIDEWALK_MSG_POOL_COUNT > 0
+	if (sidewalk_msg_from_pool(msg)) {
+		k_mem_slab_free(&sidewalk_msg_slab, msg);
+		atomic_dec(&sidewalk_msg_pool_in_use);
+		return;
+	}
+#endif
+	sid_hal_free(msg);
+}
+
+void sidewalk_msg_pool_stats(struct sidewalk_msg_pool_stats *out)
+{
+	if (!out) {
+		return;
+	}
+	out->capacity = SIDEWALK_MSG_POOL_COUNT;
+	out->in_use = (uint32_t)atomic_get(&sidewalk_msg_pool_in_use);
+	out->high_water = (uint32_t)atomic_get(&sidewalk_msg_pool_high_water);
+	out->exhausted = (uint32_t)atomic_get(&sidewalk_msg_pool_exhausted);
+	out->too_big = (uint32_t)atomic_get(&sidewalk_msg_pool_too_big);
+	out->heap_failed = (uint32_t)atomic_get(&sidewalk_msg_heap_failed);
+}
+
 static void sidewalk_msg_free_ctx(void *ctx)
 {
 	/* [BOILERPLATE] Free payload/context allocated for SDK send. */
@@ -20,51 +177,127 @@ static void sidewalk_msg_free_ctx(void *ctx)
 	if (!msg) {
 		return;
 	}
-	if (msg->msg.data) {
-		sid_hal_free(msg->msg.data);
+	/* Messages carry the payload inline, right after the context block. */
+	sidewalk_msg_release(msg);
+}
+
+sidewalk_msg_t *sidewalk_msg_reserve(size_t capacity)
+{
+	/* [3P-GLUE] Context and payload share one pool block (or heap allocation). */
+	if (capacity == 0) {
+		return NULL;
+	}
+
+	sidewalk_msg_t *msg = sidewalk_msg_alloc(capacity);
+	if (!msg) {
+		LOG_ERR("Failed to alloc msg (%u bytes)", (unsigned int)capacity);
+		return NULL;
 	}
-	sid_hal_free(msg);
+	struct sidewalk_msg_block *block = CONTAINER_OF(msg, struct sidewalk_msg_block, msg);
+
+	memset(block, 0x0, sizeof(*block));
+	block->tag = SIDEWALK_MSG_UNTRACKED;
+	msg->msg.data = (void *)(block + 1);
+	msg->msg.size = capacity;
+	return msg;
 }
 
-int sidewalk_send_msg_copy(const struct sid_msg_desc *desc, const void *payload, size_t len)
+void sidewalk_msg_set_tag(sidewalk_msg_t *msg, int32_t tag)
 {
-	/* THIRD-PARTY BOUNDARY - DO NOT MODIFY: uses Sidewalk SDK memory APIs. */
-	if (!desc || !payload || len == 0) {
-		return -EINVAL;
+	if (msg) {
+		CONTAINER_OF(msg, struct sidewalk_msg_block, msg)->tag = tag;
+	}
+}
+
+void sidewalk_msg_set_put_hook(sidewalk_msg_put_hook_t hook)
+{
+	sidewalk_msg_put_hook = hook;
+}
+
+void sidewalk_msg_put_done(const sidewalk_msg_t *msg, sid_error_t err)
+{
+	const struct sidewalk_msg_block *block =
+		CONTAINER_OF(msg, const struct sidewalk_msg_block, msg);
+
+	if (sidewalk_msg_put_hook) {
+		sidewalk_msg_put_hook(block->tag, err, msg);
 	}
+}
 
-	sidewalk_msg_t *msg = sid_hal_malloc(sizeof(*msg));
+int sidewalk_msg_commit(sidewalk_msg_t *msg, const struct sid_msg_desc *desc, size_t len)
+{
 	if (!msg) {
-		LOG_ERR("Failed to alloc msg context");
-		return -ENOMEM;
+		return -EINVAL;
+	}
+	if (!desc || len == 0 || len > msg->msg.size) {
+		sidewalk_msg_free_ctx(msg);
+		return -EINVAL;
 	}
-	memset(msg, 0x0, sizeof(*msg));
 
 	msg->msg.size = len;
-	msg->msg.data = sid_hal_malloc(msg->msg.size);
-	if (!msg->msg.data) {
-		LOG_ERR("Failed to alloc msg data");
-		sid_hal_free(msg);
-		return -ENOMEM;
-	}
-	memcpy(msg->msg.data, payload, msg->msg.size);
 	msg->desc = *desc;
 
-	int err = sidewalk_event_send(sidewalk_event_send_msg, msg, sidewalk_msg_free_ctx);
+	int err = sidewalk_event_send_prio(SIDEWALK_EVENT_PRIO_BULK, sidewalk_event_send_msg, msg,
+					   sidewalk_msg_free_ctx);
 	if (err) {
 		sidewalk_msg_free_ctx(msg);
 	}
 	return err;
 }
 
-int sidewalk_send_notify_json(const char *json, size_t len)
+int sidewalk_msg_commit_notify(sidewalk_msg_t *msg, size_t len)
 {
-	/* [3P-GLUE] SDK message descriptor for uplink notify payloads. */
+	/* [3P-GLUE] SDK message descriptor for uplink notify payloads (JSON or binary). */
 	struct sid_msg_desc desc = {
 		.type = SID_MSG_TYPE_NOTIFY,
 		.link_type = SID_LINK_TYPE_ANY,
 		.link_mode = SID_LINK_MODE_CLOUD,
 	};
 
-	return sidewalk_send_msg_copy(&desc, json, len);
+#if defined(CONFIG_SID_END_DEVICE_TELEMETRY_DELIVERY_REQUEST_ACK)
+	/* Retries are the delivery tracker's job; the SDK sends once. */
+	desc.msg_desc_attr.tx_attr.request_ack = true;
+	desc.msg_desc_attr.tx_attr.num_retries = 0;
+#endif
+	return sidewalk_msg_commit(msg, &desc, len);
+}
+
+void sidewalk_msg_abort(sidewalk_msg_t *msg)
+{
+	sidewalk_msg_free_ctx(msg);
+}
+
+int sidewalk_send_msg_copy(const struct sid_msg_desc *desc, const void *payload, size_t len)
+{
+	/* [3P-GLUE] Copy into a reserved message; same pool path as telemetry. */
+	if (!desc || !payload || len == 0) {
+		return -EINVAL;
+	}
+
+	sidewalk_msg_t *msg = sidewalk_msg_reserve(len);
+	if (!msg) {
+		return -ENOMEM;
+	}
+	memcpy(sidewalk_msg_payload(msg), payload, len);
+	return sidewalk_msg_commit(msg, desc, len);
+}
+
+int sidewalk_send_notify(const void *payload, size_t len)
+{
+	/* [3P-GLUE] Copying convenience wrapper over reserve/commit (single alloc). */
+	if (!payload || len == 0) {
+		return -EINVAL;
+	}
+
+	sidewalk_msg_t *msg = sidewalk_msg_reserve(len);
+	if (!msg) {
+		return -ENOMEM;
+	}
+	memcpy(sidewalk_msg_payload(msg), payload, len);
+	return sidewalk_msg_commit_notify(msg, len);
+}
+
+int sidewalk_send_notify_json(const char *json, size_t len)
+{
+	return sidewalk_send_notify(json, len);
 }
@@ -4,10 +4,76 @@
 #ifndef SIDEWALK_MSG_H
 #define SIDEWALK_MSG_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include <sid_api.h>
 
+#include "sidewalk/sidewalk.h"
+
+/*
+ * [3P-GLUE] Zero-copy uplink: reserve a message with an inline payload buffer,
+ * build straight into sidewalk_msg_payload(), then commit (hands ownership to the
+ * Sidewalk thread) or abort (frees it). One pool block per message, no memcpy.
+ */
+sidewalk_msg_t *sidewalk_msg_reserve(size_t capacity);
+int sidewalk_msg_commit(sidewalk_msg_t *msg, const struct sid_msg_desc *desc, size_t len);
+int sidewalk_msg_commit_notify(sidewalk_msg_t *msg, size_t len);
+void sidewalk_msg_abort(sidewalk_msg_t *msg);
+
+static inline void *sidewalk_msg_payload(sidewalk_msg_t *msg)
+{
+	return msg->msg.data;
+}
+
+static inline size_t sidewalk_msg_capacity(const sidewalk_msg_t *msg)
+{
+	return msg->msg.size;
+}
+
+/*
+ * [3P-GLUE] Delivery tracking and airtime accounting. Every message is reported
+ * to the put hook on the Sidewalk thread once sid_put_msg() has run (or the
+ * message was refused before it), while its payload and assigned desc.id are
+ * still valid. The tag is SIDEWALK_MSG_UNTRACKED unless set before commit.
+ */
+#define SIDEWALK_MSG_UNTRACKED (-1)
+
+typedef void (*sidewalk_msg_put_hook_t)(int32_t tag, sid_error_t err, const sidewalk_msg_t *msg);
+
+void sidewalk_msg_set_tag(sidewalk_msg_t *msg, int32_t tag);
+void sidewalk_msg_set_put_hook(sidewalk_msg_put_hook_t hook);
+void sidewalk_msg_put_done(const sidewalk_msg_t *msg, sid_error_t err);
+
+/*
+ * [3P-GLUE] Message pool accounting. Messages up to
+ * CONFIG_SID_END_DEVICE_MSG_POOL_PAYLOAD bytes come from a static slab of
+ * CONFIG_SID_END_DEVICE_MSG_POOL_COUNT blocks; the rest use the sid_hal heap.
+ */
+struct sidewalk_msg_pool_stats {
+	uint32_t capacity;
+	uint32_t in_use;
+	uint32_t high_water;
+	/* Heap fallbacks: pool empty, or message larger than a block. */
+	uint32_t exhausted;
+	uint32_t too_big;
+	/* Heap fallback failed as well; the message was not sent. */
+	uint32_t heap_failed;
+};
+
+void sidewalk_msg_pool_stats(struct sidewalk_msg_pool_stats *out);
+
+/*
+ * [3P-GLUE] Smallest MTU among the links in the last link_status_mask, as reported
+ * by sid_get_mtu(); 0 while unknown. Refreshed on the Sidewalk thread.
+ */
+size_t sidewalk_msg_link_mtu(void);
+void sidewalk_msg_update_link_mtu(struct sid_handle *handle, uint32_t link_status_mask);
+uint32_t sidewalk_msg_oversize_count(void);
+bool sidewalk_msg_fits_link(const sidewalk_msg_t *msg);
+
+int sidewalk_send_notify(const void *payload, size_t len);
 int sidewalk_send_notify_json(const char *json, size_t len);
 int sidewalk_send_msg_copy(const struct sid_msg_desc *desc, const void *payload, size_t len);
 
@@ -0,0 +1,299 @@
+/*
+ * [EVSE-LOGIC] Continuous analog sampling (see adc_stream.h).
+ * [3P-GLUE] nrfx SAADC/TIMER/GPPI wiring for nRF52.
+ */
+#include "telemetry/adc_stream.h"
+#include "telemetry/current_rms.h"
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+#include "telemetry/pwm_capture.h"
+#endif
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <hal/nrf_saadc.h>
+#include <helpers/nrfx_gppi.h>
+#include <nrfx_saadc.h>
+#include <nrfx_timer.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(adc_stream, CONFIG_SIDEWALK_LOG_LEVEL);
+
+#define ADC_STREAM_TIMER_HZ 1000000
+#define ADC_STREAM_INTERVAL_US CONFIG_SID_END_DEVICE_ADC_STREAM_INTERVAL_US
+#define ADC_STREAM_SAMPLE_HZ ((1000000 + ADC_STREAM_INTERVAL_US / 2) / ADC_STREAM_INTERVAL_US)
+#define ADC_STREAM_LINE_HZ CONFIG_SID_END_DEVICE_ADC_STREAM_LINE_HZ
+/* [EVSE-LOGIC] Whole line cycles per block, plus one spare scan. */
+#define ADC_STREAM_SCANS                                                                   \
+	(ADC_STREAM_SAMPLE_HZ * CONFIG_SID_END_DEVICE_ADC_STREAM_CYCLES / ADC_STREAM_LINE_HZ + 1)
+#define ADC_STREAM_BLOCK_LEN (ADC_STREAM_SCANS * ADC_STREAM_INPUTS)
+/* [BOILERPLATE] One conversion: 10 us acquisition + 2 us. */
+#define ADC_STREAM_CONV_US 12
+/* [EVSE-LOGIC] Pilot plateaus come from the last 8 PWM periods of a block. */
+#define ADC_STREAM_PILOT_WINDOW_US 8000
+
+BUILD_ASSERT(ADC_STREAM_INPUTS > 0, "ADC stream without inputs");
+BUILD_ASSERT(ADC_STREAM_BLOCK_LEN <= 32767, "SAADC EasyDMA takes at most 32767 results");
+BUILD_ASSERT(ADC_STREAM_INPUTS * ADC_STREAM_CONV_US < ADC_STREAM_INTERVAL_US,
+	     "a scan must end before the next one starts");
+
+static const nrfx_timer_t stream_timer = NRFX_TIMER_INSTANCE(3);
+
+static const nrfx_saadc_channel_t stream_channels[ADC_STREAM_INPUTS] = {
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+	NRFX_SAADC_DEFAULT_CHANNEL_SE(
+		(NRF_SAADC_INPUT_AIN0 + CONFIG_SID_END_DEVICE_EVSE_PILOT_ADC_CHANNEL),
+		ADC_STREAM_PILOT),
+	NRFX_SAADC_DEFAULT_CHANNEL_SE(
+		(NRF_SAADC_INPUT_AIN0 + CONFIG_SID_END_DEVICE_EVSE_CURRENT_ADC_CHANNEL),
+		ADC_STREAM_CURRENT),
+#endif
+#if defined(CONFIG_SID_END_DEVICE_LINE_CURRENT_ENABLED)
+	NRFX_SAADC_DEFAULT_CHANNEL_SE(
+		(NRF_SAADC_INPUT_AIN0 + CONFIG_SID_END_DEVICE_LINE_CURRENT_ADC_CHANNEL),
+		ADC_STREAM_LINE),
+#endif
+};
+
+/* [BOILERPLATE] EasyDMA fills one while the other waits its turn. */
+static nrf_saadc_value_t stream_buf[2][ADC_STREAM_BLOCK_LEN];
+static uint8_t stream_next;
+static bool stream_started;
+static int stream_err;
+
+/* [EVSE-LOGIC] Written by the block handler, read by pollers; all under stream_lock. */
+static struct k_spinlock stream_lock;
+static uint32_t stream_blocks;
+static uint32_t stream_rms_x16[ADC_STREAM_INPUTS];
+static uint64_t stream_rms_sum_x16[ADC_STREAM_INPUTS];
+static uint32_t stream_rms_sum_n[ADC_STREAM_INPUTS];
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+static struct pilot_plateau stream_plateau;
+static volatile bool stream_stamped;
+#endif
+
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+/*
+ * [EVSE-LOGIC] Pilot plateaus of a block. With a stamp of the time since the
+ * PWM rise at the block end, each sample is placed by its phase; without
+ * one (or with the PWM stopped) the samples are split by level.
+ */
+static void stream_pilot_read(const int16_t *buf, struct pilot_plateau *out)
+{
+	const int16_t *pilot = buf + ADC_STREAM_PILOT;
+
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+	struct pilot_plateau_timing t = {
+		.interval_us = ADC_STREAM_INTERVAL_US,
+		/* END comes once every later channel of the last scan has converted. */
+		.age_us = (ADC_STREAM_INPUTS - ADC_STREAM_PILOT) * ADC_STREAM_CONV_US,
+		.settle_us = CONFIG_SID_END_DEVICE_EVSE_PILOT_SETTLE_US,
+		.conv_us = ADC_STREAM_CONV_US,
+		.window_us = ADC_STREAM_PILOT_WINDOW_US,
+	};
+
+	if (stream_stamped && pwm_capture_stamp_get(&t.period_us, &t.high_us, &t.since_us) &&
+	    t.since_us < 2 * t.period_us) {
+		pilot_plateau_timed(pilot, ADC_STREAM_SCANS, ADC_STREAM_INPUTS, &t, out);
+		return;
+	}
+#endif
+	pilot_plateau_levels(pilot, ADC_STREAM_SCANS, ADC_STREAM_INPUTS,
+			     ADC_STREAM_PILOT_WINDOW_US / ADC_STREAM_INTERVAL_US, out);
+}
+#endif
+
+/* [EVSE-LOGIC] A full block: reduce it here, in the SAADC interrupt, and publish. */
+static void stream_block_done(const int16_t *buf)
+{
+	size_t n = current_rms_whole_cycles(ADC_STREAM_SCANS, ADC_STREAM_SAMPLE_HZ,
+					    ADC_STREAM_LINE_HZ);
+	uint32_t rms_x16[ADC_STREAM_INPUTS] = { 0 };
+
+	for (size_t in = 0; in < ADC_STREAM_INPUTS; in++) {
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+		if (in == ADC_STREAM_PILOT) {
+			continue;
+		}
+#endif
+		rms_x16[in] = current_rms_x16(buf + in, n, ADC_STREAM_INPUTS);
+	}
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+	struct pilot_plateau plateau;
+
+	stream_pilot_read(buf, &plateau);
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&stream_lock);
+
+	for (size_t in = 0; in < ADC_STREAM_INPUTS; in++) {
+		stream_rms_x16[in] = rms_x16[in];
+		stream_rms_sum_x16[in] += rms_x16[in];
+		stream_rms_sum_n[in]++;
+	}
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+	stream_plateau = plateau;
+#endif
+	stream_blocks++;
+	k_spin_unlock(&stream_lock, key);
+}
+
+static void stream_event(nrfx_saadc_evt_t const *evt)
+{
+	switch (evt->type) {
+	case NRFX_SAADC_EVT_DONE:
+		/* The next block started on END (PPI); this one stays put until handed back. */
+		stream_block_done(evt->data.done.p_buffer);
+		break;
+	case NRFX_SAADC_EVT_BUF_REQ:
+		(void)nrfx_saadc_buffer_set(stream_buf[stream_next], ADC_STREAM_BLOCK_LEN);
+		stream_next ^= 1;
+		break;
+	default:
+		break;
+	}
+}
+
+/* [3P-GLUE] No timer interrupts are enabled; nrfx still wants a handler. */
+static void stream_timer_handler(nrf_timer_event_t event, void *ctx)
+{
+	ARG_UNUSED(event);
+	ARG_UNUSED(ctx);
+}
+
+/* [3P-GLUE] One PPI channel eep -> tep, enabled. */
+static int stream_link(uint32_t eep, uint32_t tep)
+{
+	uint8_t ch;
+
+	if (nrfx_gppi_channel_alloc(&ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+	nrfx_gppi_channel_endpoints_setup(ch, eep, tep);
+	nrfx_gppi_channels_enable(BIT(ch));
+	return 0;
+}
+
+/*
+ * [3P-GLUE] SAADC in advanced mode on both buffers, END -> START in hardware
+ * so a late interrupt never costs a scan; scans start when the timer runs.
+ */
+static int stream_saadc_init(void)
+{
+	nrfx_saadc_adv_config_t adv = NRFX_SAADC_DEFAULT_ADV_CONFIG;
+
+	IRQ_CONNECT(DT_IRQN(DT_NODELABEL(adc)), DT_IRQ(DT_NODELABEL(adc), priority), nrfx_isr,
+		    nrfx_saadc_irq_handler, 0);
+	if (nrfx_saadc_init(DT_IRQ(DT_NODELABEL(adc), priority)) != NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+	adv.start_on_end = false;
+	if (nrfx_saadc_offset_calibrate(NULL) != NRFX_SUCCESS ||
+	    nrfx_saadc_channels_config(stream_channels, ADC_STREAM_INPUTS) != NRFX_SUCCESS ||
+	    nrfx_saadc_advanced_mode_set(BIT_MASK(ADC_STREAM_INPUTS), NRF_SAADC_RESOLUTION_12BIT,
+					 &adv, stream_event) != NRFX_SUCCESS ||
+	    nrfx_saadc_buffer_set(stream_buf[0], ADC_STREAM_BLOCK_LEN) != NRFX_SUCCESS ||
+	    nrfx_saadc_buffer_set(stream_buf[1], ADC_STREAM_BLOCK_LEN) != NRFX_SUCCESS) {
+		return -EINVAL;
+	}
+	stream_next = 0;
+
+	int err = stream_link(adc_stream_end_event(),
+			      nrf_saadc_task_address_get(NRF_SAADC, NRF_SAADC_TASK_START));
+	if (err) {
+		return err;
+	}
+	return nrfx_saadc_mode_trigger() == NRFX_SUCCESS ? 0 : -EIO;
+}
+
+/* [3P-GLUE] TIMER3 at 1 MHz, cleared on CC[0]; COMPARE0 -> SAMPLE (a scan). */
+static int stream_timer_init(void)
+{
+	nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG(ADC_STREAM_TIMER_HZ);
+
+	timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+	if (nrfx_timer_init(&stream_timer, &timer_cfg, stream_timer_handler) != NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+	nrfx_timer_extended_compare(&stream_timer, NRF_TIMER_CC_CHANNEL0,
+				    nrfx_timer_us_to_ticks(&stream_timer, ADC_STREAM_INTERVAL_US),
+				    NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, false);
+
+	int err = stream_link(
+		nrfx_timer_compare_event_address_get(&stream_timer, NRF_TIMER_CC_CHANNEL0),
+		nrf_saadc_task_address_get(NRF_SAADC, NRF_SAADC_TASK_SAMPLE));
+	if (err) {
+		nrfx_timer_uninit(&stream_timer);
+		return err;
+	}
+	nrfx_timer_enable(&stream_timer);
+	return 0;
+}
+
+int adc_stream_init(void)
+{
+	if (stream_started) {
+		return stream_err;
+	}
+	stream_started = true;
+	LOG_INF("ADC stream: %d input(s) every %d us, %d-scan blocks (%d line cycles)",
+		(int)ADC_STREAM_INPUTS, ADC_STREAM_INTERVAL_US, (int)ADC_STREAM_SCANS,
+		CONFIG_SID_END_DEVICE_ADC_STREAM_CYCLES);
+	stream_err = stream_saadc_init();
+	if (!stream_err) {
+		stream_err = stream_timer_init();
+	}
+	if (stream_err) {
+		LOG_ERR("ADC stream not started (err %d)", stream_err);
+	}
+	return stream_err;
+}
+
+uint32_t adc_stream_end_event(void)
+{
+	return nrf_saadc_event_address_get(NRF_SAADC, NRF_SAADC_EVENT_END);
+}
+
+bool adc_stream_rms_x16(enum adc_stream_input in, uint32_t *rms_x16)
+{
+	k_spinlock_key_t key = k_spin_lock(&stream_lock);
+	bool ok = stream_blocks > 0;
+
+	*rms_x16 = stream_rms_x16[in];
+	k_spin_unlock(&stream_lock, key);
+	return ok;
+}
+
+bool adc_stream_rms_mean_x16(enum adc_stream_input in, uint32_t *rms_x16)
+{
+	k_spinlock_key_t key = k_spin_lock(&stream_lock);
+	uint64_t sum = stream_rms_sum_x16[in];
+	uint32_t n = stream_rms_sum_n[in];
+
+	stream_rms_sum_x16[in] = 0;
+	stream_rms_sum_n[in] = 0;
+	k_spin_unlock(&stream_lock, key);
+	if (n == 0) {
+		return false;
+	}
+	*rms_x16 = (uint32_t)((sum + n / 2) / n);
+	return true;
+}
+
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+void adc_stream_pilot_stamped(void)
+{
+	stream_stamped = true;
+}
+
+bool adc_stream_pilot(struct pilot_plateau *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stream_lock);
+	bool ok = stream_blocks > 0;
+
+	*out = stream_plateau;
+	k_spin_unlock(&stream_lock, key);
+	return ok;
+}
+#endif
@@ -0,0 +1,59 @@
+/*
+ * [EVSE-LOGIC] Continuous sampling of the analog inputs, one block at a time.
+ * [3P-GLUE] nRF52 SAADC paced by TIMER3 through PPI, driven with nrfx_saadc.
+ *
+ * TIMER3 triggers a SAADC scan of every input each
+ * SID_END_DEVICE_ADC_STREAM_INTERVAL_US, with no interrupt per sample. EasyDMA
+ * fills one of two buffers (a block of SID_END_DEVICE_ADC_STREAM_CYCLES line
+ * cycles) while the other is handed back, so no scan is ever missed. When a
+ * block is done, its handler (SAADC interrupt) takes each current input's
+ * RMS over whole line cycles and the pilot's plateau levels, and keeps them
+ * for evse_poll and line_current_poll, which never wait on the ADC.
+ */
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "telemetry/pilot_plateau.h"
+
+/* [BOILERPLATE] Inputs of a scan, in SAADC channel order. */
+enum adc_stream_input {
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+	ADC_STREAM_PILOT,
+	ADC_STREAM_CURRENT,
+#endif
+#if defined(CONFIG_SID_END_DEVICE_LINE_CURRENT_ENABLED)
+	ADC_STREAM_LINE,
+#endif
+	ADC_STREAM_INPUTS,
+};
+
+/* [3P-GLUE] Configure and start the stream; later calls return the first result. */
+int adc_stream_init(void);
+
+/* [3P-GLUE] SAADC END event address, raised as each block completes (for PPI stamps). */
+uint32_t adc_stream_end_event(void);
+
+/* [EVSE-LOGIC] Latest block's RMS of a current input, in 1/16 LSB; false before the first. */
+bool adc_stream_rms_x16(enum adc_stream_input in, uint32_t *rms_x16);
+
+/*
+ * [EVSE-LOGIC] Mean RMS of a current input over every block since the last
+ * call, in 1/16 LSB; false when none completed. One caller per input.
+ */
+bool adc_stream_rms_mean_x16(enum adc_stream_input in, uint32_t *rms_x16);
+
+#if defined(CONFIG_SID_END_DEVICE_EVSE_ENABLED)
+/*
+ * [EVSE-LOGIC] The time since the PWM rise is stamped at every block end
+ * (pwm_capture_stamp_link): place pilot samples by phase from now on.
+ */
+void adc_stream_pilot_stamped(void);
+
+/* [EVSE-LOGIC] Latest block's pilot plateaus; false before the first block. */
+bool adc_stream_pilot(struct pilot_plateau *out);
+#endif
+
+#endif /* ADC_STREAM_H */
@@ -0,0 +1,61 @@
+/*
+ * [EVSE-LOGIC] Whole-cycle RMS (see current_rms.h).
+ */
+#include "telemetry/current_rms.h"
+
+size_t current_rms_whole_cycles(size_t n, uint32_t sample_hz, uint32_t line_hz)
+{
+	if (sample_hz == 0 || line_hz == 0) {
+		return n;
+	}
+	uint64_t cycles = (uint64_t)n * line_hz / sample_hz;
+	if (cycles == 0) {
+		return n;
+	}
+	/* Rounded: a cycle is rarely a whole number of samples. */
+	uint64_t samples = (cycles * sample_hz + line_hz / 2) / line_hz;
+	return samples < n ? (size_t)samples : n;
+}
+
+uint32_t current_rms_isqrt(uint64_t v)
+{
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= root + bit) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t)root;
+}
+
+uint32_t current_rms_x16(const int16_t *samples, size_t n, size_t stride)
+{
+	if (n == 0) {
+		return 0;
+	}
+	int64_t sum = 0;
+	uint64_t sum_sq = 0;
+
+	for (size_t i = 0; i < n; i++) {
+		int32_t x = samples[i * stride];
+
+		sum += x;
+		sum_sq += (uint64_t)(x * x);
+	}
+	/*
+	 * [EVSE-LOGIC] n^2 * variance = n * sum(x^2) - sum(x)^2, exact in 64 bits
+	 * for 12-bit samples and n up to 2^15, x256 for 1/16 LSB included.
+	 */
+	uint64_t n2_var = (uint64_t)n * sum_sq - (uint64_t)(sum * sum);
+
+	return (current_rms_isqrt(n2_var * 256U) + (uint32_t)n / 2) / (uint32_t)n;
+}
@@ -0,0 +1,32 @@
+/*
+ * [EVSE-LOGIC] True RMS of a current transformer input over whole line cycles.
+ * Pure C, no Zephyr deps; integer only.
+ *
+ * A block of ADC samples taken at a fixed rate is cut to the longest run of
+ * whole line cycles it holds, so the window starts and ends at the same
+ * phase and the result does not depend on where the block began. The DC
+ * level (the CT bias) is the mean over that window and is removed.
+ */
+#ifndef CURRENT_RMS_H
+#define CURRENT_RMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * [EVSE-LOGIC] Samples in the longest run of whole line cycles within n;
+ * all n when they cover less than one cycle.
+ */
+size_t current_rms_whole_cycles(size_t n, uint32_t sample_hz, uint32_t line_hz);
+
+/*
+ * [EVSE-LOGIC] RMS about the mean of samples[0], samples[stride], ... (n of
+ * them), in 1/16 LSB; 0 for n == 0. stride steps over the other inputs of an
+ * interleaved scan. Samples are 12-bit ADC results, n at most 2^15.
+ */
+uint32_t current_rms_x16(const int16_t *samples, size_t n, size_t stride);
+
+/* [BOILERPLATE] floor(sqrt(v)). */
+uint32_t current_rms_isqrt(uint64_t v);
+
+#endif /* CURRENT_RMS_H */
@@ -0,0 +1,115 @@
+/*
+ * [EVSE-LOGIC] Session current histogram (see current_sketch.h).
+ * [BOILERPLATE] Counts saturate by halving every bucket, so a session of any
+ * length keeps its shape in the same 128 bytes.
+ */
+#include "telemetry/current_sketch.h"
+
+#include <string.h>
+
+#define SKETCH_SUB (1U << CURRENT_SKETCH_SUB_BITS)
+
+static unsigned int msb_index(uint32_t v)
+{
+	unsigned int n = 0;
+
+	while (v >>= 1) {
+		n++;
+	}
+	return n;
+}
+
+unsigned int current_sketch_bucket(int32_t current_ma)
+{
+	uint32_t v = current_ma > 0 ? (uint32_t)current_ma / CURRENT_SKETCH_UNIT_MA : 0;
+
+	if (v < SKETCH_SUB) {
+		return v;
+	}
+	unsigned int e = msb_index(v);
+	unsigned int b = SKETCH_SUB + (e - CURRENT_SKETCH_SUB_BITS) * SKETCH_SUB +
+			 ((v >> (e - CURRENT_SKETCH_SUB_BITS)) & (SKETCH_SUB - 1));
+
+	return b < CURRENT_SKETCH_BUCKETS ? b : CURRENT_SKETCH_BUCKETS - 1;
+}
+
+void current_sketch_bucket_bounds(unsigned int bucket, int32_t *lo_ma, int32_t *hi_ma)
+{
+	uint32_t lo;
+	uint32_t width;
+
+	if (bucket < SKETCH_SUB) {
+		lo = bucket;
+		width = 1;
+	} else {
+		unsigned int e = (bucket - SKETCH_SUB) / SKETCH_SUB + CURRENT_SKETCH_SUB_BITS;
+
+		width = 1U << (e - CURRENT_SKETCH_SUB_BITS);
+		lo = (1U << e) + (bucket % SKETCH_SUB) * width;
+	}
+	*lo_ma = (int32_t)(lo * CURRENT_SKETCH_UNIT_MA);
+	*hi_ma = (int32_t)((lo + width) * CURRENT_SKETCH_UNIT_MA);
+}
+
+void current_sketch_reset(struct current_sketch *s)
+{
+	if (s) {
+		memset(s, 0, sizeof(*s));
+	}
+}
+
+void current_sketch_add(struct current_sketch *s, int32_t current_ma)
+{
+	if (!s) {
+		return;
+	}
+
+	unsigned int b = current_sketch_bucket(current_ma);
+
+	if (s->counts[b] == UINT16_MAX) {
+		s->total = 0;
+		for (unsigned int i = 0; i < CURRENT_SKETCH_BUCKETS; i++) {
+			s->counts[i] = (uint16_t)((s->counts[i] + 1U) / 2U);
+			s->total += s->counts[i];
+		}
+	}
+	s->counts[b]++;
+	s->total++;
+	if (s->samples == 0 || current_ma > s->max_ma) {
+		s->max_ma = current_ma > 0 ? current_ma : 0;
+	}
+	if (s->samples < UINT32_MAX) {
+		s->samples++;
+	}
+}
+
+int32_t current_sketch_quantile(const struct current_sketch *s, uint32_t permille)
+{
+	if (!s || s->total == 0) {
+		return 0;
+	}
+	if (permille > 1000) {
+		permille = 1000;
+	}
+
+	/* Nearest-rank: smallest bucket whose cumulative count reaches the rank. */
+	uint64_t rank = ((uint64_t)s->total * permille + 999) / 1000;
+	uint64_t seen = 0;
+
+	if (rank == 0) {
+		rank = 1;
+	}
+	for (unsigned int b = 0; b < CURRENT_SKETCH_BUCKETS; b++) {
+		seen += s->counts[b];
+		if (seen >= rank) {
+			int32_t lo;
+			int32_t hi;
+
+			current_sketch_bucket_bounds(b, &lo, &hi);
+			int32_t mid = lo + (hi - lo) / 2;
+			/* The top bucket is open ended; never report above the exact max. */
+			return mid < s->max_ma ? mid : s->max_ma;
+		}
+	}
+	return s->max_ma;
+}
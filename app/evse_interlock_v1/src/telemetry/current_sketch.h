@@ -0,0 +1,36 @@
+/*
+ * [EVSE-LOGIC] Constant-memory distribution of current draw over a session.
+ * [BOILERPLATE] Log-linear histogram: 8 linear 125 mA buckets below 1 A, then
+ * 8 buckets per power of two up to 128 A. Quantiles are bucket midpoints
+ * (within ~6% of the true value); max is exact. Pure C, no Zephyr deps.
+ */
+#ifndef CURRENT_SKETCH_H
+#define CURRENT_SKETCH_H
+
+#include <stdint.h>
+
+#define CURRENT_SKETCH_UNIT_MA 125
+#define CURRENT_SKETCH_SUB_BITS 3
+#define CURRENT_SKETCH_BUCKETS 64
+
+struct current_sketch {
+	uint16_t counts[CURRENT_SKETCH_BUCKETS];
+	/* Samples represented by counts (after any halving) and ever added. */
+	uint32_t total;
+	uint32_t samples;
+	int32_t max_ma;
+};
+
+void current_sketch_reset(struct current_sketch *s);
+
+/* [EVSE-LOGIC] Negative readings count as 0 A; > 128 A lands in the top bucket. */
+void current_sketch_add(struct current_sketch *s, int32_t current_ma);
+
+/* [TELEMETRY] Value at the given quantile (0..1000 permille); 0 when empty. */
+int32_t current_sketch_quantile(const struct current_sketch *s, uint32_t permille);
+
+/* [BOILERPLATE] Bucket index for a value and the bucket's [lo, hi) bounds in mA. */
+unsigned int current_sketch_bucket(int32_t current_ma);
+void current_sketch_bucket_bounds(unsigned int bucket, int32_t *lo_ma, int32_t *hi_ma);
+
+#endif /* CURRENT_SKETCH_H */
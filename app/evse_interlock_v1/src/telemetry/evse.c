@@ -1,9 +1,18 @@
 /*
  * [EVSE-LOGIC] EVSE sensing + J1772 pilot/proximity state machine.
- * [BOILERPLATE] Zephyr ADC/GPIO setup and PWM ISR plumbing.
+ * [BOILERPLATE] Zephyr ADC (or adc_stream)/GPIO setup and PWM ISR plumbing.
  * Unique logic: pilot thresholds, session start/end detection, and energy accumulation.
  */
 #include "telemetry/evse.h"
+#include "telemetry/current_sketch.h"
+#include "telemetry/pwm_stats.h"
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+#include "telemetry/pwm_capture.h"
+#endif
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+#include "telemetry/adc_stream.h"
+#endif
+#include "telemetry/telemetry_fixed.h"
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/adc.h>
@@ -18,6 +27,9 @@
 #if defined(CONFIG_ADC_NRFX_SAADC)
 #include <hal/nrf_saadc.h>
 #endif
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+#include <hal/nrf_gpio.h>
+#endif
 
 LOG_MODULE_REGISTER(evse, CONFIG_SIDEWALK_LOG_LEVEL);
 
@@ -34,6 +46,23 @@ LOG_MODULE_REGISTER(evse, CONFIG_SIDEWALK_LOG_LEVEL);
 #define EVSE_PILOT_CH CONFIG_SID_END_DEVICE_EVSE_PILOT_ADC_CHANNEL
 #define EVSE_CURRENT_CH CONFIG_SID_END_DEVICE_EVSE_CURRENT_ADC_CHANNEL
 
+/* [BOILERPLATE] Scans averaged per sample, and each channel's slot in a scan. */
+#define EVSE_ADC_SCANS BIT(CONFIG_SID_END_DEVICE_EVSE_ADC_OVERSAMPLING)
+#define EVSE_ADC_SCAN_CHANNELS (EVSE_PILOT_CH == EVSE_CURRENT_CH ? 1 : 2)
+#define EVSE_ADC_PILOT_IDX (EVSE_PILOT_CH > EVSE_CURRENT_CH ? 1 : 0)
+#define EVSE_ADC_CURRENT_IDX (EVSE_CURRENT_CH > EVSE_PILOT_CH ? 1 : 0)
+
+/* [BOILERPLATE] 2^N conversions of 10 us acquisition + 2 us each, pilot alone. */
+#define EVSE_PILOT_CONV_US (EVSE_ADC_SCANS * 12)
+#define EVSE_PILOT_SETTLE_US CONFIG_SID_END_DEVICE_EVSE_PILOT_SETTLE_US
+#define EVSE_PILOT_TRIES 4
+/* [EVSE-LOGIC] J1772 PWM runs at 1 kHz; other periods count as a steady pilot. */
+#define EVSE_PWM_PERIOD_MIN_US 500
+#define EVSE_PWM_PERIOD_MAX_US 2000
+#define EVSE_PWM_TIMEOUT_MS CONFIG_SID_END_DEVICE_EVSE_PWM_TIMEOUT_MS
+/* [EVSE-LOGIC] Capture registers are sampled into pwm_stats at this interval. */
+#define EVSE_PWM_SAMPLE_MS 8
+
 #define EVSE_PILOT_SCALE_NUM CONFIG_SID_END_DEVICE_EVSE_PILOT_SCALE_NUM
 #define EVSE_PILOT_SCALE_DEN CONFIG_SID_END_DEVICE_EVSE_PILOT_SCALE_DEN
 #define EVSE_PILOT_BIAS_MV CONFIG_SID_END_DEVICE_EVSE_PILOT_BIAS_MV
@@ -44,14 +73,27 @@ LOG_MODULE_REGISTER(evse, CONFIG_SIDEWALK_LOG_LEVEL);
 #define EVSE_NOMINAL_VOLTAGE_V CONFIG_SID_END_DEVICE_EVSE_NOMINAL_VOLTAGE_V
 #define EVSE_PILOT_TOL_MV CONFIG_SID_END_DEVICE_EVSE_PILOT_TOLERANCE_MV
 
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
 static const struct device *adc_dev;
+#endif
 static const struct device *pwm_gpio_dev;
 static const struct device *prox_gpio_dev;
 static struct gpio_callback pwm_cb;
 
-static volatile int64_t pwm_last_rise_us;
-static volatile int64_t pwm_last_high_us;
-static volatile int64_t pwm_last_period_us;
+/* [EVSE-LOGIC] pwm_isr state; single words, so thread reads never tear. */
+static volatile uint32_t pwm_rise_cycles;
+static volatile uint32_t pwm_isr_high_us;
+static volatile bool pwm_rise_seen;
+/* [EVSE-LOGIC] Periods from pwm_isr or the capture sampler; read lock-free. */
+static struct pwm_stats pwm_stats;
+/* [EVSE-LOGIC] Bumped by pwm_isr on every edge; a pilot conversion that saw it move is dropped. */
+static atomic_t pwm_edges;
+/* [EVSE-LOGIC] Hardware capture in use; pwm_isr is only the fallback. */
+static bool pwm_use_capture;
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+static struct k_timer pwm_sample_timer;
+#endif
+static bool pwm_present;
 
 static enum evse_pilot_state last_pilot_state = EVSE_PILOT_UNKNOWN;
 static bool last_prox_state;
@@ -59,13 +101,14 @@ static float energy_kwh;
 static char session_id[37];
 static bool session_active;
 static int64_t last_energy_ts_ms;
+static struct current_sketch session_sketch;
+static struct evse_session_summary session_summary;
 
-static int64_t cycles_to_us(uint32_t cycles)
-{
-	return (int64_t)k_cyc_to_us_floor64(cycles);
-}
-
-/* [BOILERPLATE] Typical ISR to capture PWM edges for duty-cycle calculation. */
+/*
+ * [BOILERPLATE] Typical ISR to capture PWM edges for duty-cycle calculation.
+ * [EVSE-LOGIC] Each rising edge closes a period into pwm_stats; the first
+ * one after a gap longer than EVSE_PWM_TIMEOUT_MS is not a period.
+ */
 static void pwm_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
 	ARG_UNUSED(dev);
@@ -74,19 +117,36 @@ static void pwm_isr(const struct device *dev, struct gpio_callback *cb, uint32_t
 
 	uint32_t now_cycles = k_cycle_get_32();
 	int val = gpio_pin_get(pwm_gpio_dev, EVSE_PWM_PIN);
-	int64_t now_us = cycles_to_us(now_cycles);
+	uint32_t since_rise_us = k_cyc_to_us_floor32(now_cycles - pwm_rise_cycles);
+
+	atomic_inc(&pwm_edges);
 
 	if (val > 0) {
-		if (pwm_last_rise_us > 0) {
-			pwm_last_period_us = now_us - pwm_last_rise_us;
-		}
-		pwm_last_rise_us = now_us;
-	} else {
-		if (pwm_last_rise_us > 0) {
-			pwm_last_high_us = now_us - pwm_last_rise_us;
+		if (pwm_rise_seen && since_rise_us <= EVSE_PWM_TIMEOUT_MS * 1000U) {
+			pwm_stats_record(&pwm_stats, since_rise_us, pwm_isr_high_us,
+					 k_uptime_get_32());
 		}
+		pwm_rise_cycles = now_cycles;
+		pwm_rise_seen = true;
+	} else if (pwm_rise_seen) {
+		pwm_isr_high_us = since_rise_us;
+	}
+}
+
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+/* [EVSE-LOGIC] One captured period into pwm_stats per tick while the PWM runs. */
+static void pwm_sample_handler(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+	uint32_t period;
+	uint32_t high;
+	uint32_t since;
+
+	if (pwm_capture_get(&period, &high, &since) && since < 2 * period) {
+		pwm_stats_record(&pwm_stats, period, high, k_uptime_get_32());
 	}
 }
+#endif
 
 static const struct device *gpio_dev_from_port(int port)
 {
@@ -107,19 +167,52 @@ static void log_gpio_mapping(const char *label, int port, int pin)
 	LOG_INF("%s GPIO: P%d.%02d", label, port, pin);
 }
 
-/* [EVSE-LOGIC] PWM duty cycle is a proxy for requested current. */
+/* [EVSE-LOGIC] Averaged PWM figures; false when no period came in EVSE_PWM_TIMEOUT_MS. */
+static bool pwm_snapshot_get(struct pwm_snapshot *snap)
+{
+	return pwm_stats_read(&pwm_stats, snap) &&
+	       !pwm_snapshot_stale(snap, k_uptime_get_32(), EVSE_PWM_TIMEOUT_MS);
+}
+
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+/* [EVSE-LOGIC] Time since the last rising edge: capture when it runs, else pwm_isr. */
+static bool pwm_since_rise(int64_t *since_us)
+{
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+	if (pwm_use_capture) {
+		uint32_t period;
+		uint32_t high;
+		uint32_t since;
+
+		if (!pwm_capture_get(&period, &high, &since)) {
+			return false;
+		}
+		*since_us = since;
+		return true;
+	}
+#endif
+	if (!pwm_rise_seen) {
+		return false;
+	}
+	*since_us = k_cyc_to_us_floor32(k_cycle_get_32() - pwm_rise_cycles);
+	return true;
+}
+#endif
+
+/* [EVSE-LOGIC] PWM duty cycle is a proxy for requested current; 0 without a PWM. */
 static float pwm_get_duty_cycle(void)
 {
-	int64_t period = pwm_last_period_us;
-	int64_t high = pwm_last_high_us;
-	if (period <= 0 || high <= 0 || high > period) {
+	struct pwm_snapshot snap;
+
+	if (!pwm_snapshot_get(&snap)) {
 		return 0.0f;
 	}
-	return (float)high * 100.0f / (float)period;
+	return (float)pwm_snapshot_duty_permille(&snap) / 10.0f;
 }
 
-/* [BOILERPLATE] Typical ADC channel read helper for Zephyr SAADC. */
-static int adc_read_channel(int channel, int16_t *out)
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+/* [BOILERPLATE] Channel setup, done once at evse_init. */
+static int adc_channel_init(int channel)
 {
 	struct adc_channel_cfg cfg = {
 		.gain = ADC_GAIN,
@@ -131,26 +224,149 @@ static int adc_read_channel(int channel, int16_t *out)
 #if defined(CONFIG_ADC_NRFX_SAADC)
 	cfg.input_positive = NRF_SAADC_INPUT_AIN0 + channel;
 #endif
-	int ret = adc_channel_setup(adc_dev, &cfg);
-	if (ret) {
-		return ret;
-	}
+	return adc_channel_setup(adc_dev, &cfg);
+}
 
-	int16_t buf = 0;
+/*
+ * [BOILERPLATE] Pilot and current in one scan, repeated EVSE_ADC_SCANS times
+ * back to back within a single adc_read and averaged. The SAADC stores the
+ * results of a scan in ascending channel order.
+ */
+static int adc_scan(int16_t *pilot_raw, int16_t *current_raw)
+{
+	int16_t buf[EVSE_ADC_SCANS * EVSE_ADC_SCAN_CHANNELS];
+	const struct adc_sequence_options opts = {
+		.extra_samplings = EVSE_ADC_SCANS - 1,
+	};
 	struct adc_sequence seq = {
-		.channels = BIT(channel),
-		.buffer = &buf,
+		.options = EVSE_ADC_SCANS > 1 ? &opts : NULL,
+		.channels = BIT(EVSE_PILOT_CH) | BIT(EVSE_CURRENT_CH),
+		.buffer = buf,
 		.buffer_size = sizeof(buf),
 		.resolution = ADC_RESOLUTION,
 	};
-	ret = adc_read(adc_dev, &seq);
+	int ret = adc_read(adc_dev, &seq);
 	if (ret) {
 		return ret;
 	}
-	*out = buf;
+
+	int32_t sum[EVSE_ADC_SCAN_CHANNELS] = { 0 };
+	for (size_t i = 0; i < ARRAY_SIZE(buf); i++) {
+		sum[i % EVSE_ADC_SCAN_CHANNELS] += buf[i];
+	}
+	*pilot_raw = (int16_t)(sum[EVSE_ADC_PILOT_IDX] / EVSE_ADC_SCANS);
+	*current_raw = (int16_t)(sum[EVSE_ADC_CURRENT_IDX] / EVSE_ADC_SCANS);
 	return 0;
 }
 
+/* [BOILERPLATE] Pilot alone, hardware-averaged, short enough for one PWM plateau. */
+static int adc_read_pilot(int16_t *raw)
+{
+	struct adc_sequence seq = {
+		.channels = BIT(EVSE_PILOT_CH),
+		.buffer = raw,
+		.buffer_size = sizeof(*raw),
+		.resolution = ADC_RESOLUTION,
+		.oversampling = CONFIG_SID_END_DEVICE_EVSE_ADC_OVERSAMPLING,
+	};
+	return adc_read(adc_dev, &seq);
+}
+#endif
+
+/* [EVSE-LOGIC] Averaged period and high time of a running PWM; false for a steady pilot. */
+static bool pwm_running(int64_t *period_us, int64_t *high_us)
+{
+	struct pwm_snapshot snap;
+
+	if (!pwm_snapshot_get(&snap) || snap.avg_period_us < EVSE_PWM_PERIOD_MIN_US ||
+	    snap.avg_period_us > EVSE_PWM_PERIOD_MAX_US || snap.avg_high_us == 0 ||
+	    snap.avg_high_us >= snap.avg_period_us) {
+		return false;
+	}
+	*period_us = snap.avg_period_us;
+	*high_us = snap.avg_high_us;
+	return true;
+}
+
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+/* [EVSE-LOGIC] Position within the PWM period, 0 at the rising edge. */
+static int64_t pwm_phase(int64_t period_us, int64_t since_us)
+{
+	int64_t phase = since_us % period_us;
+
+	return phase < 0 ? phase + period_us : phase;
+}
+
+/*
+ * [EVSE-LOGIC] True when no PWM edge came after `edges` and `since_before`
+ * were taken. pwm_isr counts edges, but with capture it is not installed;
+ * the capture timer tells instead: it restarts on every rise (the time since
+ * the rise went back) and latches each fall into the high time (on the high
+ * plateau, the time since the rise reached it).
+ */
+static bool pwm_no_edge_since(atomic_val_t edges, int64_t since_before, bool high)
+{
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+	if (pwm_use_capture) {
+		uint32_t period;
+		uint32_t high_us;
+		uint32_t since;
+
+		if (!pwm_capture_get(&period, &high_us, &since)) {
+			return false;
+		}
+		return since >= since_before && (!high || since < high_us);
+	}
+#else
+	ARG_UNUSED(since_before);
+	ARG_UNUSED(high);
+#endif
+	return atomic_get(&pwm_edges) == edges;
+}
+
+/*
+ * [EVSE-LOGIC] Read the pilot on one PWM plateau: start EVSE_PILOT_SETTLE_US
+ * after the edge that opens it (timed from the last rising edge), and keep
+ * the result only if the conversion stayed on that plateau: no edge seen
+ * (pwm_no_edge_since), and a phase that only moved forward inside it.
+ * Returns -EAGAIN when every try was cut by an edge.
+ */
+static int pilot_read_plateau(bool high, int64_t period_us, int64_t high_us, int16_t *raw)
+{
+	int64_t open = (high ? 0 : high_us) + EVSE_PILOT_SETTLE_US;
+	int64_t end = high ? high_us : period_us;
+	int64_t close = MAX(open, end - EVSE_PILOT_CONV_US);
+
+	for (int i = 0; i < EVSE_PILOT_TRIES; i++) {
+		atomic_val_t edges = atomic_get(&pwm_edges);
+		int64_t since;
+		int64_t before;
+		int64_t after;
+
+		if (!pwm_since_rise(&since)) {
+			return -EAGAIN;
+		}
+		before = pwm_phase(period_us, since);
+		if (before < open || before > close) {
+			k_busy_wait((uint32_t)((open - before + period_us) % period_us));
+			continue;
+		}
+		int ret = adc_read_pilot(raw);
+		if (ret) {
+			return ret;
+		}
+		if (!pwm_no_edge_since(edges, since, high) || !pwm_since_rise(&since)) {
+			continue;
+		}
+		after = pwm_phase(period_us, since);
+		if (after >= before && after < end) {
+			return 0;
+		}
+	}
+	return -EAGAIN;
+}
+#endif
+
 /* [BOILERPLATE] Common raw ADC conversion helper. */
 static int adc_raw_to_mv(int16_t raw)
 {
@@ -160,30 +376,105 @@ static int adc_raw_to_mv(int16_t raw)
 }
 
 /* [EVSE-LOGIC] Pilot voltage with scaling/bias to recover J1772 levels. */
-static int pilot_mv_from_adc(void)
+static int pilot_mv_from_raw(int16_t raw)
 {
-	int16_t raw = 0;
-	if (adc_read_channel(EVSE_PILOT_CH, &raw)) {
-		return 0;
-	}
 	int mv = adc_raw_to_mv(raw);
 	/* scale and remove bias to recover negative range */
 	int scaled = (mv * EVSE_PILOT_SCALE_NUM) / EVSE_PILOT_SCALE_DEN;
 	return scaled - EVSE_PILOT_BIAS_MV;
 }
 
-/* [EVSE-LOGIC] Current sensor scaling for energy estimation. */
-static float current_a_from_adc(void)
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+/* [EVSE-LOGIC] Current sensor scaling, in mA, for an RMS in 1/16 LSB. */
+static int32_t current_ma_from_rms_x16(uint32_t rms_x16)
 {
-	int16_t raw = 0;
-	if (adc_read_channel(EVSE_CURRENT_CH, &raw)) {
-		return 0.0f;
+	int32_t mv_x16 = (int32_t)rms_x16;
+
+	(void)adc_raw_to_millivolts(ADC_REFERENCE, ADC_GAIN, ADC_RESOLUTION, &mv_x16);
+	return (int32_t)((int64_t)mv_x16 * EVSE_CURRENT_SCALE_NUM / EVSE_CURRENT_SCALE_DEN / 16);
+}
+
+/*
+ * [EVSE-LOGIC] Latest stream block: current is its RMS over whole line
+ * cycles; the pilot is its plateau means while the PWM runs, else its mean.
+ * Nothing here waits on the ADC. -EAGAIN before the first block, or when the
+ * block held no clean sample of a plateau.
+ */
+static int evse_sample(int *high_mv, int *low_mv, float *current_a)
+{
+	struct pilot_plateau pilot;
+	uint32_t rms_x16;
+	int64_t period_us;
+	int64_t pwm_high_us;
+
+	*high_mv = 0;
+	*low_mv = 0;
+	*current_a = 0.0f;
+	if (!adc_stream_rms_x16(ADC_STREAM_CURRENT, &rms_x16) || !adc_stream_pilot(&pilot)) {
+		return -EAGAIN;
 	}
+	*current_a = (float)current_ma_from_rms_x16(rms_x16) / 1000.0f;
+	*high_mv = pilot_mv_from_raw(pilot.mean);
+	*low_mv = *high_mv;
+	if (!pwm_running(&period_us, &pwm_high_us)) {
+		return 0;
+	}
+	if (pilot.high_n == 0 || pilot.low_n == 0) {
+		return -EAGAIN;
+	}
+	*high_mv = pilot_mv_from_raw(pilot.high);
+	*low_mv = pilot_mv_from_raw(pilot.low);
+	return 0;
+}
+#else
+/* [EVSE-LOGIC] Current sensor scaling for energy estimation. */
+static float current_a_from_raw(int16_t raw)
+{
 	int mv = adc_raw_to_mv(raw);
 	int scaled = (mv * EVSE_CURRENT_SCALE_NUM) / EVSE_CURRENT_SCALE_DEN;
 	return (float)scaled / 1000.0f;
 }
 
+/*
+ * [EVSE-LOGIC] One scan for both inputs. While the PWM runs, the scan's pilot
+ * value lands on a random phase, so the pilot is read again on each plateau.
+ * Current is 0 A when the scan fails; the pilot is only valid on success.
+ */
+static int evse_sample(int *high_mv, int *low_mv, float *current_a)
+{
+	int16_t pilot_raw;
+	int16_t current_raw;
+	int64_t period_us;
+	int64_t pwm_high_us;
+
+	*high_mv = 0;
+	*low_mv = 0;
+	*current_a = 0.0f;
+	int ret = adc_scan(&pilot_raw, &current_raw);
+	if (ret) {
+		return ret;
+	}
+	*current_a = current_a_from_raw(current_raw);
+	*high_mv = pilot_mv_from_raw(pilot_raw);
+	*low_mv = *high_mv;
+	if (!pwm_running(&period_us, &pwm_high_us)) {
+		return 0;
+	}
+
+	ret = pilot_read_plateau(true, period_us, pwm_high_us, &pilot_raw);
+	if (ret) {
+		return ret;
+	}
+	*high_mv = pilot_mv_from_raw(pilot_raw);
+	ret = pilot_read_plateau(false, period_us, pwm_high_us, &pilot_raw);
+	if (ret) {
+		return ret;
+	}
+	*low_mv = pilot_mv_from_raw(pilot_raw);
+	return 0;
+}
+#endif
+
 /* [EVSE-LOGIC] Map pilot millivolts to J1772 states with tolerance band. */
 static enum evse_pilot_state pilot_state_from_mv(int mv)
 {
@@ -205,24 +496,18 @@ static enum evse_pilot_state pilot_state_from_mv(int mv)
 	return EVSE_PILOT_F;
 }
 
-char evse_pilot_state_to_char(enum evse_pilot_state state)
+/* [EVSE-LOGIC] Freeze the session's current distribution for the session_end record. */
+static const struct evse_session_summary *session_summary_close(void)
 {
-	switch (state) {
-	case EVSE_PILOT_A:
-		return 'A';
-	case EVSE_PILOT_B:
-		return 'B';
-	case EVSE_PILOT_C:
-		return 'C';
-	case EVSE_PILOT_D:
-		return 'D';
-	case EVSE_PILOT_E:
-		return 'E';
-	case EVSE_PILOT_F:
-		return 'F';
-	default:
-		return '?';
-	}
+	session_summary.session_id = session_id;
+	session_summary.samples = (int)MIN(session_sketch.samples, (uint32_t)INT32_MAX);
+	session_summary.current_p50_a =
+		(float)current_sketch_quantile(&session_sketch, 500) / 1000.0f;
+	session_summary.current_p95_a =
+		(float)current_sketch_quantile(&session_sketch, 950) / 1000.0f;
+	session_summary.current_max_a = (float)session_sketch.max_ma / 1000.0f;
+	session_summary.energy_kwh = energy_kwh;
+	return &session_summary;
 }
 
 static void session_id_new(void)
@@ -247,11 +532,18 @@ static void session_id_new(void)
 
 int evse_init(void)
 {
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	if (adc_stream_init()) {
+		LOG_ERR("ADC not ready");
+		return -ENODEV;
+	}
+#else
 	adc_dev = DEVICE_DT_GET_ANY(nordic_nrf_saadc);
 	if (!adc_dev || !device_is_ready(adc_dev)) {
 		LOG_ERR("ADC not ready");
 		return -ENODEV;
 	}
+#endif
 
 	pwm_gpio_dev = gpio_dev_from_port(EVSE_PWM_PORT);
 	prox_gpio_dev = gpio_dev_from_port(EVSE_PROX_PORT);
@@ -263,16 +555,50 @@ int evse_init(void)
 
 	log_gpio_mapping("EVSE PWM", EVSE_PWM_PORT, EVSE_PWM_PIN);
 	log_gpio_mapping("EVSE PROX", EVSE_PROX_PORT, EVSE_PROX_PIN);
-	LOG_INF("EVSE ADC channels: pilot=%d current=%d", EVSE_PILOT_CH, EVSE_CURRENT_CH);
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	LOG_INF("EVSE ADC channels: pilot=%d current=%d, streamed", EVSE_PILOT_CH,
+		EVSE_CURRENT_CH);
+#else
+	LOG_INF("EVSE ADC channels: pilot=%d current=%d, %u scan(s) per sample", EVSE_PILOT_CH,
+		EVSE_CURRENT_CH, (unsigned int)EVSE_ADC_SCANS);
+	if (adc_channel_init(EVSE_PILOT_CH) ||
+	    (EVSE_CURRENT_CH != EVSE_PILOT_CH && adc_channel_init(EVSE_CURRENT_CH))) {
+		LOG_ERR("ADC channel setup failed");
+		return -EINVAL;
+	}
+#endif
 
 	if (gpio_pin_configure(pwm_gpio_dev, EVSE_PWM_PIN, GPIO_INPUT)) {
 		return -EINVAL;
 	}
-	if (gpio_pin_interrupt_configure(pwm_gpio_dev, EVSE_PWM_PIN, GPIO_INT_EDGE_BOTH)) {
-		return -EINVAL;
+	pwm_stats_init(&pwm_stats);
+	pwm_present = false;
+#if defined(CONFIG_SID_END_DEVICE_EVSE_PWM_CAPTURE)
+	int err = pwm_capture_init(NRF_GPIO_PIN_MAP(EVSE_PWM_PORT, EVSE_PWM_PIN));
+
+	pwm_use_capture = err == 0;
+	if (err) {
+		LOG_WRN("PWM capture unavailable (err %d); using the edge ISR", err);
+	} else {
+		k_timer_init(&pwm_sample_timer, pwm_sample_handler, NULL);
+		k_timer_start(&pwm_sample_timer, K_MSEC(EVSE_PWM_SAMPLE_MS),
+			      K_MSEC(EVSE_PWM_SAMPLE_MS));
+	}
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	/* [EVSE-LOGIC] Stamp the PWM phase at each block end, so pilot samples are placed by it. */
+	if (pwm_use_capture && !pwm_capture_stamp_link(adc_stream_end_event())) {
+		adc_stream_pilot_stamped();
+	}
+#endif
+#endif
+	if (!pwm_use_capture) {
+		if (gpio_pin_interrupt_configure(pwm_gpio_dev, EVSE_PWM_PIN,
+						 GPIO_INT_EDGE_BOTH)) {
+			return -EINVAL;
+		}
+		gpio_init_callback(&pwm_cb, pwm_isr, BIT(EVSE_PWM_PIN));
+		gpio_add_callback(pwm_gpio_dev, &pwm_cb);
 	}
-	gpio_init_callback(&pwm_cb, pwm_isr, BIT(EVSE_PWM_PIN));
-	gpio_add_callback(pwm_gpio_dev, &pwm_cb);
 
 	if (gpio_pin_configure(prox_gpio_dev, EVSE_PROX_PIN, GPIO_INPUT)) {
 		return -EINVAL;
@@ -283,6 +609,7 @@ int evse_init(void)
 	energy_kwh = 0.0f;
 	session_active = false;
 	last_energy_ts_ms = 0;
+	current_sketch_reset(&session_sketch);
 	memset(session_id, 0, sizeof(session_id));
 	return 0;
 }
@@ -294,11 +621,39 @@ bool evse_poll(struct evse_event *evt, int64_t timestamp_ms)
 	}
 
 	/* [EVSE-LOGIC] Snapshot of pilot/proximity/current for this sample. */
-	int pilot_mv = pilot_mv_from_adc();
-	enum evse_pilot_state state = pilot_state_from_mv(pilot_mv);
+	int pilot_mv;
+	int pilot_low_mv;
+	float current_a;
+	/* [EVSE-LOGIC] Without a clean plateau reading the pilot state is held. */
+	enum evse_pilot_state state = last_pilot_state;
+	if (!evse_sample(&pilot_mv, &pilot_low_mv, &current_a)) {
+		state = pilot_state_from_mv(pilot_mv);
+	}
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	/* [EVSE-LOGIC] Every block since the last poll, so energy covers the whole interval. */
+	uint32_t rms_x16;
+
+	if (adc_stream_rms_mean_x16(ADC_STREAM_CURRENT, &rms_x16)) {
+		current_a = (float)current_ma_from_rms_x16(rms_x16) / 1000.0f;
+	}
+#endif
 	bool prox = gpio_pin_get(prox_gpio_dev, EVSE_PROX_PIN) > 0;
-	float current_a = current_a_from_adc();
 	float duty = pwm_get_duty_cycle();
+	struct pwm_snapshot pwm;
+	bool present = pwm_snapshot_get(&pwm);
+
+	/* [EVSE-LOGIC] PWM start/stop (EVSE offering or withdrawing current). */
+	if (present != pwm_present) {
+		pwm_present = present;
+		if (present) {
+			LOG_INF("Pilot PWM: %u.%u%% duty, high %u..%u us over %u periods",
+				pwm_snapshot_duty_permille(&pwm) / 10,
+				pwm_snapshot_duty_permille(&pwm) % 10, pwm.min_high_us,
+				pwm.max_high_us, MIN(pwm.periods, (uint32_t)PWM_STATS_WINDOW));
+		} else {
+			LOG_INF("Pilot PWM: none for %d ms", EVSE_PWM_TIMEOUT_MS);
+		}
+	}
 
 	/* [EVSE-LOGIC] Energy accumulation only while charging. */
 	if (last_energy_ts_ms > 0 && (state == EVSE_PILOT_C || state == EVSE_PILOT_D)) {
@@ -318,21 +673,32 @@ bool evse_poll(struct evse_event *evt, int64_t timestamp_ms)
 	evt->energy_kwh = energy_kwh;
 	evt->session_id = session_id[0] ? session_id : NULL;
 	evt->event_type = "state_change";
+	evt->summary = NULL;
 
 	/* [EVSE-LOGIC] Session boundaries are defined by pilot transitions. */
 	if (state != last_pilot_state || prox != last_prox_state) {
 		evt->send = true;
+		LOG_DBG("Pilot %c: high %d mV, low %d mV", evse_pilot_state_to_char(state),
+			pilot_mv, pilot_low_mv);
 		if (last_pilot_state == EVSE_PILOT_A && state == EVSE_PILOT_B) {
 			session_id_new();
 			session_active = true;
 			energy_kwh = 0.0f;
+			current_sketch_reset(&session_sketch);
 			evt->event_type = "session_start";
 		} else if (session_active && state == EVSE_PILOT_A) {
 			evt->event_type = "session_end";
+			evt->summary = session_summary_close();
 			session_active = false;
 		}
 	}
 
+	/* [EVSE-LOGIC] Every in-session sample feeds the distribution, idle B included. */
+	if (session_active) {
+		current_sketch_add(&session_sketch,
+				   (int32_t)telemetry_fixed_from_float(current_a, 1000));
+	}
+
 	last_pilot_state = state;
 	last_prox_state = prox;
 	return evt->send;
@@ -340,13 +706,17 @@ bool evse_poll(struct evse_event *evt, int64_t timestamp_ms)
 
 int evse_read_raw(struct evse_raw *raw)
 {
-	if (!raw || !adc_dev || !pwm_gpio_dev || !prox_gpio_dev) {
+	if (!raw || !pwm_gpio_dev || !prox_gpio_dev) {
 		return -EINVAL;
 	}
-	raw->pilot_mv = pilot_mv_from_adc();
-	raw->pilot_state = pilot_state_from_mv(raw->pilot_mv);
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	if (!adc_dev) {
+		return -EINVAL;
+	}
+#endif
+	int ret = evse_sample(&raw->pilot_mv, &raw->pilot_low_mv, &raw->current_draw_a);
+	raw->pilot_state = ret ? EVSE_PILOT_UNKNOWN : pilot_state_from_mv(raw->pilot_mv);
 	raw->proximity_detected = gpio_pin_get(prox_gpio_dev, EVSE_PROX_PIN) > 0;
 	raw->pwm_duty_cycle = pwm_get_duty_cycle();
-	raw->current_draw_a = current_a_from_adc();
-	return 0;
+	return ret;
 }
@@ -20,6 +20,16 @@ enum evse_pilot_state {
 	EVSE_PILOT_UNKNOWN,
 };
 
+/* [EVSE-LOGIC] Session summary sent with session_end (see current_sketch.h). */
+struct evse_session_summary {
+	const char *session_id;
+	int samples;
+	float current_p50_a;
+	float current_p95_a;
+	float current_max_a;
+	float energy_kwh;
+};
+
 struct evse_event {
 	bool send;
 	enum evse_pilot_state pilot_state;
@@ -29,6 +39,8 @@ struct evse_event {
 	float energy_kwh;
 	const char *event_type;
 	const char *session_id;
+	/* Set only on session_end; valid until the next evse_poll(). */
+	const struct evse_session_summary *summary;
 };
 
 struct evse_raw {
@@ -36,12 +48,24 @@ struct evse_raw {
 	bool proximity_detected;
 	float pwm_duty_cycle;
 	float current_draw_a;
+	/* High plateau while the PWM runs; the low plateau is reported separately. */
 	int pilot_mv;
+	int pilot_low_mv;
 };
 
 int evse_init(void);
 bool evse_poll(struct evse_event *evt, int64_t timestamp_ms);
 int evse_read_raw(struct evse_raw *raw);
-char evse_pilot_state_to_char(enum evse_pilot_state state);
+
+/* [EVSE-LOGIC] J1772 state letter; shared by logging and telemetry encoders. */
+static inline char evse_pilot_state_to_char(enum evse_pilot_state state)
+{
+	return (unsigned int)state < EVSE_PILOT_UNKNOWN ? (char)('A' + (int)state) : '?';
+}
+
+static inline enum evse_pilot_state evse_pilot_state_from_char(char c)
+{
+	return (c >= 'A' && c <= 'F') ? (enum evse_pilot_state)(c - 'A') : EVSE_PILOT_UNKNOWN;
+}
 
 #endif /* EVSE_H */
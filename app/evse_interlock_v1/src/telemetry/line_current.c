@@ -3,6 +3,9 @@
  * [BOILERPLATE] Zephyr ADC configuration for SAADC.
  */
 #include "telemetry/line_current.h"
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+#include "telemetry/adc_stream.h"
+#endif
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/adc.h>
@@ -25,10 +28,33 @@ LOG_MODULE_REGISTER(line_current, CONFIG_SIDEWALK_LOG_LEVEL);
 #define LINE_CURRENT_SCALE_DEN CONFIG_SID_END_DEVICE_LINE_CURRENT_SCALE_DEN
 #define LINE_CURRENT_DELTA_MA CONFIG_SID_END_DEVICE_LINE_CURRENT_DELTA_MA
 
+#if !defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
 static const struct device *adc_dev;
+#endif
 static float last_current_a;
 static bool current_initialized;
 
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+/*
+ * [LINE-CURRENT] Mean RMS of the stream blocks since the last poll (whole
+ * line cycles, CT bias removed), with the single-read scaling.
+ */
+static bool line_current_read_a(float *out)
+{
+	uint32_t rms_x16;
+
+	if (!adc_stream_rms_mean_x16(ADC_STREAM_LINE, &rms_x16)) {
+		return false;
+	}
+	int32_t mv_x16 = (int32_t)rms_x16;
+
+	(void)adc_raw_to_millivolts(ADC_REFERENCE, ADC_GAIN, ADC_RESOLUTION, &mv_x16);
+	int64_t ma = (int64_t)mv_x16 * LINE_CURRENT_SCALE_NUM / LINE_CURRENT_SCALE_DEN / 16;
+
+	*out = (float)ma / 1000.0f;
+	return true;
+}
+#else
 static int adc_read_channel(int channel, int16_t *out)
 {
 	struct adc_channel_cfg cfg = {
@@ -79,14 +105,22 @@ static bool line_current_read_a(float *out)
 	*out = (float)scaled / 1000.0f;
 	return true;
 }
+#endif
 
 int line_current_init(void)
 {
+#if defined(CONFIG_SID_END_DEVICE_ADC_STREAM)
+	if (adc_stream_init()) {
+		LOG_ERR("ADC not ready");
+		return -ENODEV;
+	}
+#else
 	adc_dev = DEVICE_DT_GET_ANY(nordic_nrf_saadc);
 	if (!adc_dev || !device_is_ready(adc_dev)) {
 		LOG_ERR("ADC not ready");
 		return -ENODEV;
 	}
+#endif
 
 	LOG_INF("Line current ADC channel: %d", LINE_CURRENT_CH);
 	last_current_a = 0.0f;
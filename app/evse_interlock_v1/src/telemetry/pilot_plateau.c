@@ -0,0 +1,108 @@
+/*
+ * [EVSE-LOGIC] Pilot plateaus from stream samples (see pilot_plateau.h).
+ */
+#include "telemetry/pilot_plateau.h"
+
+#include <string.h>
+
+/* [BOILERPLATE] Mean rounded to nearest; 0 for no samples. */
+static int16_t mean_of(int64_t sum, uint32_t n)
+{
+	if (n == 0) {
+		return 0;
+	}
+	int64_t half = sum < 0 ? -(int64_t)(n / 2) : (int64_t)(n / 2);
+
+	return (int16_t)((sum + half) / (int64_t)n);
+}
+
+void pilot_plateau_timed(const int16_t *samples, size_t n, size_t stride,
+			 const struct pilot_plateau_timing *t, struct pilot_plateau *out)
+{
+	int64_t sum_high = 0;
+	int64_t sum_low = 0;
+	int64_t sum = 0;
+	uint32_t high_n = 0;
+	uint32_t low_n = 0;
+	uint32_t all = 0;
+	int64_t period = t->period_us;
+
+	memset(out, 0, sizeof(*out));
+	if (period == 0 || t->high_us == 0 || t->high_us >= t->period_us) {
+		return;
+	}
+	/* Newest first, until the window is used up. */
+	for (size_t i = n; i-- > 0;) {
+		uint64_t age = (uint64_t)(n - 1 - i) * t->interval_us + t->age_us;
+
+		if (age > t->window_us) {
+			break;
+		}
+		int64_t phase = ((int64_t)t->since_us - (int64_t)age) % period;
+
+		if (phase < 0) {
+			phase += period;
+		}
+		int32_t x = samples[i * stride];
+
+		sum += x;
+		all++;
+		if (phase >= t->settle_us && phase + t->conv_us <= t->high_us) {
+			sum_high += x;
+			high_n++;
+		} else if (phase >= (int64_t)t->high_us + t->settle_us &&
+			   phase + t->conv_us <= period) {
+			sum_low += x;
+			low_n++;
+		}
+	}
+	out->high = mean_of(sum_high, high_n);
+	out->low = mean_of(sum_low, low_n);
+	out->high_n = (uint16_t)(high_n > UINT16_MAX ? UINT16_MAX : high_n);
+	out->low_n = (uint16_t)(low_n > UINT16_MAX ? UINT16_MAX : low_n);
+	out->mean = mean_of(sum, all);
+}
+
+void pilot_plateau_levels(const int16_t *samples, size_t n, size_t stride, size_t last,
+			  struct pilot_plateau *out)
+{
+	size_t first = last < n ? n - last : 0;
+	int32_t lo = INT16_MAX;
+	int32_t hi = INT16_MIN;
+	int64_t sum_high = 0;
+	int64_t sum_low = 0;
+	int64_t sum = 0;
+	uint32_t high_n = 0;
+	uint32_t low_n = 0;
+
+	memset(out, 0, sizeof(*out));
+	if (first >= n) {
+		return;
+	}
+	for (size_t i = first; i < n; i++) {
+		int32_t x = samples[i * stride];
+
+		lo = x < lo ? x : lo;
+		hi = x > hi ? x : hi;
+		sum += x;
+	}
+	int32_t mid = lo + (hi - lo) / 2;
+	int32_t guard = (hi - lo) / 8;
+
+	for (size_t i = first; i < n; i++) {
+		int32_t x = samples[i * stride];
+
+		if (x > mid + guard) {
+			sum_high += x;
+			high_n++;
+		} else if (x < mid - guard) {
+			sum_low += x;
+			low_n++;
+		}
+	}
+	out->high = mean_of(sum_high, high_n);
+	out->low = mean_of(sum_low, low_n);
+	out->high_n = (uint16_t)(high_n > UINT16_MAX ? UINT16_MAX : high_n);
+	out->low_n = (uint16_t)(low_n > UINT16_MAX ? UINT16_MAX : low_n);
+	out->mean = mean_of(sum, (uint32_t)(n - first));
+}
@@ -0,0 +1,60 @@
+/*
+ * [EVSE-LOGIC] J1772 pilot plateaus from a block of stream samples.
+ * Pure C, no Zephyr deps; integer only.
+ *
+ * The pilot is one input of a scan paced at a fixed interval, so the last
+ * sample of a block was taken a known time before the block ended. With the
+ * time since the PWM rise stamped at that moment, every sample's phase in
+ * the period is known, and only samples taken EVSE_PILOT_SETTLE_US after the
+ * edge that opens a plateau and ending before the next edge count towards
+ * it. Without a stamp the samples are split by level instead.
+ */
+#ifndef PILOT_PLATEAU_H
+#define PILOT_PLATEAU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* [EVSE-LOGIC] Where the pilot conversions of a block sat in the PWM period. */
+struct pilot_plateau_timing {
+	/* Between scans. */
+	uint32_t interval_us;
+	/* From the start of the last pilot conversion to the stamp. */
+	uint32_t age_us;
+	/* Time since the last PWM rise, at the stamp. */
+	uint32_t since_us;
+	uint32_t period_us;
+	uint32_t high_us;
+	uint32_t settle_us;
+	/* One conversion, acquisition included. */
+	uint32_t conv_us;
+	/* Only conversions this close to the stamp; period drift adds up. */
+	uint32_t window_us;
+};
+
+struct pilot_plateau {
+	/* Means in ADC counts; valid when the matching count is non-zero. */
+	int16_t high;
+	int16_t low;
+	uint16_t high_n;
+	uint16_t low_n;
+	/* Mean of every sample looked at: the level of a steady pilot. */
+	int16_t mean;
+};
+
+/*
+ * [EVSE-LOGIC] Plateau means of samples[0], samples[stride], ... (n of them,
+ * oldest first), by their phase in the PWM period.
+ */
+void pilot_plateau_timed(const int16_t *samples, size_t n, size_t stride,
+			 const struct pilot_plateau_timing *t, struct pilot_plateau *out);
+
+/*
+ * [EVSE-LOGIC] Plateau means of the last `last` of n samples, split about the
+ * midpoint of their range; samples within an eighth of the range of the
+ * midpoint are edges and are left out.
+ */
+void pilot_plateau_levels(const int16_t *samples, size_t n, size_t stride, size_t last,
+			  struct pilot_plateau *out);
+
+#endif /* PILOT_PLATEAU_H */
@@ -0,0 +1,204 @@
+/*
+ * [EVSE-LOGIC] Pilot PWM capture (see pwm_capture.h).
+ * [3P-GLUE] nrfx TIMER/GPIOTE/GPPI wiring for nRF52.
+ */
+#include "telemetry/pwm_capture.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <hal/nrf_gpio.h>
+#include <helpers/nrfx_gppi.h>
+#include <nrfx_gpiote.h>
+#include <nrfx_timer.h>
+#include <errno.h>
+
+LOG_MODULE_DECLARE(evse);
+
+#define PWM_CAPTURE_HZ 1000000
+/* [EVSE-LOGIC] Reads this close to the fall say nothing about the edge order. */
+#define PWM_CAPTURE_MARGIN_US 20
+#define PWM_CAPTURE_SWAP_LIMIT 2
+
+static const nrfx_timer_t pwm_timer = NRFX_TIMER_INSTANCE(2);
+static const nrfx_gpiote_t pwm_gpiote = NRFX_GPIOTE_INSTANCE(0);
+static uint32_t pwm_pin;
+static nrfx_gppi_channel_group_t pwm_group_rise;
+static nrfx_gppi_channel_group_t pwm_group_fall;
+static uint8_t pwm_swaps;
+
+/* [3P-GLUE] No timer interrupts are enabled; nrfx still wants a handler. */
+static void pwm_timer_handler(nrf_timer_event_t event, void *ctx)
+{
+	ARG_UNUSED(event);
+	ARG_UNUSED(ctx);
+}
+
+static uint32_t pwm_group_task(nrfx_gppi_channel_group_t group, bool enable)
+{
+	return nrfx_gppi_task_address_get(enable ? nrfx_gppi_group_enable_task_get(group) :
+						   nrfx_gppi_group_disable_task_get(group));
+}
+
+/* [3P-GLUE] One PPI channel eep -> tep (+ fork), member of group. */
+static int pwm_capture_link(uint32_t eep, uint32_t tep, uint32_t fork,
+			    nrfx_gppi_channel_group_t group)
+{
+	uint8_t ch;
+
+	if (nrfx_gppi_channel_alloc(&ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+	nrfx_gppi_channel_endpoints_setup(ch, eep, tep);
+	if (fork) {
+		nrfx_gppi_fork_endpoint_setup(ch, fork);
+	}
+	nrfx_gppi_channels_include_in_group(BIT(ch), group);
+	return 0;
+}
+
+/* [EVSE-LOGIC] Arm the group for whichever edge comes next; stale captures are dropped. */
+static void pwm_capture_arm(void)
+{
+	nrfx_gppi_group_disable(pwm_group_rise);
+	nrfx_gppi_group_disable(pwm_group_fall);
+	nrf_timer_cc_set(pwm_timer.p_reg, NRF_TIMER_CC_CHANNEL0, 0);
+	nrf_timer_cc_set(pwm_timer.p_reg, NRF_TIMER_CC_CHANNEL1, 0);
+
+	unsigned int key = irq_lock();
+
+	nrfx_gppi_group_enable(nrf_gpio_pin_read(pwm_pin) ? pwm_group_fall : pwm_group_rise);
+	irq_unlock(key);
+	pwm_swaps = 0;
+}
+
+static int pwm_capture_ppi_init(uint32_t in_event)
+{
+	uint32_t capture_rise = nrfx_timer_task_address_get(&pwm_timer, NRF_TIMER_TASK_CAPTURE0);
+	uint32_t capture_fall = nrfx_timer_task_address_get(&pwm_timer, NRF_TIMER_TASK_CAPTURE1);
+	uint32_t clear = nrfx_timer_task_address_get(&pwm_timer, NRF_TIMER_TASK_CLEAR);
+
+	if (nrfx_gppi_group_alloc(&pwm_group_rise) != NRFX_SUCCESS ||
+	    nrfx_gppi_group_alloc(&pwm_group_fall) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+	/* Rising edge: period into CC[0], restart the count, hand over to the fall group. */
+	int err = pwm_capture_link(in_event, capture_rise, clear, pwm_group_rise);
+	if (!err) {
+		err = pwm_capture_link(in_event, pwm_group_task(pwm_group_rise, false),
+				       pwm_group_task(pwm_group_fall, true), pwm_group_rise);
+	}
+	/* Falling edge: high time into CC[1], hand back to the rise group. */
+	if (!err) {
+		err = pwm_capture_link(in_event, capture_fall, 0, pwm_group_fall);
+	}
+	if (!err) {
+		err = pwm_capture_link(in_event, pwm_group_task(pwm_group_fall, false),
+				       pwm_group_task(pwm_group_rise, true), pwm_group_fall);
+	}
+	return err;
+}
+
+int pwm_capture_init(uint32_t pin)
+{
+	nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG(PWM_CAPTURE_HZ);
+	uint8_t in_ch;
+
+	timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+	if (nrfx_timer_init(&pwm_timer, &timer_cfg, pwm_timer_handler) != NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+	if (nrfx_gpiote_channel_alloc(&pwm_gpiote, &in_ch) != NRFX_SUCCESS) {
+		nrfx_timer_uninit(&pwm_timer);
+		return -ENOMEM;
+	}
+
+	const nrf_gpio_pin_pull_t pull = NRF_GPIO_PIN_NOPULL;
+	const nrfx_gpiote_trigger_config_t trigger = {
+		.trigger = NRFX_GPIOTE_TRIGGER_TOGGLE,
+		.p_in_channel = &in_ch,
+	};
+	const nrfx_gpiote_input_pin_config_t in_cfg = {
+		.p_pull_config = &pull,
+		.p_trigger_config = &trigger,
+	};
+	int err = -EIO;
+
+	if (nrfx_gpiote_input_configure(&pwm_gpiote, pin, &in_cfg) == NRFX_SUCCESS) {
+		err = pwm_capture_ppi_init(nrfx_gpiote_in_event_address_get(&pwm_gpiote, pin));
+		if (err) {
+			/* [3P-GLUE] Hand the pin back so the edge ISR can take over. */
+			(void)nrfx_gpiote_pin_uninit(&pwm_gpiote, pin);
+		}
+	}
+	if (err) {
+		(void)nrfx_gpiote_channel_free(&pwm_gpiote, in_ch);
+		nrfx_timer_uninit(&pwm_timer);
+		return err;
+	}
+
+	pwm_pin = pin;
+	nrfx_gpiote_trigger_enable(&pwm_gpiote, pin, false);
+	nrfx_timer_enable(&pwm_timer);
+	pwm_capture_arm();
+	return 0;
+}
+
+bool pwm_capture_get(uint32_t *period_us, uint32_t *high_us, uint32_t *since_rise_us)
+{
+	uint32_t since = nrfx_timer_capture(&pwm_timer, NRF_TIMER_CC_CHANNEL2);
+	bool level = nrf_gpio_pin_read(pwm_pin);
+	uint32_t period = nrfx_timer_capture_get(&pwm_timer, NRF_TIMER_CC_CHANNEL0);
+	uint32_t high = nrfx_timer_capture_get(&pwm_timer, NRF_TIMER_CC_CHANNEL1);
+
+	if (period == 0 || high == 0 || high >= period) {
+		return false;
+	}
+	/*
+	 * [EVSE-LOGIC] With the groups in step the pin is high exactly until
+	 * `high` after the rise. Swapped groups capture the low time instead and
+	 * fail this; two such reads in a row re-arm from the pin level.
+	 */
+	if (since < period && (since + PWM_CAPTURE_MARGIN_US < high ||
+			       since > high + PWM_CAPTURE_MARGIN_US)) {
+		if (level != (since < high)) {
+			if (++pwm_swaps >= PWM_CAPTURE_SWAP_LIMIT) {
+				LOG_WRN("PWM capture out of step with the pin; re-arming");
+				pwm_capture_arm();
+			}
+			return false;
+		}
+		pwm_swaps = 0;
+	}
+	*period_us = period;
+	*high_us = high;
+	*since_rise_us = since;
+	return true;
+}
+
+int pwm_capture_stamp_link(uint32_t eep)
+{
+	uint8_t ch;
+
+	if (nrfx_gppi_channel_alloc(&ch) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+	nrfx_gppi_channel_endpoints_setup(
+		ch, eep, nrfx_timer_task_address_get(&pwm_timer, NRF_TIMER_TASK_CAPTURE3));
+	nrfx_gppi_channels_enable(BIT(ch));
+	return 0;
+}
+
+bool pwm_capture_stamp_get(uint32_t *period_us, uint32_t *high_us, uint32_t *since_rise_us)
+{
+	uint32_t period = nrfx_timer_capture_get(&pwm_timer, NRF_TIMER_CC_CHANNEL0);
+	uint32_t high = nrfx_timer_capture_get(&pwm_timer, NRF_TIMER_CC_CHANNEL1);
+
+	if (period == 0 || high == 0 || high >= period) {
+		return false;
+	}
+	*period_us = period;
+	*high_us = high;
+	*since_rise_us = nrfx_timer_capture_get(&pwm_timer, NRF_TIMER_CC_CHANNEL3);
+	return true;
+}
@@ -0,0 +1,42 @@
+/*
+ * [EVSE-LOGIC] Pilot PWM period and high time measured in hardware.
+ * [3P-GLUE] nRF52 TIMER2 + GPIOTE + PPI; no CPU work per edge.
+ *
+ * A GPIOTE channel fires on both edges of the PWM pin. Two PPI channel
+ * groups alternate between rising and falling edges: a rising edge captures
+ * the 1 MHz timer into CC[0] and clears it, so CC[0] holds the period; a
+ * falling edge captures into CC[1], the high time. Which group takes the
+ * next edge is set from the pin level when armed, and re-armed if reads
+ * show the two swapped. Another peripheral's event can stamp the time since
+ * the last rise into CC[3], so its timing relative to the PWM is known.
+ */
+#ifndef PWM_CAPTURE_H
+#define PWM_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* [3P-GLUE] pin is the absolute nRF pin number (NRF_GPIO_PIN_MAP). 0 or -errno. */
+int pwm_capture_init(uint32_t pin);
+
+/*
+ * [EVSE-LOGIC] Last complete period and high time, plus the time since the
+ * last rising edge, in microseconds. False until both edges were captured.
+ */
+bool pwm_capture_get(uint32_t *period_us, uint32_t *high_us, uint32_t *since_rise_us);
+
+/*
+ * [3P-GLUE] Capture the time since the last rising edge into CC[3] on every
+ * eep (a peripheral event address), through a PPI channel of its own.
+ * 0 or -errno.
+ */
+int pwm_capture_stamp_link(uint32_t eep);
+
+/*
+ * [EVSE-LOGIC] Period and high time as pwm_capture_get, with the time since
+ * the rise taken at the last stamp event. Register reads only, so it is safe
+ * from an ISR. False until both edges were captured.
+ */
+bool pwm_capture_stamp_get(uint32_t *period_us, uint32_t *high_us, uint32_t *since_rise_us);
+
+#endif /* PWM_CAPTURE_H */
@@ -0,0 +1,85 @@
+/*
+ * [EVSE-LOGIC] Pilot PWM seqlock snapshot (see pwm_stats.h).
+ */
+#include "telemetry/pwm_stats.h"
+
+#include <string.h>
+
+void pwm_stats_init(struct pwm_stats *s)
+{
+	memset(&s->snap, 0, sizeof(s->snap));
+	memset(s->period_us, 0, sizeof(s->period_us));
+	memset(s->high_us, 0, sizeof(s->high_us));
+	s->next = 0;
+	atomic_init(&s->seq, 0);
+}
+
+void pwm_stats_record(struct pwm_stats *s, uint32_t period_us, uint32_t high_us,
+		      uint32_t now_ms)
+{
+	if (period_us == 0 || high_us > period_us) {
+		return;
+	}
+	s->period_us[s->next] = period_us;
+	s->high_us[s->next] = high_us;
+	s->next = (s->next + 1) % PWM_STATS_WINDOW;
+
+	struct pwm_snapshot snap = {
+		.period_us = period_us,
+		.high_us = high_us,
+		.periods = s->snap.periods + 1,
+		.min_high_us = UINT32_MAX,
+		.min_period_us = UINT32_MAX,
+		.updated_ms = now_ms,
+	};
+	uint32_t n = snap.periods < PWM_STATS_WINDOW ? snap.periods : PWM_STATS_WINDOW;
+	uint64_t sum_period = 0;
+	uint64_t sum_high = 0;
+
+	/* [BOILERPLATE] Slots not yet written are past n and never read. */
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t p = s->period_us[i];
+		uint32_t h = s->high_us[i];
+
+		sum_period += p;
+		sum_high += h;
+		snap.min_period_us = p < snap.min_period_us ? p : snap.min_period_us;
+		snap.max_period_us = p > snap.max_period_us ? p : snap.max_period_us;
+		snap.min_high_us = h < snap.min_high_us ? h : snap.min_high_us;
+		snap.max_high_us = h > snap.max_high_us ? h : snap.max_high_us;
+	}
+	snap.avg_period_us = (uint32_t)((sum_period + n / 2) / n);
+	snap.avg_high_us = (uint32_t)((sum_high + n / 2) / n);
+
+	/* [BOILERPLATE] Odd seq marks the update; readers that saw it retry. */
+	unsigned int seq = atomic_load_explicit(&s->seq, memory_order_relaxed);
+
+	atomic_store_explicit(&s->seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	s->snap = snap;
+	atomic_store_explicit(&s->seq, seq + 2, memory_order_release);
+}
+
+bool pwm_stats_read(const struct pwm_stats *s, struct pwm_snapshot *out)
+{
+	unsigned int before;
+	unsigned int after;
+
+	do {
+		before = atomic_load_explicit(&s->seq, memory_order_acquire);
+		*out = s->snap;
+		atomic_thread_fence(memory_order_acquire);
+		after = atomic_load_explicit(&s->seq, memory_order_relaxed);
+	} while ((before & 1U) || before != after);
+
+	return out->periods > 0;
+}
+
+uint32_t pwm_snapshot_duty_permille(const struct pwm_snapshot *snap)
+{
+	if (snap->avg_period_us == 0) {
+		return 0;
+	}
+	return (uint32_t)(((uint64_t)snap->avg_high_us * 1000U + snap->avg_period_us / 2) /
+			  snap->avg_period_us);
+}
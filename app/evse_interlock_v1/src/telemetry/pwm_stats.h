@@ -0,0 +1,68 @@
+/*
+ * [EVSE-LOGIC] Pilot PWM figures shared between the edge writer and readers.
+ * [BOILERPLATE] Seqlock: one writer (an ISR) publishes a snapshot that any
+ * thread copies without locking and without tearing; a reader retries when
+ * the writer ran in between. Pure C, no Zephyr deps.
+ *
+ * The snapshot carries the last period, a running average over the last
+ * PWM_STATS_WINDOW periods with its min/max, the number of periods recorded,
+ * and the writer's clock at the last one, so a missing PWM is a single
+ * comparison (pwm_snapshot_stale).
+ */
+#ifndef PWM_STATS_H
+#define PWM_STATS_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PWM_STATS_WINDOW 16
+
+struct pwm_snapshot {
+	uint32_t period_us;
+	uint32_t high_us;
+	/* Periods recorded since init. */
+	uint32_t periods;
+	/* Over the last min(periods, PWM_STATS_WINDOW) periods. */
+	uint32_t avg_period_us;
+	uint32_t avg_high_us;
+	uint32_t min_high_us;
+	uint32_t max_high_us;
+	uint32_t min_period_us;
+	uint32_t max_period_us;
+	uint32_t updated_ms;
+};
+
+struct pwm_stats {
+	/* Odd while the writer updates snap. */
+	atomic_uint seq;
+	struct pwm_snapshot snap;
+	/* Writer only. */
+	uint32_t period_us[PWM_STATS_WINDOW];
+	uint32_t high_us[PWM_STATS_WINDOW];
+	uint32_t next;
+};
+
+void pwm_stats_init(struct pwm_stats *s);
+
+/*
+ * [EVSE-LOGIC] One complete period (rise to rise) and its high time; single
+ * writer. Periods of 0 or with high_us > period_us are ignored.
+ */
+void pwm_stats_record(struct pwm_stats *s, uint32_t period_us, uint32_t high_us,
+		      uint32_t now_ms);
+
+/* [EVSE-LOGIC] Tear-free copy from any thread; false before the first period. */
+bool pwm_stats_read(const struct pwm_stats *s, struct pwm_snapshot *out);
+
+/* [EVSE-LOGIC] No period recorded in the last timeout_ms (writer's clock). */
+static inline bool pwm_snapshot_stale(const struct pwm_snapshot *snap, uint32_t now_ms,
+				      uint32_t timeout_ms)
+{
+	return (uint32_t)(now_ms - snap->updated_ms) > timeout_ms;
+}
+
+/* [EVSE-LOGIC] Average duty cycle in permille (0..1000). */
+uint32_t pwm_snapshot_duty_permille(const struct pwm_snapshot *snap);
+
+#endif /* PWM_STATS_H */
@@ -5,6 +5,8 @@
 #ifndef TELEMETRY_H
 #define TELEMETRY_H
 
+#include "telemetry/telemetry_envelope.h"
+#include "telemetry/telemetry_binary.h"
 #include "telemetry/telemetry_gpio.h"
 #include "telemetry/telemetry_evse.h"
 #include "telemetry/telemetry_line_current.h"
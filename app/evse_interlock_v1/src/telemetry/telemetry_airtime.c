@@ -0,0 +1,170 @@
+/*
+ * [TELEMETRY] Uplink airtime budget (see telemetry_airtime.h).
+ */
+#include "telemetry/telemetry_airtime.h"
+
+#include <string.h>
+
+/* [TELEMETRY] LoRa uplinks use an explicit header and a payload CRC. */
+#define LORA_CRC_BITS 16
+/* Low data rate optimisation is mandated once a symbol lasts 16 ms or more. */
+#define LORA_LDRO_SYMBOL_US 16000
+
+static int64_t bucket_ns(const struct telemetry_airtime *a)
+{
+	return (int64_t)a->cfg.burst_ms * 1000000;
+}
+
+static bool phy_valid(const struct telemetry_airtime_phy *phy)
+{
+	if (phy->lora) {
+		return phy->sf >= 7 && phy->sf <= 12 && phy->bw_khz > 0 && phy->cr >= 1 &&
+		       phy->cr <= 4;
+	}
+	return phy->bitrate_bps > 0;
+}
+
+int telemetry_airtime_init(struct telemetry_airtime *a, const struct telemetry_airtime_config *cfg,
+			   int64_t now_ms)
+{
+	if (!a || !cfg || cfg->burst_ms == 0 || cfg->reserve_pct > 100) {
+		return -1;
+	}
+	for (int i = 0; i < TELEMETRY_AIRTIME_LINK_COUNT; i++) {
+		if (cfg->duty_ppm[i] > 1000000 || !phy_valid(&cfg->phy[i])) {
+			return -1;
+		}
+	}
+	memset(a, 0, sizeof(*a));
+	a->cfg = *cfg;
+	a->link = TELEMETRY_AIRTIME_BLE;
+	for (int i = 0; i < TELEMETRY_AIRTIME_LINK_COUNT; i++) {
+		a->tokens_ns[i] = bucket_ns(a);
+		a->refill_ms[i] = now_ms;
+	}
+	return 0;
+}
+
+void telemetry_airtime_set_link(struct telemetry_airtime *a, enum telemetry_airtime_link link)
+{
+	if (a && link < TELEMETRY_AIRTIME_LINK_COUNT) {
+		a->link = link;
+	}
+}
+
+uint32_t telemetry_airtime_frame_us(const struct telemetry_airtime_phy *phy, size_t len)
+{
+	uint64_t bytes = (uint64_t)len + phy->overhead;
+
+	if (!phy_valid(phy)) {
+		return 0;
+	}
+	if (!phy->lora) {
+		uint64_t us = ((bytes + phy->preamble) * 8U * 1000000U) / phy->bitrate_bps;
+		return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+	}
+
+	/* [TELEMETRY] Semtech time-on-air formula, counted in quarter symbols. */
+	uint32_t chips = 1U << phy->sf;
+	bool ldro = (uint64_t)chips * 1000U >= (uint64_t)LORA_LDRO_SYMBOL_US * phy->bw_khz;
+	int64_t bits = (int64_t)bytes * 8 - 4 * phy->sf + 28 + LORA_CRC_BITS;
+	int64_t per_block = 4 * (phy->sf - (ldro ? 2 : 0));
+	int64_t blocks = bits > 0 ? (bits + per_block - 1) / per_block : 0;
+	uint64_t quarter_symbols = 4U * (uint64_t)phy->preamble + 17U +
+				   4U * (8U + (uint64_t)blocks * (phy->cr + 4U));
+	uint64_t us = (quarter_symbols * chips * 1000U) / (4U * phy->bw_khz);
+
+	return us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static void refill(struct telemetry_airtime *a, int64_t now_ms)
+{
+	uint32_t duty = a->cfg.duty_ppm[a->link];
+	int64_t elapsed = now_ms - a->refill_ms[a->link];
+	int64_t full = bucket_ns(a);
+
+	if (elapsed <= 0) {
+		return;
+	}
+	a->refill_ms[a->link] = now_ms;
+	/* 1 ppm of 1 ms is 1 ns of airtime. */
+	if (duty == 0 || elapsed >= (full - a->tokens_ns[a->link]) / duty + 1) {
+		a->tokens_ns[a->link] = full;
+		return;
+	}
+	a->tokens_ns[a->link] += elapsed * duty;
+}
+
+void telemetry_airtime_charge(struct telemetry_airtime *a, size_t len, int64_t now_ms)
+{
+	if (!a) {
+		return;
+	}
+	uint32_t us = telemetry_airtime_frame_us(&a->cfg.phy[a->link], len);
+	struct telemetry_airtime_stats *st = &a->stats[a->link];
+
+	st->used_us += us;
+	st->frames++;
+	if (a->cfg.duty_ppm[a->link] == 0) {
+		return;
+	}
+	refill(a, now_ms);
+	/* Overdrawing is bounded, so the budget always recovers within two bursts. */
+	a->tokens_ns[a->link] -= (int64_t)us * 1000;
+	if (a->tokens_ns[a->link] < -bucket_ns(a)) {
+		a->tokens_ns[a->link] = -bucket_ns(a);
+	}
+}
+
+enum telemetry_airtime_verdict telemetry_airtime_admit(struct telemetry_airtime *a,
+						       enum telemetry_queue_class cls, size_t len,
+						       int64_t now_ms)
+{
+	enum telemetry_airtime_verdict verdict = TELEMETRY_AIRTIME_SEND;
+
+	if (!a) {
+		return verdict;
+	}
+	if (a->cfg.duty_ppm[a->link] != 0 && cls != TELEMETRY_QUEUE_SAFETY) {
+		const struct telemetry_airtime_phy *phy = &a->cfg.phy[a->link];
+		int64_t cost = (int64_t)telemetry_airtime_frame_us(phy, len) * 1000;
+		int64_t reserve = bucket_ns(a) * a->cfg.reserve_pct / 100;
+
+		refill(a, now_ms);
+		if (a->tokens_ns[a->link] >= cost + reserve) {
+			verdict = TELEMETRY_AIRTIME_SEND;
+		} else if (cls == TELEMETRY_QUEUE_SESSION && a->tokens_ns[a->link] >= cost) {
+			verdict = TELEMETRY_AIRTIME_MERGE;
+		} else {
+			verdict = TELEMETRY_AIRTIME_DEFER;
+		}
+	}
+
+	struct telemetry_airtime_stats *st = &a->stats[a->link];
+	if (verdict == TELEMETRY_AIRTIME_SEND) {
+		st->sent++;
+	} else if (verdict == TELEMETRY_AIRTIME_MERGE) {
+		st->merged++;
+	} else {
+		st->deferred++;
+	}
+	return verdict;
+}
+
+int64_t telemetry_airtime_level_us(struct telemetry_airtime *a, int64_t now_ms)
+{
+	if (!a) {
+		return 0;
+	}
+	refill(a, now_ms);
+	return a->tokens_ns[a->link] / 1000;
+}
+
+bool telemetry_airtime_tight(struct telemetry_airtime *a, int64_t now_ms)
+{
+	if (!a || a->cfg.duty_ppm[a->link] == 0) {
+		return false;
+	}
+	refill(a, now_ms);
+	return a->tokens_ns[a->link] < bucket_ns(a) * a->cfg.reserve_pct / 100;
+}
@@ -0,0 +1,106 @@
+/*
+ * [TELEMETRY] Uplink airtime budget: time on air estimated from the payload
+ * size and the link's PHY parameters, charged against a token bucket per link
+ * type that refills at the link's duty cycle.
+ * [BOILERPLATE] Pure C; the caller supplies time, so the same code runs on the
+ * device and in host tests.
+ *
+ * Admission follows the telemetry queue classes (telemetry_queue.h): safety
+ * records always go and may overdraw the bucket; session records go while
+ * they fit, but only as part of a shared frame once the budget is below the
+ * reserve; periodic records wait until they fit above the reserve.
+ */
+#ifndef TELEMETRY_AIRTIME_H
+#define TELEMETRY_AIRTIME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/telemetry_queue.h"
+
+enum telemetry_airtime_link {
+	TELEMETRY_AIRTIME_BLE = 0,
+	TELEMETRY_AIRTIME_FSK,
+	TELEMETRY_AIRTIME_LORA,
+	TELEMETRY_AIRTIME_LINK_COUNT,
+};
+
+enum telemetry_airtime_verdict {
+	/* Send as the caller asked. */
+	TELEMETRY_AIRTIME_SEND = 0,
+	/* Send, but share a frame with other records rather than flush one. */
+	TELEMETRY_AIRTIME_MERGE,
+	/* Hold back and ask again later. */
+	TELEMETRY_AIRTIME_DEFER,
+};
+
+struct telemetry_airtime_phy {
+	/* LoRa: spreading factor 7..12, bandwidth, coding rate 4/(4 + cr). */
+	bool lora;
+	uint8_t sf;
+	uint16_t bw_khz;
+	uint8_t cr;
+	/* Preamble symbols (LoRa) or preamble + sync word bytes (FSK). */
+	uint16_t preamble;
+	/* FSK and BLE. */
+	uint32_t bitrate_bps;
+	/* Protocol headers and MIC added to every payload. */
+	uint16_t overhead;
+};
+
+struct telemetry_airtime_config {
+	struct telemetry_airtime_phy phy[TELEMETRY_AIRTIME_LINK_COUNT];
+	/* Share of wall time the link may transmit, in ppm; 0 means unlimited. */
+	uint32_t duty_ppm[TELEMETRY_AIRTIME_LINK_COUNT];
+	/* Bucket size: airtime a full budget allows in one burst. */
+	uint32_t burst_ms;
+	/* Below this percentage of the burst the budget is tight. */
+	uint8_t reserve_pct;
+};
+
+struct telemetry_airtime_stats {
+	uint64_t used_us;
+	uint32_t frames;
+	uint32_t sent;
+	uint32_t merged;
+	uint32_t deferred;
+};
+
+struct telemetry_airtime {
+	struct telemetry_airtime_config cfg;
+	enum telemetry_airtime_link link;
+	/* Bucket level in ns of airtime; safety traffic may take it below zero. */
+	int64_t tokens_ns[TELEMETRY_AIRTIME_LINK_COUNT];
+	int64_t refill_ms[TELEMETRY_AIRTIME_LINK_COUNT];
+	struct telemetry_airtime_stats stats[TELEMETRY_AIRTIME_LINK_COUNT];
+};
+
+/* [TELEMETRY] Starts on BLE with every bucket full. Returns 0 or -1. */
+int telemetry_airtime_init(struct telemetry_airtime *a, const struct telemetry_airtime_config *cfg,
+			   int64_t now_ms);
+
+/* [TELEMETRY] Link whose budget later charges and admissions use. */
+void telemetry_airtime_set_link(struct telemetry_airtime *a, enum telemetry_airtime_link link);
+
+/* [TELEMETRY] Time on air of one frame carrying len payload bytes, in us. */
+uint32_t telemetry_airtime_frame_us(const struct telemetry_airtime_phy *phy, size_t len);
+
+/* [TELEMETRY] A frame of len bytes went out on the current link. */
+void telemetry_airtime_charge(struct telemetry_airtime *a, size_t len, int64_t now_ms);
+
+/*
+ * [TELEMETRY] May a record of class cls and len bytes go now? Counts the
+ * verdict; the airtime itself is charged when the frame goes out.
+ */
+enum telemetry_airtime_verdict telemetry_airtime_admit(struct telemetry_airtime *a,
+						       enum telemetry_queue_class cls, size_t len,
+						       int64_t now_ms);
+
+/* [TELEMETRY] Budget left on the current link, in us (negative when overdrawn). */
+int64_t telemetry_airtime_level_us(struct telemetry_airtime *a, int64_t now_ms);
+
+/* [TELEMETRY] Below the reserve on the current link (never for an unlimited link). */
+bool telemetry_airtime_tight(struct telemetry_airtime *a, int64_t now_ms);
+
+#endif /* TELEMETRY_AIRTIME_H */
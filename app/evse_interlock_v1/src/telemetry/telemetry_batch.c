@@ -0,0 +1,130 @@
+/*
+ * [TELEMETRY] Multi-record uplink frames (coalesced telemetry).
+ * [BOILERPLATE] Byte 0 is kept free for the batch header and written on close.
+ */
+#include "telemetry/telemetry_batch.h"
+
+#include <string.h>
+
+#define TELEMETRY_BATCH_BIN_HDR                                                            \
+	((uint8_t)((TELEMETRY_BIN_SCHEMA_VERSION << 4) | TELEMETRY_BIN_TYPE_BATCH))
+
+void telemetry_batch_open(struct telemetry_batch *batch, enum telemetry_encoding encoding,
+			  void *buf, size_t cap)
+{
+	batch->buf = buf;
+	batch->cap = buf ? cap : 0;
+	batch->len = 1;
+	batch->count = 0;
+	batch->encoding = encoding;
+}
+
+/* [BOILERPLATE] Bytes between the previous record and the next one. */
+static size_t telemetry_batch_gap(const struct telemetry_batch *batch)
+{
+	if (batch->encoding == TELEMETRY_ENCODING_BINARY) {
+		return 1; /* length byte */
+	}
+	return batch->count > 0 ? 1 : 0; /* ',' */
+}
+
+/* [BOILERPLATE] Bytes that must stay free for the close step. */
+static size_t telemetry_batch_trailer(const struct telemetry_batch *batch)
+{
+	return batch->encoding == TELEMETRY_ENCODING_BINARY ? 0 : 1; /* ']' */
+}
+
+void *telemetry_batch_slot(struct telemetry_batch *batch, size_t *avail)
+{
+	size_t used = batch->len + telemetry_batch_gap(batch) + telemetry_batch_trailer(batch);
+
+	if (!batch->buf || used >= batch->cap) {
+		*avail = 0;
+		return NULL;
+	}
+
+	*avail = batch->cap - used;
+	if (batch->encoding == TELEMETRY_ENCODING_BINARY &&
+	    *avail > TELEMETRY_BATCH_BIN_RECORD_MAX) {
+		*avail = TELEMETRY_BATCH_BIN_RECORD_MAX;
+	}
+	return batch->buf + batch->len + telemetry_batch_gap(batch);
+}
+
+int telemetry_batch_commit(struct telemetry_batch *batch, size_t rec_len)
+{
+	size_t avail;
+
+	if (rec_len == 0 || !telemetry_batch_slot(batch, &avail) || rec_len > avail) {
+		return -1;
+	}
+
+	if (batch->encoding == TELEMETRY_ENCODING_BINARY) {
+		batch->buf[batch->len] = (uint8_t)rec_len;
+	} else if (batch->count > 0) {
+		batch->buf[batch->len] = ',';
+	}
+	batch->len += telemetry_batch_gap(batch) + rec_len;
+	batch->count++;
+	return 0;
+}
+
+int telemetry_batch_close(struct telemetry_batch *batch)
+{
+	if (batch->count == 0) {
+		return 0;
+	}
+
+	if (batch->count == 1) {
+		/* [TELEMETRY] Single record: drop the batch framing entirely. */
+		size_t skip = 1 + (batch->encoding == TELEMETRY_ENCODING_BINARY ? 1 : 0);
+		size_t rec_len = batch->len - skip;
+
+		memmove(batch->buf, batch->buf + skip, rec_len);
+		return (int)rec_len;
+	}
+
+	if (batch->encoding == TELEMETRY_ENCODING_BINARY) {
+		batch->buf[0] = TELEMETRY_BATCH_BIN_HDR;
+		return (int)batch->len;
+	}
+
+	batch->buf[0] = '[';
+	batch->buf[batch->len] = ']';
+	return (int)(batch->len + 1);
+}
+
+int telemetry_batch_next_bin(const uint8_t *frame, size_t len, size_t *offset,
+			     const uint8_t **rec, size_t *rec_len)
+{
+	if (!frame || !offset || !rec || !rec_len || len == 0) {
+		return -1;
+	}
+
+	if (frame[0] != TELEMETRY_BATCH_BIN_HDR) {
+		/* [TELEMETRY] Bare record: the whole frame is the only record. */
+		if (*offset >= len) {
+			return 0;
+		}
+		*rec = frame;
+		*rec_len = len;
+		*offset = len;
+		return 1;
+	}
+
+	if (*offset == 0) {
+		*offset = 1;
+	}
+	if (*offset >= len) {
+		return 0;
+	}
+
+	size_t n = frame[*offset];
+	if (n == 0 || n > len - *offset - 1) {
+		return -1;
+	}
+	*rec = frame + *offset + 1;
+	*rec_len = n;
+	*offset += 1 + n;
+	return 1;
+}
@@ -0,0 +1,53 @@
+/*
+ * [TELEMETRY] Multi-record uplink frames (coalesced telemetry).
+ * [BOILERPLATE] In-place framing over a caller-owned buffer; no allocation.
+ *
+ * JSON batch:   [<record>,<record>,...]   (records are schema 1.0 payloads)
+ * Binary batch: byte 0 = (schema version << 4) | TELEMETRY_BIN_TYPE_BATCH,
+ *               then per record: 1 length byte + schema v3 record.
+ * A batch holding a single record is emitted as that bare record, so frames
+ * stay compatible with decoders that predate batching.
+ */
+#ifndef TELEMETRY_BATCH_H
+#define TELEMETRY_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/telemetry_binary.h"
+
+/* [TELEMETRY] Binary records are length-prefixed with a single byte. */
+#define TELEMETRY_BATCH_BIN_RECORD_MAX 127
+
+struct telemetry_batch {
+	uint8_t *buf;
+	size_t cap;
+	size_t len;
+	uint16_t count;
+	enum telemetry_encoding encoding;
+};
+
+void telemetry_batch_open(struct telemetry_batch *batch, enum telemetry_encoding encoding,
+			  void *buf, size_t cap);
+
+/*
+ * [BOILERPLATE] Where the next record should be built and how many bytes it may
+ * use (builders may also write a NUL inside that space). NULL when full.
+ */
+void *telemetry_batch_slot(struct telemetry_batch *batch, size_t *avail);
+
+/* [BOILERPLATE] Accept the record just built in the slot; -1 if it does not fit. */
+int telemetry_batch_commit(struct telemetry_batch *batch, size_t rec_len);
+
+/* [BOILERPLATE] Finalize the frame in place; returns its length (0 when empty). */
+int telemetry_batch_close(struct telemetry_batch *batch);
+
+/*
+ * [TELEMETRY] Iterate records of a binary frame (batched or bare). Returns 1 and
+ * sets rec/rec_len for each record, 0 at the end, -1 on a malformed frame.
+ */
+int telemetry_batch_next_bin(const uint8_t *frame, size_t len, size_t *offset,
+			     const uint8_t **rec, size_t *rec_len);
+
+#endif /* TELEMETRY_BATCH_H */
@@ -0,0 +1,476 @@
+/*
+ * [TELEMETRY] Binary (schema v3) payload encoder/decoder.
+ * [BOILERPLATE] Cursor-based framing over varint helpers; record bodies are
+ * expanded from telemetry_schema.h with one put/get macro per field kind.
+ * Carries the same information as the JSON builders at the JSON precision.
+ */
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_fixed.h"
+
+#include <string.h>
+
+struct bin_cursor {
+	uint8_t *buf;
+	size_t len;
+	size_t pos;
+	bool err;
+};
+
+static void put_u8(struct bin_cursor *c, uint8_t v)
+{
+	if (c->err || c->pos >= c->len) {
+		c->err = true;
+		return;
+	}
+	c->buf[c->pos++] = v;
+}
+
+static void put_varint(struct bin_cursor *c, uint64_t v)
+{
+	if (c->err) {
+		return;
+	}
+	int n = telemetry_varint_put(c->buf + c->pos, c->len - c->pos, v);
+	if (n < 0) {
+		c->err = true;
+		return;
+	}
+	c->pos += (size_t)n;
+}
+
+static void put_bytes(struct bin_cursor *c, const void *data, size_t n)
+{
+	if (c->err || n > c->len - c->pos) {
+		c->err = true;
+		return;
+	}
+	memcpy(c->buf + c->pos, data, n);
+	c->pos += n;
+}
+
+/* [BOILERPLATE] Length-prefixed short string (len byte + bytes, no NUL). */
+static void put_str(struct bin_cursor *c, const char *s, size_t max)
+{
+	size_t n = s ? strlen(s) : 0;
+	if (n > max) {
+		c->err = true;
+		return;
+	}
+	put_u8(c, (uint8_t)n);
+	if (n) {
+		put_bytes(c, s, n);
+	}
+}
+
+static int hex_nibble(char ch)
+{
+	if (ch >= '0' && ch <= '9') {
+		return ch - '0';
+	}
+	if (ch >= 'a' && ch <= 'f') {
+		return ch - 'a' + 10;
+	}
+	return -1;
+}
+
+/* [TELEMETRY] Pack lowercase hex (optionally with '-' at fixed offsets) into bytes. */
+static bool hex_pack(const char *s, size_t hex_digits, uint8_t *out, const uint8_t *dash_at,
+		     size_t dash_count)
+{
+	size_t di = 0;
+	size_t o = 0;
+
+	for (size_t i = 0; s[i] != '\0'; i++) {
+		if (di < dash_count && i == dash_at[di]) {
+			if (s[i] != '-') {
+				return false;
+			}
+			di++;
+			continue;
+		}
+		int v = hex_nibble(s[i]);
+		if (v < 0 || o >= hex_digits) {
+			return false;
+		}
+		if (o & 1) {
+			out[o / 2] |= (uint8_t)v;
+		} else {
+			out[o / 2] = (uint8_t)(v << 4);
+		}
+		o++;
+	}
+	return o == hex_digits && di == dash_count;
+}
+
+static void hex_unpack(const uint8_t *in, size_t hex_digits, char *out, const uint8_t *dash_at,
+		       size_t dash_count)
+{
+	static const char digits[] = "0123456789abcdef";
+	size_t di = 0;
+	size_t pos = 0;
+
+	for (size_t o = 0; o < hex_digits; o++) {
+		if (di < dash_count && pos == dash_at[di]) {
+			out[pos++] = '-';
+			di++;
+		}
+		uint8_t b = in[o / 2];
+		out[pos++] = digits[(o & 1) ? (b & 0x0F) : (b >> 4)];
+	}
+	out[pos] = '\0';
+}
+
+/* app_next_event_id() emits "%08x%08x"; session_id_new() emits a dashed UUID. */
+static const uint8_t uuid_dashes[] = { 8, 13, 18, 23 };
+
+/* [TELEMETRY] ID codec: packed hex64 / UUID when the text allows, else a string. */
+static void put_id(struct bin_cursor *c, const char *id)
+{
+	uint8_t raw[16];
+	size_t n = id ? strlen(id) : 0;
+
+	if (n == 16 && hex_pack(id, 16, raw, NULL, 0)) {
+		put_u8(c, TELEMETRY_BIN_ID_HEX64);
+		put_bytes(c, raw, 8);
+	} else if (n == 36 && hex_pack(id, 32, raw, uuid_dashes, sizeof(uuid_dashes))) {
+		put_u8(c, TELEMETRY_BIN_ID_UUID);
+		put_bytes(c, raw, 16);
+	} else {
+		put_str(c, id, TELEMETRY_SCHEMA_STR_MAX);
+	}
+}
+
+/* [TELEMETRY] FIXEDn value; same magnitude bound as telemetry_writer_fixed(). */
+static void put_fixed(struct bin_cursor *c, float value, uint32_t scale)
+{
+	double p = (double)value * (double)scale;
+
+	if (!(p > -1e18 && p < 1e18)) {
+		c->err = true;
+		return;
+	}
+	put_varint(c, telemetry_zigzag_encode(telemetry_fixed_from_float(value, scale)));
+}
+
+enum telemetry_event_type telemetry_event_type_from_str(const char *event_type)
+{
+	if (!event_type) {
+		return TELEMETRY_EVENT_UNKNOWN;
+	}
+	for (int t = TELEMETRY_EVENT_STATE_CHANGE; t <= TELEMETRY_EVENT_HEALTH; t++) {
+		if (strcmp(event_type, telemetry_event_type_str((enum telemetry_event_type)t)) ==
+		    0) {
+			return (enum telemetry_event_type)t;
+		}
+	}
+	return TELEMETRY_EVENT_UNKNOWN;
+}
+
+const char *telemetry_event_type_str(enum telemetry_event_type event_type)
+{
+	switch (event_type) {
+	case TELEMETRY_EVENT_STATE_CHANGE:
+		return "state_change";
+	case TELEMETRY_EVENT_SESSION_START:
+		return "session_start";
+	case TELEMETRY_EVENT_SESSION_END:
+		return "session_end";
+	case TELEMETRY_EVENT_CURRENT_CHANGE:
+		return "current_change";
+	case TELEMETRY_EVENT_SAMPLE:
+		return "sample";
+	case TELEMETRY_EVENT_HEALTH:
+		return "health";
+	default:
+		return "unknown";
+	}
+}
+
+/* [TELEMETRY] Common header: type, event type, flags, timestamp, ids. */
+static void put_header(struct bin_cursor *c, enum telemetry_bin_type type,
+		       enum telemetry_event_type event_type, int64_t timestamp_ms,
+		       const char *event_id, const char *run_id, bool time_anomaly)
+{
+	bool has_run_id = run_id && run_id[0] != '\0';
+
+	if (timestamp_ms < 0 || event_type == TELEMETRY_EVENT_UNKNOWN) {
+		c->err = true;
+		return;
+	}
+	put_u8(c, (uint8_t)((TELEMETRY_BIN_SCHEMA_VERSION << 4) | type));
+	put_u8(c, (uint8_t)(((uint8_t)event_type << 4) |
+			    (time_anomaly ? TELEMETRY_BIN_F_TIME_ANOMALY : 0) |
+			    (has_run_id ? TELEMETRY_BIN_F_RUN_ID : 0)));
+	put_varint(c, (uint64_t)timestamp_ms);
+	put_id(c, event_id);
+	if (has_run_id) {
+		put_str(c, run_id, TELEMETRY_SCHEMA_STR_MAX);
+	}
+}
+
+static int finish(const struct bin_cursor *c)
+{
+	return c->err ? -1 : (int)c->pos;
+}
+
+#define BIN_PUT_STR(c, v) put_str(c, v, TELEMETRY_SCHEMA_STR_MAX)
+#define BIN_PUT_ID(c, v) put_id(c, v)
+#define BIN_PUT_INT(c, v) put_varint(c, telemetry_zigzag_encode(v))
+#define BIN_PUT_BOOL(c, v) put_u8(c, (v) ? 1 : 0)
+#define BIN_PUT_EDGE(c, v) put_u8(c, (uint8_t)(v))
+#define BIN_PUT_PILOT(c, v) put_u8(c, (uint8_t)(v))
+#define BIN_PUT_FIXED2(c, v) put_fixed(c, v, 100U)
+#define BIN_PUT_FIXED3(c, v) put_fixed(c, v, 1000U)
+#define BIN_PUT_FIXED4(c, v) put_fixed(c, v, 10000U)
+#define BIN_PUT_UPTIME(c, v) (void)(v)
+
+#define BIN_PUT_FIELD(kind, key, member) BIN_PUT_##kind(c, src->member);
+
+#define BIN_PUT_RECORD(NAME, code, name, src_type)                                         \
+	static void put_body_##name(struct bin_cursor *c, const src_type *src)             \
+	{                                                                                  \
+		TELEMETRY_SCHEMA_##NAME(BIN_PUT_FIELD)                                     \
+	}
+TELEMETRY_SCHEMA_RECORDS(BIN_PUT_RECORD)
+
+int telemetry_build_gpio_payload_bin(uint8_t *buf, size_t buf_len, const char *pin_alias,
+				     int state, gpio_edge_t edge, int64_t timestamp_ms,
+				     const char *run_id, const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !pin_alias || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct bin_cursor c = { .buf = buf, .len = buf_len };
+	const struct telemetry_gpio_src src = {
+		.pin = pin_alias,
+		.state = state,
+		.edge = edge,
+		.uptime_ms = timestamp_ms,
+	};
+
+	put_header(&c, TELEMETRY_BIN_TYPE_GPIO, TELEMETRY_EVENT_STATE_CHANGE, timestamp_ms,
+		   event_id, run_id, time_anomaly);
+	put_body_gpio(&c, &src);
+	return finish(&c);
+}
+
+int telemetry_build_evse_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+				     const struct evse_event *evt, const char *event_id,
+				     bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !evt || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct bin_cursor c = { .buf = buf, .len = buf_len };
+
+	put_header(&c, TELEMETRY_BIN_TYPE_EVSE, telemetry_event_type_from_str(evt->event_type),
+		   timestamp_ms, event_id, NULL, time_anomaly);
+	put_body_evse(&c, evt);
+	return finish(&c);
+}
+
+int telemetry_build_line_current_payload_bin(uint8_t *buf, size_t buf_len,
+					     int64_t timestamp_ms,
+					     const struct line_current_event *evt,
+					     const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !evt || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct bin_cursor c = { .buf = buf, .len = buf_len };
+
+	put_header(&c, TELEMETRY_BIN_TYPE_LINE_CURRENT,
+		   telemetry_event_type_from_str(evt->event_type), timestamp_ms, event_id, NULL,
+		   time_anomaly);
+	put_body_line_current(&c, evt);
+	return finish(&c);
+}
+
+int telemetry_build_session_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+					const struct evse_session_summary *summary,
+					const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !summary || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct bin_cursor c = { .buf = buf, .len = buf_len };
+
+	put_header(&c, TELEMETRY_BIN_TYPE_SESSION, TELEMETRY_EVENT_SESSION_END, timestamp_ms,
+		   event_id, NULL, time_anomaly);
+	put_body_session(&c, summary);
+	return finish(&c);
+}
+
+int telemetry_build_health_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+				       const struct telemetry_health *health, const char *event_id,
+				       bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !health || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct bin_cursor c = { .buf = buf, .len = buf_len };
+
+	put_header(&c, TELEMETRY_BIN_TYPE_HEALTH, TELEMETRY_EVENT_HEALTH, timestamp_ms, event_id,
+		   NULL, time_anomaly);
+	put_body_health(&c, health);
+	return finish(&c);
+}
+
+/* [BOILERPLATE] Decoder cursor helpers (bounds-checked, sticky error). */
+struct bin_reader {
+	const uint8_t *buf;
+	size_t len;
+	size_t pos;
+	bool err;
+};
+
+static uint8_t get_u8(struct bin_reader *r)
+{
+	if (r->err || r->pos >= r->len) {
+		r->err = true;
+		return 0;
+	}
+	return r->buf[r->pos++];
+}
+
+static uint64_t get_varint(struct bin_reader *r)
+{
+	uint64_t v = 0;
+	if (r->err) {
+		return 0;
+	}
+	int n = telemetry_varint_get(r->buf + r->pos, r->len - r->pos, &v);
+	if (n < 0) {
+		r->err = true;
+		return 0;
+	}
+	r->pos += (size_t)n;
+	return v;
+}
+
+static const uint8_t *get_bytes(struct bin_reader *r, size_t n)
+{
+	if (r->err || n > r->len - r->pos) {
+		r->err = true;
+		return NULL;
+	}
+	const uint8_t *p = r->buf + r->pos;
+	r->pos += n;
+	return p;
+}
+
+static void get_str(struct bin_reader *r, char *out, size_t max)
+{
+	size_t n = get_u8(r);
+	const uint8_t *p;
+
+	out[0] = '\0';
+	if (n > max) {
+		r->err = true;
+		return;
+	}
+	p = get_bytes(r, n);
+	if (p) {
+		memcpy(out, p, n);
+		out[n] = '\0';
+	}
+}
+
+static void get_id(struct bin_reader *r, char *out)
+{
+	const uint8_t *raw;
+
+	out[0] = '\0';
+	switch (r->err || r->pos >= r->len ? 0 : r->buf[r->pos]) {
+	case TELEMETRY_BIN_ID_HEX64:
+		r->pos++;
+		raw = get_bytes(r, 8);
+		if (raw) {
+			hex_unpack(raw, 16, out, NULL, 0);
+		}
+		break;
+	case TELEMETRY_BIN_ID_UUID:
+		r->pos++;
+		raw = get_bytes(r, 16);
+		if (raw) {
+			hex_unpack(raw, 32, out, uuid_dashes, sizeof(uuid_dashes));
+		}
+		break;
+	default:
+		get_str(r, out, TELEMETRY_SCHEMA_STR_MAX);
+		break;
+	}
+}
+
+static int64_t get_zigzag(struct bin_reader *r)
+{
+	return telemetry_zigzag_decode(get_varint(r));
+}
+
+#define BIN_GET_STR(r, out) get_str(r, out, TELEMETRY_SCHEMA_STR_MAX)
+#define BIN_GET_ID(r, out) get_id(r, out)
+#define BIN_GET_INT(r, out) (out) = (int32_t)get_zigzag(r)
+#define BIN_GET_BOOL(r, out) (out) = get_u8(r) != 0
+#define BIN_GET_EDGE(r, out) (out) = (gpio_edge_t)get_u8(r)
+#define BIN_GET_PILOT(r, out) (out) = (enum evse_pilot_state)get_u8(r)
+#define BIN_GET_FIXED2(r, out) (out) = get_zigzag(r)
+#define BIN_GET_FIXED3(r, out) (out) = get_zigzag(r)
+#define BIN_GET_FIXED4(r, out) (out) = get_zigzag(r)
+#define BIN_GET_UPTIME(r, out) (out) = rec->timestamp_ms
+
+#define BIN_GET_FIELD(kind, key, member) BIN_GET_##kind(r, body->member);
+
+#define BIN_GET_RECORD(NAME, code, name, src_type)                                         \
+	static void get_body_##name(struct bin_reader *r, struct telemetry_bin_record *rec) \
+	{                                                                                  \
+		struct telemetry_##name##_fields *body = &rec->name;                       \
+                                                                                           \
+		TELEMETRY_SCHEMA_##NAME(BIN_GET_FIELD)                                     \
+	}
+TELEMETRY_SCHEMA_RECORDS(BIN_GET_RECORD)
+
+#define BIN_GET_CASE(NAME, code, name, src_type)                                           \
+	case TELEMETRY_BIN_TYPE_##NAME:                                                    \
+		get_body_##name(&r, rec);                                                  \
+		break;
+
+int telemetry_decode_bin(const uint8_t *buf, size_t len, struct telemetry_bin_record *rec)
+{
+	if (!buf || len < 2 || !rec) {
+		return -1;
+	}
+
+	struct bin_reader r = { .buf = buf, .len = len };
+	uint8_t hdr = get_u8(&r);
+	uint8_t flags = get_u8(&r);
+
+	if ((hdr >> 4) != TELEMETRY_BIN_SCHEMA_VERSION) {
+		return -1;
+	}
+
+	memset(rec, 0, sizeof(*rec));
+	rec->type = (enum telemetry_bin_type)(hdr & 0x0F);
+	rec->event_type = (enum telemetry_event_type)(flags >> 4);
+	rec->time_anomaly = (flags & TELEMETRY_BIN_F_TIME_ANOMALY) != 0;
+	rec->timestamp_ms = (int64_t)get_varint(&r);
+	get_id(&r, rec->event_id);
+	if (flags & TELEMETRY_BIN_F_RUN_ID) {
+		get_str(&r, rec->run_id, TELEMETRY_SCHEMA_STR_MAX);
+	}
+
+	switch (rec->type) {
+		TELEMETRY_SCHEMA_RECORDS(BIN_GET_CASE)
+	default:
+		return -1;
+	}
+
+	if (r.err) {
+		return -1;
+	}
+	return (int)r.pos;
+}
@@ -0,0 +1,103 @@
+/*
+ * [TELEMETRY] Compact binary payload schema (v3) for single-frame LoRa uplinks.
+ * [BOILERPLATE] Encoder/decoder declarations; record bodies follow telemetry_schema.h.
+ *
+ * Frame layout:
+ *   byte 0   (schema version << 4) | record type
+ *   byte 1   (event type << 4) | flags (enum telemetry_bin_flags)
+ *   varint   timestamp (uptime or epoch ms, same semantics as JSON "timestamp")
+ *   id       event_id (ID codec below)
+ *   str      run_id, only with TELEMETRY_BIN_F_RUN_ID
+ *   ...      record fields in schema order, one codec per field kind
+ * ID codec: TELEMETRY_BIN_ID_HEX64 + 8 bytes, TELEMETRY_BIN_ID_UUID + 16 bytes,
+ * otherwise a length byte (<= TELEMETRY_SCHEMA_STR_MAX) and the characters.
+ * device_id/device_type are not carried: Sidewalk already identifies the sender.
+ * v3 replaces v2's hand-packed bodies with the schema-table field order.
+ */
+#ifndef TELEMETRY_BINARY_H
+#define TELEMETRY_BINARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/telemetry_schema.h"
+
+#define TELEMETRY_BIN_SCHEMA_VERSION 3
+#define TELEMETRY_BIN_MAX_LEN 64
+
+#define TELEMETRY_BIN_ID_HEX64 0x88
+#define TELEMETRY_BIN_ID_UUID 0x90
+
+enum telemetry_encoding {
+	TELEMETRY_ENCODING_JSON = 0,
+	TELEMETRY_ENCODING_BINARY,
+};
+
+#define TELEMETRY_BIN_DECL_TYPE(NAME, code, name, src_type) TELEMETRY_BIN_TYPE_##NAME = code,
+
+enum telemetry_bin_type {
+	TELEMETRY_SCHEMA_RECORDS(TELEMETRY_BIN_DECL_TYPE)
+	TELEMETRY_BIN_TYPE_BATCH = 4,    /* multi-record frame, see telemetry_batch.h */
+	TELEMETRY_BIN_TYPE_FRAGMENT = 5, /* part of one record, see telemetry_fragment.h */
+	TELEMETRY_BIN_TYPE_SERIES = 6,   /* sample block, see telemetry_series.h */
+};
+
+enum telemetry_bin_flags {
+	TELEMETRY_BIN_F_TIME_ANOMALY = 1 << 0,
+	TELEMETRY_BIN_F_RUN_ID = 1 << 1,
+};
+
+/* [TELEMETRY] Wire codes for event_type strings; values are part of the binary schema. */
+enum telemetry_event_type {
+	TELEMETRY_EVENT_STATE_CHANGE = 0,
+	TELEMETRY_EVENT_SESSION_START = 1,
+	TELEMETRY_EVENT_SESSION_END = 2,
+	TELEMETRY_EVENT_CURRENT_CHANGE = 3,
+	TELEMETRY_EVENT_SAMPLE = 4, /* one sample of a time-series block */
+	TELEMETRY_EVENT_HEALTH = 5, /* periodic device health report */
+	TELEMETRY_EVENT_UNKNOWN = 0xF,
+};
+
+#define TELEMETRY_BIN_DECL_BODY(NAME, code, name, src_type) struct telemetry_##name##_fields name;
+
+/* [TELEMETRY] Decoded record; string fields are NUL terminated copies. */
+struct telemetry_bin_record {
+	enum telemetry_bin_type type;
+	int64_t timestamp_ms;
+	bool time_anomaly;
+	char event_id[TELEMETRY_SCHEMA_STR_MAX + 1];
+	enum telemetry_event_type event_type;
+	char run_id[TELEMETRY_SCHEMA_STR_MAX + 1];
+	union {
+		TELEMETRY_SCHEMA_RECORDS(TELEMETRY_BIN_DECL_BODY)
+	};
+};
+
+enum telemetry_event_type telemetry_event_type_from_str(const char *event_type);
+const char *telemetry_event_type_str(enum telemetry_event_type event_type);
+
+int telemetry_build_gpio_payload_bin(uint8_t *buf, size_t buf_len, const char *pin_alias,
+				     int state, gpio_edge_t edge, int64_t timestamp_ms,
+				     const char *run_id, const char *event_id, bool time_anomaly);
+
+int telemetry_build_evse_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+				     const struct evse_event *evt, const char *event_id,
+				     bool time_anomaly);
+
+int telemetry_build_line_current_payload_bin(uint8_t *buf, size_t buf_len,
+					     int64_t timestamp_ms,
+					     const struct line_current_event *evt,
+					     const char *event_id, bool time_anomaly);
+
+int telemetry_build_session_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+					const struct evse_session_summary *summary,
+					const char *event_id, bool time_anomaly);
+
+int telemetry_build_health_payload_bin(uint8_t *buf, size_t buf_len, int64_t timestamp_ms,
+				       const struct telemetry_health *health, const char *event_id,
+				       bool time_anomaly);
+
+int telemetry_decode_bin(const uint8_t *buf, size_t len, struct telemetry_bin_record *rec);
+
+#endif /* TELEMETRY_BINARY_H */
@@ -0,0 +1,669 @@
+/*
+ * [TELEMETRY] Host-side frame decoder (JSON, binary, batches, fragments, series).
+ * [BOILERPLATE] Single-pass JSON cursor limited to what the firmware emits:
+ * objects, arrays, strings with simple escapes, integers and fixed decimals.
+ * Numbers are parsed straight into the schema's fixed-point scale, no floats.
+ */
+#include "telemetry/telemetry_decode.h"
+#include "telemetry/telemetry_batch.h"
+#include "telemetry/telemetry_series.h"
+#include "telemetry/telemetry_writer.h"
+
+#include <string.h>
+
+#define JSON_KEY_MAX 31
+#define JSON_DEPTH_MAX 8
+
+struct json_cur {
+	const char *p;
+	const char *end;
+	bool err;
+};
+
+static void json_ws(struct json_cur *c)
+{
+	while (c->p < c->end && (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r')) {
+		c->p++;
+	}
+}
+
+static bool json_peek(struct json_cur *c, char ch)
+{
+	json_ws(c);
+	return !c->err && c->p < c->end && *c->p == ch;
+}
+
+static void json_expect(struct json_cur *c, char ch)
+{
+	if (!json_peek(c, ch)) {
+		c->err = true;
+		return;
+	}
+	c->p++;
+}
+
+/* [BOILERPLATE] After a member: true on ',', false on the closing bracket. */
+static bool json_more(struct json_cur *c, char close)
+{
+	if (json_peek(c, ',')) {
+		c->p++;
+		return true;
+	}
+	json_expect(c, close);
+	return false;
+}
+
+static void json_literal(struct json_cur *c, const char *lit, size_t n)
+{
+	json_ws(c);
+	if (c->err || (size_t)(c->end - c->p) < n || memcmp(c->p, lit, n) != 0) {
+		c->err = true;
+		return;
+	}
+	c->p += n;
+}
+
+#define JSON_LITERAL(c, lit) json_literal((c), (lit), sizeof(lit) - 1)
+
+/* [BOILERPLATE] String into out[max + 1]; out == NULL skips the value. */
+static void json_string(struct json_cur *c, char *out, size_t max)
+{
+	size_t n = 0;
+
+	json_expect(c, '"');
+	while (!c->err) {
+		if (c->p >= c->end) {
+			c->err = true;
+			break;
+		}
+		char ch = *c->p++;
+		if (ch == '"') {
+			break;
+		}
+		if (ch == '\\') {
+			if (c->p >= c->end) {
+				c->err = true;
+				break;
+			}
+			ch = *c->p++;
+			if (ch == 'n') {
+				ch = '\n';
+			} else if (ch == 't') {
+				ch = '\t';
+			} else if (ch == 'r') {
+				ch = '\r';
+			} else if (ch != '"' && ch != '\\' && ch != '/') {
+				c->err = true;
+				break;
+			}
+		}
+		if (out) {
+			if (n >= max) {
+				c->err = true;
+				break;
+			}
+			out[n] = ch;
+		}
+		n++;
+	}
+	if (out) {
+		out[c->err ? 0 : n] = '\0';
+	}
+}
+
+static void json_string_or_null(struct json_cur *c, char *out, size_t max)
+{
+	if (json_peek(c, 'n')) {
+		JSON_LITERAL(c, "null");
+		out[0] = '\0';
+		return;
+	}
+	json_string(c, out, max);
+}
+
+static bool json_bool(struct json_cur *c)
+{
+	if (json_peek(c, 't')) {
+		JSON_LITERAL(c, "true");
+		return true;
+	}
+	JSON_LITERAL(c, "false");
+	return false;
+}
+
+/*
+ * [TELEMETRY] Decimal as value * 10^decimals. More fraction digits than the
+ * schema carries, exponents and overflow are errors, so decoding is exact.
+ */
+static int64_t json_fixed(struct json_cur *c, unsigned int decimals)
+{
+	bool neg = false;
+	bool dot = false;
+	bool digits = false;
+	unsigned int frac = 0;
+	int64_t v = 0;
+
+	json_ws(c);
+	if (c->p < c->end && *c->p == '-') {
+		neg = true;
+		c->p++;
+	}
+	while (!c->err && c->p < c->end) {
+		char ch = *c->p;
+		if (ch == '.' && !dot && decimals > 0) {
+			dot = true;
+			c->p++;
+			continue;
+		}
+		if (ch < '0' || ch > '9') {
+			break;
+		}
+		if ((dot && frac == decimals) || v > (INT64_MAX - 9) / 10) {
+			c->err = true;
+			break;
+		}
+		v = v * 10 + (ch - '0');
+		digits = true;
+		frac += dot ? 1 : 0;
+		c->p++;
+	}
+	for (; !c->err && frac < decimals; frac++) {
+		if (v > INT64_MAX / 10) {
+			c->err = true;
+		}
+		v *= 10;
+	}
+	if (!digits) {
+		c->err = true;
+	}
+	return c->err ? 0 : (neg ? -v : v);
+}
+
+static void json_skip(struct json_cur *c, int depth)
+{
+	json_ws(c);
+	if (c->err || c->p >= c->end || depth > JSON_DEPTH_MAX) {
+		c->err = true;
+		return;
+	}
+
+	char ch = *c->p;
+	if (ch == '"') {
+		json_string(c, NULL, 0);
+	} else if (ch == '{' || ch == '[') {
+		char close = ch == '{' ? '}' : ']';
+		c->p++;
+		if (json_peek(c, close)) {
+			c->p++;
+			return;
+		}
+		do {
+			if (close == '}') {
+				json_string(c, NULL, 0);
+				json_expect(c, ':');
+			}
+			json_skip(c, depth + 1);
+		} while (!c->err && json_more(c, close));
+	} else if (ch == 't' || ch == 'f') {
+		(void)json_bool(c);
+	} else if (ch == 'n') {
+		JSON_LITERAL(c, "null");
+	} else {
+		const char *start = c->p;
+		while (c->p < c->end && strchr("+-.0123456789eE", *c->p)) {
+			c->p++;
+		}
+		c->err = c->p == start;
+	}
+}
+
+static void json_key(struct json_cur *c, char key[JSON_KEY_MAX + 1])
+{
+	json_string(c, key, JSON_KEY_MAX);
+	json_expect(c, ':');
+}
+
+static gpio_edge_t edge_from_str(const char *s)
+{
+	for (int e = GPIO_EDGE_NONE; e < GPIO_EDGE_UNKNOWN; e++) {
+		if (strcmp(s, gpio_edge_str((gpio_edge_t)e)) == 0) {
+			return (gpio_edge_t)e;
+		}
+	}
+	return GPIO_EDGE_UNKNOWN;
+}
+
+static gpio_edge_t json_edge(struct json_cur *c)
+{
+	char s[16];
+
+	json_string(c, s, sizeof(s) - 1);
+	return edge_from_str(s);
+}
+
+static enum evse_pilot_state json_pilot(struct json_cur *c)
+{
+	char s[2];
+
+	json_string(c, s, sizeof(s) - 1);
+	return evse_pilot_state_from_char(s[0]);
+}
+
+#define JSON_GET_STR(c, out) json_string(c, out, TELEMETRY_SCHEMA_STR_MAX)
+#define JSON_GET_ID(c, out) json_string(c, out, TELEMETRY_SCHEMA_STR_MAX)
+#define JSON_GET_INT(c, out) (out) = (int32_t)json_fixed(c, 0)
+#define JSON_GET_BOOL(c, out) (out) = json_bool(c)
+#define JSON_GET_EDGE(c, out) (out) = json_edge(c)
+#define JSON_GET_PILOT(c, out) (out) = json_pilot(c)
+#define JSON_GET_FIXED2(c, out) (out) = json_fixed(c, 2)
+#define JSON_GET_FIXED3(c, out) (out) = json_fixed(c, 3)
+#define JSON_GET_FIXED4(c, out) (out) = json_fixed(c, 4)
+#define JSON_GET_UPTIME(c, out) (out) = json_fixed(c, 0)
+
+/* [TELEMETRY] Elided frames omit uptime_ms; it equals the timestamp, as in binary. */
+#define JSON_DEFAULT_UPTIME(out) (out) = rec->timestamp_ms
+#define JSON_DEFAULT_STR(out)
+#define JSON_DEFAULT_ID(out)
+#define JSON_DEFAULT_INT(out)
+#define JSON_DEFAULT_BOOL(out)
+#define JSON_DEFAULT_EDGE(out)
+#define JSON_DEFAULT_PILOT(out)
+#define JSON_DEFAULT_FIXED2(out)
+#define JSON_DEFAULT_FIXED3(out)
+#define JSON_DEFAULT_FIXED4(out)
+
+#define JSON_DEFAULT_FIELD(kind, key, member) JSON_DEFAULT_##kind(body->member);
+#define JSON_GET_FIELD(kind, key, member)                                                  \
+	if (strcmp(k, key) == 0) {                                                         \
+		JSON_GET_##kind(c, body->member);                                          \
+		continue;                                                                  \
+	}
+
+#define JSON_BODY_RECORD(NAME, code, name, src_type)                                       \
+	static void json_body_##name(struct json_cur *c, struct telemetry_bin_record *rec)  \
+	{                                                                                  \
+		struct telemetry_##name##_fields *body = &rec->name;                       \
+		char k[JSON_KEY_MAX + 1];                                                  \
+                                                                                           \
+		TELEMETRY_SCHEMA_##NAME(JSON_DEFAULT_FIELD)                                \
+		json_expect(c, '{');                                                       \
+		if (json_peek(c, '}')) {                                                   \
+			c->p++;                                                            \
+			return;                                                            \
+		}                                                                          \
+		do {                                                                       \
+			json_key(c, k);                                                    \
+			TELEMETRY_SCHEMA_##NAME(JSON_GET_FIELD)                            \
+			json_skip(c, 1);                                                   \
+		} while (!c->err && json_more(c, '}'));                                    \
+	}
+TELEMETRY_SCHEMA_RECORDS(JSON_BODY_RECORD)
+
+#define JSON_BODY_CASE(NAME, code, name, src_type)                                         \
+	if (strcmp(k, #name) == 0) {                                                       \
+		rec->type = TELEMETRY_BIN_TYPE_##NAME;                                     \
+		json_body_##name(c, rec);                                                  \
+		continue;                                                                  \
+	}
+
+static void json_data(struct json_cur *c, struct telemetry_bin_record *rec)
+{
+	char k[JSON_KEY_MAX + 1];
+
+	json_expect(c, '{');
+	do {
+		json_key(c, k);
+		TELEMETRY_SCHEMA_RECORDS(JSON_BODY_CASE)
+		json_skip(c, 1);
+	} while (!c->err && json_more(c, '}'));
+}
+
+static int hex_digit(char ch)
+{
+	if (ch >= '0' && ch <= '9') {
+		return ch - '0';
+	}
+	if (ch >= 'a' && ch <= 'f') {
+		return ch - 'a' + 10;
+	}
+	return -1;
+}
+
+static void json_ctx(struct json_cur *c, struct telemetry_record *out)
+{
+	char s[5];
+	unsigned int v = 0;
+
+	json_string(c, s, sizeof(s) - 1);
+	for (int i = 0; i < 4 && !c->err; i++) {
+		int d = hex_digit(s[i]);
+		if (d < 0) {
+			c->err = true;
+		}
+		v = (v << 4) | (unsigned int)d;
+	}
+	out->ctx_id = (uint16_t)v;
+	out->has_ctx = !c->err;
+}
+
+int telemetry_decode_json(const char *json, size_t len, struct telemetry_record *out)
+{
+	if (!json || !out) {
+		return -1;
+	}
+
+	struct json_cur c = { .p = json, .end = json + len };
+	struct telemetry_bin_record *rec = &out->rec;
+	char k[JSON_KEY_MAX + 1];
+	char s[TELEMETRY_SCHEMA_STR_MAX + 1];
+
+	memset(out, 0, sizeof(*out));
+	out->encoding = TELEMETRY_ENCODING_JSON;
+	rec->event_type = TELEMETRY_EVENT_UNKNOWN;
+
+	json_expect(&c, '{');
+	do {
+		json_key(&c, k);
+		if (strcmp(k, "schema_version") == 0) {
+			json_string(&c, s, sizeof(s) - 1);
+			c.err |= strcmp(s, TELEMETRY_SCHEMA_VERSION) != 0;
+		} else if (strcmp(k, "device_id") == 0) {
+			json_string(&c, out->device_id, TELEMETRY_DECODE_DEVICE_MAX);
+		} else if (strcmp(k, "device_type") == 0) {
+			json_string(&c, out->device_type, TELEMETRY_DECODE_DEVICE_MAX);
+		} else if (strcmp(k, "ctx") == 0) {
+			json_ctx(&c, out);
+		} else if (strcmp(k, "timestamp") == 0) {
+			rec->timestamp_ms = json_fixed(&c, 0);
+		} else if (strcmp(k, "event_id") == 0) {
+			json_string(&c, rec->event_id, TELEMETRY_SCHEMA_STR_MAX);
+		} else if (strcmp(k, "time_anomaly") == 0) {
+			rec->time_anomaly = json_bool(&c);
+		} else if (strcmp(k, "event_type") == 0) {
+			json_string(&c, s, sizeof(s) - 1);
+			out->announce = strcmp(s, "announce") == 0;
+			rec->event_type = telemetry_event_type_from_str(s);
+		} else if (strcmp(k, "run_id") == 0) {
+			json_string_or_null(&c, rec->run_id, TELEMETRY_SCHEMA_STR_MAX);
+		} else if (strcmp(k, "data") == 0) {
+			json_data(&c, rec);
+		} else {
+			json_skip(&c, 1);
+		}
+	} while (!c.err && json_more(&c, '}'));
+
+	if (c.err || (!out->announce && rec->type == 0)) {
+		return -1;
+	}
+	return (int)(c.p - json);
+}
+
+void telemetry_decoder_init(struct telemetry_decoder *d)
+{
+	memset(d, 0, sizeof(*d));
+	telemetry_reassembly_init(&d->frag);
+}
+
+static void deliver(const struct telemetry_record *r, telemetry_decode_cb_t cb, void *ctx)
+{
+	if (cb) {
+		cb(r, ctx);
+	}
+}
+
+/* [TELEMETRY] Bare JSON record or a JSON batch array. */
+static int decode_json_frame(const char *s, size_t len, telemetry_decode_cb_t cb, void *ctx)
+{
+	struct telemetry_record r;
+	struct json_cur c = { .p = s, .end = s + len };
+	bool array = json_peek(&c, '[');
+	int count = 0;
+
+	if (array) {
+		c.p++;
+	}
+	do {
+		int n = telemetry_decode_json(c.p, (size_t)(c.end - c.p), &r);
+		if (n < 0) {
+			return -1;
+		}
+		c.p += n;
+		deliver(&r, cb, ctx);
+		count++;
+	} while (array && json_more(&c, ']'));
+
+	json_ws(&c);
+	return (c.err || c.p != c.end) ? -1 : count;
+}
+
+struct series_sink {
+	const struct telemetry_series_info *info;
+	telemetry_decode_cb_t cb;
+	void *ctx;
+};
+
+/* [TELEMETRY] One series sample as a current record with event_type "sample". */
+static void series_sample(int64_t timestamp_ms, int32_t value_ma, void *arg)
+{
+	const struct series_sink *sink = arg;
+	struct telemetry_record r;
+
+	memset(&r, 0, sizeof(r));
+	r.encoding = TELEMETRY_ENCODING_BINARY;
+	r.rec.timestamp_ms = timestamp_ms;
+	r.rec.time_anomaly = sink->info->time_anomaly;
+	r.rec.event_type = TELEMETRY_EVENT_SAMPLE;
+	if (sink->info->channel == TELEMETRY_SERIES_EVSE_CURRENT) {
+		r.rec.type = TELEMETRY_BIN_TYPE_EVSE;
+		r.rec.evse.pilot_state = EVSE_PILOT_UNKNOWN;
+		r.rec.evse.current_draw_a = value_ma;
+	} else {
+		r.rec.type = TELEMETRY_BIN_TYPE_LINE_CURRENT;
+		r.rec.line_current.current_a = value_ma;
+	}
+	deliver(&r, sink->cb, sink->ctx);
+}
+
+static int decode_series_frame(const uint8_t *frame, size_t len, telemetry_decode_cb_t cb,
+			       void *ctx)
+{
+	struct telemetry_series_info info;
+	struct series_sink sink = { .info = &info, .cb = cb, .ctx = ctx };
+
+	/* Validate the whole block before delivering any sample. */
+	if (telemetry_series_decode(frame, len, &info, NULL, NULL) < 0 ||
+	    (info.channel != TELEMETRY_SERIES_LINE_CURRENT &&
+	     info.channel != TELEMETRY_SERIES_EVSE_CURRENT)) {
+		return -1;
+	}
+	return telemetry_series_decode(frame, len, &info, series_sample, &sink);
+}
+
+static int decode_frame(struct telemetry_decoder *d, const uint8_t *frame, size_t len,
+			telemetry_decode_cb_t cb, void *ctx, bool reassembled)
+{
+	struct telemetry_record r;
+	const uint8_t *rec;
+	size_t rec_len;
+	size_t off = 0;
+	int count = 0;
+	int res;
+
+	if (frame[0] == '{' || frame[0] == '[') {
+		return decode_json_frame((const char *)frame, len, cb, ctx);
+	}
+	if (telemetry_fragment_is_fragment(frame, len)) {
+		int n = reassembled ? -1 : telemetry_reassembly_add(&d->frag, frame, len);
+		if (n <= 0) {
+			return n;
+		}
+		return decode_frame(d, d->frag.buf, (size_t)n, cb, ctx, true);
+	}
+	if (frame[0] == ((TELEMETRY_BIN_SCHEMA_VERSION << 4) | TELEMETRY_BIN_TYPE_SERIES)) {
+		return decode_series_frame(frame, len, cb, ctx);
+	}
+
+	while ((res = telemetry_batch_next_bin(frame, len, &off, &rec, &rec_len)) == 1) {
+		memset(&r, 0, sizeof(r));
+		r.encoding = TELEMETRY_ENCODING_BINARY;
+		if (telemetry_decode_bin(rec, rec_len, &r.rec) != (int)rec_len) {
+			return -1;
+		}
+		deliver(&r, cb, ctx);
+		count++;
+	}
+	return res < 0 ? -1 : count;
+}
+
+int telemetry_decoder_feed(struct telemetry_decoder *d, const uint8_t *frame, size_t len,
+			   telemetry_decode_cb_t cb, void *ctx)
+{
+	if (!d || !frame || len == 0) {
+		return -1;
+	}
+
+	d->frames++;
+	int n = decode_frame(d, frame, len, cb, ctx, false);
+	if (n < 0) {
+		d->errors++;
+	} else {
+		d->records += (uint32_t)n;
+	}
+	return n;
+}
+
+/* [BOILERPLATE] CSV cell helpers; quoting only when the value needs it. */
+static void csv_str(struct telemetry_writer *w, const char *s)
+{
+	if (!strpbrk(s, ",\"\n\r")) {
+		telemetry_writer_str(w, s);
+		return;
+	}
+	telemetry_writer_char(w, '"');
+	for (; *s; s++) {
+		if (*s == '"') {
+			telemetry_writer_char(w, '"');
+		}
+		telemetry_writer_char(w, *s);
+	}
+	telemetry_writer_char(w, '"');
+}
+
+/* [TELEMETRY] Scaled integer back to the JSON text, e.g. 53330 @2 -> 533.30. */
+static void csv_fixed(struct telemetry_writer *w, int64_t v, unsigned int decimals)
+{
+	uint64_t mag = v < 0 ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+	uint64_t scale = 1;
+	char frac[4];
+
+	for (unsigned int i = 0; i < decimals; i++) {
+		scale *= 10;
+	}
+	if (v < 0) {
+		telemetry_writer_char(w, '-');
+	}
+	telemetry_writer_i64(w, (int64_t)(mag / scale));
+	telemetry_writer_char(w, '.');
+	mag %= scale;
+	for (unsigned int i = decimals; i > 0; i--) {
+		frac[i - 1] = (char)('0' + mag % 10);
+		mag /= 10;
+	}
+	telemetry_writer_raw(w, frac, decimals);
+}
+
+#define CSV_STR(w, v) csv_str(w, v)
+#define CSV_ID(w, v) csv_str(w, v)
+#define CSV_INT(w, v) telemetry_writer_i64(w, v)
+#define CSV_BOOL(w, v) telemetry_writer_bool(w, v)
+#define CSV_EDGE(w, v) telemetry_writer_str(w, gpio_edge_str(v))
+#define CSV_PILOT(w, v) telemetry_writer_char(w, evse_pilot_state_to_char(v))
+#define CSV_FIXED2(w, v) csv_fixed(w, v, 2)
+#define CSV_FIXED3(w, v) csv_fixed(w, v, 3)
+#define CSV_FIXED4(w, v) csv_fixed(w, v, 4)
+#define CSV_UPTIME(w, v) telemetry_writer_i64(w, v)
+
+#define CSV_HEADER_FIELD(kind, key, member)                                                \
+	telemetry_writer_char(&w, ',');                                                    \
+	telemetry_writer_str(&w, prefix);                                                  \
+	TELEMETRY_WRITER_LIT(&w, "." key);
+#define CSV_HEADER_RECORD(NAME, code, name, src_type)                                      \
+	{                                                                                  \
+		const char *prefix = #name;                                                \
+                                                                                           \
+		TELEMETRY_SCHEMA_##NAME(CSV_HEADER_FIELD)                                  \
+	}
+
+int telemetry_record_csv_header(char *buf, size_t buf_len)
+{
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, buf_len);
+	TELEMETRY_WRITER_LIT(&w, "encoding,type,timestamp,event_id,event_type,time_anomaly,"
+				 "run_id,device_id,device_type,ctx");
+	TELEMETRY_SCHEMA_RECORDS(CSV_HEADER_RECORD)
+	return telemetry_writer_finish(&w);
+}
+
+#define CSV_TYPE_NAME(NAME, code, name, src_type)                                          \
+	case TELEMETRY_BIN_TYPE_##NAME:                                                    \
+		return #name;
+
+static const char *csv_type_name(const struct telemetry_record *r)
+{
+	if (r->announce) {
+		return "announce";
+	}
+	switch (r->rec.type) {
+		TELEMETRY_SCHEMA_RECORDS(CSV_TYPE_NAME)
+	default:
+		return "unknown";
+	}
+}
+
+#define CSV_EMPTY_FIELD(kind, key, member) telemetry_writer_char(&w, ',');
+#define CSV_FIELD(kind, key, member)                                                       \
+	telemetry_writer_char(&w, ',');                                                    \
+	CSV_##kind(&w, body->member);
+#define CSV_RECORD(NAME, code, name, src_type)                                             \
+	if (r->rec.type == TELEMETRY_BIN_TYPE_##NAME) {                                    \
+		const struct telemetry_##name##_fields *body = &r->rec.name;               \
+                                                                                           \
+		TELEMETRY_SCHEMA_##NAME(CSV_FIELD)                                         \
+	} else {                                                                           \
+		TELEMETRY_SCHEMA_##NAME(CSV_EMPTY_FIELD)                                   \
+	}
+
+int telemetry_record_csv(const struct telemetry_record *r, char *buf, size_t buf_len)
+{
+	struct telemetry_writer w;
+
+	if (!r) {
+		return -1;
+	}
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_writer_str(&w, r->encoding == TELEMETRY_ENCODING_BINARY ? "binary" : "json");
+	telemetry_writer_char(&w, ',');
+	telemetry_writer_str(&w, csv_type_name(r));
+	telemetry_writer_char(&w, ',');
+	telemetry_writer_i64(&w, r->rec.timestamp_ms);
+	telemetry_writer_char(&w, ',');
+	csv_str(&w, r->rec.event_id);
+	telemetry_writer_char(&w, ',');
+	telemetry_writer_str(&w, r->announce ? "announce" :
+					       telemetry_event_type_str(r->rec.event_type));
+	telemetry_writer_char(&w, ',');
+	telemetry_writer_bool(&w, r->rec.time_anomaly);
+	telemetry_writer_char(&w, ',');
+	csv_str(&w, r->rec.run_id);
+	telemetry_writer_char(&w, ',');
+	csv_str(&w, r->device_id);
+	telemetry_writer_char(&w, ',');
+	csv_str(&w, r->device_type);
+	telemetry_writer_char(&w, ',');
+	if (r->has_ctx) {
+		telemetry_writer_hex16(&w, r->ctx_id);
+	}
+	TELEMETRY_SCHEMA_RECORDS(CSV_RECORD)
+	return telemetry_writer_finish(&w);
+}
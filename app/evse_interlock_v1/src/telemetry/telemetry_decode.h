@@ -0,0 +1,59 @@
+/*
+ * [TELEMETRY] Host-side decoder for every uplink frame the firmware emits.
+ * [BOILERPLATE] JSON (schema 1.0, full or elided envelope), binary records,
+ * batches, fragments and series blocks (one record per sample) all decode into
+ * one struct; field parsing is expanded from telemetry_schema.h so the decoder
+ * follows the encoders automatically.
+ * Not linked into the firmware image; used by host tests and tools/telemetry_decode.
+ */
+#ifndef TELEMETRY_DECODE_H
+#define TELEMETRY_DECODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_fragment.h"
+
+#define TELEMETRY_DECODE_DEVICE_MAX 63
+
+struct telemetry_record {
+	enum telemetry_encoding encoding;
+	/* [TELEMETRY] Announce frames carry only the envelope; rec.type is 0. */
+	bool announce;
+	/* Envelope fields; empty for binary and elided JSON frames. */
+	char device_id[TELEMETRY_DECODE_DEVICE_MAX + 1];
+	char device_type[TELEMETRY_DECODE_DEVICE_MAX + 1];
+	bool has_ctx;
+	uint16_t ctx_id;
+	struct telemetry_bin_record rec;
+};
+
+/* [TELEMETRY] Decode one JSON record; returns bytes consumed or -1. */
+int telemetry_decode_json(const char *json, size_t len, struct telemetry_record *out);
+
+typedef void (*telemetry_decode_cb_t)(const struct telemetry_record *rec, void *ctx);
+
+struct telemetry_decoder {
+	struct telemetry_reassembly frag;
+	uint32_t frames;
+	uint32_t records;
+	uint32_t errors;
+};
+
+void telemetry_decoder_init(struct telemetry_decoder *d);
+
+/*
+ * [TELEMETRY] Decode one uplink frame and call cb for each record in it.
+ * Returns the number of records delivered (0 for a fragment that does not yet
+ * complete its record) or -1 if the frame is malformed.
+ */
+int telemetry_decoder_feed(struct telemetry_decoder *d, const uint8_t *frame, size_t len,
+			   telemetry_decode_cb_t cb, void *ctx);
+
+/* [BOILERPLATE] CSV output: one column per envelope field and per schema field. */
+int telemetry_record_csv_header(char *buf, size_t buf_len);
+int telemetry_record_csv(const struct telemetry_record *r, char *buf, size_t buf_len);
+
+#endif /* TELEMETRY_DECODE_H */
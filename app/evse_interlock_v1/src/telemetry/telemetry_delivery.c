@@ -0,0 +1,215 @@
+/*
+ * [TELEMETRY] Uplink delivery tracking and retry (see telemetry_delivery.h).
+ */
+#include "telemetry/telemetry_delivery.h"
+
+#include <string.h>
+
+static struct telemetry_delivery_slot *slot_by_id(struct telemetry_delivery *d, uint16_t id)
+{
+	for (uint16_t i = 0; i < d->count; i++) {
+		if (d->slots[i].state == TELEMETRY_DELIVERY_IN_FLIGHT && d->slots[i].id == id) {
+			return &d->slots[i];
+		}
+	}
+	return NULL;
+}
+
+static void slot_in_flight(struct telemetry_delivery *d, struct telemetry_delivery_slot *s,
+			   uint16_t id, int64_t now_ms)
+{
+	s->state = TELEMETRY_DELIVERY_IN_FLIGHT;
+	s->id = id;
+	s->due_ms = now_ms + d->cfg.ack_timeout_ms;
+}
+
+/* [TELEMETRY] One attempt failed: back off, or give the record up. */
+static void slot_failed(struct telemetry_delivery *d, struct telemetry_delivery_slot *s,
+			int64_t now_ms)
+{
+	if (s->attempts >= d->cfg.max_attempts) {
+		d->stats.failed++;
+		s->state = TELEMETRY_DELIVERY_FREE;
+		return;
+	}
+	s->state = TELEMETRY_DELIVERY_BACKOFF;
+	s->due_ms = now_ms + telemetry_delivery_backoff_ms(d, s->attempts);
+}
+
+int telemetry_delivery_init(struct telemetry_delivery *d, struct telemetry_delivery_slot *slots,
+			    uint16_t count, uint8_t *storage, uint16_t item_size,
+			    const struct telemetry_delivery_config *cfg)
+{
+	if (!d || !cfg || (count && (!slots || !storage || item_size == 0)) ||
+	    count >= TELEMETRY_DELIVERY_NEW || cfg->max_attempts == 0 ||
+	    cfg->backoff_base_ms == 0 || cfg->backoff_max_ms < cfg->backoff_base_ms) {
+		return -1;
+	}
+	memset(d, 0, sizeof(*d));
+	d->slots = slots;
+	d->count = count;
+	d->item_size = item_size;
+	d->cfg = *cfg;
+	for (uint16_t i = 0; i < count; i++) {
+		memset(&slots[i], 0, sizeof(slots[i]));
+		slots[i].data = storage + (size_t)i * item_size;
+	}
+	return 0;
+}
+
+uint32_t telemetry_delivery_backoff_ms(const struct telemetry_delivery *d, uint8_t attempts)
+{
+	uint32_t delay = d->cfg.backoff_base_ms;
+
+	for (uint8_t i = 1; i < attempts && delay < d->cfg.backoff_max_ms; i++) {
+		delay = delay > UINT32_MAX / 2 ? UINT32_MAX : delay * 2;
+	}
+	if (delay > d->cfg.backoff_max_ms) {
+		delay = d->cfg.backoff_max_ms;
+	}
+	if (!d->cfg.rand) {
+		return delay;
+	}
+	/* [TELEMETRY] "Equal jitter": half fixed, half random, so retries spread out. */
+	uint32_t half = delay / 2;
+	return half + d->cfg.rand() % (delay - half + 1);
+}
+
+void telemetry_delivery_put(struct telemetry_delivery *d, uint16_t tag, bool put_ok, uint16_t id,
+			    const void *data, size_t len, int64_t now_ms)
+{
+	struct telemetry_delivery_slot *s = NULL;
+
+	if (!d) {
+		return;
+	}
+	if (tag != TELEMETRY_DELIVERY_NEW) {
+		if (tag >= d->count || d->slots[tag].state != TELEMETRY_DELIVERY_RESENDING) {
+			return;
+		}
+		s = &d->slots[tag];
+	} else {
+		for (uint16_t i = 0; i < d->count && !s; i++) {
+			if (d->slots[i].state == TELEMETRY_DELIVERY_FREE) {
+				s = &d->slots[i];
+			}
+		}
+		if (!s || !data || len == 0 || len > d->item_size) {
+			d->stats.untracked++;
+			return;
+		}
+		memcpy(s->data, data, len);
+		s->len = (uint16_t)len;
+		s->attempts = 0;
+		s->first_ms = now_ms;
+		d->stats.tracked++;
+	}
+
+	s->attempts++;
+	if (s->attempts > 1) {
+		d->stats.retries++;
+	}
+	if (put_ok) {
+		slot_in_flight(d, s, id, now_ms);
+	} else {
+		slot_failed(d, s, now_ms);
+	}
+}
+
+void telemetry_delivery_sent(struct telemetry_delivery *d, uint16_t id, int64_t now_ms)
+{
+	struct telemetry_delivery_slot *s = d ? slot_by_id(d, id) : NULL;
+
+	if (!s) {
+		if (d) {
+			d->stats.unknown++;
+		}
+		return;
+	}
+	int64_t ack_ms = now_ms - s->first_ms;
+	uint32_t ms = ack_ms < 0 ? 0 : ack_ms > UINT32_MAX ? UINT32_MAX : (uint32_t)ack_ms;
+
+	d->stats.acked++;
+	d->stats.ack_ms_total += ms;
+	if (ms > d->stats.ack_ms_max) {
+		d->stats.ack_ms_max = ms;
+	}
+	s->state = TELEMETRY_DELIVERY_FREE;
+}
+
+void telemetry_delivery_error(struct telemetry_delivery *d, uint16_t id, int64_t now_ms)
+{
+	struct telemetry_delivery_slot *s = d ? slot_by_id(d, id) : NULL;
+
+	if (!s) {
+		if (d) {
+			d->stats.unknown++;
+		}
+		return;
+	}
+	slot_failed(d, s, now_ms);
+}
+
+int telemetry_delivery_next_resend(struct telemetry_delivery *d, int64_t now_ms,
+				   const void **data, size_t *len)
+{
+	int due = -1;
+
+	if (!d) {
+		return -1;
+	}
+	for (uint16_t i = 0; i < d->count; i++) {
+		struct telemetry_delivery_slot *s = &d->slots[i];
+
+		if (s->state == TELEMETRY_DELIVERY_IN_FLIGHT && now_ms >= s->due_ms) {
+			d->stats.timeouts++;
+			slot_failed(d, s, now_ms);
+		} else if (s->state == TELEMETRY_DELIVERY_RESENDING && now_ms >= s->due_ms) {
+			/* The resend never reached sid_put_msg(). */
+			telemetry_delivery_put(d, i, false, 0, NULL, 0, now_ms);
+		}
+		/* Oldest record first among those due. */
+		if (s->state == TELEMETRY_DELIVERY_BACKOFF && now_ms >= s->due_ms &&
+		    (due < 0 || s->first_ms < d->slots[due].first_ms)) {
+			due = i;
+		}
+	}
+	if (due < 0) {
+		return -1;
+	}
+	d->slots[due].state = TELEMETRY_DELIVERY_RESENDING;
+	d->slots[due].due_ms = now_ms + d->cfg.ack_timeout_ms;
+	if (data) {
+		*data = d->slots[due].data;
+	}
+	if (len) {
+		*len = d->slots[due].len;
+	}
+	return due;
+}
+
+void telemetry_delivery_resend_failed(struct telemetry_delivery *d, uint16_t slot,
+				      int64_t now_ms)
+{
+	if (!d || slot >= d->count || d->slots[slot].state != TELEMETRY_DELIVERY_RESENDING) {
+		return;
+	}
+	telemetry_delivery_put(d, slot, false, 0, NULL, 0, now_ms);
+}
+
+int64_t telemetry_delivery_next_due(const struct telemetry_delivery *d)
+{
+	int64_t due = INT64_MAX;
+
+	if (!d) {
+		return due;
+	}
+	for (uint16_t i = 0; i < d->count; i++) {
+		const struct telemetry_delivery_slot *s = &d->slots[i];
+
+		if (s->state != TELEMETRY_DELIVERY_FREE && s->due_ms < due) {
+			due = s->due_ms;
+		}
+	}
+	return due;
+}
@@ -0,0 +1,113 @@
+/*
+ * [TELEMETRY] Uplink delivery tracking: an in-flight table keyed by the Sidewalk
+ * message id, with retries on exponential backoff and jitter.
+ * [BOILERPLATE] Pure C over caller-owned storage; the caller supplies time and
+ * randomness, so the same code runs on the device and in host tests.
+ *
+ * A slot goes FREE -> IN_FLIGHT when sid_put_msg() hands out an id, and back to
+ * FREE on the send confirmation. A send error, a put error or a confirmation
+ * that never comes (ack_timeout_ms) moves it to BACKOFF; once due it is handed
+ * out for a resend (RESENDING) and returns to IN_FLIGHT under its new id; a
+ * resend that never reaches sid_put_msg() also times out. After max_attempts
+ * the record is given up and counted as failed.
+ */
+#ifndef TELEMETRY_DELIVERY_H
+#define TELEMETRY_DELIVERY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* [TELEMETRY] Tag for a first send; a resend is tagged with its slot index. */
+#define TELEMETRY_DELIVERY_NEW 0xFFFF
+
+enum telemetry_delivery_state {
+	TELEMETRY_DELIVERY_FREE = 0,
+	TELEMETRY_DELIVERY_IN_FLIGHT,
+	TELEMETRY_DELIVERY_BACKOFF,
+	TELEMETRY_DELIVERY_RESENDING,
+};
+
+struct telemetry_delivery_config {
+	uint32_t backoff_base_ms;
+	uint32_t backoff_max_ms;
+	/* In flight this long without a confirmation counts as a failed attempt. */
+	uint32_t ack_timeout_ms;
+	/* Sends per record, the first one included. */
+	uint8_t max_attempts;
+	uint32_t (*rand)(void);
+};
+
+struct telemetry_delivery_stats {
+	/* Records tracked, and records the table had no room for. */
+	uint32_t tracked;
+	uint32_t untracked;
+	uint32_t acked;
+	/* Given up after max_attempts. */
+	uint32_t failed;
+	uint32_t retries;
+	uint32_t timeouts;
+	/* Confirmations for ids not in the table (untracked or already timed out). */
+	uint32_t unknown;
+	/* Time from the first send to the confirmation, over acked records. */
+	uint64_t ack_ms_total;
+	uint32_t ack_ms_max;
+};
+
+struct telemetry_delivery_slot {
+	uint8_t *data;
+	uint16_t len;
+	uint16_t id;
+	uint8_t state;
+	uint8_t attempts;
+	int64_t first_ms;
+	/* BACKOFF: when to resend; otherwise when the pending step times out. */
+	int64_t due_ms;
+};
+
+struct telemetry_delivery {
+	struct telemetry_delivery_slot *slots;
+	uint16_t count;
+	uint16_t item_size;
+	struct telemetry_delivery_config cfg;
+	struct telemetry_delivery_stats stats;
+};
+
+/*
+ * [TELEMETRY] slots[count] and storage of count * item_size bytes belong to the
+ * caller. Returns 0 or -1.
+ */
+int telemetry_delivery_init(struct telemetry_delivery *d, struct telemetry_delivery_slot *slots,
+			    uint16_t count, uint8_t *storage, uint16_t item_size,
+			    const struct telemetry_delivery_config *cfg);
+
+/*
+ * [TELEMETRY] Outcome of sid_put_msg() for a message tagged with
+ * TELEMETRY_DELIVERY_NEW or a slot index: the assigned id when put_ok, a failed
+ * attempt otherwise. A new record is copied into a free slot.
+ */
+void telemetry_delivery_put(struct telemetry_delivery *d, uint16_t tag, bool put_ok, uint16_t id,
+			    const void *data, size_t len, int64_t now_ms);
+
+/* [TELEMETRY] Send confirmation / send error for a message id. */
+void telemetry_delivery_sent(struct telemetry_delivery *d, uint16_t id, int64_t now_ms);
+void telemetry_delivery_error(struct telemetry_delivery *d, uint16_t id, int64_t now_ms);
+
+/*
+ * [TELEMETRY] Expire overdue confirmations, then hand out one record due for a
+ * resend. Returns its slot index (the tag for the resend) or -1.
+ */
+int telemetry_delivery_next_resend(struct telemetry_delivery *d, int64_t now_ms,
+				   const void **data, size_t *len);
+
+/* [TELEMETRY] A resend that could not even be queued counts as a failed attempt. */
+void telemetry_delivery_resend_failed(struct telemetry_delivery *d, uint16_t slot,
+				      int64_t now_ms);
+
+/* [TELEMETRY] Earliest resend or confirmation timeout; INT64_MAX when idle. */
+int64_t telemetry_delivery_next_due(const struct telemetry_delivery *d);
+
+/* [TELEMETRY] Backoff before attempt n+1 after n failed attempts, with jitter. */
+uint32_t telemetry_delivery_backoff_ms(const struct telemetry_delivery *d, uint8_t attempts);
+
+#endif /* TELEMETRY_DELIVERY_H */
@@ -0,0 +1,138 @@
+/*
+ * [TELEMETRY] JSON envelope formatting shared by all payload builders.
+ * [BOILERPLATE] Context id hashing and announce frame glue.
+ */
+#include "telemetry/telemetry_envelope.h"
+
+/* [BOILERPLATE] FNV-1a over a NUL-separated field list. */
+static uint32_t fnv1a(uint32_t h, const char *s)
+{
+	for (; *s; s++) {
+		h ^= (uint8_t)*s;
+		h *= 16777619u;
+	}
+	/* Terminating NUL keeps "ab"+"c" distinct from "a"+"bc". */
+	h *= 16777619u;
+	return h;
+}
+
+/*
+ * [TELEMETRY] The ctx id is a stable hash of every elided field, so it only changes
+ * when the envelope does and the cloud can keep its ctx -> envelope mapping across
+ * reboots.
+ */
+uint16_t telemetry_envelope_ctx_id(const char *device_id, const char *device_type)
+{
+	uint32_t h = 2166136261u;
+
+	h = fnv1a(h, TELEMETRY_SCHEMA_VERSION);
+	h = fnv1a(h, device_id ? device_id : "");
+	h = fnv1a(h, device_type ? device_type : "");
+	return (uint16_t)((h >> 16) ^ (h & 0xFFFF));
+}
+
+/* [TELEMETRY] Schema 1.0 head shared by FULL event frames and the announce frame. */
+static void telemetry_envelope_full_prefix(struct telemetry_writer *w,
+					   const struct telemetry_envelope *env)
+{
+	TELEMETRY_WRITER_LIT(w, "{\"schema_version\":\"" TELEMETRY_SCHEMA_VERSION
+				"\",\"device_id\":\"");
+	telemetry_writer_str(w, env->device_id);
+	TELEMETRY_WRITER_LIT(w, "\",\"device_type\":\"");
+	telemetry_writer_str(w, env->device_type);
+	TELEMETRY_WRITER_LIT(w, "\",\"timestamp\":");
+}
+
+int telemetry_envelope_init(struct telemetry_envelope *env, const char *device_id,
+			    const char *device_type, enum telemetry_envelope_mode mode)
+{
+	struct telemetry_writer w;
+
+	if (!env || !device_id || !device_type) {
+		return -1;
+	}
+	env->device_id = device_id;
+	env->device_type = device_type;
+	env->mode = mode;
+	env->ctx_id = telemetry_envelope_ctx_id(device_id, device_type);
+
+	/* [TELEMETRY] Everything before the timestamp is constant per device; render it once. */
+	telemetry_writer_init(&w, env->prefix, sizeof(env->prefix));
+	if (mode == TELEMETRY_ENVELOPE_ELIDED) {
+		TELEMETRY_WRITER_LIT(&w, "{\"ctx\":\"");
+		telemetry_writer_hex16(&w, env->ctx_id);
+		TELEMETRY_WRITER_LIT(&w, "\",\"timestamp\":");
+	} else {
+		telemetry_envelope_full_prefix(&w, env);
+	}
+	int len = telemetry_writer_finish(&w);
+	if (len < 0) {
+		env->prefix_len = 0;
+		return -1;
+	}
+	env->prefix_len = (size_t)len;
+	return 0;
+}
+
+/*
+ * [TELEMETRY] Envelope head up to and including "data":{ ; the caller appends the
+ * record body. Field order in FULL mode matches schema 1.0 byte for byte.
+ */
+void telemetry_envelope_head(struct telemetry_writer *w, const struct telemetry_envelope *env,
+			     int64_t timestamp_ms, const char *event_id, bool time_anomaly,
+			     const char *event_type, const char *run_id)
+{
+	bool has_run_id = run_id && run_id[0] != '\0';
+
+	telemetry_writer_raw(w, env->prefix, env->prefix_len);
+	telemetry_writer_i64(w, timestamp_ms);
+	TELEMETRY_WRITER_LIT(w, ",\"event_id\":\"");
+	telemetry_writer_str(w, event_id);
+	TELEMETRY_WRITER_LIT(w, "\",\"time_anomaly\":");
+	telemetry_writer_bool(w, time_anomaly);
+	TELEMETRY_WRITER_LIT(w, ",\"event_type\":\"");
+	telemetry_writer_str(w, event_type);
+
+	if (env->mode == TELEMETRY_ENVELOPE_ELIDED) {
+		TELEMETRY_WRITER_LIT(w, "\",");
+		if (has_run_id) {
+			TELEMETRY_WRITER_LIT(w, "\"run_id\":\"");
+			telemetry_writer_str(w, run_id);
+			TELEMETRY_WRITER_LIT(w, "\",");
+		}
+	} else {
+		TELEMETRY_WRITER_LIT(w, "\",\"location\":null,\"run_id\":");
+		if (has_run_id) {
+			telemetry_writer_char(w, '"');
+			telemetry_writer_str(w, run_id);
+			TELEMETRY_WRITER_LIT(w, "\",");
+		} else {
+			TELEMETRY_WRITER_LIT(w, "null,");
+		}
+	}
+	TELEMETRY_WRITER_LIT(w, "\"data\":{");
+}
+
+/* [TELEMETRY] One-shot frame carrying every field elided from event frames. */
+int telemetry_build_announce_payload(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, int64_t timestamp_ms,
+				     const char *event_id)
+{
+	struct telemetry_writer w;
+
+	if (!buf || buf_len == 0 || !env || !env->device_id || !env->device_type ||
+	    !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_full_prefix(&w, env);
+	telemetry_writer_i64(&w, timestamp_ms);
+	TELEMETRY_WRITER_LIT(&w, ",\"event_id\":\"");
+	telemetry_writer_str(&w, event_id);
+	TELEMETRY_WRITER_LIT(&w, "\",\"event_type\":\"announce\",\"location\":null,"
+				 "\"run_id\":null,\"ctx\":\"");
+	telemetry_writer_hex16(&w, env->ctx_id);
+	TELEMETRY_WRITER_LIT(&w, "\"}");
+	return telemetry_writer_finish(&w);
+}
@@ -0,0 +1,48 @@
+/*
+ * [TELEMETRY] Shared JSON envelope (schema_version/device_id/device_type/...).
+ * [BOILERPLATE] Envelope mode selection and announce frame builder.
+ * In ELIDED mode the static fields are sent once in an announce frame and every
+ * event frame carries only a short "ctx" id that refers back to it.
+ * The constant head of every frame is rendered once by telemetry_envelope_init().
+ */
+#ifndef TELEMETRY_ENVELOPE_H
+#define TELEMETRY_ENVELOPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/telemetry_writer.h"
+
+#define TELEMETRY_SCHEMA_VERSION "1.0"
+#define TELEMETRY_ENVELOPE_PREFIX_MAX 128
+
+enum telemetry_envelope_mode {
+	TELEMETRY_ENVELOPE_FULL = 0,
+	TELEMETRY_ENVELOPE_ELIDED,
+};
+
+struct telemetry_envelope {
+	const char *device_id;
+	const char *device_type;
+	uint16_t ctx_id;
+	enum telemetry_envelope_mode mode;
+	/* [TELEMETRY] Cached '{...,"timestamp":' head for the selected mode. */
+	char prefix[TELEMETRY_ENVELOPE_PREFIX_MAX];
+	size_t prefix_len;
+};
+
+int telemetry_envelope_init(struct telemetry_envelope *env, const char *device_id,
+			    const char *device_type, enum telemetry_envelope_mode mode);
+
+uint16_t telemetry_envelope_ctx_id(const char *device_id, const char *device_type);
+
+void telemetry_envelope_head(struct telemetry_writer *w, const struct telemetry_envelope *env,
+			     int64_t timestamp_ms, const char *event_id, bool time_anomaly,
+			     const char *event_type, const char *run_id);
+
+int telemetry_build_announce_payload(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, int64_t timestamp_ms,
+				     const char *event_id);
+
+#endif /* TELEMETRY_ENVELOPE_H */
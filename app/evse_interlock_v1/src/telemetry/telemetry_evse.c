@@ -3,29 +3,7 @@
  * [EVSE-LOGIC] Field semantics follow J1772 pilot/proximity state machine.
  */
 #include "telemetry/telemetry_evse.h"
-
-#include <stdio.h>
-
-/* [BOILERPLATE] Convert enum to compact JSON-friendly pilot state. */
-static char telemetry_pilot_state_to_char(enum evse_pilot_state state)
-{
-	switch (state) {
-	case EVSE_PILOT_A:
-		return 'A';
-	case EVSE_PILOT_B:
-		return 'B';
-	case EVSE_PILOT_C:
-		return 'C';
-	case EVSE_PILOT_D:
-		return 'D';
-	case EVSE_PILOT_E:
-		return 'E';
-	case EVSE_PILOT_F:
-		return 'F';
-	default:
-		return '?';
-	}
-}
+#include "telemetry/telemetry_schema.h"
 
 int telemetry_build_evse_payload(char *buf, size_t buf_len, const char *device_id,
 				 const char *device_type, int64_t timestamp_ms,
@@ -41,27 +19,49 @@ int telemetry_build_evse_payload_ex(char *buf, size_t buf_len, const char *devic
 				    const struct evse_event *evt, const char *event_id,
 				    bool time_anomaly)
 {
-	if (!buf || buf_len == 0 || !device_id || !device_type || !evt || !event_id ||
-	    event_id[0] == '\0') {
+	struct telemetry_envelope env;
+
+	if (telemetry_envelope_init(&env, device_id, device_type, TELEMETRY_ENVELOPE_FULL)) {
+		return -1;
+	}
+	return telemetry_build_evse_payload_env(buf, buf_len, &env, timestamp_ms, evt, event_id,
+						time_anomaly);
+}
+
+int telemetry_build_evse_payload_env(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, int64_t timestamp_ms,
+				     const struct evse_event *evt, const char *event_id,
+				     bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !env || !evt || !event_id || event_id[0] == '\0') {
 		return -1;
 	}
 
-	int len = snprintf(
-		buf, buf_len,
-		"{\"schema_version\":\"1.0\",\"device_id\":\"%s\",\"device_type\":\"%s\","
-		"\"timestamp\":%lld,\"event_id\":\"%s\",\"time_anomaly\":%s,\"event_type\":\"%s\","
-		"\"location\":null,\"run_id\":null,"
-		"\"data\":{\"evse\":{\"pilot_state\":\"%c\",\"pwm_duty_cycle\":%.2f,"
-		"\"current_draw\":%.3f,\"proximity_detected\":%s,\"session_id\":\"%s\","
-		"\"energy_delivered_kwh\":%.4f}}}",
-		device_id, device_type, (long long)timestamp_ms,
-		event_id, time_anomaly ? "true" : "false", evt->event_type,
-		telemetry_pilot_state_to_char(evt->pilot_state), (double)evt->pwm_duty_cycle,
-		(double)evt->current_draw_a, evt->proximity_detected ? "true" : "false",
-		evt->session_id ? evt->session_id : "", (double)evt->energy_kwh);
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_head(&w, env, timestamp_ms, event_id, time_anomaly, evt->event_type,
+				NULL);
+	telemetry_schema_json_evse(&w, env, evt);
+	TELEMETRY_WRITER_LIT(&w, "}}");
+	return telemetry_writer_finish(&w);
+}
 
-	if (len < 0 || (size_t)len >= buf_len) {
+int telemetry_build_session_payload_env(char *buf, size_t buf_len,
+					const struct telemetry_envelope *env, int64_t timestamp_ms,
+					const struct evse_session_summary *summary,
+					const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !env || !summary || !event_id || event_id[0] == '\0') {
 		return -1;
 	}
-	return len;
+
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_head(&w, env, timestamp_ms, event_id, time_anomaly, "session_end",
+				NULL);
+	telemetry_schema_json_session(&w, env, summary);
+	TELEMETRY_WRITER_LIT(&w, "}}");
+	return telemetry_writer_finish(&w);
 }
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 
 #include "telemetry/evse.h"
+#include "telemetry/telemetry_envelope.h"
 
 int telemetry_build_evse_payload(char *buf, size_t buf_len, const char *device_id,
 				 const char *device_type, int64_t timestamp_ms,
@@ -20,4 +21,15 @@ int telemetry_build_evse_payload_ex(char *buf, size_t buf_len, const char *devic
 				    const struct evse_event *evt, const char *event_id,
 				    bool time_anomaly);
 
+int telemetry_build_evse_payload_env(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, int64_t timestamp_ms,
+				     const struct evse_event *evt, const char *event_id,
+				     bool time_anomaly);
+
+/* [EVSE-LOGIC] Session summary record; shares event_id with its session_end record. */
+int telemetry_build_session_payload_env(char *buf, size_t buf_len,
+					const struct telemetry_envelope *env, int64_t timestamp_ms,
+					const struct evse_session_summary *summary,
+					const char *event_id, bool time_anomaly);
+
 #endif /* TELEMETRY_EVSE_H */
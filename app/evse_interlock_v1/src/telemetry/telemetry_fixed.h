@@ -0,0 +1,76 @@
+/*
+ * [TELEMETRY] Fixed-point and varint helpers shared by payload encoders.
+ * [BOILERPLATE] LEB128 varint + zigzag coding; no schema semantics here.
+ */
+#ifndef TELEMETRY_FIXED_H
+#define TELEMETRY_FIXED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * [TELEMETRY] Scale a float to an integer with round-half-even, matching the
+ * rounding printf applies for "%.Nf". The product is exact in double for
+ * scales up to 10^4, so the tie test below is exact as well.
+ */
+static inline int64_t telemetry_fixed_from_float(float value, uint32_t scale)
+{
+	double p = (double)value * (double)scale;
+	int64_t r = (int64_t)p;
+	double frac = p - (double)r;
+	int64_t step = (p < 0) ? -1 : 1;
+
+	if (frac < 0) {
+		frac = -frac;
+	}
+	if (frac > 0.5 || (frac == 0.5 && (r & 1))) {
+		r += step;
+	}
+	return r;
+}
+
+static inline uint64_t telemetry_zigzag_encode(int64_t v)
+{
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t telemetry_zigzag_decode(uint64_t v)
+{
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/* [BOILERPLATE] Append an unsigned LEB128 varint; returns bytes written or -1. */
+static inline int telemetry_varint_put(uint8_t *buf, size_t buf_len, uint64_t v)
+{
+	size_t n = 0;
+
+	do {
+		if (n >= buf_len) {
+			return -1;
+		}
+		uint8_t b = (uint8_t)(v & 0x7F);
+		v >>= 7;
+		buf[n++] = v ? (uint8_t)(b | 0x80) : b;
+	} while (v);
+	return (int)n;
+}
+
+/* [BOILERPLATE] Read an unsigned LEB128 varint; returns bytes consumed or -1. */
+static inline int telemetry_varint_get(const uint8_t *buf, size_t buf_len, uint64_t *out)
+{
+	uint64_t v = 0;
+	size_t n = 0;
+
+	while (n < buf_len && n < 10) {
+		uint8_t b = buf[n];
+		v |= (uint64_t)(b & 0x7F) << (7 * n);
+		n++;
+		if (!(b & 0x80)) {
+			*out = v;
+			return (int)n;
+		}
+	}
+	return -1;
+}
+
+#endif /* TELEMETRY_FIXED_H */
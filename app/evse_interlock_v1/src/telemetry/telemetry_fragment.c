@@ -0,0 +1,106 @@
+/*
+ * [TELEMETRY] Split one record across several link-MTU-sized uplinks.
+ * [BOILERPLATE] Fixed chunk size keeps offsets implicit (index * chunk).
+ */
+#include "telemetry/telemetry_fragment.h"
+#include "telemetry/telemetry_binary.h"
+
+#include <string.h>
+
+#define TELEMETRY_FRAG_TYPE_BYTE                                                           \
+	((uint8_t)((TELEMETRY_BIN_SCHEMA_VERSION << 4) | TELEMETRY_BIN_TYPE_FRAGMENT))
+
+static size_t telemetry_fragment_chunk(size_t mtu)
+{
+	size_t chunk = mtu - TELEMETRY_FRAG_HDR_LEN;
+
+	return chunk > UINT8_MAX ? UINT8_MAX : chunk;
+}
+
+int telemetry_fragment_count(size_t rec_len, size_t mtu)
+{
+	if (rec_len == 0 || rec_len > TELEMETRY_FRAG_RECORD_MAX || mtu <= TELEMETRY_FRAG_HDR_LEN) {
+		return -1;
+	}
+
+	size_t chunk = telemetry_fragment_chunk(mtu);
+	size_t count = (rec_len + chunk - 1) / chunk;
+
+	return count > TELEMETRY_FRAG_MAX_COUNT ? -1 : (int)count;
+}
+
+int telemetry_fragment_build(uint8_t *out, size_t out_len, const uint8_t *rec, size_t rec_len,
+			     size_t mtu, uint8_t msg_id, unsigned int index)
+{
+	int count = telemetry_fragment_count(rec_len, mtu);
+
+	if (!out || !rec || count < 0 || index >= (unsigned int)count) {
+		return -1;
+	}
+
+	size_t chunk = telemetry_fragment_chunk(mtu);
+	size_t offset = index * chunk;
+	size_t n = rec_len - offset < chunk ? rec_len - offset : chunk;
+
+	if (out_len < TELEMETRY_FRAG_HDR_LEN + n) {
+		return -1;
+	}
+	out[0] = TELEMETRY_FRAG_TYPE_BYTE;
+	out[1] = msg_id;
+	out[2] = (uint8_t)((index << 4) | (unsigned int)(count - 1));
+	out[3] = (uint8_t)chunk;
+	memcpy(out + TELEMETRY_FRAG_HDR_LEN, rec + offset, n);
+	return (int)(TELEMETRY_FRAG_HDR_LEN + n);
+}
+
+bool telemetry_fragment_is_fragment(const uint8_t *frame, size_t len)
+{
+	return frame && len > TELEMETRY_FRAG_HDR_LEN && frame[0] == TELEMETRY_FRAG_TYPE_BYTE;
+}
+
+void telemetry_reassembly_init(struct telemetry_reassembly *r)
+{
+	r->active = false;
+	r->received = 0;
+	r->last_len = 0;
+}
+
+int telemetry_reassembly_add(struct telemetry_reassembly *r, const uint8_t *frame, size_t len)
+{
+	if (!r || !telemetry_fragment_is_fragment(frame, len)) {
+		return -1;
+	}
+
+	uint8_t msg_id = frame[1];
+	unsigned int index = frame[2] >> 4;
+	uint8_t count = (uint8_t)((frame[2] & 0x0F) + 1);
+	uint8_t chunk = frame[3];
+	size_t n = len - TELEMETRY_FRAG_HDR_LEN;
+	bool last = index == (unsigned int)count - 1;
+
+	if (index >= count || chunk == 0 || n > chunk || (!last && n != chunk) ||
+	    (size_t)index * chunk + n > sizeof(r->buf)) {
+		return -1;
+	}
+
+	if (!r->active || r->msg_id != msg_id || r->count != count || r->chunk != chunk) {
+		r->active = true;
+		r->msg_id = msg_id;
+		r->count = count;
+		r->chunk = chunk;
+		r->received = 0;
+		r->last_len = 0;
+	}
+
+	memcpy(r->buf + (size_t)index * chunk, frame + TELEMETRY_FRAG_HDR_LEN, n);
+	r->received |= (uint16_t)(1U << index);
+	if (last) {
+		r->last_len = n;
+	}
+
+	if (r->received != (uint16_t)((1UL << count) - 1)) {
+		return 0;
+	}
+	r->active = false;
+	return (int)((size_t)(count - 1) * chunk + r->last_len);
+}
@@ -0,0 +1,52 @@
+/*
+ * [TELEMETRY] Split one record across several link-MTU-sized uplinks.
+ * [BOILERPLATE] Fragment framing and receiver-side reassembly.
+ *
+ * Fragment frame:
+ *   byte 0   (schema version << 4) | TELEMETRY_BIN_TYPE_FRAGMENT
+ *   byte 1   message id (same for every fragment of one record)
+ *   byte 2   (fragment index << 4) | (fragment count - 1)
+ *   byte 3   chunk size: data bytes carried by every fragment but the last
+ *   ...      record bytes [index * chunk, ...)
+ * The reassembled record is a normal JSON or binary schema payload.
+ */
+#ifndef TELEMETRY_FRAGMENT_H
+#define TELEMETRY_FRAGMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEMETRY_FRAG_HDR_LEN 4
+#define TELEMETRY_FRAG_MAX_COUNT 16
+#define TELEMETRY_FRAG_RECORD_MAX 1024
+
+/* [BOILERPLATE] Fragments needed for rec_len bytes at this MTU, or -1 if impossible. */
+int telemetry_fragment_count(size_t rec_len, size_t mtu);
+
+/* [BOILERPLATE] Write fragment `index` into out; returns its length or -1. */
+int telemetry_fragment_build(uint8_t *out, size_t out_len, const uint8_t *rec, size_t rec_len,
+			     size_t mtu, uint8_t msg_id, unsigned int index);
+
+bool telemetry_fragment_is_fragment(const uint8_t *frame, size_t len);
+
+struct telemetry_reassembly {
+	bool active;
+	uint8_t msg_id;
+	uint8_t count;
+	uint8_t chunk;
+	uint16_t received;
+	size_t last_len;
+	uint8_t buf[TELEMETRY_FRAG_RECORD_MAX];
+};
+
+void telemetry_reassembly_init(struct telemetry_reassembly *r);
+
+/*
+ * [TELEMETRY] Feed one fragment. Returns the record length once every fragment
+ * has arrived (record in r->buf), 0 while incomplete, -1 on a malformed frame.
+ * A fragment with a new message id abandons the previous partial record.
+ */
+int telemetry_reassembly_add(struct telemetry_reassembly *r, const uint8_t *frame, size_t len);
+
+#endif /* TELEMETRY_FRAGMENT_H */
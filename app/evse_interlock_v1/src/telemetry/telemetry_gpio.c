@@ -1,10 +1,9 @@
 /*
  * [TELEMETRY] GPIO event payload builder and schema formatting.
- * [BOILERPLATE] JSON formatting glue; semantics are in field choices.
+ * [BOILERPLATE] Envelope glue; the data body comes from telemetry_schema.h.
  */
 #include "telemetry/telemetry_gpio.h"
-
-#include <stdio.h>
+#include "telemetry/telemetry_schema.h"
 
 /* [TELEMETRY] Default wrapper uses uptime_ms when epoch is not yet available. */
 int telemetry_build_gpio_payload(char *buf, size_t buf_len, const char *device_id,
@@ -21,44 +20,37 @@ int telemetry_build_gpio_payload_ex(char *buf, size_t buf_len, const char *devic
 				    gpio_edge_t edge, int64_t uptime_ms, const char *run_id,
 				    const char *event_id, bool time_anomaly)
 {
-	if (!buf || buf_len == 0 || !pin_alias || !device_id || !device_type ||
-	    !event_id || event_id[0] == '\0') {
-		return -1;
-	}
+	struct telemetry_envelope env;
 
-	const char *edge_str = gpio_edge_str(edge);
-	int len = 0;
-	/* [TELEMETRY] timestamp uses uptime_ms until a time_sync epoch is applied. */
-
-	if (run_id && run_id[0] != '\0') {
-		len = snprintf(buf, buf_len,
-			       "{\"schema_version\":\"1.0\",\"device_id\":\"%s\","
-			       "\"device_type\":\"%s\",\"timestamp\":%lld,"
-			       "\"event_id\":\"%s\","
-			       "\"time_anomaly\":%s,\"event_type\":\"state_change\","
-			       "\"location\":null,"
-			       "\"run_id\":\"%s\",\"data\":{\"gpio\":{\"pin\":\"%s\","
-			       "\"state\":%d,\"edge\":\"%s\",\"uptime_ms\":%lld}}}",
-			       device_id, device_type, (long long)uptime_ms,
-			       event_id, time_anomaly ? "true" : "false", run_id,
-			       pin_alias, state, edge_str, (long long)uptime_ms);
-	} else {
-		len = snprintf(buf, buf_len,
-			       "{\"schema_version\":\"1.0\",\"device_id\":\"%s\","
-			       "\"device_type\":\"%s\",\"timestamp\":%lld,"
-			       "\"event_id\":\"%s\","
-			       "\"time_anomaly\":%s,\"event_type\":\"state_change\","
-			       "\"location\":null,"
-			       "\"run_id\":null,\"data\":{\"gpio\":{\"pin\":\"%s\","
-			       "\"state\":%d,\"edge\":\"%s\",\"uptime_ms\":%lld}}}",
-			       device_id, device_type, (long long)uptime_ms,
-			       event_id, time_anomaly ? "true" : "false", pin_alias, state,
-			       edge_str,
-			       (long long)uptime_ms);
+	if (telemetry_envelope_init(&env, device_id, device_type, TELEMETRY_ENVELOPE_FULL)) {
+		return -1;
 	}
+	return telemetry_build_gpio_payload_env(buf, buf_len, &env, pin_alias, state, edge,
+						uptime_ms, run_id, event_id, time_anomaly);
+}
 
-	if (len < 0 || (size_t)len >= buf_len) {
+int telemetry_build_gpio_payload_env(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, const char *pin_alias,
+				     int state, gpio_edge_t edge, int64_t timestamp_ms,
+				     const char *run_id, const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !pin_alias || !env || !event_id || event_id[0] == '\0') {
 		return -1;
 	}
-	return len;
+
+	struct telemetry_writer w;
+	const struct telemetry_gpio_src src = {
+		.pin = pin_alias,
+		.state = state,
+		.edge = edge,
+		.uptime_ms = timestamp_ms,
+	};
+
+	/* [TELEMETRY] timestamp uses uptime_ms until a time_sync epoch is applied. */
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_head(&w, env, timestamp_ms, event_id, time_anomaly, "state_change",
+				run_id);
+	telemetry_schema_json_gpio(&w, env, &src);
+	TELEMETRY_WRITER_LIT(&w, "}}");
+	return telemetry_writer_finish(&w);
 }
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 
 #include "telemetry/gpio_event.h"
+#include "telemetry/telemetry_envelope.h"
 
 #define TELEMETRY_EVENT_ID_SUPPORTED 1
 
@@ -23,4 +24,9 @@ int telemetry_build_gpio_payload_ex(char *buf, size_t buf_len, const char *devic
 				    gpio_edge_t edge, int64_t uptime_ms, const char *run_id,
 				    const char *event_id, bool time_anomaly);
 
+int telemetry_build_gpio_payload_env(char *buf, size_t buf_len,
+				     const struct telemetry_envelope *env, const char *pin_alias,
+				     int state, gpio_edge_t edge, int64_t timestamp_ms,
+				     const char *run_id, const char *event_id, bool time_anomaly);
+
 #endif /* TELEMETRY_GPIO_H */
@@ -0,0 +1,23 @@
+/*
+ * [TELEMETRY] Device health payload builder.
+ */
+#include "telemetry/telemetry_health.h"
+#include "telemetry/telemetry_schema.h"
+
+int telemetry_build_health_payload_env(char *buf, size_t buf_len,
+				       const struct telemetry_envelope *env, int64_t timestamp_ms,
+				       const struct telemetry_health *health, const char *event_id,
+				       bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !env || !health || !event_id || event_id[0] == '\0') {
+		return -1;
+	}
+
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_head(&w, env, timestamp_ms, event_id, time_anomaly, "health", NULL);
+	telemetry_schema_json_health(&w, env, health);
+	TELEMETRY_WRITER_LIT(&w, "}}");
+	return telemetry_writer_finish(&w);
+}
@@ -0,0 +1,36 @@
+/*
+ * [TELEMETRY] Device health record: Sidewalk thread queue sizing figures.
+ * Counters are cumulative since boot; values above INT32_MAX saturate.
+ */
+#ifndef TELEMETRY_HEALTH_H
+#define TELEMETRY_HEALTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/telemetry_envelope.h"
+
+struct telemetry_health {
+	/* Control queue: configured depth, most events waiting at once. */
+	int32_t queue_size;
+	int32_t queue_depth_max;
+	/* Bulk queue: most events waiting at once. */
+	int32_t bulk_depth_max;
+	/* Events dropped because a queue was full, both levels. */
+	int32_t enqueue_failed;
+	/* Worst control event enqueue-to-dispatch time. */
+	int32_t latency_max_us;
+	/* Handler with the longest single run, and that run. */
+	const char *slow_handler;
+	int32_t exec_max_us;
+	/* sid_process() signals merged into a waiting request. */
+	int32_t process_merged;
+};
+
+int telemetry_build_health_payload_env(char *buf, size_t buf_len,
+				       const struct telemetry_envelope *env, int64_t timestamp_ms,
+				       const struct telemetry_health *health, const char *event_id,
+				       bool time_anomaly);
+
+#endif /* TELEMETRY_HEALTH_H */
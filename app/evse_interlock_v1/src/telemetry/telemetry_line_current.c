@@ -2,8 +2,7 @@
  * [TELEMETRY] Line current payload builder and schema formatting.
  */
 #include "telemetry/telemetry_line_current.h"
-
-#include <stdio.h>
+#include "telemetry/telemetry_schema.h"
 
 int telemetry_build_line_current_payload(char *buf, size_t buf_len, const char *device_id,
 					 const char *device_type, int64_t timestamp_ms,
@@ -19,22 +18,31 @@ int telemetry_build_line_current_payload_ex(char *buf, size_t buf_len, const cha
 					    const struct line_current_event *evt,
 					    const char *event_id, bool time_anomaly)
 {
-	if (!buf || buf_len == 0 || !device_id || !device_type || !evt || !event_id ||
-	    event_id[0] == '\0') {
+	struct telemetry_envelope env;
+
+	if (telemetry_envelope_init(&env, device_id, device_type, TELEMETRY_ENVELOPE_FULL)) {
 		return -1;
 	}
+	return telemetry_build_line_current_payload_env(buf, buf_len, &env, timestamp_ms, evt,
+							event_id, time_anomaly);
+}
 
-	int len = snprintf(
-		buf, buf_len,
-		"{\"schema_version\":\"1.0\",\"device_id\":\"%s\",\"device_type\":\"%s\","
-		"\"timestamp\":%lld,\"event_id\":\"%s\",\"time_anomaly\":%s,\"event_type\":\"%s\","
-		"\"location\":null,\"run_id\":null,"
-		"\"data\":{\"line_current\":{\"current_a\":%.3f}}}",
-		device_id, device_type, (long long)timestamp_ms, event_id,
-		time_anomaly ? "true" : "false", evt->event_type, (double)evt->current_a);
-
-	if (len < 0 || (size_t)len >= buf_len) {
+int telemetry_build_line_current_payload_env(char *buf, size_t buf_len,
+					     const struct telemetry_envelope *env,
+					     int64_t timestamp_ms,
+					     const struct line_current_event *evt,
+					     const char *event_id, bool time_anomaly)
+{
+	if (!buf || buf_len == 0 || !env || !evt || !event_id || event_id[0] == '\0') {
 		return -1;
 	}
-	return len;
+
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, buf_len);
+	telemetry_envelope_head(&w, env, timestamp_ms, event_id, time_anomaly, evt->event_type,
+				NULL);
+	telemetry_schema_json_line_current(&w, env, evt);
+	TELEMETRY_WRITER_LIT(&w, "}}");
+	return telemetry_writer_finish(&w);
 }
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include "telemetry/line_current.h"
+#include "telemetry/telemetry_envelope.h"
 
 int telemetry_build_line_current_payload(char *buf, size_t buf_len, const char *device_id,
 					 const char *device_type, int64_t timestamp_ms,
@@ -18,5 +19,10 @@ int telemetry_build_line_current_payload_ex(char *buf, size_t buf_len, const cha
 					    const char *device_type, int64_t timestamp_ms,
 					    const struct line_current_event *evt,
 					    const char *event_id, bool time_anomaly);
+int telemetry_build_line_current_payload_env(char *buf, size_t buf_len,
+					     const struct telemetry_envelope *env,
+					     int64_t timestamp_ms,
+					     const struct line_current_event *evt,
+					     const char *event_id, bool time_anomaly);
 
 #endif /* TELEMETRY_LINE_CURRENT_H */
@@ -0,0 +1,473 @@
+/*
+ * [TELEMETRY] Store-and-forward outbox (circular flash log, see telemetry_outbox.h).
+ * [BOILERPLATE] Invariant: write_off always lies inside the write sector, which
+ * is erased from write_off to its end. Every other sector holds records in
+ * sequence order, oldest first starting with the sector after the write sector.
+ */
+#include "telemetry/telemetry_outbox.h"
+
+#include <string.h>
+
+#define OUTBOX_HDR_LEN 12
+#define OUTBOX_CHUNK 32
+#define OUTBOX_NONE UINT32_MAX
+
+enum outbox_rec_status {
+	/* Header is intact; the payload CRC is only checked on peek. */
+	OUTBOX_REC_VALID,
+	/* Erased flash, or no room left in the sector for another header. */
+	OUTBOX_REC_END,
+	/* Neither a header nor erased: nothing after it in this sector is usable. */
+	OUTBOX_REC_BAD,
+	OUTBOX_REC_IO,
+};
+
+struct outbox_rec {
+	uint32_t off;
+	uint32_t size;
+	uint32_t seq;
+	uint32_t crc;
+	uint16_t len;
+	bool done;
+};
+
+static uint32_t align_up(uint32_t v, uint32_t a)
+{
+	return (v + a - 1) & ~(a - 1);
+}
+
+static uint32_t done_off(const struct telemetry_outbox *ob)
+{
+	return align_up(OUTBOX_HDR_LEN, ob->flash->write_align);
+}
+
+static uint32_t payload_off(const struct telemetry_outbox *ob)
+{
+	return done_off(ob) + ob->flash->write_align;
+}
+
+static uint32_t rec_size(const struct telemetry_outbox *ob, size_t len)
+{
+	return align_up(payload_off(ob) + (uint32_t)len, ob->flash->write_align);
+}
+
+static uint32_t sector_start(const struct telemetry_outbox *ob, uint32_t off)
+{
+	return off - off % ob->flash->sector_size;
+}
+
+static uint32_t sector_index(const struct telemetry_outbox *ob, uint32_t off)
+{
+	return off / ob->flash->sector_size;
+}
+
+static uint32_t next_sector_start(const struct telemetry_outbox *ob, uint32_t off)
+{
+	uint32_t s = (sector_index(ob, off) + 1) % ob->flash->sector_count;
+
+	return s * ob->flash->sector_size;
+}
+
+/* [BOILERPLATE] The end of the last sector is the start of the first. */
+static uint32_t ring_off(const struct telemetry_outbox *ob, uint32_t off)
+{
+	return off % (ob->flash->sector_size * ob->flash->sector_count);
+}
+
+/* [BOILERPLATE] Bitwise CRC-32 (IEEE, reflected); records are short. */
+static uint32_t outbox_crc(uint32_t crc, const uint8_t *p, size_t n)
+{
+	while (n--) {
+		crc ^= *p++;
+		for (int i = 0; i < 8; i++) {
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+		}
+	}
+	return crc;
+}
+
+static uint32_t get_le(const uint8_t *p, int n)
+{
+	uint32_t v = 0;
+
+	while (n--) {
+		v = (v << 8) | p[n];
+	}
+	return v;
+}
+
+static void put_le(uint8_t *p, uint32_t v, int n)
+{
+	for (int i = 0; i < n; i++) {
+		p[i] = (uint8_t)(v >> (8 * i));
+	}
+}
+
+/* [TELEMETRY] CRC over seq, len and payload; header bytes 0..5 hold seq and len. */
+static uint32_t rec_crc(const uint8_t *hdr, const void *payload, size_t len)
+{
+	uint32_t crc = outbox_crc(0xFFFFFFFFu, hdr, 6);
+
+	return ~outbox_crc(crc, payload, len);
+}
+
+static enum outbox_rec_status rec_read(const struct telemetry_outbox *ob, uint32_t off,
+				       struct outbox_rec *rec)
+{
+	const struct telemetry_outbox_flash *f = ob->flash;
+	uint32_t end = sector_start(ob, off) + f->sector_size;
+	uint8_t hdr[OUTBOX_HDR_LEN];
+	uint8_t done[TELEMETRY_OUTBOX_ALIGN_MAX];
+
+	if (end - off < payload_off(ob) + 1) {
+		return OUTBOX_REC_END;
+	}
+	if (f->read(f->ctx, off, hdr, sizeof(hdr)) < 0) {
+		return OUTBOX_REC_IO;
+	}
+	uint16_t magic = (uint16_t)get_le(hdr + 10, 2);
+	if (magic == 0xFFFF) {
+		return OUTBOX_REC_END;
+	}
+	rec->off = off;
+	rec->seq = get_le(hdr, 4);
+	rec->len = (uint16_t)get_le(hdr + 4, 2);
+	rec->crc = get_le(hdr + 6, 4);
+	rec->size = rec_size(ob, rec->len);
+	if (magic != TELEMETRY_OUTBOX_MAGIC || rec->len == 0 || rec->size > end - off) {
+		return OUTBOX_REC_BAD;
+	}
+	if (f->read(f->ctx, off + done_off(ob), done, f->write_align) < 0) {
+		return OUTBOX_REC_IO;
+	}
+	rec->done = false;
+	for (uint8_t i = 0; i < f->write_align; i++) {
+		/* A torn done write still means the record went out. */
+		rec->done |= done[i] != 0xFF;
+	}
+	return OUTBOX_REC_VALID;
+}
+
+/*
+ * [BOILERPLATE] First record at or after off in ring order; write_off when none.
+ * Walking the write sector from its start hits write_off; the jump bound only
+ * matters if a header in the write sector has rotted since it was written.
+ */
+static uint32_t outbox_settle(const struct telemetry_outbox *ob, uint32_t off,
+			      struct outbox_rec *rec, int *err)
+{
+	uint32_t jumps = 0;
+
+	*err = 0;
+	off = ring_off(ob, off);
+	while (off != ob->write_off && jumps <= ob->flash->sector_count) {
+		enum outbox_rec_status st = rec_read(ob, off, rec);
+		if (st == OUTBOX_REC_VALID) {
+			return off;
+		}
+		if (st == OUTBOX_REC_IO) {
+			*err = -1;
+			break;
+		}
+		off = next_sector_start(ob, off);
+		jumps++;
+	}
+	return ob->write_off;
+}
+
+static int outbox_erased(const struct telemetry_outbox *ob, uint32_t off, uint32_t end)
+{
+	uint8_t buf[OUTBOX_CHUNK];
+
+	while (off < end) {
+		size_t n = end - off < sizeof(buf) ? end - off : sizeof(buf);
+		if (ob->flash->read(ob->flash->ctx, off, buf, n) < 0) {
+			return -1;
+		}
+		for (size_t i = 0; i < n; i++) {
+			if (buf[i] != 0xFF) {
+				return 0;
+			}
+		}
+		off += (uint32_t)n;
+	}
+	return 1;
+}
+
+/* [TELEMETRY] Erase the sector at start and make it the write sector. */
+static int outbox_take_sector(struct telemetry_outbox *ob, uint32_t start)
+{
+	const struct telemetry_outbox_flash *f = ob->flash;
+	struct outbox_rec rec;
+	uint32_t off = start;
+	uint32_t lost = 0;
+
+	/* Unsent records stored there are lost; count them first. */
+	while (off < start + f->sector_size && rec_read(ob, off, &rec) == OUTBOX_REC_VALID) {
+		lost += !rec.done;
+		off += rec.size;
+	}
+	if (f->erase(f->ctx, start, f->sector_size) < 0) {
+		return -1;
+	}
+	ob->erases++;
+	ob->dropped += lost;
+	ob->pending -= lost < ob->pending ? lost : ob->pending;
+
+	if (ob->peek_off != OUTBOX_NONE && sector_start(ob, ob->peek_off) == start) {
+		ob->peek_off = OUTBOX_NONE;
+	}
+	if (sector_start(ob, ob->read_off) == start) {
+		/* The next sector in the ring now holds the oldest records. */
+		ob->read_off = next_sector_start(ob, start);
+	}
+	ob->write_off = start;
+	if (ob->pending == 0) {
+		ob->read_off = start;
+	}
+	return 0;
+}
+
+static bool outbox_geometry_ok(const struct telemetry_outbox_flash *f)
+{
+	uint8_t a = f ? f->write_align : 0;
+
+	return f && f->read && f->write && f->erase && f->sector_count >= 2 &&
+	       (a == 1 || a == 2 || a == 4 || a == 8) && f->sector_size >= 64 &&
+	       f->sector_size % a == 0 &&
+	       (uint64_t)f->sector_size * f->sector_count < OUTBOX_NONE;
+}
+
+int telemetry_outbox_mount(struct telemetry_outbox *ob,
+			   const struct telemetry_outbox_flash *flash)
+{
+	struct outbox_rec rec;
+	uint32_t head = 0;
+	uint32_t head_seq = 0;
+	bool found = false;
+	int err;
+
+	if (!ob || !outbox_geometry_ok(flash)) {
+		return -1;
+	}
+	memset(ob, 0, sizeof(*ob));
+	ob->flash = flash;
+	ob->peek_off = OUTBOX_NONE;
+
+	/* [TELEMETRY] The write sector is the one whose first record is newest. */
+	for (uint32_t s = 0; s < flash->sector_count; s++) {
+		enum outbox_rec_status st = rec_read(ob, s * flash->sector_size, &rec);
+		if (st == OUTBOX_REC_IO) {
+			return -1;
+		}
+		if (st == OUTBOX_REC_VALID && (!found || (int32_t)(rec.seq - head_seq) > 0)) {
+			head = s;
+			head_seq = rec.seq;
+			found = true;
+		}
+	}
+
+	uint32_t off = head * flash->sector_size;
+	uint32_t end = off + flash->sector_size;
+	uint32_t last_seq = head_seq - 1;
+	enum outbox_rec_status st = OUTBOX_REC_END;
+	while (off < end && (st = rec_read(ob, off, &rec)) == OUTBOX_REC_VALID) {
+		last_seq = rec.seq;
+		off += rec.size;
+	}
+	if (st == OUTBOX_REC_IO) {
+		return -1;
+	}
+	ob->write_off = head * flash->sector_size;
+	ob->read_off = ob->write_off;
+	ob->next_seq = found ? last_seq + 1 : 0;
+
+	/* A full sector or a torn write at the head: continue in the next sector. */
+	int erased = off < end ? outbox_erased(ob, off, end) : 0;
+	if (erased < 0) {
+		return -1;
+	}
+	if (erased) {
+		ob->write_off = off;
+		ob->read_off = off;
+	} else if (outbox_take_sector(ob, found ? next_sector_start(ob, ob->write_off) :
+						  ob->write_off) < 0) {
+		return -1;
+	}
+
+	/* Unsent records, oldest first, starting after the write sector. */
+	uint32_t pos = outbox_settle(ob, next_sector_start(ob, ob->write_off), &rec, &err);
+	while (pos != ob->write_off) {
+		if (!rec.done && ob->pending++ == 0) {
+			ob->read_off = pos;
+		}
+		pos = outbox_settle(ob, pos + rec.size, &rec, &err);
+	}
+	return err;
+}
+
+size_t telemetry_outbox_max_len(const struct telemetry_outbox *ob)
+{
+	size_t max = ob->flash->sector_size - payload_off(ob);
+
+	max -= max % ob->flash->write_align;
+	return max < UINT16_MAX ? max : UINT16_MAX;
+}
+
+static int outbox_write_payload(struct telemetry_outbox *ob, uint32_t off, const uint8_t *data,
+				size_t len)
+{
+	const struct telemetry_outbox_flash *f = ob->flash;
+	size_t head = len - len % f->write_align;
+	uint8_t tail[TELEMETRY_OUTBOX_ALIGN_MAX];
+
+	if (head && f->write(f->ctx, off, data, head) < 0) {
+		return -1;
+	}
+	if (head == len) {
+		return 0;
+	}
+	memset(tail, 0xFF, sizeof(tail));
+	memcpy(tail, data + head, len - head);
+	return f->write(f->ctx, off + (uint32_t)head, tail, f->write_align);
+}
+
+int telemetry_outbox_push(struct telemetry_outbox *ob, const void *data, size_t len)
+{
+	if (!ob || !ob->flash || !data || len == 0 || len > telemetry_outbox_max_len(ob)) {
+		return -1;
+	}
+
+	const struct telemetry_outbox_flash *f = ob->flash;
+	uint32_t size = rec_size(ob, len);
+	if (size > sector_start(ob, ob->write_off) + f->sector_size - ob->write_off &&
+	    outbox_take_sector(ob, next_sector_start(ob, ob->write_off)) < 0) {
+		return -1;
+	}
+
+	/* [TELEMETRY] Payload first, header last: a header implies a whole record. */
+	uint32_t off = ob->write_off;
+	uint32_t end = sector_start(ob, off) + f->sector_size;
+	uint8_t hdr[TELEMETRY_OUTBOX_ALIGN_MAX * 2];
+	memset(hdr, 0xFF, sizeof(hdr));
+	put_le(hdr, ob->next_seq, 4);
+	put_le(hdr + 4, (uint32_t)len, 2);
+	put_le(hdr + 6, rec_crc(hdr, data, len), 4);
+	/* Flash programs in address order, so a complete magic implies the rest. */
+	put_le(hdr + 10, TELEMETRY_OUTBOX_MAGIC, 2);
+
+	if (outbox_write_payload(ob, off + payload_off(ob), data, len) < 0 ||
+	    f->write(f->ctx, off, hdr, done_off(ob)) < 0) {
+		/* Never reuse a partly written slot: the rest of the sector is abandoned. */
+		(void)outbox_take_sector(ob, next_sector_start(ob, off));
+		return -1;
+	}
+	ob->write_off = off + size;
+	ob->next_seq++;
+	if (ob->pending++ == 0) {
+		ob->read_off = off;
+	}
+	if (ob->write_off == end) {
+		/* Exactly full: keep write_off inside the write sector. */
+		return outbox_take_sector(ob, next_sector_start(ob, off));
+	}
+	return 0;
+}
+
+/* [BOILERPLATE] Program the done unit of the record at off. */
+static int outbox_mark_done(struct telemetry_outbox *ob, uint32_t off)
+{
+	const struct telemetry_outbox_flash *f = ob->flash;
+	uint8_t zero[TELEMETRY_OUTBOX_ALIGN_MAX] = { 0 };
+
+	if (f->write(f->ctx, off + done_off(ob), zero, f->write_align) < 0) {
+		return -1;
+	}
+	if (ob->pending) {
+		ob->pending--;
+	}
+	return 0;
+}
+
+/* [TELEMETRY] Next unsent record in the given order; write_off when none. */
+static uint32_t outbox_find(struct telemetry_outbox *ob, enum telemetry_outbox_order order,
+			    struct outbox_rec *out, int *err)
+{
+	struct outbox_rec rec;
+	uint32_t found = ob->write_off;
+	uint32_t pos = outbox_settle(ob, ob->read_off, &rec, err);
+	bool front = true;
+
+	while (pos != ob->write_off) {
+		if (!rec.done) {
+			found = pos;
+			*out = rec;
+			if (order == TELEMETRY_OUTBOX_FIFO) {
+				break;
+			}
+			front = false;
+		} else if (front) {
+			/* Sent records at the front never need walking again. */
+			ob->read_off = ring_off(ob, pos + rec.size);
+		}
+		pos = outbox_settle(ob, pos + rec.size, &rec, err);
+	}
+	if (found != ob->write_off && front) {
+		ob->read_off = found;
+	}
+	return *err ? ob->write_off : found;
+}
+
+int telemetry_outbox_peek(struct telemetry_outbox *ob, enum telemetry_outbox_order order,
+			  void *buf, size_t cap)
+{
+	struct outbox_rec rec = { 0 };
+	uint8_t hdr[OUTBOX_HDR_LEN];
+	int err;
+
+	if (!ob || !ob->flash || !buf) {
+		return -1;
+	}
+	ob->peek_off = OUTBOX_NONE;
+	while (ob->pending) {
+		uint32_t off = outbox_find(ob, order, &rec, &err);
+		if (err) {
+			return -1;
+		}
+		if (off == ob->write_off) {
+			/* Counter drifted (e.g. a record lost its header); resync. */
+			ob->pending = 0;
+			break;
+		}
+		if (rec.len > cap) {
+			return -1;
+		}
+		if (ob->flash->read(ob->flash->ctx, off + payload_off(ob), buf, rec.len) < 0) {
+			return -1;
+		}
+		put_le(hdr, rec.seq, 4);
+		put_le(hdr + 4, rec.len, 2);
+		if (rec_crc(hdr, buf, rec.len) == rec.crc) {
+			ob->peek_off = off;
+			return rec.len;
+		}
+		/* [TELEMETRY] A corrupt record is retired so it cannot block the queue. */
+		ob->corrupt++;
+		if (outbox_mark_done(ob, off) < 0) {
+			return -1;
+		}
+	}
+	ob->read_off = ob->write_off;
+	return 0;
+}
+
+int telemetry_outbox_pop(struct telemetry_outbox *ob)
+{
+	if (!ob || !ob->flash || ob->peek_off == OUTBOX_NONE) {
+		return -1;
+	}
+	uint32_t off = ob->peek_off;
+
+	ob->peek_off = OUTBOX_NONE;
+	return outbox_mark_done(ob, off);
+}
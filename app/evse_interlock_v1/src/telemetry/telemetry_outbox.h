@@ -0,0 +1,90 @@
+/*
+ * [TELEMETRY] Store-and-forward outbox: a circular record log in raw flash.
+ * [BOILERPLATE] Pure C over caller-supplied read/write/erase callbacks, so the
+ * same code runs on a flash_area and on a RAM-backed host simulator.
+ *
+ * The partition is split into erase sectors used round-robin, which spreads
+ * erases evenly (wear levelling comes from the ring itself). Records never
+ * straddle a sector. Each record is
+ *   seq(4) len(2) crc32(4) magic(2)   header, written after the payload
+ *   done                              one write unit, programmed to 0 when sent
+ *   payload[len]
+ * padded to the write alignment. The CRC covers seq, len and the payload. When
+ * the writer needs a sector that still holds unsent records, the oldest sector
+ * is erased and its records are counted as dropped. Mount rebuilds the cursors
+ * from sequence numbers; a torn write at the head moves writing to the next
+ * sector.
+ *
+ * Marking a record sent programs its done unit a second time, which NOR flash
+ * (and the nRF NVMC, n_WRITE = 2) allows without an erase.
+ */
+#ifndef TELEMETRY_OUTBOX_H
+#define TELEMETRY_OUTBOX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_OUTBOX_MAGIC 0x0B7Eu
+/* [BOILERPLATE] Write units larger than this are not supported. */
+#define TELEMETRY_OUTBOX_ALIGN_MAX 8
+
+struct telemetry_outbox_flash {
+	/* Offsets are relative to the start of the partition; return 0 or negative. */
+	int (*read)(void *ctx, uint32_t off, void *buf, size_t len);
+	int (*write)(void *ctx, uint32_t off, const void *buf, size_t len);
+	int (*erase)(void *ctx, uint32_t off, size_t len);
+	void *ctx;
+	uint32_t sector_size;
+	uint16_t sector_count;
+	/* Flash write block size: 1, 2, 4 or 8. */
+	uint8_t write_align;
+};
+
+enum telemetry_outbox_order {
+	/* Oldest record first: the backlog replays in event order. */
+	TELEMETRY_OUTBOX_FIFO = 0,
+	/* Newest record first: fresh state reaches the cloud before history. */
+	TELEMETRY_OUTBOX_LIFO = 1,
+};
+
+struct telemetry_outbox {
+	const struct telemetry_outbox_flash *flash;
+	/* Next write position, and the first record that may still be unsent. */
+	uint32_t write_off;
+	uint32_t read_off;
+	/* Record returned by the last peek (UINT32_MAX when none). */
+	uint32_t peek_off;
+	uint32_t next_seq;
+	uint32_t pending;
+	/* Unsent records lost to sector reuse, and records failing their CRC. */
+	uint32_t dropped;
+	uint32_t corrupt;
+	uint32_t erases;
+};
+
+/*
+ * [TELEMETRY] Scan the partition and restore the cursors. An unformatted or
+ * fully corrupt partition is erased. Returns 0 or -1 (bad geometry, I/O error).
+ */
+int telemetry_outbox_mount(struct telemetry_outbox *ob,
+			   const struct telemetry_outbox_flash *flash);
+
+/* [TELEMETRY] Largest payload one record can hold. */
+size_t telemetry_outbox_max_len(const struct telemetry_outbox *ob);
+
+/* [TELEMETRY] Append a record; may drop the oldest sector. Returns 0 or -1. */
+int telemetry_outbox_push(struct telemetry_outbox *ob, const void *data, size_t len);
+
+/*
+ * [TELEMETRY] Copy the next unsent record (in the given order) into buf.
+ * Returns its length, 0 when the outbox is empty, or -1 when buf is too small
+ * or flash cannot be read. Records failing their CRC are skipped and counted.
+ */
+int telemetry_outbox_peek(struct telemetry_outbox *ob, enum telemetry_outbox_order order,
+			  void *buf, size_t cap);
+
+/* [TELEMETRY] Mark the record returned by the last peek as sent. Returns 0 or -1. */
+int telemetry_outbox_pop(struct telemetry_outbox *ob);
+
+#endif /* TELEMETRY_OUTBOX_H */
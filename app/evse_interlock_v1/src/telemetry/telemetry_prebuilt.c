@@ -0,0 +1,99 @@
+/*
+ * [TELEMETRY] Prebuilt records (see telemetry_prebuilt.h).
+ */
+#include "telemetry/telemetry_prebuilt.h"
+
+#include "telemetry/telemetry_fragment.h"
+
+#include <string.h>
+
+int telemetry_prebuilt_pack(uint8_t *out, size_t cap, enum telemetry_encoding encoding,
+			    telemetry_build_t build, const void *arg)
+{
+	if (!out || !build || cap <= TELEMETRY_PREBUILT_HDR_LEN) {
+		return -1;
+	}
+	size_t room = cap - TELEMETRY_PREBUILT_HDR_LEN;
+	int len = build(out + TELEMETRY_PREBUILT_HDR_LEN, room > UINT16_MAX ? UINT16_MAX : room,
+			encoding, arg);
+
+	if (len <= 0) {
+		return -1;
+	}
+	out[0] = (uint8_t)len;
+	out[1] = (uint8_t)(len >> 8);
+
+	size_t used = TELEMETRY_PREBUILT_HDR_LEN + (size_t)len;
+	if (encoding == TELEMETRY_ENCODING_BINARY || used == cap) {
+		return (int)used;
+	}
+	int bin = build(out + used, cap - used, TELEMETRY_ENCODING_BINARY, arg);
+
+	return (int)(bin > 0 ? used + (size_t)bin : used);
+}
+
+int telemetry_prebuilt_unpack(const uint8_t *item, size_t len, enum telemetry_encoding encoding,
+			      struct telemetry_prebuilt *out)
+{
+	if (!item || !out || len <= TELEMETRY_PREBUILT_HDR_LEN) {
+		return -1;
+	}
+	size_t rec_len = (size_t)item[0] | ((size_t)item[1] << 8);
+	size_t rest = len - TELEMETRY_PREBUILT_HDR_LEN;
+
+	if (rec_len == 0 || rec_len > rest) {
+		return -1;
+	}
+	out->data = item + TELEMETRY_PREBUILT_HDR_LEN;
+	out->len = rec_len;
+	out->encoding = encoding;
+	out->bin = rest > rec_len ? item + TELEMETRY_PREBUILT_HDR_LEN + rec_len : NULL;
+	out->bin_len = rest - rec_len;
+	return 0;
+}
+
+int telemetry_prebuilt_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			     const void *arg)
+{
+	const struct telemetry_prebuilt *rec = arg;
+	const void *data = rec->data;
+	size_t len = rec->len;
+
+	if (encoding != rec->encoding) {
+		if (encoding != TELEMETRY_ENCODING_BINARY || !rec->bin) {
+			return -1;
+		}
+		data = rec->bin;
+		len = rec->bin_len;
+	}
+	if (len > cap) {
+		return -1;
+	}
+	memcpy(buf, data, len);
+	return (int)len;
+}
+
+enum telemetry_prebuilt_route telemetry_prebuilt_route(telemetry_build_t build, const void *arg,
+							enum telemetry_encoding encoding,
+							size_t mtu, uint8_t *scratch,
+							size_t scratch_cap, size_t *len)
+{
+	if (mtu == 0) {
+		return TELEMETRY_PREBUILT_ALONE;
+	}
+	int n = build(scratch, scratch_cap, TELEMETRY_ENCODING_BINARY, arg);
+
+	if (n > 0 && (size_t)n <= mtu) {
+		*len = (size_t)n;
+		return TELEMETRY_PREBUILT_BINARY;
+	}
+	/* [TELEMETRY] Binary is the smaller encoding; JSON only when there is no binary. */
+	if (n <= 0 && encoding != TELEMETRY_ENCODING_BINARY) {
+		n = build(scratch, scratch_cap, encoding, arg);
+	}
+	if (n <= 0 || telemetry_fragment_count((size_t)n, mtu) < 0) {
+		return TELEMETRY_PREBUILT_NONE;
+	}
+	*len = (size_t)n;
+	return TELEMETRY_PREBUILT_FRAGMENTS;
+}
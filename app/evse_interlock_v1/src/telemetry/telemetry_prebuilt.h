@@ -0,0 +1,83 @@
+/*
+ * [TELEMETRY] A record built once and held as bytes (queue slot, outbox,
+ * retention window), and how one too big for the link still goes out.
+ * [BOILERPLATE] Pure C, no Zephyr deps.
+ *
+ * A JSON record is packed together with its binary form, so a link whose MTU
+ * the JSON does not fit can send the binary record instead, whole or in
+ * fragments, long after the builder's arguments are gone:
+ *   len(2, LE)   record[len] in its build encoding
+ *   ...          binary record (rest of the item; empty for a binary record
+ *                or one without a binary form)
+ */
+#ifndef TELEMETRY_PREBUILT_H
+#define TELEMETRY_PREBUILT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/telemetry_binary.h"
+
+#define TELEMETRY_PREBUILT_HDR_LEN 2
+/* [TELEMETRY] Packed size for a record of at most rec_max bytes in any encoding. */
+#define TELEMETRY_PREBUILT_MAX(rec_max)                                                    \
+	(TELEMETRY_PREBUILT_HDR_LEN + (rec_max) + TELEMETRY_BIN_MAX_LEN)
+
+/*
+ * [TELEMETRY] Build one record into buf (at most cap bytes) using the given
+ * encoding; return its length or -1. May be called more than once for the
+ * same record, so it must not have side effects.
+ */
+typedef int (*telemetry_build_t)(void *buf, size_t cap, enum telemetry_encoding encoding,
+				 const void *arg);
+
+struct telemetry_prebuilt {
+	const void *data;
+	size_t len;
+	enum telemetry_encoding encoding;
+	/* Binary form of a JSON record; NULL when there is none. */
+	const void *bin;
+	size_t bin_len;
+};
+
+/*
+ * [TELEMETRY] Build the record in encoding, and for JSON its binary form as
+ * well, into out. Returns the packed length, or -1 when the record does not
+ * build. A binary form that does not fit is left out.
+ */
+int telemetry_prebuilt_pack(uint8_t *out, size_t cap, enum telemetry_encoding encoding,
+			    telemetry_build_t build, const void *arg);
+
+/* [TELEMETRY] View of a packed item (pointers into item). Returns 0 or -1. */
+int telemetry_prebuilt_unpack(const uint8_t *item, size_t len, enum telemetry_encoding encoding,
+			      struct telemetry_prebuilt *out);
+
+/*
+ * [TELEMETRY] telemetry_build_t over a struct telemetry_prebuilt: the record
+ * in its own encoding, or its binary form when asked for binary.
+ */
+int telemetry_prebuilt_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			     const void *arg);
+
+/* [TELEMETRY] How a record that does not fit an empty frame at the link MTU goes out. */
+enum telemetry_prebuilt_route {
+	/* Link MTU unknown: alone at full size, in its own encoding. */
+	TELEMETRY_PREBUILT_ALONE = 0,
+	/* The binary record fits one frame. */
+	TELEMETRY_PREBUILT_BINARY,
+	/* Split into fragments (telemetry_fragment.h), binary when it builds. */
+	TELEMETRY_PREBUILT_FRAGMENTS,
+	/* Not even TELEMETRY_FRAG_MAX_COUNT fragments hold it. */
+	TELEMETRY_PREBUILT_NONE,
+};
+
+/*
+ * [TELEMETRY] Pick the route for a record built by build/arg in encoding. For
+ * BINARY and FRAGMENTS the bytes to send are left in scratch (*len bytes).
+ */
+enum telemetry_prebuilt_route telemetry_prebuilt_route(telemetry_build_t build, const void *arg,
+							enum telemetry_encoding encoding,
+							size_t mtu, uint8_t *scratch,
+							size_t scratch_cap, size_t *len);
+
+#endif /* TELEMETRY_PREBUILT_H */
@@ -0,0 +1,151 @@
+/*
+ * [TELEMETRY] Bounded multi-class record queue (see telemetry_queue.h).
+ * [BOILERPLATE] Slots hold a little-endian 16-bit length followed by the record.
+ */
+#include "telemetry/telemetry_queue.h"
+
+#include <string.h>
+
+static uint8_t *lane_slot(const struct telemetry_queue *q, const struct telemetry_queue_lane *lane,
+			  uint16_t index)
+{
+	uint16_t pos = (uint16_t)((lane->head + index) % lane->capacity);
+
+	return lane->slots + (size_t)pos * TELEMETRY_QUEUE_SLOT_SIZE(q->item_size);
+}
+
+static void lane_drop(struct telemetry_queue *q, enum telemetry_queue_class cls)
+{
+	struct telemetry_queue_lane *lane = &q->lane[cls];
+
+	lane->stats.dropped++;
+	if (q->overflow) {
+		q->overflow(q->overflow_ctx, cls, &lane->stats);
+	}
+}
+
+int telemetry_queue_init(struct telemetry_queue *q, size_t item_size,
+			 telemetry_queue_overflow_t overflow, void *overflow_ctx)
+{
+	if (!q || item_size == 0 || item_size > UINT16_MAX) {
+		return -1;
+	}
+	memset(q, 0, sizeof(*q));
+	q->item_size = (uint16_t)item_size;
+	q->overflow = overflow;
+	q->overflow_ctx = overflow_ctx;
+	return 0;
+}
+
+int telemetry_queue_configure(struct telemetry_queue *q, enum telemetry_queue_class cls,
+			      uint8_t *slots, uint16_t capacity,
+			      enum telemetry_queue_policy policy)
+{
+	if (!q || (unsigned int)cls >= TELEMETRY_QUEUE_CLASS_COUNT || (capacity && !slots) ||
+	    (policy != TELEMETRY_QUEUE_DROP_OLDEST && policy != TELEMETRY_QUEUE_DROP_NEWEST)) {
+		return -1;
+	}
+	struct telemetry_queue_lane *lane = &q->lane[cls];
+
+	memset(lane, 0, sizeof(*lane));
+	lane->slots = slots;
+	lane->capacity = capacity;
+	lane->policy = policy;
+	return 0;
+}
+
+int telemetry_queue_push(struct telemetry_queue *q, enum telemetry_queue_class cls,
+			 const void *data, size_t len)
+{
+	if (!q || (unsigned int)cls >= TELEMETRY_QUEUE_CLASS_COUNT || !data || len == 0) {
+		return -1;
+	}
+	struct telemetry_queue_lane *lane = &q->lane[cls];
+
+	if (len > q->item_size) {
+		lane->stats.too_big++;
+		lane_drop(q, cls);
+		return -1;
+	}
+	if (lane->stats.depth == lane->capacity) {
+		if (lane->policy == TELEMETRY_QUEUE_DROP_NEWEST || lane->capacity == 0) {
+			lane_drop(q, cls);
+			return -1;
+		}
+		/* [TELEMETRY] Drop-oldest: the evicted slot becomes the tail. */
+		lane->head = (uint16_t)((lane->head + 1) % lane->capacity);
+		lane->stats.depth--;
+		lane_drop(q, cls);
+	}
+
+	uint8_t *slot = lane_slot(q, lane, lane->stats.depth);
+	slot[0] = (uint8_t)len;
+	slot[1] = (uint8_t)(len >> 8);
+	memcpy(slot + 2, data, len);
+	lane->stats.depth++;
+	lane->stats.enqueued++;
+	if (lane->stats.depth > lane->stats.high_water) {
+		lane->stats.high_water = lane->stats.depth;
+	}
+	return 0;
+}
+
+size_t telemetry_queue_peek(const struct telemetry_queue *q, enum telemetry_queue_class *cls,
+			    const void **data)
+{
+	if (!q) {
+		return 0;
+	}
+	for (unsigned int c = 0; c < TELEMETRY_QUEUE_CLASS_COUNT; c++) {
+		const struct telemetry_queue_lane *lane = &q->lane[c];
+
+		if (lane->stats.depth == 0) {
+			continue;
+		}
+		const uint8_t *slot = lane_slot(q, lane, 0);
+		if (cls) {
+			*cls = (enum telemetry_queue_class)c;
+		}
+		if (data) {
+			*data = slot + 2;
+		}
+		return (size_t)slot[0] | ((size_t)slot[1] << 8);
+	}
+	return 0;
+}
+
+int telemetry_queue_pop(struct telemetry_queue *q, enum telemetry_queue_class cls)
+{
+	if (!q || (unsigned int)cls >= TELEMETRY_QUEUE_CLASS_COUNT ||
+	    q->lane[cls].stats.depth == 0) {
+		return -1;
+	}
+	struct telemetry_queue_lane *lane = &q->lane[cls];
+
+	lane->head = (uint16_t)((lane->head + 1) % lane->capacity);
+	lane->stats.depth--;
+	lane->stats.dequeued++;
+	return 0;
+}
+
+size_t telemetry_queue_depth(const struct telemetry_queue *q)
+{
+	size_t depth = 0;
+
+	if (!q) {
+		return 0;
+	}
+	for (unsigned int c = 0; c < TELEMETRY_QUEUE_CLASS_COUNT; c++) {
+		depth += q->lane[c].stats.depth;
+	}
+	return depth;
+}
+
+const struct telemetry_queue_stats *telemetry_queue_stats(const struct telemetry_queue *q,
+							  enum telemetry_queue_class cls)
+{
+	if (!q || (unsigned int)cls >= TELEMETRY_QUEUE_CLASS_COUNT) {
+		return NULL;
+	}
+	return &q->lane[cls].stats;
+}
@@ -0,0 +1,99 @@
+/*
+ * [TELEMETRY] Bounded multi-class record queue between sensing and the uplink.
+ * [BOILERPLATE] Pure C over caller-owned slot storage; no allocation, no locking.
+ *
+ * Each class is a ring of fixed-size slots with its own capacity and drop
+ * policy. Peek always serves the highest-priority non-empty class, so interlock
+ * records overtake session boundaries, which overtake periodic samples. Every
+ * drop is counted and reported through the overflow hook.
+ */
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* [TELEMETRY] Classes in priority order (lowest value served first). */
+enum telemetry_queue_class {
+	TELEMETRY_QUEUE_SAFETY = 0,
+	TELEMETRY_QUEUE_SESSION = 1,
+	TELEMETRY_QUEUE_PERIODIC = 2,
+	TELEMETRY_QUEUE_CLASS_COUNT,
+};
+
+enum telemetry_queue_policy {
+	/* Evict the oldest queued record: the newest state always gets through. */
+	TELEMETRY_QUEUE_DROP_OLDEST = 0,
+	/* Refuse the incoming record: what is queued keeps its order. */
+	TELEMETRY_QUEUE_DROP_NEWEST = 1,
+};
+
+/* [BOILERPLATE] Bytes of slot storage per record (length prefix + item). */
+#define TELEMETRY_QUEUE_SLOT_SIZE(item_size) (2 + (item_size))
+
+struct telemetry_queue_stats {
+	uint32_t enqueued;
+	uint32_t dequeued;
+	/* Records lost to the drop policy, and records larger than a slot. */
+	uint32_t dropped;
+	uint32_t too_big;
+	uint16_t depth;
+	uint16_t high_water;
+};
+
+/*
+ * [TELEMETRY] Called after every drop, with the class and its updated counters.
+ * An EVSE build can feed safety_gate_set_queue_overflow() from here.
+ */
+typedef void (*telemetry_queue_overflow_t)(void *ctx, enum telemetry_queue_class cls,
+					   const struct telemetry_queue_stats *stats);
+
+struct telemetry_queue_lane {
+	uint8_t *slots;
+	uint16_t capacity;
+	uint16_t head;
+	enum telemetry_queue_policy policy;
+	struct telemetry_queue_stats stats;
+};
+
+struct telemetry_queue {
+	struct telemetry_queue_lane lane[TELEMETRY_QUEUE_CLASS_COUNT];
+	uint16_t item_size;
+	telemetry_queue_overflow_t overflow;
+	void *overflow_ctx;
+};
+
+/* [TELEMETRY] All classes start empty with no storage. Returns 0 or -1. */
+int telemetry_queue_init(struct telemetry_queue *q, size_t item_size,
+			 telemetry_queue_overflow_t overflow, void *overflow_ctx);
+
+/*
+ * [TELEMETRY] Give a class capacity * TELEMETRY_QUEUE_SLOT_SIZE(item_size)
+ * bytes of storage and its drop policy. A class with no capacity drops every
+ * record. Returns 0 or -1.
+ */
+int telemetry_queue_configure(struct telemetry_queue *q, enum telemetry_queue_class cls,
+			      uint8_t *slots, uint16_t capacity,
+			      enum telemetry_queue_policy policy);
+
+/* [TELEMETRY] Queue a copy of the record. Returns 0, or -1 when it was dropped. */
+int telemetry_queue_push(struct telemetry_queue *q, enum telemetry_queue_class cls,
+			 const void *data, size_t len);
+
+/*
+ * [TELEMETRY] Next record by priority, left in place until telemetry_queue_pop.
+ * Returns its length (0 when every class is empty) and sets *cls and *data.
+ */
+size_t telemetry_queue_peek(const struct telemetry_queue *q, enum telemetry_queue_class *cls,
+			    const void **data);
+
+/* [TELEMETRY] Remove the oldest record of a class. Returns 0 or -1 when empty. */
+int telemetry_queue_pop(struct telemetry_queue *q, enum telemetry_queue_class cls);
+
+/* [TELEMETRY] Records queued across all classes. */
+size_t telemetry_queue_depth(const struct telemetry_queue *q);
+
+const struct telemetry_queue_stats *telemetry_queue_stats(const struct telemetry_queue *q,
+							  enum telemetry_queue_class cls);
+
+#endif /* TELEMETRY_QUEUE_H */
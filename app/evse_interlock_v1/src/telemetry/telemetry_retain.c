@@ -0,0 +1,165 @@
+/*
+ * [TELEMETRY] Retention window and sequence numbers (see telemetry_retain.h).
+ */
+#include "telemetry/telemetry_retain.h"
+
+#include <string.h>
+
+struct retain_hdr {
+	uint32_t seq;
+	uint16_t len;
+	uint8_t tag;
+	uint8_t pad;
+};
+
+static struct retain_hdr read_hdr(const struct telemetry_retain *r, uint32_t pos)
+{
+	struct retain_hdr hdr;
+
+	memcpy(&hdr, r->buf + pos, sizeof(hdr));
+	return hdr;
+}
+
+/* [BOILERPLATE] Offset after the entry at pos, following the wrap. */
+static uint32_t next_pos(const struct telemetry_retain *r, uint32_t pos)
+{
+	uint32_t next = pos + TELEMETRY_RETAIN_ENTRY_SIZE(read_hdr(r, pos).len);
+
+	return (r->wrapped && pos >= r->tail && next == r->end) ? 0 : next;
+}
+
+static void evict_oldest(struct telemetry_retain *r)
+{
+	uint32_t next = next_pos(r, r->head);
+
+	if (r->wrapped && next == 0) {
+		r->wrapped = false;
+	}
+	r->head = next;
+	r->count--;
+	r->evicted++;
+	if (r->count == 0) {
+		r->head = 0;
+		r->tail = 0;
+		r->wrapped = false;
+	}
+}
+
+int telemetry_retain_init(struct telemetry_retain *r, void *storage, size_t size)
+{
+	if (!r || !storage || size < TELEMETRY_RETAIN_HDR || size > UINT32_MAX) {
+		return -1;
+	}
+	memset(r, 0, sizeof(*r));
+	r->buf = storage;
+	r->size = (uint32_t)(size & ~(size_t)3);
+	return 0;
+}
+
+/* [TELEMETRY] Write offset for need bytes, or UINT32_MAX while the oldest must go. */
+static uint32_t find_room(struct telemetry_retain *r, uint32_t need)
+{
+	if (r->count == 0) {
+		return 0;
+	}
+	if (r->wrapped) {
+		return r->head - r->tail >= need ? r->tail : UINT32_MAX;
+	}
+	if (r->size - r->tail >= need) {
+		return r->tail;
+	}
+	if (r->head >= need) {
+		r->end = r->tail;
+		r->wrapped = true;
+		return 0;
+	}
+	return UINT32_MAX;
+}
+
+int telemetry_retain_put(struct telemetry_retain *r, uint32_t seq, uint8_t tag,
+			 const void *data, size_t len)
+{
+	if (!r || !r->buf || (!data && len) || len > UINT16_MAX ||
+	    TELEMETRY_RETAIN_ENTRY_SIZE(len) > r->size) {
+		return -1;
+	}
+	uint32_t need = TELEMETRY_RETAIN_ENTRY_SIZE(len);
+	uint32_t at;
+
+	while ((at = find_room(r, need)) == UINT32_MAX) {
+		evict_oldest(r);
+	}
+
+	const struct retain_hdr hdr = { .seq = seq, .len = (uint16_t)len, .tag = tag };
+
+	memcpy(r->buf + at, &hdr, sizeof(hdr));
+	if (len) {
+		memcpy(r->buf + at + TELEMETRY_RETAIN_HDR, data, len);
+	}
+	r->tail = at + need;
+	r->count++;
+	return 0;
+}
+
+void telemetry_retain_iter_init(const struct telemetry_retain *r,
+				struct telemetry_retain_iter *it)
+{
+	it->pos = r ? r->head : 0;
+	it->left = r ? r->count : 0;
+}
+
+bool telemetry_retain_next(const struct telemetry_retain *r, struct telemetry_retain_iter *it,
+			   uint32_t from, uint32_t to, struct telemetry_retain_entry *out)
+{
+	if (!r || !it || !out) {
+		return false;
+	}
+	while (it->left > 0) {
+		uint32_t pos = it->pos;
+		struct retain_hdr hdr = read_hdr(r, pos);
+
+		it->pos = next_pos(r, pos);
+		it->left--;
+		if (hdr.seq >= from && hdr.seq <= to) {
+			out->seq = hdr.seq;
+			out->tag = hdr.tag;
+			out->data = r->buf + pos + TELEMETRY_RETAIN_HDR;
+			out->len = hdr.len;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool telemetry_retain_oldest(const struct telemetry_retain *r, uint32_t *seq)
+{
+	if (!r || r->count == 0) {
+		return false;
+	}
+	if (seq) {
+		*seq = read_hdr(r, r->head).seq;
+	}
+	return true;
+}
+
+uint32_t telemetry_seq_init(struct telemetry_seq *s, uint32_t stored, uint32_t block)
+{
+	s->block = block ? block : 1;
+	/* 0 is never handed out, so a fresh device starts at 1. */
+	s->next = stored ? stored : 1;
+	s->limit = s->next + s->block;
+	return s->limit;
+}
+
+uint32_t telemetry_seq_take(struct telemetry_seq *s, uint32_t *persist)
+{
+	uint32_t seq = s->next++;
+
+	*persist = 0;
+	/* Move the limit half a block early so the store is written ahead of use. */
+	if (s->limit - s->next <= s->block / 2) {
+		s->limit = s->next + s->block;
+		*persist = s->limit;
+	}
+	return seq;
+}
@@ -0,0 +1,90 @@
+/*
+ * [TELEMETRY] Retention window for selective resends, and the sequence numbers
+ * that key it.
+ * [BOILERPLATE] Pure C; the caller supplies storage and locking.
+ *
+ * Every record is kept as built, tagged with its sequence number, in a ring
+ * of variable-length entries
+ *   seq(4) len(2) tag(1) pad(1)   header
+ *   data[len]                     padded to 4 bytes
+ * that evicts the oldest entries to make room. An entry never wraps: when the
+ * end of the buffer is too short, writing restarts at offset 0 and the rest
+ * of the upper segment is left unused until the reader passes it. Records of
+ * one event (e.g. session_end and its session summary) share a sequence
+ * number and are kept as separate entries.
+ */
+#ifndef TELEMETRY_RETAIN_H
+#define TELEMETRY_RETAIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_RETAIN_HDR 8
+/* [BOILERPLATE] Storage bytes one record of len bytes occupies. */
+#define TELEMETRY_RETAIN_ENTRY_SIZE(len) (TELEMETRY_RETAIN_HDR + (((len) + 3U) & ~3U))
+
+struct telemetry_retain {
+	uint8_t *buf;
+	uint32_t size;
+	/* Oldest entry, next write, and the end of the upper segment once wrapped. */
+	uint32_t head;
+	uint32_t tail;
+	uint32_t end;
+	bool wrapped;
+	uint32_t count;
+	/* Entries pushed out to make room. */
+	uint32_t evicted;
+};
+
+struct telemetry_retain_entry {
+	uint32_t seq;
+	uint8_t tag;
+	const void *data;
+	size_t len;
+};
+
+/* [TELEMETRY] Walks entries oldest first; invalidated by the next put. */
+struct telemetry_retain_iter {
+	uint32_t pos;
+	uint32_t left;
+};
+
+/* [TELEMETRY] size is rounded down to 4 bytes; returns 0 or -1. */
+int telemetry_retain_init(struct telemetry_retain *r, void *storage, size_t size);
+
+/*
+ * [TELEMETRY] Keep a copy of one record; tag is opaque (the app stores the
+ * encoding). Returns 0, or -1 when the record can never fit.
+ */
+int telemetry_retain_put(struct telemetry_retain *r, uint32_t seq, uint8_t tag,
+			 const void *data, size_t len);
+
+void telemetry_retain_iter_init(const struct telemetry_retain *r,
+				struct telemetry_retain_iter *it);
+
+/* [TELEMETRY] Next entry with from <= seq <= to; false when none is left. */
+bool telemetry_retain_next(const struct telemetry_retain *r, struct telemetry_retain_iter *it,
+			   uint32_t from, uint32_t to, struct telemetry_retain_entry *out);
+
+/* [TELEMETRY] Oldest retained sequence number; false when empty. */
+bool telemetry_retain_oldest(const struct telemetry_retain *r, uint32_t *seq);
+
+/*
+ * [TELEMETRY] Per-device sequence numbers that keep increasing across reboots.
+ * Only a limit is persisted, one block ahead of the numbers handed out, so the
+ * store is written once per block/2 records; a reboot skips the unused rest.
+ */
+struct telemetry_seq {
+	uint32_t next;
+	uint32_t limit;
+	uint32_t block;
+};
+
+/* [TELEMETRY] stored is the last persisted limit (0 if none); returns the limit to persist. */
+uint32_t telemetry_seq_init(struct telemetry_seq *s, uint32_t stored, uint32_t block);
+
+/* [TELEMETRY] Next number; *persist is the new limit to store, or 0 when unchanged. */
+uint32_t telemetry_seq_take(struct telemetry_seq *s, uint32_t *persist);
+
+#endif /* TELEMETRY_RETAIN_H */
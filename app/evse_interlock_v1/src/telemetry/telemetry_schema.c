@@ -0,0 +1,67 @@
+/*
+ * [TELEMETRY] JSON record bodies expanded from telemetry_schema.h.
+ * [BOILERPLATE] One emitter macro per field kind; each record becomes straight-line
+ * writer calls with the keys folded into literals at compile time.
+ */
+#include "telemetry/telemetry_schema.h"
+
+/* [BOILERPLATE] ,"key": (no comma before the first field). */
+static void schema_json_key(struct telemetry_writer *w, bool *first, const char *lit, size_t n)
+{
+	if (!*first) {
+		telemetry_writer_char(w, ',');
+	}
+	*first = false;
+	telemetry_writer_raw(w, lit, n);
+}
+
+#define SCHEMA_KEY(key) schema_json_key(w, &first, "\"" key "\":", sizeof("\"" key "\":") - 1)
+
+#define SCHEMA_JSON_STR(key, v)                                                            \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_char(w, '"');                                                     \
+	telemetry_writer_str(w, (v) ? (v) : "");                                           \
+	telemetry_writer_char(w, '"')
+#define SCHEMA_JSON_ID(key, v) SCHEMA_JSON_STR(key, v)
+#define SCHEMA_JSON_INT(key, v)                                                            \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_i64(w, (v))
+#define SCHEMA_JSON_BOOL(key, v)                                                           \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_bool(w, (v))
+#define SCHEMA_JSON_EDGE(key, v) SCHEMA_JSON_STR(key, gpio_edge_str(v))
+#define SCHEMA_JSON_PILOT(key, v)                                                          \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_char(w, '"');                                                     \
+	telemetry_writer_char(w, evse_pilot_state_to_char(v));                             \
+	telemetry_writer_char(w, '"')
+#define SCHEMA_JSON_FIXED2(key, v)                                                         \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_fixed(w, (v), 2)
+#define SCHEMA_JSON_FIXED3(key, v)                                                         \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_fixed(w, (v), 3)
+#define SCHEMA_JSON_FIXED4(key, v)                                                         \
+	SCHEMA_KEY(key);                                                                   \
+	telemetry_writer_fixed(w, (v), 4)
+/* [TELEMETRY] uptime_ms duplicates timestamp; only the full envelope keeps it. */
+#define SCHEMA_JSON_UPTIME(key, v)                                                         \
+	if (env->mode == TELEMETRY_ENVELOPE_FULL) {                                        \
+		SCHEMA_JSON_INT(key, v);                                                   \
+	}
+
+#define SCHEMA_JSON_FIELD(kind, key, member) SCHEMA_JSON_##kind(key, src->member);
+
+#define SCHEMA_JSON_RECORD(NAME, code, name, src_type)                                     \
+	void telemetry_schema_json_##name(struct telemetry_writer *w,                      \
+					  const struct telemetry_envelope *env,            \
+					  const src_type *src)                             \
+	{                                                                                  \
+		bool first = true;                                                         \
+                                                                                           \
+		(void)env;                                                                 \
+		TELEMETRY_WRITER_LIT(w, "\"" #name "\":{");                                \
+		TELEMETRY_SCHEMA_##NAME(SCHEMA_JSON_FIELD)                                 \
+		telemetry_writer_char(w, '}');                                             \
+	}
+TELEMETRY_SCHEMA_RECORDS(SCHEMA_JSON_RECORD)
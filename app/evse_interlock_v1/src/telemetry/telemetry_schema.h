@@ -0,0 +1,121 @@
+/*
+ * [TELEMETRY] Single-source description of every telemetry record's "data" body.
+ * [BOILERPLATE] X-macro tables; the JSON writer, the binary encoder, the decoder
+ * structs and the host fixtures are all expanded from the lists below.
+ *
+ * Each TELEMETRY_SCHEMA_<RECORD>(X) lists its fields in wire order as
+ *   X(kind, "json_key", member)
+ * where member names the field in the source struct and in the decoded struct.
+ * Kinds (codec per encoding):
+ *   STR     JSON string            | len byte + bytes
+ *   ID      JSON string            | 8/16 packed bytes for hex64/UUID, else STR
+ *   INT     JSON integer           | zigzag varint
+ *   BOOL    JSON true/false        | 1 byte
+ *   EDGE    JSON gpio_edge_str()   | 1 byte
+ *   PILOT   JSON "A".."F"          | 1 byte
+ *   FIXEDn  JSON %.nf              | zigzag varint of value * 10^n
+ *   UPTIME  JSON integer, FULL envelope only | not sent (equals the timestamp)
+ * Adding a field is one line here; wire order changes bump the binary schema.
+ */
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/evse.h"
+#include "telemetry/gpio_event.h"
+#include "telemetry/line_current.h"
+#include "telemetry/telemetry_envelope.h"
+#include "telemetry/telemetry_health.h"
+#include "telemetry/telemetry_writer.h"
+
+/* [TELEMETRY] GPIO has no event struct of its own; builders fill this view. */
+struct telemetry_gpio_src {
+	const char *pin;
+	int state;
+	gpio_edge_t edge;
+	int64_t uptime_ms;
+};
+
+#define TELEMETRY_SCHEMA_GPIO(X)                                                           \
+	X(STR, "pin", pin)                                                                 \
+	X(INT, "state", state)                                                             \
+	X(EDGE, "edge", edge)                                                              \
+	X(UPTIME, "uptime_ms", uptime_ms)
+
+#define TELEMETRY_SCHEMA_EVSE(X)                                                           \
+	X(PILOT, "pilot_state", pilot_state)                                               \
+	X(FIXED2, "pwm_duty_cycle", pwm_duty_cycle)                                        \
+	X(FIXED3, "current_draw", current_draw_a)                                          \
+	X(BOOL, "proximity_detected", proximity_detected)                                  \
+	X(ID, "session_id", session_id)                                                    \
+	X(FIXED4, "energy_delivered_kwh", energy_kwh)
+
+#define TELEMETRY_SCHEMA_LINE_CURRENT(X) X(FIXED3, "current_a", current_a)
+
+#define TELEMETRY_SCHEMA_SESSION(X)                                                        \
+	X(ID, "session_id", session_id)                                                    \
+	X(INT, "samples", samples)                                                         \
+	X(FIXED3, "current_p50", current_p50_a)                                            \
+	X(FIXED3, "current_p95", current_p95_a)                                            \
+	X(FIXED3, "current_max", current_max_a)                                            \
+	X(FIXED4, "energy_delivered_kwh", energy_kwh)
+
+#define TELEMETRY_SCHEMA_HEALTH(X)                                                         \
+	X(INT, "queue_size", queue_size)                                                   \
+	X(INT, "queue_hwm", queue_depth_max)                                               \
+	X(INT, "bulk_hwm", bulk_depth_max)                                                 \
+	X(INT, "enqueue_failed", enqueue_failed)                                           \
+	X(INT, "latency_max_us", latency_max_us)                                           \
+	X(STR, "slow_handler", slow_handler)                                               \
+	X(INT, "exec_max_us", exec_max_us)                                                 \
+	X(INT, "process_merged", process_merged)
+
+/*
+ * [TELEMETRY] Record list: X(NAME, binary type code, name, source struct).
+ * The JSON object key under "data" is the stringified name.
+ */
+#define TELEMETRY_SCHEMA_RECORDS(X)                                                        \
+	X(GPIO, 1, gpio, struct telemetry_gpio_src)                                        \
+	X(EVSE, 2, evse, struct evse_event)                                                \
+	X(LINE_CURRENT, 3, line_current, struct line_current_event)                        \
+	X(SESSION, 7, session, struct evse_session_summary)                                \
+	X(HEALTH, 8, health, struct telemetry_health)
+
+/* [BOILERPLATE] Longest STR/ID value carried by any record (dashed UUID). */
+#define TELEMETRY_SCHEMA_STR_MAX 36
+
+/* [TELEMETRY] Decoded field types; FIXEDn members hold value * 10^n exactly. */
+#define TELEMETRY_SCHEMA_CTYPE_STR(m) char m[TELEMETRY_SCHEMA_STR_MAX + 1]
+#define TELEMETRY_SCHEMA_CTYPE_ID(m) char m[TELEMETRY_SCHEMA_STR_MAX + 1]
+#define TELEMETRY_SCHEMA_CTYPE_INT(m) int32_t m
+#define TELEMETRY_SCHEMA_CTYPE_BOOL(m) bool m
+#define TELEMETRY_SCHEMA_CTYPE_EDGE(m) gpio_edge_t m
+#define TELEMETRY_SCHEMA_CTYPE_PILOT(m) enum evse_pilot_state m
+#define TELEMETRY_SCHEMA_CTYPE_FIXED2(m) int64_t m
+#define TELEMETRY_SCHEMA_CTYPE_FIXED3(m) int64_t m
+#define TELEMETRY_SCHEMA_CTYPE_FIXED4(m) int64_t m
+#define TELEMETRY_SCHEMA_CTYPE_UPTIME(m) int64_t m
+
+#define TELEMETRY_SCHEMA_DECL_FIELD(kind, key, member) TELEMETRY_SCHEMA_CTYPE_##kind(member);
+
+/* Decoded bodies: struct telemetry_gpio_fields, _evse_fields, _line_current_fields, ... */
+#define TELEMETRY_SCHEMA_DECL_STRUCT(NAME, code, name, src_type)                          \
+	struct telemetry_##name##_fields {                                                 \
+		TELEMETRY_SCHEMA_##NAME(TELEMETRY_SCHEMA_DECL_FIELD)                       \
+	};
+TELEMETRY_SCHEMA_RECORDS(TELEMETRY_SCHEMA_DECL_STRUCT)
+
+/*
+ * [TELEMETRY] Generated JSON bodies: append "<name>":{...} for one record.
+ * The writer's overflow flag carries errors, as for the envelope head.
+ */
+#define TELEMETRY_SCHEMA_DECL_JSON(NAME, code, name, src_type)                            \
+	void telemetry_schema_json_##name(struct telemetry_writer *w,                      \
+					  const struct telemetry_envelope *env,            \
+					  const src_type *src);
+TELEMETRY_SCHEMA_RECORDS(TELEMETRY_SCHEMA_DECL_JSON)
+
+#endif /* TELEMETRY_SCHEMA_H */
@@ -0,0 +1,276 @@
+/*
+ * [TELEMETRY] Time-series block encoder/decoder (delta + zigzag + varint runs).
+ * [BOILERPLATE] Every append checks its space up front, so a rejected sample
+ * leaves the block untouched and close() can always finish a pending run.
+ */
+#include "telemetry/telemetry_series.h"
+#include "telemetry/telemetry_fixed.h"
+
+#include <string.h>
+
+#define SERIES_TOKEN_RUN 0x1
+#define SERIES_TOKEN_SKIP 0x3
+/* [TELEMETRY] Decoder bound: keeps t0 + slot * period well inside int64. */
+#define SERIES_T0_MAX (INT64_C(1) << 62)
+
+static size_t varint_len(uint64_t v)
+{
+	size_t n = 1;
+
+	while (v >>= 7) {
+		n++;
+	}
+	return n;
+}
+
+/* [BOILERPLATE] Caller has already checked the space. */
+static void put_varint(struct telemetry_series *s, uint64_t v)
+{
+	s->len += (size_t)telemetry_varint_put(s->buf + s->len, s->cap - s->len, v);
+}
+
+static uint64_t run_token(uint32_t run)
+{
+	/* A single repeat is cheaper as a zero-delta sample token. */
+	return run == 1 ? 0 : ((uint64_t)(run - 2) << 2) | SERIES_TOKEN_RUN;
+}
+
+static size_t run_len(uint32_t run)
+{
+	return run ? varint_len(run_token(run)) : 0;
+}
+
+static uint64_t skip_token(int64_t gap)
+{
+	return ((uint64_t)(gap - 2) << 2) | SERIES_TOKEN_SKIP;
+}
+
+static uint64_t sample_token(int64_t dq)
+{
+	return telemetry_zigzag_encode(dq) << 1;
+}
+
+/* [TELEMETRY] Round half away from zero to the nearest quantum. */
+static int64_t quantize(int32_t value_ma, uint32_t quantum_ma)
+{
+	int64_t v = value_ma;
+	int64_t half = quantum_ma / 2;
+
+	return (v >= 0 ? v + half : v - half) / (int64_t)quantum_ma;
+}
+
+int telemetry_series_open(struct telemetry_series *s, enum telemetry_series_channel channel,
+			  uint32_t period_ms, uint32_t quantum_ma, bool time_anomaly, void *buf,
+			  size_t cap)
+{
+	if (!s || !buf || cap < TELEMETRY_SERIES_MIN_LEN || period_ms == 0 || quantum_ma == 0 ||
+	    (unsigned int)channel > 0xF) {
+		return -1;
+	}
+	memset(s, 0, sizeof(*s));
+	s->buf = buf;
+	s->cap = cap;
+	s->channel = channel;
+	s->period_ms = period_ms;
+	s->quantum_ma = quantum_ma;
+	s->time_anomaly = time_anomaly;
+	return 0;
+}
+
+static int series_first(struct telemetry_series *s, int64_t timestamp_ms, int64_t q)
+{
+	size_t need = 2 + varint_len((uint64_t)timestamp_ms) + varint_len(s->period_ms) +
+		      varint_len(s->quantum_ma) + varint_len(telemetry_zigzag_encode(q));
+
+	if (need > s->cap) {
+		return -1;
+	}
+	s->buf[s->len++] = (uint8_t)((TELEMETRY_BIN_SCHEMA_VERSION << 4) |
+				     TELEMETRY_BIN_TYPE_SERIES);
+	s->buf[s->len++] = (uint8_t)(((unsigned int)s->channel << 4) |
+				     (s->time_anomaly ? TELEMETRY_BIN_F_TIME_ANOMALY : 0));
+	put_varint(s, (uint64_t)timestamp_ms);
+	put_varint(s, s->period_ms);
+	put_varint(s, s->quantum_ma);
+	put_varint(s, telemetry_zigzag_encode(q));
+	s->t0_ms = timestamp_ms;
+	s->last_q = q;
+	s->count = 1;
+	return 0;
+}
+
+int telemetry_series_add(struct telemetry_series *s, int64_t timestamp_ms, int32_t value_ma)
+{
+	if (!s || !s->buf || timestamp_ms < 0 || s->count == UINT16_MAX) {
+		return -1;
+	}
+
+	int64_t q = quantize(value_ma, s->quantum_ma);
+	if (s->count == 0) {
+		return series_first(s, timestamp_ms, q);
+	}
+	if (timestamp_ms < s->t0_ms) {
+		return -1;
+	}
+
+	int64_t slot = (timestamp_ms - s->t0_ms + s->period_ms / 2) / s->period_ms;
+	int64_t gap = slot - s->last_slot;
+	int64_t dq = q - s->last_q;
+
+	/* Two samples in one slot or a long gap: this block cannot hold it. */
+	if (gap <= 0 || gap > TELEMETRY_SERIES_GAP_MAX) {
+		return -1;
+	}
+
+	if (gap == 1 && dq == 0 && s->run < TELEMETRY_SERIES_RUN_MAX) {
+		if (s->len + run_len(s->run + 1) > s->cap) {
+			return -1;
+		}
+		s->run++;
+	} else {
+		size_t need = run_len(s->run) + (gap > 1 ? varint_len(skip_token(gap)) : 0) +
+			      varint_len(sample_token(dq));
+		if (s->len + need > s->cap) {
+			return -1;
+		}
+		if (s->run) {
+			put_varint(s, run_token(s->run));
+			s->run = 0;
+		}
+		if (gap > 1) {
+			put_varint(s, skip_token(gap));
+		}
+		put_varint(s, sample_token(dq));
+	}
+
+	s->last_slot = slot;
+	s->last_q = q;
+	s->count++;
+	return 0;
+}
+
+int telemetry_series_close(struct telemetry_series *s)
+{
+	if (!s || !s->buf) {
+		return -1;
+	}
+	if (s->run) {
+		/* Space for the pending run was reserved when it grew. */
+		put_varint(s, run_token(s->run));
+		s->run = 0;
+	}
+	return (int)s->len;
+}
+
+struct series_reader {
+	const uint8_t *buf;
+	size_t len;
+	size_t pos;
+	bool err;
+};
+
+static uint64_t get_varint(struct series_reader *r)
+{
+	uint64_t v = 0;
+
+	if (r->err) {
+		return 0;
+	}
+	int n = telemetry_varint_get(r->buf + r->pos, r->len - r->pos, &v);
+	if (n < 0) {
+		r->err = true;
+		return 0;
+	}
+	r->pos += (size_t)n;
+	return v;
+}
+
+static bool series_emit(const struct telemetry_series_info *info, int64_t slot, int64_t q,
+			telemetry_series_cb_t cb, void *ctx)
+{
+	int64_t value = q * (int64_t)info->quantum_ma;
+
+	if (q > INT32_MAX || q < INT32_MIN || value > INT32_MAX || value < INT32_MIN) {
+		return false;
+	}
+	if (cb) {
+		cb(info->t0_ms + slot * (int64_t)info->period_ms, (int32_t)value, ctx);
+	}
+	return true;
+}
+
+int telemetry_series_decode(const uint8_t *buf, size_t len, struct telemetry_series_info *info,
+			    telemetry_series_cb_t cb, void *ctx)
+{
+	struct series_reader r = { .buf = buf, .len = len, .pos = 2 };
+	struct telemetry_series_info hdr;
+	int count = 0;
+	int64_t slot = 0;
+	bool skipped = false;
+
+	if (!buf || len < 2 ||
+	    buf[0] != ((TELEMETRY_BIN_SCHEMA_VERSION << 4) | TELEMETRY_BIN_TYPE_SERIES) ||
+	    (buf[1] & 0x0F & ~TELEMETRY_BIN_F_TIME_ANOMALY)) {
+		return -1;
+	}
+	hdr.channel = (enum telemetry_series_channel)(buf[1] >> 4);
+	hdr.time_anomaly = (buf[1] & TELEMETRY_BIN_F_TIME_ANOMALY) != 0;
+
+	uint64_t t0 = get_varint(&r);
+	uint64_t period = get_varint(&r);
+	uint64_t quantum = get_varint(&r);
+	int64_t q = telemetry_zigzag_decode(get_varint(&r));
+	if (r.err || t0 > (uint64_t)SERIES_T0_MAX || period == 0 || period > UINT32_MAX ||
+	    quantum == 0 || quantum > UINT32_MAX) {
+		return -1;
+	}
+	hdr.t0_ms = (int64_t)t0;
+	hdr.period_ms = (uint32_t)period;
+	hdr.quantum_ma = (uint32_t)quantum;
+	if (info) {
+		*info = hdr;
+	}
+	if (!series_emit(&hdr, 0, q, cb, ctx)) {
+		return -1;
+	}
+	count++;
+
+	while (r.pos < r.len) {
+		uint64_t tok = get_varint(&r);
+		if (r.err) {
+			return -1;
+		}
+		if ((tok & 1) == 0) {
+			slot++;
+			q += telemetry_zigzag_decode(tok >> 1);
+			if (!series_emit(&hdr, slot, q, cb, ctx)) {
+				return -1;
+			}
+			count++;
+			skipped = false;
+			continue;
+		}
+		/* A skip must be followed by a sample. */
+		if (skipped) {
+			return -1;
+		}
+		uint64_t n = (tok >> 2) + ((tok & 3) == SERIES_TOKEN_RUN ? 2 : 1);
+		if ((tok & 3) == SERIES_TOKEN_SKIP) {
+			if (n > TELEMETRY_SERIES_GAP_MAX - 1) {
+				return -1;
+			}
+			slot += (int64_t)n;
+			skipped = true;
+			continue;
+		}
+		if (n > TELEMETRY_SERIES_RUN_MAX || count + n > UINT16_MAX) {
+			return -1;
+		}
+		for (uint64_t i = 0; i < n; i++) {
+			slot++;
+			(void)series_emit(&hdr, slot, q, cb, ctx);
+		}
+		count += (int)n;
+	}
+	return skipped ? -1 : count;
+}
@@ -0,0 +1,86 @@
+/*
+ * [TELEMETRY] Time-series blocks: many current samples in one binary uplink.
+ * [BOILERPLATE] Pure encoder/decoder over a caller-owned buffer; no allocation.
+ *
+ * Samples sit on a fixed grid (the sampling timer period) and are quantized to
+ * quantum_ma, so a steady load costs one byte per run and a ramp one byte per
+ * sample. Frame layout:
+ *   byte 0   (schema version << 4) | TELEMETRY_BIN_TYPE_SERIES
+ *   byte 1   (channel << 4) | flags (TELEMETRY_BIN_F_TIME_ANOMALY)
+ *   varint   t0 (timestamp of the first sample, same semantics as "timestamp")
+ *   varint   period_ms (grid step)
+ *   varint   quantum_ma (value step)
+ *   varint   zigzag(v0), first sample in quanta
+ * then one varint token per step:
+ *   ...0     next slot, value += zigzag_decode(token >> 1)
+ *   ..01     (token >> 2) + 2 consecutive slots with an unchanged value
+ *   ..11     skip (token >> 2) + 1 empty slots; the next token is a sample
+ * Sample times are snapped to the grid (timer jitter is below period / 2).
+ */
+#ifndef TELEMETRY_SERIES_H
+#define TELEMETRY_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "telemetry/telemetry_binary.h"
+
+/* [TELEMETRY] Gaps longer than this many slots end the block (e.g. time sync jumps). */
+#define TELEMETRY_SERIES_GAP_MAX 1024
+/* Longest zero-delta run held in one token (fits a 2-byte varint). */
+#define TELEMETRY_SERIES_RUN_MAX 4097
+/* Smallest useful block: header plus a few tokens. */
+#define TELEMETRY_SERIES_MIN_LEN 16
+
+enum telemetry_series_channel {
+	TELEMETRY_SERIES_LINE_CURRENT = 0,
+	TELEMETRY_SERIES_EVSE_CURRENT = 1,
+};
+
+struct telemetry_series {
+	uint8_t *buf;
+	size_t cap;
+	size_t len;
+	uint16_t count;
+	enum telemetry_series_channel channel;
+	bool time_anomaly;
+	uint32_t period_ms;
+	uint32_t quantum_ma;
+	int64_t t0_ms;
+	int64_t last_slot;
+	int64_t last_q;
+	/* Zero-delta samples not yet written; always has room reserved in buf. */
+	uint32_t run;
+};
+
+struct telemetry_series_info {
+	enum telemetry_series_channel channel;
+	bool time_anomaly;
+	int64_t t0_ms;
+	uint32_t period_ms;
+	uint32_t quantum_ma;
+};
+
+/* [BOILERPLATE] Start an empty block; -1 on bad arguments. */
+int telemetry_series_open(struct telemetry_series *s, enum telemetry_series_channel channel,
+			  uint32_t period_ms, uint32_t quantum_ma, bool time_anomaly, void *buf,
+			  size_t cap);
+
+/*
+ * [TELEMETRY] Append one sample. Returns -1 without changing the block when it
+ * is full or the sample cannot share it (time went backwards, gap too long);
+ * the caller ships the block and opens a new one.
+ */
+int telemetry_series_add(struct telemetry_series *s, int64_t timestamp_ms, int32_t value_ma);
+
+/* [BOILERPLATE] Finalize the block in place; returns its length (0 when empty). */
+int telemetry_series_close(struct telemetry_series *s);
+
+typedef void (*telemetry_series_cb_t)(int64_t timestamp_ms, int32_t value_ma, void *ctx);
+
+/* [TELEMETRY] Decode a block; calls cb per sample and returns the sample count or -1. */
+int telemetry_series_decode(const uint8_t *buf, size_t len, struct telemetry_series_info *info,
+			    telemetry_series_cb_t cb, void *ctx);
+
+#endif /* TELEMETRY_SERIES_H */
@@ -0,0 +1,154 @@
+/*
+ * [TELEMETRY] Bounded append writer used by the JSON payload builders.
+ * [BOILERPLATE] Decimal/hex emitters; keeps float printf out of the image.
+ */
+#include "telemetry/telemetry_writer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "telemetry/telemetry_fixed.h"
+
+static const uint32_t telemetry_writer_pow10[] = {1U, 10U, 100U, 1000U, 10000U};
+
+void telemetry_writer_init(struct telemetry_writer *w, char *buf, size_t buf_len)
+{
+	w->buf = buf;
+	w->cap = buf_len;
+	w->len = 0;
+	/* Reserve the NUL terminator up front; a zero-sized buffer is always overflowed. */
+	w->overflow = (buf == NULL || buf_len == 0);
+}
+
+void telemetry_writer_raw(struct telemetry_writer *w, const char *s, size_t n)
+{
+	if (w->overflow) {
+		return;
+	}
+	if (n >= w->cap - w->len) {
+		w->overflow = true;
+		return;
+	}
+	if (n > 0) {
+		memcpy(w->buf + w->len, s, n);
+		w->len += n;
+	}
+}
+
+void telemetry_writer_str(struct telemetry_writer *w, const char *s)
+{
+	/* [BOILERPLATE] A missing string fails the whole payload instead of faulting. */
+	if (!s) {
+		w->overflow = true;
+		return;
+	}
+	telemetry_writer_raw(w, s, strlen(s));
+}
+
+void telemetry_writer_char(struct telemetry_writer *w, char c)
+{
+	telemetry_writer_raw(w, &c, 1);
+}
+
+/* [BOILERPLATE] Unsigned decimal, optionally zero-padded to min_digits. */
+static void telemetry_writer_u64_pad(struct telemetry_writer *w, uint64_t v,
+				     unsigned int min_digits)
+{
+	char tmp[20];
+	size_t n = 0;
+
+	do {
+		tmp[sizeof(tmp) - 1 - n] = (char)('0' + (v % 10U));
+		v /= 10U;
+		n++;
+	} while (v || n < min_digits);
+	telemetry_writer_raw(w, &tmp[sizeof(tmp) - n], n);
+}
+
+void telemetry_writer_i64(struct telemetry_writer *w, int64_t v)
+{
+	uint64_t mag = (uint64_t)v;
+
+	if (v < 0) {
+		telemetry_writer_char(w, '-');
+		mag = 0U - mag;
+	}
+	telemetry_writer_u64_pad(w, mag, 1);
+}
+
+void telemetry_writer_hex16(struct telemetry_writer *w, uint16_t v)
+{
+	static const char digits[] = "0123456789abcdef";
+	char tmp[4];
+
+	for (int i = 3; i >= 0; i--) {
+		tmp[i] = digits[v & 0xF];
+		v >>= 4;
+	}
+	telemetry_writer_raw(w, tmp, sizeof(tmp));
+}
+
+void telemetry_writer_bool(struct telemetry_writer *w, bool v)
+{
+	if (v) {
+		TELEMETRY_WRITER_LIT(w, "true");
+	} else {
+		TELEMETRY_WRITER_LIT(w, "false");
+	}
+}
+
+/*
+ * [TELEMETRY] Scale with round-half-even (telemetry_fixed_from_float), then print
+ * integer and zero-padded fraction. The sign comes from the float itself so that
+ * small negatives render as "-0.000" exactly like printf does.
+ */
+void telemetry_writer_fixed(struct telemetry_writer *w, float value, unsigned int decimals)
+{
+	if (decimals >= sizeof(telemetry_writer_pow10) / sizeof(telemetry_writer_pow10[0])) {
+		w->overflow = true;
+		return;
+	}
+	if (isnan(value)) {
+		telemetry_writer_str(w, signbit(value) ? "-nan" : "nan");
+		return;
+	}
+	if (isinf(value)) {
+		telemetry_writer_str(w, signbit(value) ? "-inf" : "inf");
+		return;
+	}
+
+	uint32_t scale = telemetry_writer_pow10[decimals];
+	double scaled_abs = (double)value * (double)scale;
+
+	if (scaled_abs < 0) {
+		scaled_abs = -scaled_abs;
+	}
+	if (scaled_abs >= 1e18) {
+		w->overflow = true;
+		return;
+	}
+
+	int64_t scaled = telemetry_fixed_from_float(value, scale);
+	uint64_t mag = (uint64_t)(scaled < 0 ? -scaled : scaled);
+
+	if (signbit(value)) {
+		telemetry_writer_char(w, '-');
+	}
+	telemetry_writer_u64_pad(w, mag / scale, 1);
+	if (decimals > 0) {
+		telemetry_writer_char(w, '.');
+		telemetry_writer_u64_pad(w, mag % scale, decimals);
+	}
+}
+
+int telemetry_writer_finish(struct telemetry_writer *w)
+{
+	if (w->overflow) {
+		if (w->buf && w->cap > 0) {
+			w->buf[0] = '\0';
+		}
+		return -1;
+	}
+	w->buf[w->len] = '\0';
+	return (int)w->len;
+}
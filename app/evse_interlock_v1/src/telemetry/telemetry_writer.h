@@ -0,0 +1,42 @@
+/*
+ * [TELEMETRY] Bounded append writer used by the JSON payload builders.
+ * [BOILERPLATE] Integer and fixed-point emitters; no printf, no float formatting.
+ * Any append that does not fit marks the writer as overflowed and later appends
+ * are ignored, so builders check once in telemetry_writer_finish().
+ */
+#ifndef TELEMETRY_WRITER_H
+#define TELEMETRY_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+struct telemetry_writer {
+	char *buf;
+	size_t cap;
+	size_t len;
+	bool overflow;
+};
+
+void telemetry_writer_init(struct telemetry_writer *w, char *buf, size_t buf_len);
+
+void telemetry_writer_raw(struct telemetry_writer *w, const char *s, size_t n);
+void telemetry_writer_str(struct telemetry_writer *w, const char *s);
+void telemetry_writer_char(struct telemetry_writer *w, char c);
+void telemetry_writer_i64(struct telemetry_writer *w, int64_t v);
+void telemetry_writer_hex16(struct telemetry_writer *w, uint16_t v);
+void telemetry_writer_bool(struct telemetry_writer *w, bool v);
+
+/*
+ * [TELEMETRY] Same text as printf("%.<decimals>f") for decimals <= 4 and
+ * |value| * 10^decimals < 1e18; larger magnitudes overflow the writer.
+ */
+void telemetry_writer_fixed(struct telemetry_writer *w, float value, unsigned int decimals);
+
+/* [BOILERPLATE] NUL-terminates and returns the length, or -1 on overflow. */
+int telemetry_writer_finish(struct telemetry_writer *w);
+
+/* [BOILERPLATE] String literal append without strlen at runtime. */
+#define TELEMETRY_WRITER_LIT(w, lit) telemetry_writer_raw((w), (lit), sizeof(lit) - 1)
+
+#endif /* TELEMETRY_WRITER_H */
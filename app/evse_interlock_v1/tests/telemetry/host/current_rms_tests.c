@@ -0,0 +1,118 @@
+/*
+ * [TEST] Host tests for the whole-cycle current RMS.
+ * [EVSE-LOGIC] A biased 60 Hz sine reads its true RMS wherever the block starts.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/current_rms.h"
+
+#define TEST_PI 3.14159265358979323846
+#define TEST_RATE_HZ 8000
+#define TEST_LINE_HZ 60
+#define TEST_BIAS 2048
+#define TEST_AMPLITUDE 1000
+/* Six cycles plus the spare sample, as the EVSE block is sized. */
+#define TEST_SAMPLES (TEST_RATE_HZ * 6 / TEST_LINE_HZ + 1)
+/* 1000 / sqrt(2) in 1/16 LSB. */
+#define TEST_RMS_X16 11314
+
+/* [BOILERPLATE] Taylor series, so the host build needs no libm. */
+static double test_sin(double x)
+{
+	while (x > TEST_PI) {
+		x -= 2 * TEST_PI;
+	}
+	while (x < -TEST_PI) {
+		x += 2 * TEST_PI;
+	}
+	double term = x;
+	double sum = x;
+
+	for (int k = 1; k < 12; k++) {
+		term *= -x * x / ((2 * k) * (2 * k + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+static void fill_sine(int16_t *buf, size_t n, double phase)
+{
+	for (size_t i = 0; i < n; i++) {
+		double v = test_sin(2 * TEST_PI * TEST_LINE_HZ * (double)i / TEST_RATE_HZ + phase);
+		double s = TEST_BIAS + TEST_AMPLITUDE * v;
+
+		buf[i] = (int16_t)(s < 0 ? s - 0.5 : s + 0.5);
+	}
+}
+
+static uint32_t diff_u32(uint32_t a, uint32_t b)
+{
+	return a > b ? a - b : b - a;
+}
+
+void test_current_rms_math(void)
+{
+	assert(current_rms_isqrt(0) == 0);
+	assert(current_rms_isqrt(1) == 1);
+	assert(current_rms_isqrt(15) == 3 && current_rms_isqrt(16) == 4);
+	assert(current_rms_isqrt(UINT64_MAX) == UINT32_MAX);
+	assert(current_rms_isqrt((uint64_t)65535 * 65535) == 65535);
+
+	/* 133.3 samples per cycle: six cycles are 800, rounded from the run. */
+	assert(current_rms_whole_cycles(TEST_SAMPLES, TEST_RATE_HZ, TEST_LINE_HZ) == 800);
+	assert(current_rms_whole_cycles(799, TEST_RATE_HZ, TEST_LINE_HZ) == 667);
+	assert(current_rms_whole_cycles(100, TEST_RATE_HZ, TEST_LINE_HZ) == 100);
+	assert(current_rms_whole_cycles(100, 0, TEST_LINE_HZ) == 100);
+
+	/* DC only (no load on the CT): no current, whatever the bias. */
+	int16_t flat[64];
+
+	for (size_t i = 0; i < 64; i++) {
+		flat[i] = TEST_BIAS;
+	}
+	assert(current_rms_x16(flat, 64, 1) == 0);
+	assert(current_rms_x16(flat, 0, 1) == 0);
+
+	/* Square wave of +-100 LSB about the bias: RMS 100 exactly. */
+	for (size_t i = 0; i < 64; i++) {
+		flat[i] = (int16_t)(TEST_BIAS + ((i & 1) ? 100 : -100));
+	}
+	assert(current_rms_x16(flat, 64, 1) == 100 * 16);
+
+	/* Interleaved scan: every other sample is a flat pilot, skipped by stride. */
+	int16_t scan[128];
+
+	for (size_t i = 0; i < 64; i++) {
+		scan[2 * i] = (int16_t)(TEST_BIAS + 1500);
+		scan[2 * i + 1] = flat[i];
+	}
+	assert(current_rms_x16(scan + 1, 64, 2) == 100 * 16);
+	assert(current_rms_x16(scan, 64, 2) == 0);
+}
+
+void test_current_rms_whole_cycles(void)
+{
+	static int16_t buf[TEST_SAMPLES];
+	size_t n = current_rms_whole_cycles(TEST_SAMPLES, TEST_RATE_HZ, TEST_LINE_HZ);
+	uint32_t worst_whole = 0;
+	uint32_t worst_all = 0;
+
+	/* [EVSE-LOGIC] Starting phase is wherever the block happened to begin. */
+	for (int p = 0; p < 16; p++) {
+		fill_sine(buf, TEST_SAMPLES, 2 * TEST_PI * p / 16);
+		uint32_t whole = diff_u32(current_rms_x16(buf, n, 1), TEST_RMS_X16);
+		uint32_t all = diff_u32(current_rms_x16(buf, TEST_SAMPLES, 1), TEST_RMS_X16);
+
+		worst_whole = whole > worst_whole ? whole : worst_whole;
+		worst_all = all > worst_all ? all : worst_all;
+	}
+	/* Within 0.1% on whole cycles; a trailing part cycle skews it with phase. */
+	assert(worst_whole * 1000 <= TEST_RMS_X16);
+	assert(worst_all > worst_whole);
+
+	/* A part cycle (here 1.5 of them) is off by much more. */
+	fill_sine(buf, 200, TEST_PI / 4);
+	assert(diff_u32(current_rms_x16(buf, 200, 1), TEST_RMS_X16) * 100 > TEST_RMS_X16);
+}
@@ -0,0 +1,107 @@
+/*
+ * [TEST] Host tests for the session current sketch.
+ * [EVSE-LOGIC] Quantiles stay within one bucket of the exact answer in fixed memory.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "telemetry/current_sketch.h"
+
+static int cmp_i32(const void *a, const void *b)
+{
+	int32_t x = *(const int32_t *)a;
+	int32_t y = *(const int32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest-rank quantile over the raw samples. */
+static int32_t exact_quantile(const int32_t *sorted, size_t n, uint32_t permille)
+{
+	size_t rank = (n * permille + 999) / 1000;
+
+	return sorted[rank ? rank - 1 : 0];
+}
+
+void test_current_sketch_buckets(void)
+{
+	/* [BOILERPLATE] Buckets tile 0..128 A without gaps; widths stay within 1/8. */
+	unsigned int prev = 0;
+
+	for (int32_t ma = 0; ma < 128000; ma += 7) {
+		unsigned int b = current_sketch_bucket(ma);
+		int32_t lo;
+		int32_t hi;
+
+		assert(b >= prev && b < CURRENT_SKETCH_BUCKETS);
+		current_sketch_bucket_bounds(b, &lo, &hi);
+		assert(lo <= ma && ma < hi);
+		assert(hi - lo <= CURRENT_SKETCH_UNIT_MA || (hi - lo) * 8 <= lo);
+		prev = b;
+	}
+	assert(current_sketch_bucket(-5000) == 0);
+	assert(current_sketch_bucket(INT32_MAX) == CURRENT_SKETCH_BUCKETS - 1);
+	assert(sizeof(struct current_sketch) <= 2 * CURRENT_SKETCH_BUCKETS + 12);
+}
+
+void test_current_sketch_quantiles(void)
+{
+	/* [EVSE-LOGIC] A 3 h session: idle, 32 A plateau with noise, taper, idle. */
+	static int32_t samples[5400];
+	struct current_sketch s;
+	size_t n = sizeof(samples) / sizeof(samples[0]);
+	static const uint32_t q[] = { 100, 500, 900, 950, 990 };
+
+	current_sketch_reset(&s);
+	assert(current_sketch_quantile(&s, 500) == 0);
+	for (size_t i = 0; i < n; i++) {
+		int32_t ma;
+
+		if (i < 300 || i >= 5100) {
+			ma = 150 + (int32_t)(i % 3) * 40;
+		} else if (i < 4200) {
+			ma = 32000 + (int32_t)((i * 7919) % 1201) - 600;
+		} else {
+			ma = 32000 - (int32_t)(i - 4200) * 35;
+		}
+		samples[i] = ma;
+		current_sketch_add(&s, ma);
+	}
+	qsort(samples, n, sizeof(samples[0]), cmp_i32);
+
+	assert(s.samples == n && s.total == n);
+	assert(s.max_ma == samples[n - 1]);
+	for (size_t i = 0; i < sizeof(q) / sizeof(q[0]); i++) {
+		int32_t exact = exact_quantile(samples, n, q[i]);
+		int32_t est = current_sketch_quantile(&s, q[i]);
+		int32_t lo;
+		int32_t hi;
+
+		/* The estimate lies in the exact value's bucket. */
+		current_sketch_bucket_bounds(current_sketch_bucket(exact), &lo, &hi);
+		assert(est >= lo && est < hi);
+	}
+	assert(current_sketch_quantile(&s, 1000) <= s.max_ma);
+}
+
+void test_current_sketch_saturation(void)
+{
+	/* [EVSE-LOGIC] Counts halve instead of wrapping; the shape survives. */
+	struct current_sketch s;
+
+	current_sketch_reset(&s);
+	for (int i = 0; i < 200000; i++) {
+		current_sketch_add(&s, (i % 4) == 0 ? 32000 : 16000);
+	}
+	assert(s.samples == 200000);
+	assert(s.total < 200000);
+	assert(current_sketch_quantile(&s, 500) == 17000);
+	assert(current_sketch_quantile(&s, 950) > 31000);
+	assert(s.max_ma == 32000);
+
+	current_sketch_add(&s, -250);
+	assert(s.max_ma == 32000);
+	current_sketch_add(NULL, 1);
+	current_sketch_reset(NULL);
+}
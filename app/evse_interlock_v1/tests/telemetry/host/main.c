@@ -15,6 +15,45 @@
 
 void test_telemetry_required_fields(void);
 void test_telemetry_golden_fixtures(void);
+void test_telemetry_envelope_elided(void);
+void test_telemetry_writer_fixed(void);
+void test_telemetry_writer_bounds(void);
+void test_telemetry_writer_speedup(void);
+void test_telemetry_binary_equivalence(void);
+void test_telemetry_binary_rejects(void);
+void test_telemetry_batch_binary(void);
+void test_telemetry_batch_json(void);
+void test_telemetry_batch_savings(void);
+void test_telemetry_fragment_roundtrip(void);
+void test_telemetry_fragment_rejects(void);
+void test_telemetry_decode_json(void);
+void test_telemetry_decode_frames(void);
+void test_telemetry_decode_csv(void);
+void test_telemetry_series_roundtrip(void);
+void test_telemetry_series_compression(void);
+void test_telemetry_series_rejects(void);
+void test_current_sketch_buckets(void);
+void test_current_sketch_quantiles(void);
+void test_current_sketch_saturation(void);
+void test_pwm_stats_window(void);
+void test_pwm_stats_seqlock(void);
+void test_current_rms_math(void);
+void test_current_rms_whole_cycles(void);
+void test_pilot_plateau_timed(void);
+void test_pilot_plateau_levels(void);
+void test_telemetry_prebuilt_pack(void);
+void test_telemetry_prebuilt_oversize(void);
+void test_telemetry_outbox_roundtrip(void);
+void test_telemetry_outbox_wrap(void);
+void test_telemetry_outbox_faults(void);
+void test_telemetry_queue_priority(void);
+void test_telemetry_queue_drop_policy(void);
+void test_telemetry_delivery_retry(void);
+void test_telemetry_delivery_give_up(void);
+void test_telemetry_airtime_estimate(void);
+void test_telemetry_airtime_budget(void);
+void test_telemetry_retain_window(void);
+void test_telemetry_retain_seq(void);
 static void test_gpio_debounce(void)
 {
 	/* [BOILERPLATE] Generic debounce behavior; not EVSE-specific. */
@@ -230,5 +269,44 @@ int main(void)
 	test_time_sync_backward_clamp();
 	test_telemetry_required_fields();
 	test_telemetry_golden_fixtures();
+	test_telemetry_envelope_elided();
+	test_telemetry_writer_fixed();
+	test_telemetry_writer_bounds();
+	test_telemetry_writer_speedup();
+	test_telemetry_binary_equivalence();
+	test_telemetry_binary_rejects();
+	test_telemetry_batch_binary();
+	test_telemetry_batch_json();
+	test_telemetry_batch_savings();
+	test_telemetry_fragment_roundtrip();
+	test_telemetry_fragment_rejects();
+	test_telemetry_decode_json();
+	test_telemetry_decode_frames();
+	test_telemetry_decode_csv();
+	test_telemetry_series_roundtrip();
+	test_telemetry_series_compression();
+	test_telemetry_series_rejects();
+	test_current_sketch_buckets();
+	test_current_sketch_quantiles();
+	test_current_sketch_saturation();
+	test_pwm_stats_window();
+	test_pwm_stats_seqlock();
+	test_current_rms_math();
+	test_current_rms_whole_cycles();
+	test_pilot_plateau_timed();
+	test_pilot_plateau_levels();
+	test_telemetry_prebuilt_pack();
+	test_telemetry_prebuilt_oversize();
+	test_telemetry_outbox_roundtrip();
+	test_telemetry_outbox_wrap();
+	test_telemetry_outbox_faults();
+	test_telemetry_queue_priority();
+	test_telemetry_queue_drop_policy();
+	test_telemetry_delivery_retry();
+	test_telemetry_delivery_give_up();
+	test_telemetry_airtime_estimate();
+	test_telemetry_airtime_budget();
+	test_telemetry_retain_window();
+	test_telemetry_retain_seq();
 	return 0;
 }
@@ -0,0 +1,106 @@
+/*
+ * [TEST] Host tests for pilot plateaus from stream samples.
+ * [EVSE-LOGIC] A 1 kHz pilot with ringing after each edge reads its true
+ * plateau levels from a scan paced at a fixed interval.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/pilot_plateau.h"
+
+#define TEST_PERIOD_US 1000
+#define TEST_INTERVAL_US 123
+#define TEST_SCANS 800
+#define TEST_HIGH 3000
+#define TEST_LOW 500
+/* Ringing right after an edge, shorter than the settle time. */
+#define TEST_RING_US 30
+#define TEST_RING 400
+
+/* Pilot level at time t (us), with the PWM rising at t = 0 mod period. */
+static int16_t test_pilot_at(uint32_t t, uint32_t high_us)
+{
+	uint32_t phase = t % TEST_PERIOD_US;
+
+	if (phase < high_us) {
+		return (int16_t)(TEST_HIGH + (phase < TEST_RING_US ? TEST_RING : 0));
+	}
+	return (int16_t)(TEST_LOW - (phase - high_us < TEST_RING_US ? TEST_RING : 0));
+}
+
+/*
+ * Interleaved scan of {pilot, current}, the first scan at t0. Returns the
+ * time since the PWM rise at the stamp, conv_us after the last pilot sample.
+ */
+static uint32_t test_fill(int16_t *scan, uint32_t t0, uint32_t high_us, uint32_t conv_us)
+{
+	for (size_t i = 0; i < TEST_SCANS; i++) {
+		scan[2 * i] = test_pilot_at(t0 + (uint32_t)i * TEST_INTERVAL_US, high_us);
+		scan[2 * i + 1] = 2048;
+	}
+	return (t0 + (TEST_SCANS - 1) * TEST_INTERVAL_US + conv_us) % TEST_PERIOD_US;
+}
+
+void test_pilot_plateau_timed(void)
+{
+	static int16_t scan[2 * TEST_SCANS];
+	struct pilot_plateau p;
+	struct pilot_plateau_timing t = {
+		.interval_us = TEST_INTERVAL_US,
+		.age_us = 24,
+		.period_us = TEST_PERIOD_US,
+		.settle_us = 50,
+		.conv_us = 12,
+		.window_us = 8 * TEST_PERIOD_US,
+	};
+
+	/* [EVSE-LOGIC] Ringing never reaches a plateau mean, 10..90% duty, any start. */
+	for (uint32_t high = 100; high <= 900; high += 200) {
+		for (uint32_t t0 = 0; t0 < TEST_PERIOD_US; t0 += 97) {
+			t.high_us = high;
+			t.since_us = test_fill(scan, t0, high, t.age_us);
+			pilot_plateau_timed(scan, TEST_SCANS, 2, &t, &p);
+			assert(p.high_n > 0 && p.high == TEST_HIGH);
+			assert(p.low_n > 0 && p.low == TEST_LOW);
+		}
+	}
+
+	/* Only the window is looked at: 8 ms of 123 us scans. */
+	t.high_us = 500;
+	t.since_us = test_fill(scan, 0, 500, t.age_us);
+	pilot_plateau_timed(scan, TEST_SCANS, 2, &t, &p);
+	assert(p.high_n + p.low_n <= 8 * TEST_PERIOD_US / TEST_INTERVAL_US + 1);
+
+	/* A wrong stamp puts edges inside the plateaus; a right one does not. */
+	t.since_us = (t.since_us + 250) % TEST_PERIOD_US;
+	pilot_plateau_timed(scan, TEST_SCANS, 2, &t, &p);
+	assert(p.high != TEST_HIGH || p.low != TEST_LOW);
+
+	/* No PWM figures: nothing. */
+	t.high_us = 0;
+	pilot_plateau_timed(scan, TEST_SCANS, 2, &t, &p);
+	assert(p.high_n == 0 && p.low_n == 0);
+}
+
+void test_pilot_plateau_levels(void)
+{
+	static int16_t scan[2 * TEST_SCANS];
+	struct pilot_plateau p;
+
+	(void)test_fill(scan, 0, 500, 0);
+	pilot_plateau_levels(scan, TEST_SCANS, 2, 65, &p);
+	assert(p.high_n > 0 && p.low_n > 0);
+	/* Ringing stays in: close, not exact. */
+	assert(p.high >= TEST_HIGH && p.high < TEST_HIGH + TEST_RING / 4);
+	assert(p.low <= TEST_LOW && p.low > TEST_LOW - TEST_RING / 4);
+
+	/* Steady pilot: the mean is the level. */
+	for (size_t i = 0; i < TEST_SCANS; i++) {
+		scan[2 * i] = (int16_t)(TEST_HIGH + (i & 1));
+	}
+	pilot_plateau_levels(scan, TEST_SCANS, 2, 64, &p);
+	assert(p.mean == TEST_HIGH || p.mean == TEST_HIGH + 1);
+	pilot_plateau_levels(scan, TEST_SCANS, 2, 0, &p);
+	assert(p.high_n == 0 && p.low_n == 0 && p.mean == 0);
+}
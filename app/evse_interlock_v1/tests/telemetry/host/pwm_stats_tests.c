@@ -0,0 +1,107 @@
+/*
+ * [TEST] Host tests for the pilot PWM snapshot.
+ * [EVSE-LOGIC] Window average/min/max and staleness; reads stay consistent
+ * while a signal handler, standing in for the edge ISR, keeps writing.
+ */
+#define _XOPEN_SOURCE 700
+
+#include <assert.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "telemetry/pwm_stats.h"
+
+void test_pwm_stats_window(void)
+{
+	struct pwm_stats s;
+	struct pwm_snapshot snap;
+
+	pwm_stats_init(&s);
+	assert(!pwm_stats_read(&s, &snap));
+	assert(pwm_snapshot_duty_permille(&snap) == 0);
+
+	/* Nonsense periods are dropped. */
+	pwm_stats_record(&s, 0, 0, 1);
+	pwm_stats_record(&s, 1000, 1001, 1);
+	assert(!pwm_stats_read(&s, &snap));
+
+	/* Partial window: averages over what was recorded. */
+	pwm_stats_record(&s, 1000, 250, 10);
+	pwm_stats_record(&s, 1002, 270, 11);
+	assert(pwm_stats_read(&s, &snap));
+	assert(snap.periods == 2 && snap.period_us == 1002 && snap.high_us == 270);
+	assert(snap.avg_period_us == 1001 && snap.avg_high_us == 260);
+	assert(snap.min_high_us == 250 && snap.max_high_us == 270);
+	assert(snap.min_period_us == 1000 && snap.max_period_us == 1002);
+	assert(pwm_snapshot_duty_permille(&snap) == 260);
+
+	/* Once full, the oldest periods leave the window. */
+	for (uint32_t i = 0; i < PWM_STATS_WINDOW; i++) {
+		pwm_stats_record(&s, 1000, 500 + (i & 1) * 10, 20 + i);
+	}
+	assert(pwm_stats_read(&s, &snap));
+	assert(snap.periods == 2 + PWM_STATS_WINDOW);
+	assert(snap.avg_period_us == 1000 && snap.avg_high_us == 505);
+	assert(snap.min_high_us == 500 && snap.max_high_us == 510);
+	assert(snap.min_period_us == 1000 && snap.max_period_us == 1000);
+
+	/* Missing PWM: no period for longer than the timeout, across the ms wrap. */
+	assert(!pwm_snapshot_stale(&snap, snap.updated_ms + 20, 20));
+	assert(pwm_snapshot_stale(&snap, snap.updated_ms + 21, 20));
+	pwm_stats_record(&s, 1000, 500, UINT32_MAX - 5);
+	assert(pwm_stats_read(&s, &snap));
+	assert(!pwm_snapshot_stale(&snap, 10, 20));
+	assert(pwm_snapshot_stale(&snap, 15, 20));
+}
+
+static struct pwm_stats async_stats;
+static volatile sig_atomic_t async_writes;
+
+/* Every field of a snapshot derives from the write count, so a torn copy shows. */
+static void async_writer(int sig)
+{
+	(void)sig;
+	uint32_t k = (uint32_t)async_writes + 1;
+	uint32_t period = 990 + k % 21;
+
+	pwm_stats_record(&async_stats, period, period / 4, k);
+	async_writes = (sig_atomic_t)k;
+}
+
+void test_pwm_stats_seqlock(void)
+{
+	const struct itimerval every_50us = {
+		.it_interval = { .tv_sec = 0, .tv_usec = 50 },
+		.it_value = { .tv_sec = 0, .tv_usec = 50 },
+	};
+	const struct itimerval off = { 0 };
+	struct sigaction sa;
+	uint32_t reads = 0;
+
+	pwm_stats_init(&async_stats);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = async_writer;
+	assert(sigaction(SIGALRM, &sa, NULL) == 0);
+	assert(setitimer(ITIMER_REAL, &every_50us, NULL) == 0);
+
+	while (async_writes < 2000) {
+		struct pwm_snapshot snap;
+
+		if (!pwm_stats_read(&async_stats, &snap)) {
+			continue;
+		}
+		assert(snap.updated_ms == snap.periods);
+		assert(snap.period_us == 990 + snap.periods % 21);
+		assert(snap.high_us == snap.period_us / 4);
+		assert(snap.min_period_us <= snap.avg_period_us &&
+		       snap.avg_period_us <= snap.max_period_us);
+		reads++;
+	}
+	assert(setitimer(ITIMER_REAL, &off, NULL) == 0);
+	signal(SIGALRM, SIG_DFL);
+	printf("pwm stats: %u consistent reads against %d async writes\n", reads,
+	       (int)async_writes);
+}
@@ -0,0 +1,122 @@
+/*
+ * [TEST] Host tests for the uplink airtime budget.
+ * [TELEMETRY] Time on air against known LoRa/FSK figures; budget verdicts over
+ * simulated time.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "telemetry/telemetry_airtime.h"
+
+static const struct telemetry_airtime_phy lora_sf7 = {
+	.lora = true,
+	.sf = 7,
+	.bw_khz = 125,
+	.cr = 1,
+	.preamble = 8,
+};
+
+static void airtime_setup(struct telemetry_airtime *a)
+{
+	const struct telemetry_airtime_config cfg = {
+		.phy = {
+			[TELEMETRY_AIRTIME_BLE] = { .bitrate_bps = 1000000, .preamble = 6 },
+			[TELEMETRY_AIRTIME_FSK] = { .bitrate_bps = 50000, .preamble = 8 },
+			[TELEMETRY_AIRTIME_LORA] = lora_sf7,
+		},
+		/* BLE unlimited, LoRa 1 %. */
+		.duty_ppm = { [TELEMETRY_AIRTIME_FSK] = 100000, [TELEMETRY_AIRTIME_LORA] = 10000 },
+		.burst_ms = 1000,
+		.reserve_pct = 25,
+	};
+
+	assert(telemetry_airtime_init(a, &cfg, 0) == 0);
+}
+
+void test_telemetry_airtime_estimate(void)
+{
+	/* [TELEMETRY] Reference values from the Semtech LoRa calculator. */
+	struct telemetry_airtime_phy phy = lora_sf7;
+
+	assert(telemetry_airtime_frame_us(&phy, 10) == 41216);
+	phy.sf = 12;
+	/* Low data rate optimisation kicks in at SF12/125 kHz. */
+	assert(telemetry_airtime_frame_us(&phy, 10) == 991232);
+	phy.overhead = 10;
+	phy.bw_khz = 500;
+	assert(telemetry_airtime_frame_us(&phy, 0) < telemetry_airtime_frame_us(&phy, 20));
+
+	const struct telemetry_airtime_phy fsk = { .bitrate_bps = 50000, .preamble = 8 };
+	assert(telemetry_airtime_frame_us(&fsk, 42) == 8000);
+
+	const struct telemetry_airtime_phy bad = { .lora = true, .sf = 6, .bw_khz = 125, .cr = 1 };
+	assert(telemetry_airtime_frame_us(&bad, 10) == 0);
+}
+
+void test_telemetry_airtime_budget(void)
+{
+	/* [TELEMETRY] Periodic waits first, session merges, safety always goes. */
+	struct telemetry_airtime a;
+	int64_t now = 0;
+
+	airtime_setup(&a);
+	telemetry_airtime_set_link(&a, TELEMETRY_AIRTIME_LORA);
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_PERIODIC, 10, now) ==
+	       TELEMETRY_AIRTIME_SEND);
+	for (int i = 0; i < 20; i++) {
+		telemetry_airtime_charge(&a, 10, now);
+	}
+	assert(telemetry_airtime_level_us(&a, now) == 1000000 - 20 * 41216);
+	assert(telemetry_airtime_tight(&a, now));
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_PERIODIC, 10, now) ==
+	       TELEMETRY_AIRTIME_DEFER);
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_SESSION, 10, now) ==
+	       TELEMETRY_AIRTIME_MERGE);
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_SAFETY, 10, now) ==
+	       TELEMETRY_AIRTIME_SEND);
+
+	/* Overdrawn by safety traffic: nothing else goes. */
+	for (int i = 0; i < 5; i++) {
+		telemetry_airtime_charge(&a, 10, now);
+	}
+	assert(telemetry_airtime_level_us(&a, now) == -30400);
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_SESSION, 10, now) ==
+	       TELEMETRY_AIRTIME_DEFER);
+
+	/* 1 % refills 10 us per ms. */
+	now += 32000;
+	assert(telemetry_airtime_level_us(&a, now) == 289600);
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_PERIODIC, 10, now) ==
+	       TELEMETRY_AIRTIME_DEFER);
+	now += 200;
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_PERIODIC, 10, now) ==
+	       TELEMETRY_AIRTIME_SEND);
+
+	/* Overdraft is bounded; a long idle period fills the bucket, no further. */
+	for (int i = 0; i < 100; i++) {
+		telemetry_airtime_charge(&a, 10, now);
+	}
+	assert(telemetry_airtime_level_us(&a, now) == -1000000);
+	now += 1000000000;
+	assert(telemetry_airtime_level_us(&a, now) == 1000000);
+
+	const struct telemetry_airtime_stats *lora = &a.stats[TELEMETRY_AIRTIME_LORA];
+	assert(lora->frames == 125 && lora->used_us == 125ULL * 41216);
+	assert(lora->sent == 3 && lora->merged == 1 && lora->deferred == 3);
+
+	/* Unlimited link: counted, never held back. */
+	telemetry_airtime_set_link(&a, TELEMETRY_AIRTIME_BLE);
+	for (int i = 0; i < 1000; i++) {
+		telemetry_airtime_charge(&a, 100, now);
+	}
+	assert(!telemetry_airtime_tight(&a, now));
+	assert(telemetry_airtime_admit(&a, TELEMETRY_QUEUE_PERIODIC, 100, now) ==
+	       TELEMETRY_AIRTIME_SEND);
+	assert(a.stats[TELEMETRY_AIRTIME_BLE].frames == 1000);
+
+	const struct telemetry_airtime_config bad = { .burst_ms = 0 };
+	assert(telemetry_airtime_init(&a, &bad, 0) < 0);
+	printf("telemetry airtime: %u LoRa frames, %u ms on air, %u deferred\n", lora->frames,
+	       (unsigned int)(lora->used_us / 1000), lora->deferred);
+}
@@ -0,0 +1,185 @@
+/*
+ * [TEST] Host tests for coalesced (multi-record) telemetry frames.
+ * [TELEMETRY] Batched frames carry every record unchanged and respect the MTU.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry/telemetry_batch.h"
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_gpio.h"
+#include "telemetry/telemetry_line_current.h"
+
+static const struct evse_event batch_evse = {
+	.pilot_state = EVSE_PILOT_B,
+	.proximity_detected = true,
+	.pwm_duty_cycle = 53.33f,
+	.current_draw_a = 0.0f,
+	.energy_kwh = 0.0f,
+	.event_type = "session_start",
+	.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+};
+
+static const struct line_current_event batch_line = {
+	.current_a = 31.5f,
+	.event_type = "current_change",
+};
+
+/* [BOILERPLATE] Session start burst: pilot/proximity edge, EVSE record, current. */
+static int build_record(int i, enum telemetry_encoding enc, const struct telemetry_envelope *env,
+			void *buf, size_t cap)
+{
+	int64_t ts = 1704067200000LL + i * 250;
+
+	switch (i % 3) {
+	case 0:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_gpio_payload_bin(buf, cap, "prox", 1,
+								GPIO_EDGE_RISING, ts, NULL,
+								"0123456789abcdef", false) :
+			       telemetry_build_gpio_payload_env(buf, cap, env, "prox", 1,
+								GPIO_EDGE_RISING, ts, NULL,
+								"0123456789abcdef", false);
+	case 1:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_evse_payload_bin(buf, cap, ts, &batch_evse,
+								"0123456789abcdf0", false) :
+			       telemetry_build_evse_payload_env(buf, cap, env, ts, &batch_evse,
+								"0123456789abcdf0", false);
+	default:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_line_current_payload_bin(buf, cap, ts, &batch_line,
+									"0123456789abcdf1", false) :
+			       telemetry_build_line_current_payload_env(buf, cap, env, ts,
+									&batch_line,
+									"0123456789abcdf1", false);
+	}
+}
+
+/* [BOILERPLATE] Fill a batch until the next record no longer fits. */
+static int fill_batch(struct telemetry_batch *batch, enum telemetry_encoding enc,
+		      const struct telemetry_envelope *env, int first, int max_records)
+{
+	int i;
+
+	for (i = first; i < first + max_records; i++) {
+		size_t avail;
+		void *slot = telemetry_batch_slot(batch, &avail);
+		int len = slot ? build_record(i, enc, env, slot, avail) : -1;
+		if (len < 0) {
+			break;
+		}
+		assert(telemetry_batch_commit(batch, (size_t)len) == 0);
+	}
+	return i - first;
+}
+
+void test_telemetry_batch_binary(void)
+{
+	/* [TELEMETRY] Binary batch decodes back to the same records as separate frames. */
+	uint8_t frame[255];
+	uint8_t single[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_batch batch;
+	size_t separate_bytes = 0;
+
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_BINARY, frame, sizeof(frame));
+	int n = fill_batch(&batch, TELEMETRY_ENCODING_BINARY, NULL, 0, 3);
+	assert(n == 3);
+	int len = telemetry_batch_close(&batch);
+	assert(len > 0 && frame[0] == ((TELEMETRY_BIN_SCHEMA_VERSION << 4) |
+				       TELEMETRY_BIN_TYPE_BATCH));
+
+	size_t off = 0;
+	const uint8_t *rec;
+	size_t rec_len;
+	int i = 0;
+	int r;
+	while ((r = telemetry_batch_next_bin(frame, (size_t)len, &off, &rec, &rec_len)) == 1) {
+		int slen = build_record(i, TELEMETRY_ENCODING_BINARY, NULL, single, sizeof(single));
+		struct telemetry_bin_record decoded;
+		assert(slen > 0 && (size_t)slen == rec_len);
+		assert(memcmp(rec, single, rec_len) == 0);
+		assert(telemetry_decode_bin(rec, rec_len, &decoded) == slen);
+		separate_bytes += (size_t)slen;
+		i++;
+	}
+	assert(r == 0 && i == 3);
+	/* One header plus one length byte per record on top of the separate frames. */
+	assert((size_t)len == separate_bytes + 1 + 3);
+
+	/* [TELEMETRY] Corrupt length byte is rejected, not over-read. */
+	frame[1] = 0xFF;
+	off = 0;
+	assert(telemetry_batch_next_bin(frame, (size_t)len, &off, &rec, &rec_len) < 0);
+
+	/* [TELEMETRY] Full-size LoRa-ish frames: records only up to the MTU. */
+	uint8_t small[48];
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_BINARY, small, sizeof(small));
+	n = fill_batch(&batch, TELEMETRY_ENCODING_BINARY, NULL, 0, 10);
+	assert(n >= 1 && n < 10);
+	len = telemetry_batch_close(&batch);
+	assert(len > 0 && (size_t)len <= sizeof(small));
+}
+
+void test_telemetry_batch_json(void)
+{
+	/* [TELEMETRY] JSON batch is an array of the unchanged schema 1.0 records. */
+	char frame[1024];
+	char single[512];
+	struct telemetry_batch batch;
+	struct telemetry_envelope env;
+
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED) == 0);
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_JSON, frame, sizeof(frame));
+	assert(fill_batch(&batch, TELEMETRY_ENCODING_JSON, &env, 0, 3) == 3);
+	int len = telemetry_batch_close(&batch);
+	assert(len > 0 && frame[0] == '[' && frame[len - 1] == ']');
+
+	size_t pos = 1;
+	for (int i = 0; i < 3; i++) {
+		int slen = build_record(i, TELEMETRY_ENCODING_JSON, &env, single, sizeof(single));
+		assert(slen > 0);
+		assert(memcmp(frame + pos, single, (size_t)slen) == 0);
+		pos += (size_t)slen;
+		assert(frame[pos] == (i < 2 ? ',' : ']'));
+		pos++;
+	}
+	assert(pos == (size_t)len);
+
+	/* [TELEMETRY] One record means no framing at all. */
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_JSON, frame, sizeof(frame));
+	assert(fill_batch(&batch, TELEMETRY_ENCODING_JSON, &env, 2, 1) == 1);
+	len = telemetry_batch_close(&batch);
+	int slen = build_record(2, TELEMETRY_ENCODING_JSON, &env, single, sizeof(single));
+	assert(len == slen && memcmp(frame, single, (size_t)len) == 0);
+
+	/* [BOILERPLATE] Empty batch closes to nothing; overlong commits are refused. */
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_JSON, frame, 8);
+	assert(telemetry_batch_close(&batch) == 0);
+	assert(telemetry_batch_commit(&batch, 7) < 0);
+	assert(telemetry_batch_commit(&batch, 6) == 0);
+}
+
+void test_telemetry_batch_savings(void)
+{
+	/* [TELEMETRY] Session start burst: frames needed with and without coalescing. */
+	uint8_t frame[255];
+	struct telemetry_batch batch;
+	int frames = 0;
+	int records = 0;
+	size_t bytes = 0;
+
+	while (records < 12) {
+		telemetry_batch_open(&batch, TELEMETRY_ENCODING_BINARY, frame, sizeof(frame));
+		records += fill_batch(&batch, TELEMETRY_ENCODING_BINARY, NULL, records,
+				      12 - records);
+		bytes += (size_t)telemetry_batch_close(&batch);
+		frames++;
+	}
+	assert(frames * 4 <= records);
+	printf("telemetry batch: %d records in %d binary frame(s), %u bytes\n", records, frames,
+	       (unsigned int)bytes);
+}
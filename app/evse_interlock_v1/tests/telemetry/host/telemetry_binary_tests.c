@@ -0,0 +1,241 @@
+/*
+ * [TEST] Host binary (schema v3) telemetry tests.
+ * [TELEMETRY] JSON and binary encodings must carry identical information.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_gpio.h"
+#include "telemetry/telemetry_line_current.h"
+
+/* [BOILERPLATE] Locate the raw value text following "key": in a flat JSON payload. */
+static const char *json_value(const char *json, const char *key)
+{
+	char pattern[64];
+	const char *p;
+
+	snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+	p = strstr(json, pattern);
+	assert(p != NULL);
+	return p + strlen(pattern);
+}
+
+static void json_str(const char *json, const char *key, char *out, size_t out_len)
+{
+	const char *p = json_value(json, key);
+	size_t n = 0;
+
+	assert(*p == '"');
+	p++;
+	while (p[n] != '"' && n + 1 < out_len) {
+		n++;
+	}
+	memcpy(out, p, n);
+	out[n] = '\0';
+}
+
+/* [BOILERPLATE] Parse a decimal JSON number into a scaled integer without floats. */
+static int64_t json_fixed(const char *json, const char *key, int decimals)
+{
+	const char *p = json_value(json, key);
+	bool neg = false;
+	int64_t v = 0;
+	int frac = -1;
+
+	if (*p == '-') {
+		neg = true;
+		p++;
+	}
+	for (; *p; p++) {
+		if (*p == '.') {
+			frac = 0;
+			continue;
+		}
+		if (*p < '0' || *p > '9') {
+			break;
+		}
+		if (frac >= 0) {
+			frac++;
+		}
+		v = v * 10 + (*p - '0');
+	}
+	assert(frac < 0 ? decimals == 0 : frac == decimals);
+	return neg ? -v : v;
+}
+
+static bool json_bool(const char *json, const char *key)
+{
+	return strncmp(json_value(json, key), "true", 4) == 0;
+}
+
+static void check_gpio(const char *pin, int state, gpio_edge_t edge, int64_t ts,
+		       const char *run_id, const char *event_id, bool anomaly)
+{
+	char json[384];
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_bin_record rec;
+	char s[64];
+
+	int jlen = telemetry_build_gpio_payload_ex(json, sizeof(json), "dev123", "evse", pin,
+						   state, edge, ts, run_id, event_id, anomaly);
+	int blen = telemetry_build_gpio_payload_bin(bin, sizeof(bin), pin, state, edge, ts,
+						    run_id, event_id, anomaly);
+	assert(jlen > 0 && blen > 0);
+	assert(blen <= 24 && blen * 10 < jlen);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &rec) == blen);
+
+	assert(rec.type == TELEMETRY_BIN_TYPE_GPIO);
+	assert(rec.timestamp_ms == json_fixed(json, "timestamp", 0));
+	assert(rec.time_anomaly == json_bool(json, "time_anomaly"));
+	json_str(json, "event_id", s, sizeof(s));
+	assert(strcmp(rec.event_id, s) == 0);
+	json_str(json, "event_type", s, sizeof(s));
+	assert(strcmp(telemetry_event_type_str(rec.event_type), s) == 0);
+	json_str(json, "pin", s, sizeof(s));
+	assert(strcmp(rec.gpio.pin, s) == 0);
+	assert(rec.gpio.state == json_fixed(json, "state", 0));
+	json_str(json, "edge", s, sizeof(s));
+	assert(strcmp(gpio_edge_str(rec.gpio.edge), s) == 0);
+	if (run_id) {
+		json_str(json, "run_id", s, sizeof(s));
+		assert(strcmp(rec.run_id, s) == 0);
+	} else {
+		assert(rec.run_id[0] == '\0');
+	}
+}
+
+static void check_evse(const struct evse_event *evt, int64_t ts, const char *event_id,
+		       bool anomaly)
+{
+	char json[512];
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_bin_record rec;
+	char s[64];
+
+	int jlen = telemetry_build_evse_payload_ex(json, sizeof(json), "dev123", "evse", ts, evt,
+						   event_id, anomaly);
+	int blen = telemetry_build_evse_payload_bin(bin, sizeof(bin), ts, evt, event_id,
+						    anomaly);
+	assert(jlen > 0 && blen > 0);
+	assert(blen * 5 < jlen);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &rec) == blen);
+
+	assert(rec.type == TELEMETRY_BIN_TYPE_EVSE);
+	assert(rec.timestamp_ms == json_fixed(json, "timestamp", 0));
+	assert(rec.time_anomaly == json_bool(json, "time_anomaly"));
+	json_str(json, "event_id", s, sizeof(s));
+	assert(strcmp(rec.event_id, s) == 0);
+	json_str(json, "event_type", s, sizeof(s));
+	assert(strcmp(telemetry_event_type_str(rec.event_type), s) == 0);
+	json_str(json, "pilot_state", s, sizeof(s));
+	assert(evse_pilot_state_to_char(rec.evse.pilot_state) == s[0]);
+	assert(rec.evse.proximity_detected == json_bool(json, "proximity_detected"));
+	assert(rec.evse.pwm_duty_cycle == json_fixed(json, "pwm_duty_cycle", 2));
+	assert(rec.evse.current_draw_a == json_fixed(json, "current_draw", 3));
+	assert(rec.evse.energy_kwh == json_fixed(json, "energy_delivered_kwh", 4));
+	json_str(json, "session_id", s, sizeof(s));
+	assert(strcmp(rec.evse.session_id, s) == 0);
+}
+
+static void check_line_current(const struct line_current_event *evt, int64_t ts,
+			       const char *event_id, bool anomaly)
+{
+	char json[256];
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_bin_record rec;
+	char s[64];
+
+	int jlen = telemetry_build_line_current_payload_ex(json, sizeof(json), "dev123", "evse",
+							   ts, evt, event_id, anomaly);
+	int blen = telemetry_build_line_current_payload_bin(bin, sizeof(bin), ts, evt, event_id,
+							    anomaly);
+	assert(jlen > 0 && blen > 0);
+	assert(blen <= 24 && blen * 8 < jlen);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &rec) == blen);
+
+	assert(rec.type == TELEMETRY_BIN_TYPE_LINE_CURRENT);
+	assert(rec.timestamp_ms == json_fixed(json, "timestamp", 0));
+	assert(rec.time_anomaly == json_bool(json, "time_anomaly"));
+	json_str(json, "event_id", s, sizeof(s));
+	assert(strcmp(rec.event_id, s) == 0);
+	json_str(json, "event_type", s, sizeof(s));
+	assert(strcmp(telemetry_event_type_str(rec.event_type), s) == 0);
+	assert(rec.line_current.current_a == json_fixed(json, "current_a", 3));
+}
+
+void test_telemetry_binary_equivalence(void)
+{
+	/* [TELEMETRY] Decoded binary fields equal the JSON fields for the same event. */
+	check_gpio("hvac", 1, GPIO_EDGE_RISING, 1234, NULL, "evt-uptime", false);
+	check_gpio("hvac", 0, GPIO_EDGE_FALLING, 1704067200000LL, NULL, "9f3a00c100000007",
+		   true);
+	check_gpio("hvac", 1, GPIO_EDGE_UNKNOWN, 42, "run-7", "evt-run", false);
+
+	struct evse_event evt = {
+		.send = true,
+		.pilot_state = EVSE_PILOT_B,
+		.proximity_detected = true,
+		.pwm_duty_cycle = 12.5f,
+		.current_draw_a = 1.234f,
+		.energy_kwh = 0.4567f,
+		.event_type = "state_change",
+		.session_id = "session-1",
+	};
+	check_evse(&evt, 9876, "evt-3", false);
+
+	evt.pilot_state = EVSE_PILOT_C;
+	evt.proximity_detected = false;
+	evt.pwm_duty_cycle = 53.335f;
+	evt.current_draw_a = 31.9996f;
+	evt.energy_kwh = 12.00005f;
+	evt.event_type = "session_start";
+	evt.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9";
+	check_evse(&evt, 1704067200123LL, "0123456789abcdef", true);
+
+	evt.pilot_state = EVSE_PILOT_A;
+	evt.current_draw_a = -0.0625f;
+	evt.event_type = "session_end";
+	evt.session_id = NULL;
+	check_evse(&evt, 0, "evt-end", false);
+
+	struct line_current_event line_evt = {
+		.send = true,
+		.current_a = 12.345f,
+		.event_type = "current_change",
+	};
+	check_line_current(&line_evt, 7777, "evt-4", false);
+	line_evt.current_a = -3.0005f;
+	check_line_current(&line_evt, 1704067200000LL, "00000000ffffffff", true);
+}
+
+void test_telemetry_binary_rejects(void)
+{
+	/* [TELEMETRY] Invalid input and truncated frames are rejected. */
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_bin_record rec;
+	struct line_current_event line_evt = {
+		.current_a = 1.0f,
+		.event_type = "not_a_type",
+	};
+
+	assert(telemetry_build_line_current_payload_bin(bin, sizeof(bin), 1, &line_evt, "e",
+							 false) < 0);
+	assert(telemetry_build_gpio_payload_bin(bin, sizeof(bin), "hvac", 1, GPIO_EDGE_RISING,
+						 -1, NULL, "e", false) < 0);
+	assert(telemetry_build_gpio_payload_bin(bin, 4, "hvac", 1, GPIO_EDGE_RISING, 1, NULL,
+						 "evt-1", false) < 0);
+
+	int len = telemetry_build_gpio_payload_bin(bin, sizeof(bin), "hvac", 1,
+						   GPIO_EDGE_RISING, 1, NULL, "evt-1", false);
+	assert(len > 0);
+	for (int cut = 0; cut < len; cut++) {
+		assert(telemetry_decode_bin(bin, (size_t)cut, &rec) < 0);
+	}
+	bin[0] = (uint8_t)((1 << 4) | TELEMETRY_BIN_TYPE_GPIO);
+	assert(telemetry_decode_bin(bin, (size_t)len, &rec) < 0);
+}
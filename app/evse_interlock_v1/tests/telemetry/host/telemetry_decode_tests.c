@@ -0,0 +1,259 @@
+/*
+ * [TEST] Host tests for the frame decoder library.
+ * [TELEMETRY] JSON and binary frames of one event decode to the same fields.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry/telemetry_batch.h"
+#include "telemetry/telemetry_decode.h"
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_gpio.h"
+#include "telemetry/telemetry_health.h"
+#include "telemetry/telemetry_line_current.h"
+
+static const struct evse_event decode_evse = {
+	.pilot_state = EVSE_PILOT_C,
+	.proximity_detected = true,
+	.pwm_duty_cycle = 53.335f,
+	.current_draw_a = -0.0625f,
+	.energy_kwh = 12.00005f,
+	.event_type = "session_start",
+	.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+};
+
+struct collect {
+	struct telemetry_record recs[4];
+	int count;
+};
+
+static void collect_cb(const struct telemetry_record *r, void *ctx)
+{
+	struct collect *col = ctx;
+
+	assert(col->count < 4);
+	col->recs[col->count++] = *r;
+}
+
+static void assert_same_record(const struct telemetry_bin_record *a,
+			       const struct telemetry_bin_record *b)
+{
+	assert(a->type == b->type);
+	assert(a->timestamp_ms == b->timestamp_ms);
+	assert(a->time_anomaly == b->time_anomaly);
+	assert(a->event_type == b->event_type);
+	assert(strcmp(a->event_id, b->event_id) == 0);
+	assert(strcmp(a->run_id, b->run_id) == 0);
+	/* Both decoders zero the record first, so whole bodies compare bytewise. */
+	switch (a->type) {
+	case TELEMETRY_BIN_TYPE_GPIO:
+		assert(memcmp(&a->gpio, &b->gpio, sizeof(a->gpio)) == 0);
+		break;
+	case TELEMETRY_BIN_TYPE_EVSE:
+		assert(memcmp(&a->evse, &b->evse, sizeof(a->evse)) == 0);
+		break;
+	case TELEMETRY_BIN_TYPE_SESSION:
+		assert(memcmp(&a->session, &b->session, sizeof(a->session)) == 0);
+		break;
+	case TELEMETRY_BIN_TYPE_HEALTH:
+		assert(memcmp(&a->health, &b->health, sizeof(a->health)) == 0);
+		break;
+	default:
+		assert(memcmp(&a->line_current, &b->line_current, sizeof(a->line_current)) == 0);
+		break;
+	}
+}
+
+void test_telemetry_decode_json(void)
+{
+	/* [TELEMETRY] Full and elided JSON decode to the binary decoder's record. */
+	struct telemetry_envelope full;
+	struct telemetry_envelope elided;
+	struct telemetry_record j;
+	struct telemetry_bin_record b;
+	char json[512];
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	int len;
+	int blen;
+
+	assert(telemetry_envelope_init(&full, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	assert(telemetry_envelope_init(&elided, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED) ==
+	       0);
+
+	len = telemetry_build_evse_payload_env(json, sizeof(json), &full, 1704067200123LL,
+					       &decode_evse, "0123456789abcdef", true);
+	blen = telemetry_build_evse_payload_bin(bin, sizeof(bin), 1704067200123LL, &decode_evse,
+						"0123456789abcdef", true);
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &b) == blen);
+	assert(strcmp(j.device_id, "dev123") == 0 && strcmp(j.device_type, "evse") == 0);
+	assert(!j.has_ctx && !j.announce);
+	assert(j.rec.evse.pwm_duty_cycle == 5333 && j.rec.evse.current_draw_a == -62);
+	assert_same_record(&j.rec, &b);
+
+	/* Elided GPIO: uptime_ms is implied by the timestamp, as in binary. */
+	len = telemetry_build_gpio_payload_env(json, sizeof(json), &elided, "hvac", 0,
+					       GPIO_EDGE_FALLING, 1704067200000LL, "run-7",
+					       "9f3a00c100000007", false);
+	blen = telemetry_build_gpio_payload_bin(bin, sizeof(bin), "hvac", 0, GPIO_EDGE_FALLING,
+						1704067200000LL, "run-7", "9f3a00c100000007",
+						false);
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &b) == blen);
+	assert(j.has_ctx && j.ctx_id == elided.ctx_id && j.device_id[0] == '\0');
+	assert_same_record(&j.rec, &b);
+
+	struct line_current_event line = { .current_a = -3.0005f, .event_type = "current_change" };
+	len = telemetry_build_line_current_payload_env(json, sizeof(json), &full, 7777, &line,
+						       "evt-line", false);
+	blen = telemetry_build_line_current_payload_bin(bin, sizeof(bin), 7777, &line,
+							"evt-line", false);
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &b) == blen);
+	assert_same_record(&j.rec, &b);
+
+	static const struct evse_session_summary session = {
+		.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+		.samples = 1800,
+		.current_p50_a = 15.875f,
+		.current_p95_a = 16.125f,
+		.current_max_a = 16.4f,
+		.energy_kwh = 7.25f,
+	};
+	len = telemetry_build_session_payload_env(json, sizeof(json), &elided, 8888, &session,
+						  "evt-s", false);
+	blen = telemetry_build_session_payload_bin(bin, sizeof(bin), 8888, &session, "evt-s",
+						   false);
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &b) == blen);
+	assert(j.rec.event_type == TELEMETRY_EVENT_SESSION_END);
+	assert(j.rec.session.samples == 1800 && j.rec.session.current_max_a == 16400);
+	assert_same_record(&j.rec, &b);
+
+	static const struct telemetry_health health = {
+		.queue_size = 16,
+		.queue_depth_max = 16,
+		.enqueue_failed = 3,
+		.latency_max_us = 250000,
+		.slow_handler = "process",
+		.exec_max_us = 1200,
+		.process_merged = 40,
+	};
+	len = telemetry_build_health_payload_env(json, sizeof(json), &elided, 9999, &health,
+						 "evt-h", false);
+	blen = telemetry_build_health_payload_bin(bin, sizeof(bin), 9999, &health, "evt-h",
+						  false);
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(telemetry_decode_bin(bin, (size_t)blen, &b) == blen);
+	assert(j.rec.event_type == TELEMETRY_EVENT_HEALTH);
+	assert(j.rec.health.queue_depth_max == 16 && j.rec.health.bulk_depth_max == 0);
+	assert(strcmp(j.rec.health.slow_handler, "process") == 0);
+	assert_same_record(&j.rec, &b);
+
+	len = telemetry_build_announce_payload(json, sizeof(json), &elided, 5, "evt-a");
+	assert(telemetry_decode_json(json, (size_t)len, &j) == len);
+	assert(j.announce && j.has_ctx && j.ctx_id == elided.ctx_id);
+	assert(strcmp(j.device_type, "evse") == 0);
+
+	/* [TELEMETRY] Malformed or over-precise input is rejected, never rounded. */
+	static const char *const bad[] = {
+		"{\"timestamp\":1,\"event_type\":\"state_change\"}",
+		"{\"timestamp\":1,\"data\":{\"line_current\":{\"current_a\":1.2345}}}",
+		"{\"schema_version\":\"2.0\",\"data\":{\"line_current\":{\"current_a\":1.000}}}",
+		"{\"timestamp\":1,\"data\":{\"line_current\":{\"current_a\":1.000}}",
+		"{\"timestamp\":99999999999999999999,\"data\":{\"gpio\":{}}}",
+	};
+	for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+		assert(telemetry_decode_json(bad[i], strlen(bad[i]), &j) < 0);
+	}
+}
+
+void test_telemetry_decode_frames(void)
+{
+	/* [TELEMETRY] Batches and fragments come out as individual records. */
+	struct telemetry_decoder d;
+	struct telemetry_batch batch;
+	struct collect col = { 0 };
+	struct telemetry_envelope env;
+	uint8_t frame[1024];
+	uint8_t frag[64];
+	size_t avail;
+	void *slot;
+	int len;
+
+	telemetry_decoder_init(&d);
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED) == 0);
+
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_JSON, frame, sizeof(frame));
+	for (int i = 0; i < 2; i++) {
+		slot = telemetry_batch_slot(&batch, &avail);
+		len = telemetry_build_evse_payload_env(slot, avail, &env, 100 + i, &decode_evse,
+						       "evt-b", false);
+		assert(telemetry_batch_commit(&batch, (size_t)len) == 0);
+	}
+	len = telemetry_batch_close(&batch);
+	assert(telemetry_decoder_feed(&d, frame, (size_t)len, collect_cb, &col) == 2);
+	assert(col.count == 2 && col.recs[1].rec.timestamp_ms == 101);
+
+	telemetry_batch_open(&batch, TELEMETRY_ENCODING_BINARY, frame, 255);
+	for (int i = 0; i < 2; i++) {
+		slot = telemetry_batch_slot(&batch, &avail);
+		len = telemetry_build_gpio_payload_bin(slot, avail, "prox", i, GPIO_EDGE_RISING,
+						       200 + i, NULL, "0123456789abcdef", false);
+		assert(telemetry_batch_commit(&batch, (size_t)len) == 0);
+	}
+	len = telemetry_batch_close(&batch);
+	col.count = 0;
+	assert(telemetry_decoder_feed(&d, frame, (size_t)len, collect_cb, &col) == 2);
+	assert(col.recs[0].encoding == TELEMETRY_ENCODING_BINARY);
+	assert(col.recs[1].rec.gpio.state == 1 && col.recs[1].rec.gpio.uptime_ms == 201);
+
+	/* A full-envelope JSON record split into 40-byte fragments, sent in order. */
+	char json[512];
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	int jlen = telemetry_build_evse_payload_env(json, sizeof(json), &env, 300, &decode_evse,
+						    "evt-f", false);
+	int count = telemetry_fragment_count((size_t)jlen, 40);
+	assert(count > 1);
+	col.count = 0;
+	for (int i = 0; i < count; i++) {
+		len = telemetry_fragment_build(frag, sizeof(frag), (const uint8_t *)json,
+					       (size_t)jlen, 40, 9, (unsigned int)i);
+		int n = telemetry_decoder_feed(&d, frag, (size_t)len, collect_cb, &col);
+		assert(n == (i == count - 1 ? 1 : 0));
+	}
+	assert(col.count == 1 && strcmp(col.recs[0].device_id, "dev123") == 0);
+
+	assert(telemetry_decoder_feed(&d, (const uint8_t *)"[{}]", 4, collect_cb, &col) < 0);
+	assert(d.frames == 3 + (uint32_t)count && d.records == 5 && d.errors == 1);
+}
+
+void test_telemetry_decode_csv(void)
+{
+	/* [TELEMETRY] CSV rows line up with the generated header. */
+	struct telemetry_record r;
+	char header[1024];
+	char row[1024];
+	char json[512];
+	int commas = 0;
+
+	int len = telemetry_build_evse_payload_ex(json, sizeof(json), "dev123", "evse", 9876,
+						  &decode_evse, "evt-3", false);
+	assert(telemetry_decode_json(json, (size_t)len, &r) == len);
+	assert(telemetry_record_csv_header(header, sizeof(header)) > 0);
+	assert(telemetry_record_csv(&r, row, sizeof(row)) > 0);
+	for (const char *p = header; *p; p++) {
+		commas += *p == ',';
+	}
+	for (const char *p = row; *p; p++) {
+		commas -= *p == ',';
+	}
+	assert(commas == 0);
+	assert(strstr(header, ",evse.pwm_duty_cycle,") != NULL);
+	assert(strncmp(row, "json,evse,9876,evt-3,session_start,false,,dev123,evse,", 54) == 0);
+	assert(strstr(row, ",C,53.33,-0.062,true,0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9,12.0000") !=
+	       NULL);
+	assert(telemetry_record_csv(&r, row, 16) < 0);
+}
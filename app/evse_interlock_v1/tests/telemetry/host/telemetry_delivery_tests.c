@@ -0,0 +1,139 @@
+/*
+ * [TEST] Host tests for uplink delivery tracking and retry.
+ * [TELEMETRY] A scripted link confirms or fails each id; time is simulated.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry/telemetry_delivery.h"
+
+#define SLOTS 4
+#define ITEM 32
+
+static struct telemetry_delivery_slot slots[SLOTS];
+static uint8_t storage[SLOTS * ITEM];
+static uint32_t rng_state;
+
+static uint32_t test_rand(void)
+{
+	rng_state = rng_state * 1103515245u + 12345u;
+	return rng_state >> 8;
+}
+
+static void delivery_setup(struct telemetry_delivery *d, uint32_t (*rand)(void))
+{
+	const struct telemetry_delivery_config cfg = {
+		.backoff_base_ms = 1000,
+		.backoff_max_ms = 8000,
+		.ack_timeout_ms = 30000,
+		.max_attempts = 4,
+		.rand = rand,
+	};
+
+	rng_state = 1;
+	assert(telemetry_delivery_init(d, slots, SLOTS, storage, ITEM, &cfg) == 0);
+}
+
+void test_telemetry_delivery_retry(void)
+{
+	/* [TELEMETRY] Fail, back off, resend under a new id, confirm; time-to-ack spans it. */
+	struct telemetry_delivery d;
+	const void *data;
+	size_t len;
+
+	delivery_setup(&d, NULL);
+	assert(telemetry_delivery_next_due(&d) == INT64_MAX);
+
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, 7, "rec-a", 5, 0);
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, 8, "rec-b", 5, 10);
+	assert(d.stats.tracked == 2 && telemetry_delivery_next_due(&d) == 30000);
+
+	telemetry_delivery_sent(&d, 8, 410);
+	assert(d.stats.acked == 1 && d.stats.ack_ms_max == 400);
+
+	telemetry_delivery_error(&d, 7, 500);
+	assert(telemetry_delivery_next_due(&d) == 1500);
+	assert(telemetry_delivery_next_resend(&d, 1499, &data, &len) < 0);
+	int slot = telemetry_delivery_next_resend(&d, 1500, &data, &len);
+	assert(slot >= 0 && len == 5 && memcmp(data, "rec-a", 5) == 0);
+	/* Handed out once: not again while the resend is pending. */
+	assert(telemetry_delivery_next_resend(&d, 1500, NULL, NULL) < 0);
+
+	telemetry_delivery_put(&d, (uint16_t)slot, true, 9, data, len, 1600);
+	assert(d.stats.retries == 1);
+	telemetry_delivery_sent(&d, 7, 1700);
+	assert(d.stats.unknown == 1);
+	telemetry_delivery_sent(&d, 9, 2000);
+	assert(d.stats.acked == 2 && d.stats.ack_ms_max == 2000);
+	assert(d.stats.ack_ms_total == 2400 && d.stats.failed == 0);
+	assert(telemetry_delivery_next_due(&d) == INT64_MAX);
+
+	/* Exponential backoff, capped. */
+	assert(telemetry_delivery_backoff_ms(&d, 1) == 1000);
+	assert(telemetry_delivery_backoff_ms(&d, 2) == 2000);
+	assert(telemetry_delivery_backoff_ms(&d, 3) == 4000);
+	assert(telemetry_delivery_backoff_ms(&d, 4) == 8000);
+	assert(telemetry_delivery_backoff_ms(&d, 200) == 8000);
+}
+
+void test_telemetry_delivery_give_up(void)
+{
+	/* [TELEMETRY] Timeouts and put errors count as attempts; max_attempts gives up. */
+	struct telemetry_delivery d;
+	int64_t now = 0;
+	uint16_t id = 100;
+
+	delivery_setup(&d, test_rand);
+	for (uint8_t n = 1; n < 10; n++) {
+		uint32_t b = telemetry_delivery_backoff_ms(&d, n);
+		uint32_t cap = n >= 4 ? 8000 : 1000u << (n - 1);
+		assert(b >= cap / 2 && b <= cap);
+	}
+
+	/* Never confirmed: every attempt times out. */
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, id++, "lost", 4, now);
+	for (int attempt = 2; attempt <= 4; attempt++) {
+		now = telemetry_delivery_next_due(&d);
+		int slot = telemetry_delivery_next_resend(&d, now, NULL, NULL);
+		assert(slot < 0);
+		now = telemetry_delivery_next_due(&d);
+		slot = telemetry_delivery_next_resend(&d, now, NULL, NULL);
+		assert(slot >= 0);
+		telemetry_delivery_put(&d, (uint16_t)slot, true, id++, NULL, 0, now);
+	}
+	assert(d.stats.timeouts == 3 && d.stats.retries == 3);
+	now = telemetry_delivery_next_due(&d);
+	assert(telemetry_delivery_next_resend(&d, now, NULL, NULL) < 0);
+	assert(d.stats.failed == 1 && d.stats.timeouts == 4);
+	assert(telemetry_delivery_next_due(&d) == INT64_MAX);
+
+	/* A put error, then a resend that could not be queued, then success. */
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, false, 0, "put", 3, now);
+	now = telemetry_delivery_next_due(&d);
+	int slot = telemetry_delivery_next_resend(&d, now, NULL, NULL);
+	telemetry_delivery_resend_failed(&d, (uint16_t)slot, now);
+	now = telemetry_delivery_next_due(&d);
+	slot = telemetry_delivery_next_resend(&d, now, NULL, NULL);
+	telemetry_delivery_put(&d, (uint16_t)slot, true, id, NULL, 0, now);
+	telemetry_delivery_sent(&d, id, now + 50);
+	assert(d.stats.acked == 1 && d.stats.failed == 1 && d.stats.retries == 5);
+
+	/* Table full or record too large: counted, not tracked. */
+	uint8_t big[ITEM + 1] = { 0 };
+	for (int i = 0; i < SLOTS; i++) {
+		telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, (uint16_t)(200 + i), "x",
+				       1, now);
+	}
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, 300, "y", 1, now);
+	assert(d.stats.untracked == 1);
+	telemetry_delivery_sent(&d, 200, now);
+	telemetry_delivery_put(&d, TELEMETRY_DELIVERY_NEW, true, 301, big, sizeof(big), now);
+	assert(d.stats.untracked == 2);
+
+	const struct telemetry_delivery_config bad = { .backoff_base_ms = 0, .max_attempts = 1 };
+	assert(telemetry_delivery_init(&d, slots, SLOTS, storage, ITEM, &bad) < 0);
+	printf("telemetry delivery: %u tracked, %u acked, %u failed, %u retries\n",
+	       d.stats.tracked, d.stats.acked, d.stats.failed, d.stats.retries);
+}
@@ -0,0 +1,107 @@
+/*
+ * [TEST] Host tests for MTU fragmentation and reassembly.
+ * [TELEMETRY] Any order of fragments rebuilds the original record byte for byte.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry/telemetry_binary.h"
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_fragment.h"
+
+static void roundtrip(const uint8_t *rec, size_t rec_len, size_t mtu, bool reverse)
+{
+	uint8_t frames[TELEMETRY_FRAG_MAX_COUNT][256];
+	int frame_len[TELEMETRY_FRAG_MAX_COUNT];
+	struct telemetry_reassembly r;
+	int count = telemetry_fragment_count(rec_len, mtu);
+
+	assert(count > 0);
+	for (int i = 0; i < count; i++) {
+		frame_len[i] = telemetry_fragment_build(frames[i], sizeof(frames[i]), rec, rec_len,
+							mtu, 7, (unsigned int)i);
+		assert(frame_len[i] > TELEMETRY_FRAG_HDR_LEN && (size_t)frame_len[i] <= mtu);
+		assert(telemetry_fragment_is_fragment(frames[i], (size_t)frame_len[i]));
+	}
+
+	telemetry_reassembly_init(&r);
+	for (int k = 0; k < count; k++) {
+		int i = reverse ? count - 1 - k : k;
+		int res = telemetry_reassembly_add(&r, frames[i], (size_t)frame_len[i]);
+		if (k < count - 1) {
+			assert(res == 0);
+		} else {
+			assert(res == (int)rec_len);
+			assert(memcmp(r.buf, rec, rec_len) == 0);
+		}
+	}
+}
+
+void test_telemetry_fragment_roundtrip(void)
+{
+	/* [TELEMETRY] Full-envelope EVSE JSON over BLE/LoRa-sized MTUs, both orders. */
+	char json[512];
+	struct evse_event evt = {
+		.pilot_state = EVSE_PILOT_C,
+		.proximity_detected = true,
+		.pwm_duty_cycle = 53.33f,
+		.current_draw_a = 31.5f,
+		.energy_kwh = 1.25f,
+		.event_type = "session_start",
+		.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+	};
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+
+	int jlen = telemetry_build_evse_payload_ex(json, sizeof(json), "dev123", "evse",
+						   1704067200123LL, &evt, "0123456789abcdef", false);
+	int blen = telemetry_build_evse_payload_bin(bin, sizeof(bin), 1704067200123LL, &evt,
+						    "0123456789abcdef", false);
+	assert(jlen > 255 && blen > 19);
+
+	roundtrip((const uint8_t *)json, (size_t)jlen, 255, false);
+	roundtrip((const uint8_t *)json, (size_t)jlen, 255, true);
+	roundtrip((const uint8_t *)json, (size_t)jlen, 200, true);
+	roundtrip(bin, (size_t)blen, 19, false);
+	roundtrip(bin, (size_t)blen, 19, true);
+	/* Record that already fits is a single fragment. */
+	roundtrip(bin, (size_t)blen, 255, false);
+
+	/* [TELEMETRY] Full-envelope JSON cannot be squeezed into LoRa frames. */
+	assert(telemetry_fragment_count((size_t)jlen, 19) < 0);
+	assert(telemetry_fragment_count(10, TELEMETRY_FRAG_HDR_LEN) < 0);
+}
+
+void test_telemetry_fragment_rejects(void)
+{
+	/* [TELEMETRY] Malformed or interleaved fragments never yield a bogus record. */
+	uint8_t rec[40];
+	uint8_t f0[32];
+	uint8_t f1[32];
+	uint8_t other[32];
+	struct telemetry_reassembly r;
+
+	for (size_t i = 0; i < sizeof(rec); i++) {
+		rec[i] = (uint8_t)(i * 3);
+	}
+	int l0 = telemetry_fragment_build(f0, sizeof(f0), rec, sizeof(rec), 24, 1, 0);
+	int l1 = telemetry_fragment_build(f1, sizeof(f1), rec, sizeof(rec), 24, 1, 1);
+	int lo = telemetry_fragment_build(other, sizeof(other), rec, sizeof(rec), 24, 2, 1);
+	assert(l0 == 24 && l1 == 4 + 20 && lo == l1);
+	assert(telemetry_fragment_build(f0, sizeof(f0), rec, sizeof(rec), 24, 1, 2) < 0);
+	assert(telemetry_fragment_build(f0, 8, rec, sizeof(rec), 24, 1, 0) < 0);
+
+	telemetry_reassembly_init(&r);
+	assert(telemetry_reassembly_add(&r, f0, (size_t)l0) == 0);
+	/* A different message id restarts; the stale first half is not reused. */
+	assert(telemetry_reassembly_add(&r, other, (size_t)lo) == 0);
+	assert(telemetry_reassembly_add(&r, f1, (size_t)l1) == 0);
+	assert(telemetry_reassembly_add(&r, f0, (size_t)l0) == (int)sizeof(rec));
+	assert(memcmp(r.buf, rec, sizeof(rec)) == 0);
+
+	/* Short non-last fragment and non-fragment frames are rejected. */
+	assert(telemetry_reassembly_add(&r, f0, (size_t)l0 - 1) < 0);
+	assert(telemetry_reassembly_add(&r, rec, sizeof(rec)) < 0);
+	assert(telemetry_reassembly_add(&r, f0, TELEMETRY_FRAG_HDR_LEN) < 0);
+}
@@ -0,0 +1,234 @@
+/*
+ * [TEST] Host tests for the store-and-forward outbox.
+ * [TELEMETRY] A RAM flash model with NOR semantics (program clears bits, erase
+ * sets a sector to 0xFF) stands in for the flash_area; writes can be cut off to
+ * model power loss.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry/telemetry_outbox.h"
+
+#define SIM_SECTOR 256
+#define SIM_SECTORS 4
+
+struct flash_sim {
+	uint8_t mem[SIM_SECTOR * SIM_SECTORS];
+	unsigned int erases[SIM_SECTORS];
+	/* Writes left before a simulated power cut (-1: never). */
+	int writes_left;
+	uint8_t align;
+};
+
+static int sim_read(void *ctx, uint32_t off, void *buf, size_t len)
+{
+	struct flash_sim *sim = ctx;
+
+	assert(off + len <= sizeof(sim->mem));
+	memcpy(buf, sim->mem + off, len);
+	return 0;
+}
+
+static int sim_write(void *ctx, uint32_t off, const void *buf, size_t len)
+{
+	struct flash_sim *sim = ctx;
+	const uint8_t *p = buf;
+
+	assert(off % sim->align == 0 && len % sim->align == 0);
+	assert(off + len <= sizeof(sim->mem));
+	if (sim->writes_left == 0) {
+		/* Power cut halfway through this write. */
+		len /= 2;
+	}
+	for (size_t i = 0; i < len; i++) {
+		sim->mem[off + i] &= p[i];
+	}
+	if (sim->writes_left >= 0 && sim->writes_left-- == 0) {
+		return -1;
+	}
+	return 0;
+}
+
+static int sim_erase(void *ctx, uint32_t off, size_t len)
+{
+	struct flash_sim *sim = ctx;
+
+	assert(off % SIM_SECTOR == 0 && len == SIM_SECTOR);
+	memset(sim->mem + off, 0xFF, len);
+	sim->erases[off / SIM_SECTOR]++;
+	return 0;
+}
+
+static void sim_init(struct flash_sim *sim, struct telemetry_outbox_flash *f, uint8_t align)
+{
+	memset(sim, 0, sizeof(*sim));
+	/* Unformatted flash: not erased, not a log. */
+	memset(sim->mem, 0x5A, sizeof(sim->mem));
+	sim->writes_left = -1;
+	sim->align = align;
+	*f = (struct telemetry_outbox_flash){
+		.read = sim_read,
+		.write = sim_write,
+		.erase = sim_erase,
+		.ctx = sim,
+		.sector_size = SIM_SECTOR,
+		.sector_count = SIM_SECTORS,
+		.write_align = align,
+	};
+}
+
+static int push_rec(struct telemetry_outbox *ob, int n)
+{
+	char rec[64];
+	int len = snprintf(rec, sizeof(rec), "{\"n\":%d}", n);
+
+	return telemetry_outbox_push(ob, rec, (size_t)len);
+}
+
+/* [TELEMETRY] Peek + pop one record and return its number (-1 when empty). */
+static int pop_rec(struct telemetry_outbox *ob, enum telemetry_outbox_order order)
+{
+	char rec[64];
+	int n = -1;
+	int len = telemetry_outbox_peek(ob, order, rec, sizeof(rec) - 1);
+
+	assert(len >= 0);
+	if (len == 0) {
+		return -1;
+	}
+	rec[len] = '\0';
+	assert(sscanf(rec, "{\"n\":%d}", &n) == 1);
+	assert(telemetry_outbox_pop(ob) == 0);
+	return n;
+}
+
+void test_telemetry_outbox_roundtrip(void)
+{
+	/* [TELEMETRY] FIFO replay, progress survives a remount, LIFO serves newest first. */
+	static const uint8_t aligns[] = { 1, 4, 8 };
+	struct flash_sim sim;
+	struct telemetry_outbox_flash f;
+	struct telemetry_outbox ob;
+
+	for (size_t a = 0; a < sizeof(aligns); a++) {
+		sim_init(&sim, &f, aligns[a]);
+		assert(telemetry_outbox_mount(&ob, &f) == 0);
+		assert(ob.pending == 0 && pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == -1);
+
+		for (int i = 0; i < 12; i++) {
+			assert(push_rec(&ob, i) == 0);
+		}
+		assert(ob.pending == 12 && ob.dropped == 0);
+		for (int i = 0; i < 5; i++) {
+			assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == i);
+		}
+
+		/* Reboot: sent records stay sent, sequence numbers continue. */
+		uint32_t seq = ob.next_seq;
+		assert(telemetry_outbox_mount(&ob, &f) == 0);
+		assert(ob.pending == 7 && ob.next_seq == seq);
+		assert(pop_rec(&ob, TELEMETRY_OUTBOX_LIFO) == 11);
+		assert(pop_rec(&ob, TELEMETRY_OUTBOX_LIFO) == 10);
+		assert(push_rec(&ob, 12) == 0);
+		assert(pop_rec(&ob, TELEMETRY_OUTBOX_LIFO) == 12);
+		for (int i = 5; i < 10; i++) {
+			assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == i);
+		}
+		assert(ob.pending == 0 && pop_rec(&ob, TELEMETRY_OUTBOX_LIFO) == -1);
+		assert(telemetry_outbox_pop(&ob) < 0);
+	}
+}
+
+void test_telemetry_outbox_wrap(void)
+{
+	/* [TELEMETRY] A long outage overwrites the oldest sector; erases stay even. */
+	struct flash_sim sim;
+	struct telemetry_outbox_flash f;
+	struct telemetry_outbox ob;
+	int next = 0;
+
+	sim_init(&sim, &f, 4);
+	assert(telemetry_outbox_mount(&ob, &f) == 0);
+	for (int i = 0; i < 400; i++) {
+		assert(push_rec(&ob, i) == 0);
+		if (i % 3 == 0) {
+			/* Drain slower than the producer, as over a congested link. */
+			int n = pop_rec(&ob, TELEMETRY_OUTBOX_FIFO);
+			assert(n >= next);
+			next = n + 1;
+		}
+	}
+	assert(ob.dropped > 0);
+	printf("telemetry outbox: %u dropped, %u erases over %d sectors\n", ob.dropped,
+	       ob.erases, SIM_SECTORS);
+	uint32_t total = ob.pending;
+	assert(telemetry_outbox_mount(&ob, &f) == 0);
+	assert(ob.pending == total);
+
+	/* What is left is the newest records, in order, with nothing duplicated. */
+	int n;
+	int count = 0;
+	int last = -1;
+	while ((n = pop_rec(&ob, TELEMETRY_OUTBOX_FIFO)) >= 0) {
+		assert(n > last);
+		last = n;
+		count++;
+	}
+	assert(last == 399 && (uint32_t)count == total);
+
+	unsigned int lo = sim.erases[0];
+	unsigned int hi = sim.erases[0];
+	for (int s = 1; s < SIM_SECTORS; s++) {
+		lo = sim.erases[s] < lo ? sim.erases[s] : lo;
+		hi = sim.erases[s] > hi ? sim.erases[s] : hi;
+	}
+	assert(lo > 0 && hi - lo <= 1);
+}
+
+void test_telemetry_outbox_faults(void)
+{
+	/* [TELEMETRY] Corrupt records are skipped; a torn write loses only itself. */
+	struct flash_sim sim;
+	struct telemetry_outbox_flash f;
+	struct telemetry_outbox ob;
+	uint8_t big[SIM_SECTOR];
+
+	sim_init(&sim, &f, 4);
+	assert(telemetry_outbox_mount(&ob, &f) == 0);
+	for (int i = 0; i < 4; i++) {
+		assert(push_rec(&ob, i) == 0);
+	}
+	/* Flip a payload bit in record 1 (each "{\"n\":i}" record takes 24 bytes). */
+	sim.mem[24 + 16 + 3] ^= 0x01;
+	assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == 0);
+	assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == 2);
+	assert(ob.corrupt == 1);
+
+	/* Power cut while writing record 4. */
+	sim.writes_left = 1;
+	assert(push_rec(&ob, 4) < 0);
+	sim.writes_left = -1;
+	assert(telemetry_outbox_mount(&ob, &f) == 0);
+	assert(ob.pending == 1);
+	assert(push_rec(&ob, 5) == 0);
+	assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == 3);
+	assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == 5);
+	assert(pop_rec(&ob, TELEMETRY_OUTBOX_FIFO) == -1);
+
+	/* Size limits and geometry. */
+	memset(big, 0xA5, sizeof(big));
+	assert(telemetry_outbox_push(&ob, big, 0) < 0);
+	assert(telemetry_outbox_push(&ob, big, telemetry_outbox_max_len(&ob) + 1) < 0);
+	assert(telemetry_outbox_push(&ob, big, telemetry_outbox_max_len(&ob)) == 0);
+	assert(telemetry_outbox_peek(&ob, TELEMETRY_OUTBOX_FIFO, big, 8) < 0);
+	assert(telemetry_outbox_peek(&ob, TELEMETRY_OUTBOX_FIFO, big, sizeof(big)) ==
+	       (int)telemetry_outbox_max_len(&ob));
+	f.write_align = 3;
+	assert(telemetry_outbox_mount(&ob, &f) < 0);
+	f.write_align = 4;
+	f.sector_count = 1;
+	assert(telemetry_outbox_mount(&ob, &f) < 0);
+}
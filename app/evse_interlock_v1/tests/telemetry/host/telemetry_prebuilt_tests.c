@@ -0,0 +1,168 @@
+/*
+ * [TEST] Host tests for prebuilt records.
+ * [TELEMETRY] A JSON record queued as bytes still goes out on a link whose MTU
+ * it does not fit: as its binary form, whole or in fragments.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_fragment.h"
+#include "telemetry/telemetry_prebuilt.h"
+#include "telemetry/telemetry_queue.h"
+
+#define TEST_JSON_MAX 512
+#define TEST_ITEM TELEMETRY_PREBUILT_MAX(TEST_JSON_MAX)
+
+static const struct evse_event test_evt = {
+	.pilot_state = EVSE_PILOT_C,
+	.proximity_detected = true,
+	.pwm_duty_cycle = 53.33f,
+	.current_draw_a = 31.5f,
+	.energy_kwh = 1.25f,
+	.event_type = "session_start",
+	.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+};
+
+/* Full-envelope EVSE record, like app_evse_build. */
+static int test_evse_build(void *buf, size_t cap, enum telemetry_encoding encoding,
+			   const void *arg)
+{
+	(void)arg;
+	if (encoding == TELEMETRY_ENCODING_BINARY) {
+		return telemetry_build_evse_payload_bin(buf, cap, 1704067200123LL, &test_evt,
+							"0123456789abcdef", false);
+	}
+	return telemetry_build_evse_payload_ex(buf, cap, "dev123", "evse", 1704067200123LL,
+					       &test_evt, "0123456789abcdef", false);
+}
+
+/* Sends every fragment of rec and checks the receiver rebuilds it. */
+static void fragments_rebuild(const uint8_t *rec, size_t rec_len, size_t mtu)
+{
+	struct telemetry_reassembly r;
+	uint8_t frame[256];
+	int count = telemetry_fragment_count(rec_len, mtu);
+	int res = 0;
+
+	assert(count > 1);
+	telemetry_reassembly_init(&r);
+	for (int i = 0; i < count; i++) {
+		int len = telemetry_fragment_build(frame, sizeof(frame), rec, rec_len, mtu, 3,
+						   (unsigned int)i);
+		assert(len > 0 && (size_t)len <= mtu);
+		res = telemetry_reassembly_add(&r, frame, (size_t)len);
+	}
+	assert(res == (int)rec_len && memcmp(r.buf, rec, rec_len) == 0);
+}
+
+void test_telemetry_prebuilt_pack(void)
+{
+	uint8_t item[TEST_ITEM];
+	uint8_t json[TEST_JSON_MAX];
+	uint8_t bin[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_prebuilt rec;
+	int jlen = test_evse_build(json, sizeof(json), TELEMETRY_ENCODING_JSON, NULL);
+	int blen = test_evse_build(bin, sizeof(bin), TELEMETRY_ENCODING_BINARY, NULL);
+
+	/* JSON: both forms, each rebuilt byte for byte. */
+	int len = telemetry_prebuilt_pack(item, sizeof(item), TELEMETRY_ENCODING_JSON,
+					  test_evse_build, NULL);
+	assert(len == TELEMETRY_PREBUILT_HDR_LEN + jlen + blen);
+	assert(telemetry_prebuilt_unpack(item, (size_t)len, TELEMETRY_ENCODING_JSON, &rec) == 0);
+	assert(rec.len == (size_t)jlen && memcmp(rec.data, json, rec.len) == 0);
+	assert(rec.bin_len == (size_t)blen && memcmp(rec.bin, bin, rec.bin_len) == 0);
+
+	uint8_t out[TEST_JSON_MAX];
+	assert(telemetry_prebuilt_build(out, sizeof(out), TELEMETRY_ENCODING_JSON, &rec) == jlen);
+	assert(telemetry_prebuilt_build(out, sizeof(out), TELEMETRY_ENCODING_BINARY, &rec) ==
+	       blen);
+	assert(memcmp(out, bin, (size_t)blen) == 0);
+	assert(telemetry_prebuilt_build(out, (size_t)jlen - 1, TELEMETRY_ENCODING_JSON, &rec) ==
+	       -1);
+
+	/* Repacking a prebuilt record keeps both forms (queue -> outbox). */
+	uint8_t again[TEST_ITEM];
+	assert(telemetry_prebuilt_pack(again, sizeof(again), TELEMETRY_ENCODING_JSON,
+				       telemetry_prebuilt_build, &rec) == len);
+	assert(memcmp(again, item, (size_t)len) == 0);
+
+	/* Binary: one form only; JSON is not made up from it. */
+	len = telemetry_prebuilt_pack(item, sizeof(item), TELEMETRY_ENCODING_BINARY,
+				      test_evse_build, NULL);
+	assert(len == TELEMETRY_PREBUILT_HDR_LEN + blen);
+	assert(telemetry_prebuilt_unpack(item, (size_t)len, TELEMETRY_ENCODING_BINARY, &rec) ==
+	       0);
+	assert(rec.bin == NULL && rec.bin_len == 0);
+	assert(telemetry_prebuilt_build(out, sizeof(out), TELEMETRY_ENCODING_JSON, &rec) == -1);
+
+	/* No room for the binary form: the JSON record alone. */
+	len = telemetry_prebuilt_pack(item, TELEMETRY_PREBUILT_HDR_LEN + (size_t)jlen + 4,
+				      TELEMETRY_ENCODING_JSON, test_evse_build, NULL);
+	assert(len == TELEMETRY_PREBUILT_HDR_LEN + jlen);
+	assert(telemetry_prebuilt_pack(item, (size_t)jlen, TELEMETRY_ENCODING_JSON,
+				       test_evse_build, NULL) == -1);
+
+	/* Malformed items. */
+	item[0] = 0xFF;
+	item[1] = 0x7F;
+	assert(telemetry_prebuilt_unpack(item, 40, TELEMETRY_ENCODING_JSON, &rec) == -1);
+	assert(telemetry_prebuilt_unpack(item, TELEMETRY_PREBUILT_HDR_LEN,
+					 TELEMETRY_ENCODING_JSON, &rec) == -1);
+}
+
+void test_telemetry_prebuilt_oversize(void)
+{
+	uint8_t slots[TELEMETRY_QUEUE_SLOT_SIZE(TEST_ITEM)];
+	uint8_t item[TEST_ITEM];
+	uint8_t scratch[TEST_JSON_MAX];
+	struct telemetry_queue q;
+	struct telemetry_prebuilt rec;
+	enum telemetry_queue_class cls;
+	const void *data;
+	size_t len = 0;
+
+	/* [TELEMETRY] Through a queue slot, as the drain sees the record. */
+	assert(telemetry_queue_init(&q, TEST_ITEM, NULL, NULL) == 0);
+	assert(telemetry_queue_configure(&q, TELEMETRY_QUEUE_SESSION, slots, 1,
+					 TELEMETRY_QUEUE_DROP_NEWEST) == 0);
+	int packed = telemetry_prebuilt_pack(item, sizeof(item), TELEMETRY_ENCODING_JSON,
+					     test_evse_build, NULL);
+	assert(packed > 0);
+	assert(telemetry_queue_push(&q, TELEMETRY_QUEUE_SESSION, item, (size_t)packed) == 0);
+	size_t n = telemetry_queue_peek(&q, &cls, &data);
+	assert(n == (size_t)packed);
+	assert(telemetry_prebuilt_unpack(data, n, TELEMETRY_ENCODING_JSON, &rec) == 0);
+	assert(rec.len > 255 && rec.bin_len > 19);
+
+	/* MTU unknown: alone at full size. */
+	assert(telemetry_prebuilt_route(telemetry_prebuilt_build, &rec, rec.encoding, 0, scratch,
+					sizeof(scratch), &len) == TELEMETRY_PREBUILT_ALONE);
+
+	/* BLE-sized MTU: the JSON does not fit; the binary record does. */
+	assert(telemetry_prebuilt_route(telemetry_prebuilt_build, &rec, rec.encoding, 255,
+					scratch, sizeof(scratch),
+					&len) == TELEMETRY_PREBUILT_BINARY);
+	assert(len == rec.bin_len && memcmp(scratch, rec.bin, len) == 0);
+
+	/* LoRa-sized MTU: binary fragments, where the JSON needs too many. */
+	assert(telemetry_fragment_count(rec.len, 19) < 0);
+	assert(telemetry_prebuilt_route(telemetry_prebuilt_build, &rec, rec.encoding, 19, scratch,
+					sizeof(scratch), &len) == TELEMETRY_PREBUILT_FRAGMENTS);
+	assert(len == rec.bin_len && memcmp(scratch, rec.bin, len) == 0);
+	fragments_rebuild(scratch, len, 19);
+
+	/* Without its binary form the JSON fragments where it can, else no route. */
+	struct telemetry_prebuilt json_only = rec;
+
+	json_only.bin = NULL;
+	json_only.bin_len = 0;
+	assert(telemetry_prebuilt_route(telemetry_prebuilt_build, &json_only, rec.encoding, 200,
+					scratch, sizeof(scratch),
+					&len) == TELEMETRY_PREBUILT_FRAGMENTS);
+	assert(len == rec.len);
+	fragments_rebuild(scratch, len, 200);
+	assert(telemetry_prebuilt_route(telemetry_prebuilt_build, &json_only, rec.encoding, 19,
+					scratch, sizeof(scratch), &len) == TELEMETRY_PREBUILT_NONE);
+}
@@ -0,0 +1,161 @@
+/*
+ * [TEST] Host tests for the multi-class telemetry queue.
+ * [EVSE-LOGIC] A dropped interlock record must be able to force EV OFF.
+ */
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "safety_gate/safety_gate.h"
+#include "telemetry/telemetry_queue.h"
+
+#define ITEM 16
+
+static uint8_t safety_slots[2 * TELEMETRY_QUEUE_SLOT_SIZE(ITEM)];
+static uint8_t session_slots[2 * TELEMETRY_QUEUE_SLOT_SIZE(ITEM)];
+static uint8_t periodic_slots[3 * TELEMETRY_QUEUE_SLOT_SIZE(ITEM)];
+
+static void queue_setup(struct telemetry_queue *q, telemetry_queue_overflow_t overflow,
+			void *ctx)
+{
+	assert(telemetry_queue_init(q, ITEM, overflow, ctx) == 0);
+	assert(telemetry_queue_configure(q, TELEMETRY_QUEUE_SAFETY, safety_slots, 2,
+					 TELEMETRY_QUEUE_DROP_NEWEST) == 0);
+	assert(telemetry_queue_configure(q, TELEMETRY_QUEUE_SESSION, session_slots, 2,
+					 TELEMETRY_QUEUE_DROP_NEWEST) == 0);
+	assert(telemetry_queue_configure(q, TELEMETRY_QUEUE_PERIODIC, periodic_slots, 3,
+					 TELEMETRY_QUEUE_DROP_OLDEST) == 0);
+}
+
+static int push_tag(struct telemetry_queue *q, enum telemetry_queue_class cls, char tag)
+{
+	return telemetry_queue_push(q, cls, &tag, 1);
+}
+
+/* [TELEMETRY] Peek + pop one record; returns its tag ('\0' when empty). */
+static char pop_tag(struct telemetry_queue *q, enum telemetry_queue_class *cls)
+{
+	const void *data = NULL;
+	size_t len = telemetry_queue_peek(q, cls, &data);
+
+	if (len == 0) {
+		return '\0';
+	}
+	assert(len == 1);
+	char tag = *(const char *)data;
+	assert(telemetry_queue_pop(q, *cls) == 0);
+	return tag;
+}
+
+void test_telemetry_queue_priority(void)
+{
+	/* [TELEMETRY] Strict priority across classes, FIFO within a class. */
+	struct telemetry_queue q;
+	enum telemetry_queue_class cls;
+
+	queue_setup(&q, NULL, NULL);
+	assert(pop_tag(&q, &cls) == '\0');
+	assert(push_tag(&q, TELEMETRY_QUEUE_PERIODIC, 'p') == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_SESSION, 's') == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_PERIODIC, 'q') == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_SAFETY, 'a') == 0);
+	assert(telemetry_queue_depth(&q) == 4);
+
+	assert(pop_tag(&q, &cls) == 'a' && cls == TELEMETRY_QUEUE_SAFETY);
+	assert(pop_tag(&q, &cls) == 's' && cls == TELEMETRY_QUEUE_SESSION);
+	/* A late safety record still overtakes queued periodic samples. */
+	assert(push_tag(&q, TELEMETRY_QUEUE_SAFETY, 'b') == 0);
+	assert(pop_tag(&q, &cls) == 'b');
+	assert(pop_tag(&q, &cls) == 'p' && cls == TELEMETRY_QUEUE_PERIODIC);
+	assert(pop_tag(&q, &cls) == 'q');
+	assert(pop_tag(&q, &cls) == '\0' && telemetry_queue_depth(&q) == 0);
+	assert(telemetry_queue_pop(&q, TELEMETRY_QUEUE_SAFETY) < 0);
+
+	/* Records of different lengths keep their length. */
+	uint8_t rec[ITEM];
+	const void *data;
+	memset(rec, 0x5A, sizeof(rec));
+	assert(telemetry_queue_push(&q, TELEMETRY_QUEUE_SESSION, rec, ITEM) == 0);
+	assert(telemetry_queue_peek(&q, &cls, &data) == ITEM);
+	assert(memcmp(data, rec, ITEM) == 0);
+
+	const struct telemetry_queue_stats *st;
+	st = telemetry_queue_stats(&q, TELEMETRY_QUEUE_PERIODIC);
+	assert(st->enqueued == 2 && st->dequeued == 2 && st->dropped == 0);
+	assert(st->depth == 0 && st->high_water == 2);
+}
+
+struct overflow_log {
+	unsigned int calls;
+	enum telemetry_queue_class last;
+	struct safety_gate *gate;
+};
+
+static void on_overflow(void *ctx, enum telemetry_queue_class cls,
+			const struct telemetry_queue_stats *stats)
+{
+	struct overflow_log *log = ctx;
+
+	assert(stats->dropped > 0);
+	log->calls++;
+	log->last = cls;
+	/* [EVSE-LOGIC] Only a lost interlock record is ambiguity for the gate. */
+	if (cls == TELEMETRY_QUEUE_SAFETY) {
+		safety_gate_set_queue_overflow(log->gate);
+	}
+}
+
+void test_telemetry_queue_drop_policy(void)
+{
+	/* [TELEMETRY] Drop-newest keeps the queue, drop-oldest keeps the latest. */
+	struct telemetry_queue q;
+	struct safety_gate gate;
+	struct overflow_log log = { .gate = &gate };
+	enum telemetry_queue_class cls;
+
+	safety_gate_init(&gate, 50);
+	queue_setup(&q, on_overflow, &log);
+
+	for (char t = 'a'; t <= 'e'; t++) {
+		assert(push_tag(&q, TELEMETRY_QUEUE_PERIODIC, t) == 0);
+	}
+	assert(log.calls == 2 && log.last == TELEMETRY_QUEUE_PERIODIC);
+	assert(!safety_gate_has_fault(&gate, SAFETY_FAULT_QUEUE_OVERFLOW));
+	const struct telemetry_queue_stats *st;
+	st = telemetry_queue_stats(&q, TELEMETRY_QUEUE_PERIODIC);
+	assert(st->dropped == 2 && st->depth == 3 && st->high_water == 3);
+
+	assert(push_tag(&q, TELEMETRY_QUEUE_SAFETY, '1') == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_SAFETY, '2') == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_SAFETY, '3') < 0);
+	assert(log.calls == 3 && log.last == TELEMETRY_QUEUE_SAFETY);
+	assert(safety_gate_has_fault(&gate, SAFETY_FAULT_QUEUE_OVERFLOW));
+	safety_gate_update_ac(&gate, 0, 0);
+	safety_gate_update_ac(&gate, 0, 100);
+	assert(!safety_gate_is_ev_allowed(&gate));
+
+	assert(pop_tag(&q, &cls) == '1');
+	assert(pop_tag(&q, &cls) == '2');
+	assert(pop_tag(&q, &cls) == 'c');
+	assert(pop_tag(&q, &cls) == 'd');
+	assert(pop_tag(&q, &cls) == 'e');
+	assert(pop_tag(&q, &cls) == '\0');
+
+	/* Oversize records and classes without storage are counted drops too. */
+	uint8_t big[ITEM + 1] = { 0 };
+	assert(telemetry_queue_push(&q, TELEMETRY_QUEUE_SESSION, big, sizeof(big)) < 0);
+	st = telemetry_queue_stats(&q, TELEMETRY_QUEUE_SESSION);
+	assert(st->too_big == 1 && st->dropped == 1 && log.calls == 4);
+	assert(telemetry_queue_configure(&q, TELEMETRY_QUEUE_SESSION, NULL, 0,
+					 TELEMETRY_QUEUE_DROP_OLDEST) == 0);
+	assert(push_tag(&q, TELEMETRY_QUEUE_SESSION, 'x') < 0 && log.calls == 5);
+
+	/* Bad arguments. */
+	assert(telemetry_queue_push(&q, TELEMETRY_QUEUE_CLASS_COUNT, big, 1) < 0);
+	assert(telemetry_queue_push(&q, TELEMETRY_QUEUE_SAFETY, big, 0) < 0);
+	assert(telemetry_queue_configure(&q, TELEMETRY_QUEUE_SAFETY, NULL, 2,
+					 TELEMETRY_QUEUE_DROP_OLDEST) < 0);
+	assert(telemetry_queue_init(&q, 0, NULL, NULL) < 0);
+	printf("telemetry queue: %u overflow hook call(s)\n", log.calls);
+}
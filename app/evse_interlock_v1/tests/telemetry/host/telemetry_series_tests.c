@@ -0,0 +1,171 @@
+/*
+ * [TEST] Host tests for time-series sample blocks.
+ * [TELEMETRY] Samples round-trip on the grid; a realistic load fits one uplink.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry/telemetry_decode.h"
+#include "telemetry/telemetry_series.h"
+
+#define SERIES_PERIOD_MS 2000
+#define SERIES_SAMPLES_MAX 512
+
+struct series_collect {
+	int64_t t[SERIES_SAMPLES_MAX];
+	int32_t v[SERIES_SAMPLES_MAX];
+	int count;
+};
+
+static void series_collect_cb(int64_t timestamp_ms, int32_t value_ma, void *ctx)
+{
+	struct series_collect *col = ctx;
+
+	assert(col->count < SERIES_SAMPLES_MAX);
+	col->t[col->count] = timestamp_ms;
+	col->v[col->count] = value_ma;
+	col->count++;
+}
+
+static void record_collect_cb(const struct telemetry_record *r, void *ctx)
+{
+	assert(r->rec.type == TELEMETRY_BIN_TYPE_LINE_CURRENT);
+	assert(r->rec.event_type == TELEMETRY_EVENT_SAMPLE);
+	series_collect_cb(r->rec.timestamp_ms, (int32_t)r->rec.line_current.current_a, ctx);
+}
+
+void test_telemetry_series_roundtrip(void)
+{
+	/* [TELEMETRY] Jittered timestamps snap to the grid; gaps and runs survive. */
+	static const int32_t values[] = { 0, 0, 0, 16000, 16040, 15960, 16000, 16000, -250, 7 };
+	static const int64_t jitter[] = { 0, 3, 11, 40, 2, 0, 7, 1, 0, 5 };
+	struct telemetry_series s;
+	struct telemetry_series_info info;
+	struct series_collect col = { 0 };
+	struct telemetry_decoder d;
+	uint8_t buf[64];
+	int64_t slot = 0;
+
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_LINE_CURRENT, SERIES_PERIOD_MS, 10,
+				     true, buf, sizeof(buf)) == 0);
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		/* Two missed samples before index 6. */
+		slot += i == 6 ? 3 : (i ? 1 : 0);
+		int64_t ts = 1704067200000LL + slot * SERIES_PERIOD_MS + jitter[i];
+		assert(telemetry_series_add(&s, ts, values[i]) == 0);
+	}
+	int len = telemetry_series_close(&s);
+	assert(len > 0 && s.count == 10);
+
+	assert(telemetry_series_decode(buf, (size_t)len, &info, series_collect_cb, &col) == 10);
+	assert(info.channel == TELEMETRY_SERIES_LINE_CURRENT && info.time_anomaly);
+	assert(info.period_ms == SERIES_PERIOD_MS && info.quantum_ma == 10);
+	assert(col.t[0] == 1704067200000LL && col.t[9] == 1704067200000LL + 11 * SERIES_PERIOD_MS);
+	assert(col.t[5] + 3 * SERIES_PERIOD_MS == col.t[6]);
+	assert(col.v[3] == 16000 && col.v[4] == 16040 && col.v[8] == -250);
+	/* 7 mA at a 10 mA quantum rounds to the nearest step. */
+	assert(col.v[9] == 10);
+
+	/* [TELEMETRY] The frame decoder turns the block into one record per sample. */
+	struct series_collect rows = { 0 };
+	telemetry_decoder_init(&d);
+	assert(telemetry_decoder_feed(&d, buf, (size_t)len, record_collect_cb, &rows) == 10);
+	assert(memcmp(rows.t, col.t, sizeof(col.t)) == 0);
+	assert(memcmp(rows.v, col.v, sizeof(col.v)) == 0);
+
+	/* Empty blocks close to nothing. */
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_EVSE_CURRENT, SERIES_PERIOD_MS, 10,
+				     false, buf, sizeof(buf)) == 0);
+	assert(telemetry_series_close(&s) == 0);
+}
+
+void test_telemetry_series_compression(void)
+{
+	/* [TELEMETRY] Ten minutes of a charge session at 2 s in one 255-byte frame. */
+	struct telemetry_series s;
+	struct series_collect col = { 0 };
+	uint8_t buf[255];
+	int32_t expect[300];
+	int i;
+
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_EVSE_CURRENT, SERIES_PERIOD_MS, 100,
+				     false, buf, sizeof(buf)) == 0);
+	for (i = 0; i < 300; i++) {
+		/* Idle, a ramp to 32 A, a noisy plateau, a taper, then idle again. */
+		int32_t ma = 0;
+		if (i >= 30 && i < 46) {
+			ma = (i - 30) * 2000;
+		} else if (i >= 46 && i < 200) {
+			ma = 32000 + ((i * 37) % 7 - 3) * 40;
+		} else if (i >= 200 && i < 260) {
+			ma = 32000 - (i - 200) * 500;
+		}
+		expect[i] = (ma + 50) / 100 * 100;
+		assert(telemetry_series_add(&s, 5000 + (int64_t)i * SERIES_PERIOD_MS + (i % 5),
+					    ma) == 0);
+	}
+	int len = telemetry_series_close(&s);
+	assert(len > 0 && len <= 255);
+	assert(telemetry_series_decode(buf, (size_t)len, NULL, series_collect_cb, &col) == 300);
+	assert(memcmp(col.v, expect, sizeof(expect)) == 0);
+	assert(col.t[299] == 5000 + 299 * SERIES_PERIOD_MS);
+	printf("telemetry series: %d samples in %d bytes\n", col.count, len);
+
+	/* A full block rejects the next sample and is left intact. */
+	uint8_t small[TELEMETRY_SERIES_MIN_LEN];
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_LINE_CURRENT, SERIES_PERIOD_MS, 1,
+				     false, small, sizeof(small)) == 0);
+	for (i = 0; telemetry_series_add(&s, (int64_t)i * SERIES_PERIOD_MS, i * 1000) == 0; i++) {
+	}
+	size_t before = s.len;
+	assert(i > 1 && telemetry_series_add(&s, (int64_t)i * SERIES_PERIOD_MS, 5) < 0);
+	assert(s.len == before && s.count == i);
+	len = telemetry_series_close(&s);
+	col.count = 0;
+	assert(telemetry_series_decode(small, (size_t)len, NULL, series_collect_cb, &col) == i);
+	assert(col.v[i - 1] == (i - 1) * 1000);
+}
+
+void test_telemetry_series_rejects(void)
+{
+	/* [TELEMETRY] Samples that cannot share a block and malformed blocks. */
+	struct telemetry_series s;
+	uint8_t buf[64];
+
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_LINE_CURRENT, 0, 10, false, buf,
+				     sizeof(buf)) < 0);
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_LINE_CURRENT, SERIES_PERIOD_MS, 10,
+				     false, buf, 8) < 0);
+	assert(telemetry_series_open(&s, TELEMETRY_SERIES_LINE_CURRENT, SERIES_PERIOD_MS, 10,
+				     false, buf, sizeof(buf)) == 0);
+	assert(telemetry_series_add(&s, -1, 0) < 0);
+	assert(telemetry_series_add(&s, 10000, 500) == 0);
+	/* Backwards, same slot, and a time sync jump all need a new block. */
+	assert(telemetry_series_add(&s, 9000, 500) < 0);
+	assert(telemetry_series_add(&s, 10600, 500) < 0);
+	assert(telemetry_series_add(&s, 1704067200000LL, 500) < 0);
+	assert(telemetry_series_add(&s, 12000, 500) == 0);
+
+	int len = telemetry_series_close(&s);
+	assert(len > 0);
+	assert(telemetry_series_decode(buf, (size_t)len, NULL, NULL, NULL) == 2);
+	assert(telemetry_series_decode(buf, 3, NULL, NULL, NULL) < 0);
+
+	uint8_t bad[64];
+	memcpy(bad, buf, (size_t)len);
+	bad[0] = (uint8_t)((TELEMETRY_BIN_SCHEMA_VERSION << 4) | TELEMETRY_BIN_TYPE_LINE_CURRENT);
+	assert(telemetry_series_decode(bad, (size_t)len, NULL, NULL, NULL) < 0);
+	memcpy(bad, buf, (size_t)len);
+	bad[1] |= 0x4;
+	assert(telemetry_series_decode(bad, (size_t)len, NULL, NULL, NULL) < 0);
+	/* A trailing skip token with no sample after it. */
+	memcpy(bad, buf, (size_t)len);
+	bad[len] = 0x03;
+	assert(telemetry_series_decode(bad, (size_t)len + 1, NULL, NULL, NULL) < 0);
+	/* An unterminated varint. */
+	bad[len] = 0x80;
+	assert(telemetry_series_decode(bad, (size_t)len + 1, NULL, NULL, NULL) < 0);
+}
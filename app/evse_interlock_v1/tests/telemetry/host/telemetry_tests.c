@@ -5,11 +5,16 @@
 #include <assert.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "telemetry/telemetry_gpio.h"
 #include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_health.h"
 #include "telemetry/telemetry_line_current.h"
+#include "telemetry/telemetry_envelope.h"
+#include "telemetry/telemetry_binary.h"
 
 #ifndef TEST_FIXTURES_DIR
 #define TEST_FIXTURES_DIR "app/evse_interlock_v1/tests/telemetry/host/fixtures"
@@ -83,25 +88,267 @@ void test_telemetry_required_fields(void)
 	assert(strstr(buf, "\"event_id\":\"evt-req-3\"") != NULL);
 }
 
+/* [TELEMETRY] Golden fixture events; one entry per fixture file. */
+static const struct evse_event fixture_evse_evt = {
+	.send = true,
+	.pilot_state = EVSE_PILOT_C,
+	.proximity_detected = true,
+	.pwm_duty_cycle = 53.335f,
+	.current_draw_a = 31.9996f,
+	.energy_kwh = 12.00005f,
+	.event_type = "session_start",
+	.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+};
+
+static const struct line_current_event fixture_line_evt = {
+	.send = true,
+	.current_a = -3.0005f,
+	.event_type = "current_change",
+};
+
+static const struct evse_session_summary fixture_session = {
+	.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+	.samples = 5400,
+	.current_p50_a = 31.75f,
+	.current_p95_a = 33.75f,
+	.current_max_a = 34.217f,
+	.energy_kwh = 21.5125f,
+};
+
+static const struct telemetry_health fixture_health = {
+	.queue_size = 16,
+	.queue_depth_max = 5,
+	.bulk_depth_max = 8,
+	.enqueue_failed = 2,
+	.latency_max_us = 12500,
+	.slow_handler = "send_msg",
+	.exec_max_us = 48213,
+	.process_merged = 731,
+};
+
+static int fixture_gpio_uptime(void *buf, size_t len)
+{
+	return telemetry_build_gpio_payload_ex(buf, len, "dev123", "evse", "hvac", 1,
+					       GPIO_EDGE_RISING, 1234, NULL, "evt-uptime", false);
+}
+
+static int fixture_gpio_epoch(void *buf, size_t len)
+{
+	return telemetry_build_gpio_payload_ex(buf, len, "dev123", "evse", "hvac", 1,
+					       GPIO_EDGE_RISING, 1704067200000LL, NULL,
+					       "evt-epoch", false);
+}
+
+static int fixture_evse(void *buf, size_t len)
+{
+	return telemetry_build_evse_payload_ex(buf, len, "dev123", "evse", 1704067200123LL,
+					       &fixture_evse_evt, "0123456789abcdef", false);
+}
+
+static int fixture_line_current(void *buf, size_t len)
+{
+	return telemetry_build_line_current_payload_ex(buf, len, "dev123", "evse", 7777,
+						       &fixture_line_evt, "evt-line", true);
+}
+
+static int fixture_gpio_elided(void *buf, size_t len)
+{
+	struct telemetry_envelope env;
+
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED) == 0);
+	return telemetry_build_gpio_payload_env(buf, len, &env, "hvac", 0, GPIO_EDGE_FALLING,
+						1704067200000LL, "run-7", "9f3a00c100000007",
+						false);
+}
+
+static int fixture_gpio_elided_bin(void *buf, size_t len)
+{
+	return telemetry_build_gpio_payload_bin(buf, len, "hvac", 0, GPIO_EDGE_FALLING,
+						1704067200000LL, "run-7", "9f3a00c100000007",
+						false);
+}
+
+static int fixture_evse_bin(void *buf, size_t len)
+{
+	return telemetry_build_evse_payload_bin(buf, len, 1704067200123LL, &fixture_evse_evt,
+						"0123456789abcdef", false);
+}
+
+static int fixture_line_current_bin(void *buf, size_t len)
+{
+	return telemetry_build_line_current_payload_bin(buf, len, 7777, &fixture_line_evt,
+							"evt-line", true);
+}
+
+static int fixture_session_end(void *buf, size_t len)
+{
+	struct telemetry_envelope env;
+
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	return telemetry_build_session_payload_env(buf, len, &env, 1704078000000LL,
+						   &fixture_session, "0123456789abcdf2", false);
+}
+
+static int fixture_session_end_bin(void *buf, size_t len)
+{
+	return telemetry_build_session_payload_bin(buf, len, 1704078000000LL, &fixture_session,
+						   "0123456789abcdf2", false);
+}
+
+static int fixture_health_json(void *buf, size_t len)
+{
+	struct telemetry_envelope env;
+
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	return telemetry_build_health_payload_env(buf, len, &env, 1704081600000LL,
+						  &fixture_health, "0123456789abcdf3", false);
+}
+
+static int fixture_health_bin(void *buf, size_t len)
+{
+	return telemetry_build_health_payload_bin(buf, len, 1704081600000LL, &fixture_health,
+						  "0123456789abcdf3", false);
+}
+
+static const struct {
+	const char *name;
+	int (*build)(void *buf, size_t len);
+	bool binary; /* fixture holds the frame as lowercase hex */
+} fixtures[] = {
+	{ "telemetry_gpio_uptime.json", fixture_gpio_uptime, false },
+	{ "telemetry_gpio_epoch.json", fixture_gpio_epoch, false },
+	{ "telemetry_evse_session_start.json", fixture_evse, false },
+	{ "telemetry_line_current.json", fixture_line_current, false },
+	{ "telemetry_gpio_elided.json", fixture_gpio_elided, false },
+	{ "telemetry_gpio_elided.hex", fixture_gpio_elided_bin, true },
+	{ "telemetry_evse_session_start.hex", fixture_evse_bin, true },
+	{ "telemetry_line_current.hex", fixture_line_current_bin, true },
+	{ "telemetry_session_end.json", fixture_session_end, false },
+	{ "telemetry_session_end.hex", fixture_session_end_bin, true },
+	{ "telemetry_health.json", fixture_health_json, false },
+	{ "telemetry_health.hex", fixture_health_bin, true },
+};
+
+/* [BOILERPLATE] TELEMETRY_REGEN_FIXTURES=1 rewrites the files after a schema change. */
+static void write_fixture(const char *name, const char *text)
+{
+	char path[512];
+	FILE *fp;
+
+	snprintf(path, sizeof(path), "%s/%s", TEST_FIXTURES_DIR, name);
+	fp = fopen(path, "wb");
+	assert(fp != NULL);
+	fprintf(fp, "%s\n", text);
+	fclose(fp);
+	printf("telemetry fixture regenerated: %s\n", name);
+}
+
 void test_telemetry_golden_fixtures(void)
 {
-	/* [TELEMETRY] Exact JSON formatting for known fixtures. */
+	/* [TELEMETRY] Exact JSON and binary encodings for known fixtures. */
+	const char *regen = getenv("TELEMETRY_REGEN_FIXTURES");
 	char expected[512];
 	char actual[512];
+	uint8_t frame[TELEMETRY_BIN_MAX_LEN];
+
+	for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+		int len;
+
+		if (fixtures[i].binary) {
+			len = fixtures[i].build(frame, sizeof(frame));
+			assert(len > 0);
+			for (int b = 0; b < len; b++) {
+				snprintf(&actual[b * 2], 3, "%02x", frame[b]);
+			}
+			actual[len * 2] = '\0';
+		} else {
+			len = fixtures[i].build(actual, sizeof(actual));
+			assert(len == (int)strlen(actual));
+		}
+
+		if (regen && regen[0] == '1') {
+			write_fixture(fixtures[i].name, actual);
+			continue;
+		}
+		read_fixture(fixtures[i].name, expected, sizeof(expected));
+		assert(strcmp(actual, expected) == 0);
+	}
+}
+
+void test_telemetry_envelope_elided(void)
+{
+	/* [TELEMETRY] Elided frames drop static fields; announce carries them once. */
+	struct telemetry_envelope env;
+	char announce[256];
+	char full[384];
+	char elided[384];
+	char ctx[16];
 	int len;
 
-	read_fixture("telemetry_gpio_uptime.json", expected, sizeof(expected));
-	len = telemetry_build_gpio_payload_ex(actual, sizeof(actual), "dev123", "evse",
-					      "hvac", 1, GPIO_EDGE_RISING, 1234,
-					      NULL, "evt-uptime", false);
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED) == 0);
+	assert(env.ctx_id == telemetry_envelope_ctx_id("dev123", "evse"));
+	assert(env.ctx_id != telemetry_envelope_ctx_id("dev124", "evse"));
+	assert(env.ctx_id != telemetry_envelope_ctx_id("dev12", "3evse"));
+	snprintf(ctx, sizeof(ctx), "\"ctx\":\"%04x\"", env.ctx_id);
+
+	len = telemetry_build_announce_payload(announce, sizeof(announce), &env, 1234, "evt-a");
+	assert(len > 0);
+	assert(strstr(announce, "\"schema_version\":\"1.0\"") != NULL);
+	assert(strstr(announce, "\"device_id\":\"dev123\"") != NULL);
+	assert(strstr(announce, "\"device_type\":\"evse\"") != NULL);
+	assert(strstr(announce, "\"event_type\":\"announce\"") != NULL);
+	assert(strstr(announce, ctx) != NULL);
+
+	int full_len = telemetry_build_gpio_payload_ex(full, sizeof(full), "dev123", "evse",
+						       "hvac", 1, GPIO_EDGE_RISING, 1234, NULL,
+						       "evt-1", false);
+	len = telemetry_build_gpio_payload_env(elided, sizeof(elided), &env, "hvac", 1,
+					       GPIO_EDGE_RISING, 1234, NULL, "evt-1", false);
+	assert(full_len > 0 && len > 0 && len + 90 < full_len);
+	assert(strncmp(elided, "{\"ctx\":", 7) == 0);
+	assert(strstr(elided, ctx) != NULL);
+	assert(strstr(elided, "schema_version") == NULL);
+	assert(strstr(elided, "device_id") == NULL);
+	assert(strstr(elided, "location") == NULL);
+	assert(strstr(elided, "run_id") == NULL);
+	assert(strstr(elided, "uptime_ms") == NULL);
+	assert(strstr(elided, "\"timestamp\":1234") != NULL);
+	assert(strstr(elided, "\"data\":{\"gpio\":{\"pin\":\"hvac\",\"state\":1,"
+				"\"edge\":\"rising\"}}}") != NULL);
+
+	len = telemetry_build_gpio_payload_env(elided, sizeof(elided), &env, "hvac", 1,
+					       GPIO_EDGE_RISING, 1234, "run-9", "evt-1", false);
+	assert(len > 0);
+	assert(strstr(elided, "\"run_id\":\"run-9\",\"data\"") != NULL);
+
+	struct evse_event evt = {
+		.pilot_state = EVSE_PILOT_C,
+		.pwm_duty_cycle = 50.0f,
+		.current_draw_a = 16.0f,
+		.energy_kwh = 1.5f,
+		.event_type = "state_change",
+		.session_id = "session-1",
+	};
+	len = telemetry_build_evse_payload_env(elided, sizeof(elided), &env, 9876, &evt,
+					       "evt-2", true);
 	assert(len > 0);
-	assert(strcmp(actual, expected) == 0);
+	assert(strstr(elided, "device_type") == NULL);
+	assert(strstr(elided, "\"time_anomaly\":true") != NULL);
+	assert(strstr(elided, "\"pilot_state\":\"C\"") != NULL);
 
-	read_fixture("telemetry_gpio_epoch.json", expected, sizeof(expected));
-	len = telemetry_build_gpio_payload_ex(actual, sizeof(actual), "dev123", "evse",
-					      "hvac", 1, GPIO_EDGE_RISING,
-					      1704067200000LL, NULL, "evt-epoch",
-					      false);
+	struct line_current_event line_evt = {
+		.current_a = 2.5f,
+		.event_type = "current_change",
+	};
+	len = telemetry_build_line_current_payload_env(elided, sizeof(elided), &env, 1, &line_evt,
+						       "evt-3", false);
 	assert(len > 0);
-	assert(strcmp(actual, expected) == 0);
+	assert(strstr(elided, "\"line_current\":{\"current_a\":2.500}}}") != NULL);
+
+	/* [TELEMETRY] FULL envelope through the _env entry point is schema 1.0 verbatim. */
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	len = telemetry_build_gpio_payload_env(elided, sizeof(elided), &env, "hvac", 1,
+					       GPIO_EDGE_RISING, 1234, NULL, "evt-1", false);
+	assert(len == full_len);
+	assert(strcmp(elided, full) == 0);
 }
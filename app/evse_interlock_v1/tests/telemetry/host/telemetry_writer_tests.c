@@ -0,0 +1,186 @@
+/*
+ * [TEST] Host tests for the snprintf-free telemetry writer.
+ * [TELEMETRY] Writer output must stay byte-identical to the legacy printf formatting.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_writer.h"
+
+#define WRITER_BENCH_ITERATIONS 20000
+
+/* [BOILERPLATE] Deterministic LCG so failures reproduce. */
+static uint32_t writer_rand(uint32_t *state)
+{
+	*state = *state * 1664525u + 1013904223u;
+	return *state;
+}
+
+static void check_fixed(float value, unsigned int decimals)
+{
+	char expected[64];
+	char actual[64];
+	struct telemetry_writer w;
+
+	snprintf(expected, sizeof(expected), "%.*f", (int)decimals, (double)value);
+	telemetry_writer_init(&w, actual, sizeof(actual));
+	telemetry_writer_fixed(&w, value, decimals);
+	assert(telemetry_writer_finish(&w) == (int)strlen(expected));
+	if (strcmp(actual, expected) != 0) {
+		fprintf(stderr, "fixed mismatch: %.9g/%u writer=%s printf=%s\n", (double)value,
+			decimals, actual, expected);
+		assert(0);
+	}
+}
+
+/* [BOILERPLATE] Legacy schema 1.0 EVSE formatter, kept only as the reference. */
+static int legacy_evse_payload(char *buf, size_t buf_len, int64_t timestamp_ms,
+			       const struct evse_event *evt, const char *event_id)
+{
+	int len = snprintf(
+		buf, buf_len,
+		"{\"schema_version\":\"1.0\",\"device_id\":\"%s\",\"device_type\":\"%s\","
+		"\"timestamp\":%lld,\"event_id\":\"%s\",\"time_anomaly\":%s,"
+		"\"event_type\":\"%s\",\"location\":null,\"run_id\":null,\"data\":{"
+		"\"evse\":{\"pilot_state\":\"%c\",\"pwm_duty_cycle\":%.2f,"
+		"\"current_draw\":%.3f,\"proximity_detected\":%s,\"session_id\":\"%s\","
+		"\"energy_delivered_kwh\":%.4f}}}",
+		"dev123", "evse", (long long)timestamp_ms, event_id, "false", evt->event_type,
+		"ABCDEF?"[evt->pilot_state], (double)evt->pwm_duty_cycle,
+		(double)evt->current_draw_a, evt->proximity_detected ? "true" : "false",
+		evt->session_id, (double)evt->energy_kwh);
+
+	return (len < 0 || (size_t)len >= buf_len) ? -1 : len;
+}
+
+void test_telemetry_writer_fixed(void)
+{
+	/* [TELEMETRY] Fixed-point text equals "%.Nf" including ties and negative zero. */
+	static const float edge_values[] = {
+		0.0f,     -0.0f,   0.5f,    1.5f,     2.5f,   -2.5f,    0.125f,  0.375f,
+		-0.125f,  0.0005f, -0.0004f, 12.5f,   1.234f, 0.4567f,  53.335f, 31.9996f,
+		12.00005f, -3.0005f, 99.99f, 100.0f,  1e6f,   -65535.5f, 0.00005f, 1e-9f,
+	};
+	uint32_t seed = 0x5eed1234u;
+
+	for (size_t i = 0; i < sizeof(edge_values) / sizeof(edge_values[0]); i++) {
+		for (unsigned int d = 0; d <= 4; d++) {
+			check_fixed(edge_values[i], d);
+		}
+	}
+	for (int i = 0; i < 20000; i++) {
+		/* Mix of small currents/duties and exact binary fractions (printf ties). */
+		float v = (float)(int32_t)(writer_rand(&seed) % 2000000u - 1000000) / 1024.0f;
+		if (i & 1) {
+			v = (float)(int32_t)writer_rand(&seed) * 1e-6f;
+		}
+		check_fixed(v, 1U + (unsigned int)(i % 4));
+	}
+}
+
+void test_telemetry_writer_bounds(void)
+{
+	/* [BOILERPLATE] Overflow, NULL strings and integer extremes. */
+	char buf[32];
+	struct telemetry_writer w;
+
+	telemetry_writer_init(&w, buf, sizeof(buf));
+	telemetry_writer_i64(&w, INT64_MIN);
+	telemetry_writer_char(&w, ' ');
+	telemetry_writer_hex16(&w, 0x0a0f);
+	assert(telemetry_writer_finish(&w) == 25);
+	assert(strcmp(buf, "-9223372036854775808 0a0f") == 0);
+
+	/* Exactly len + 1 bytes fit; one less fails and leaves an empty string. */
+	telemetry_writer_init(&w, buf, 6);
+	TELEMETRY_WRITER_LIT(&w, "hello");
+	assert(telemetry_writer_finish(&w) == 5);
+	telemetry_writer_init(&w, buf, 5);
+	TELEMETRY_WRITER_LIT(&w, "hello");
+	assert(telemetry_writer_finish(&w) < 0);
+	assert(buf[0] == '\0');
+
+	telemetry_writer_init(&w, buf, sizeof(buf));
+	telemetry_writer_str(&w, NULL);
+	assert(telemetry_writer_finish(&w) < 0);
+
+	telemetry_writer_init(&w, buf, sizeof(buf));
+	telemetry_writer_fixed(&w, 1e30f, 3);
+	assert(telemetry_writer_finish(&w) < 0);
+
+	telemetry_writer_init(&w, NULL, 0);
+	TELEMETRY_WRITER_LIT(&w, "");
+	assert(telemetry_writer_finish(&w) < 0);
+
+	/* [TELEMETRY] Every truncation of a real payload is rejected, never cut short. */
+	struct evse_event evt = {
+		.pilot_state = EVSE_PILOT_B,
+		.pwm_duty_cycle = 12.5f,
+		.current_draw_a = 1.234f,
+		.energy_kwh = 0.4567f,
+		.event_type = "state_change",
+		.session_id = "session-1",
+	};
+	char payload[512];
+	int full = telemetry_build_evse_payload_ex(payload, sizeof(payload), "dev123", "evse", 1,
+						   &evt, "evt-1", false);
+	assert(full > 0);
+	for (size_t cap = 1; cap <= (size_t)full; cap++) {
+		assert(telemetry_build_evse_payload_ex(payload, cap, "dev123", "evse", 1, &evt,
+						       "evt-1", false) < 0);
+	}
+}
+
+void test_telemetry_writer_speedup(void)
+{
+	/* [TELEMETRY] Byte-identical to the snprintf builder; report per-build cost. */
+	char legacy[512];
+	char writer[512];
+	struct telemetry_envelope env;
+	struct evse_event evt = {
+		.pilot_state = EVSE_PILOT_C,
+		.proximity_detected = true,
+		.event_type = "session_start",
+		.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+	};
+	uint32_t seed = 42;
+	volatile int sink = 0;
+	clock_t start;
+
+	assert(telemetry_envelope_init(&env, "dev123", "evse", TELEMETRY_ENVELOPE_FULL) == 0);
+	for (int i = 0; i < 2000; i++) {
+		evt.pwm_duty_cycle = (float)(writer_rand(&seed) % 10000u) / 100.0f;
+		evt.current_draw_a = (float)(writer_rand(&seed) % 80000u) / 997.0f;
+		evt.energy_kwh = (float)(writer_rand(&seed) % 1000000u) / 7919.0f;
+		int a = legacy_evse_payload(legacy, sizeof(legacy), 1704067200000LL + i, &evt,
+					    "0123456789abcdef");
+		int b = telemetry_build_evse_payload_env(writer, sizeof(writer), &env,
+							 1704067200000LL + i, &evt,
+							 "0123456789abcdef", false);
+		assert(a > 0 && a == b);
+		assert(strcmp(legacy, writer) == 0);
+	}
+
+	start = clock();
+	for (int i = 0; i < WRITER_BENCH_ITERATIONS; i++) {
+		sink += legacy_evse_payload(legacy, sizeof(legacy), i, &evt, "0123456789abcdef");
+	}
+	double legacy_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (int i = 0; i < WRITER_BENCH_ITERATIONS; i++) {
+		sink += telemetry_build_evse_payload_env(writer, sizeof(writer), &env, i, &evt,
+							 "0123456789abcdef", false);
+	}
+	double writer_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	(void)sink;
+	printf("telemetry writer: evse build snprintf %.0f ns, writer %.0f ns, speedup %.1fx\n",
+	       legacy_s * 1e9 / WRITER_BENCH_ITERATIONS, writer_s * 1e9 / WRITER_BENCH_ITERATIONS,
+	       writer_s > 0 ? legacy_s / writer_s : 0.0);
+}
@@ -8,6 +8,7 @@
 #include "telemetry/telemetry_gpio.h"
 #include "telemetry/telemetry_evse.h"
 #include "telemetry/telemetry_line_current.h"
+#include "telemetry/telemetry_binary.h"
 
 ZTEST(telemetry, test_gpio_payload_rising)
 {
@@ -89,4 +90,26 @@ ZTEST(telemetry, test_line_current_payload_fields)
 	zassert_not_null(strstr(buf, "\"current_a\":12.345"), NULL);
 }
 
+ZTEST(telemetry, test_line_current_payload_binary)
+{
+	/* [TELEMETRY] Binary round trip keeps fixed-point fields. */
+	uint8_t buf[TELEMETRY_BIN_MAX_LEN];
+	struct telemetry_bin_record rec;
+	struct line_current_event evt = {
+		.send = true,
+		.current_a = 12.345f,
+		.event_type = "current_change",
+	};
+
+	int len = telemetry_build_line_current_payload_bin(buf, sizeof(buf), 7777, &evt,
+							   "0123456789abcdef", false);
+	zassert_true(len > 0 && len <= 20, NULL);
+	zassert_equal(telemetry_decode_bin(buf, (size_t)len, &rec), len, NULL);
+	zassert_equal(rec.type, TELEMETRY_BIN_TYPE_LINE_CURRENT, NULL);
+	zassert_equal(rec.timestamp_ms, 7777, NULL);
+	zassert_equal(rec.event_type, TELEMETRY_EVENT_CURRENT_CHANGE, NULL);
+	zassert_equal(rec.line_current.current_a, 12345, NULL);
+	zassert_equal(strcmp(rec.event_id, "0123456789abcdef"), 0, NULL);
+}
+
 ZTEST_SUITE(telemetry, NULL, NULL, NULL, NULL, NULL);
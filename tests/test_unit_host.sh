@@ -11,14 +11,59 @@ mkdir -p "${BUILD_DIR}"
 
 cc -std=c11 -Wall -Wextra -I"${SRC_DIR}/src" \
   "${SRC_DIR}/src/telemetry/gpio_event.c" \
+  "${SRC_DIR}/src/telemetry/current_sketch.c" \
+  "${SRC_DIR}/src/telemetry/pwm_stats.c" \
+  "${SRC_DIR}/src/telemetry/current_rms.c" \
+  "${SRC_DIR}/src/telemetry/pilot_plateau.c" \
   "${SRC_DIR}/src/safety_gate/safety_gate.c" \
   "${SRC_DIR}/src/sidewalk/time_sync.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_writer.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_envelope.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_schema.c" \
   "${SRC_DIR}/src/telemetry/telemetry_gpio.c" \
   "${SRC_DIR}/src/telemetry/telemetry_evse.c" \
   "${SRC_DIR}/src/telemetry/telemetry_line_current.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_health.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_binary.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_batch.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_fragment.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_series.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_outbox.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_queue.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_delivery.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_airtime.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_retain.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_prebuilt.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_decode.c" \
   "${SRC_DIR}/tests/telemetry/host/main.c" \
   "${SRC_DIR}/tests/telemetry/host/telemetry_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_writer_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_binary_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_batch_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_fragment_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_decode_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_series_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/current_sketch_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/pwm_stats_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/current_rms_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/pilot_plateau_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_outbox_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_queue_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_delivery_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_airtime_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_retain_tests.c" \
+  "${SRC_DIR}/tests/telemetry/host/telemetry_prebuilt_tests.c" \
   -o "${BUILD_DIR}/host_tests"
 
 "${BUILD_DIR}/host_tests"
+
+# [TELEMETRY] Decoder CLI: golden fixtures must decode cleanly; then the benchmark.
+cc -std=c11 -O2 -Wall -Wextra -I"${SRC_DIR}/src" \
+  "${ROOT_DIR}/tools/telemetry_decode/telemetry_decode.c" \
+  "${SRC_DIR}/src/telemetry/gpio_event.c" \
+  "${SRC_DIR}/src/telemetry/telemetry_"*.c \
+  -o "${BUILD_DIR}/telemetry_decode"
+cat "${SRC_DIR}/tests/telemetry/host/fixtures/"*.json "${SRC_DIR}/tests/telemetry/host/fixtures/"*.hex \
+  | "${BUILD_DIR}/telemetry_decode" > "${BUILD_DIR}/fixtures.csv"
+"${BUILD_DIR}/telemetry_decode" --bench 200000
 echo "PASS: ${SCRIPT_NAME}"
@@ -0,0 +1,283 @@
+/*
+ * [TELEMETRY] telemetry_decode: uplink frames in, CSV rows out.
+ * [BOILERPLATE] Thin CLI over src/telemetry/telemetry_decode.c, so offline log
+ * analysis and cloud ingest use the firmware's own schema tables.
+ *
+ * Input: one frame per line on stdin. Lines starting with '{' or '[' are JSON
+ * payloads; anything else is the frame as hex (binary records, batches and
+ * fragments). Blank lines and lines starting with '#' are ignored.
+ *
+ *   telemetry_decode < frames.txt > records.csv
+ *   telemetry_decode --bench 200000     # synthetic corpus, reports frames/sec
+ *
+ * Build (see tests/test_unit_host.sh):
+ *   cc -std=c11 -O2 -Iapp/evse_interlock_v1/src tools/telemetry_decode/telemetry_decode.c \
+ *      app/evse_interlock_v1/src/telemetry/{gpio_event,telemetry_*}.c -o telemetry_decode
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "telemetry/telemetry_batch.h"
+#include "telemetry/telemetry_decode.h"
+#include "telemetry/telemetry_evse.h"
+#include "telemetry/telemetry_fragment.h"
+#include "telemetry/telemetry_gpio.h"
+#include "telemetry/telemetry_line_current.h"
+
+#define LINE_MAX_LEN 4096
+#define ROW_MAX_LEN 1024
+
+static void print_row(const struct telemetry_record *r, void *ctx)
+{
+	char row[ROW_MAX_LEN];
+
+	(void)ctx;
+	if (telemetry_record_csv(r, row, sizeof(row)) >= 0) {
+		puts(row);
+	}
+}
+
+static int hex_val(char c)
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+/* [BOILERPLATE] Hex text to bytes in place; returns byte count or -1. */
+static int hex_decode(char *line, size_t len)
+{
+	uint8_t *out = (uint8_t *)line;
+
+	if (len % 2) {
+		return -1;
+	}
+	for (size_t i = 0; i < len; i += 2) {
+		int hi = hex_val(line[i]);
+		int lo = hex_val(line[i + 1]);
+		if (hi < 0 || lo < 0) {
+			return -1;
+		}
+		out[i / 2] = (uint8_t)((hi << 4) | lo);
+	}
+	return (int)(len / 2);
+}
+
+static int decode_stream(FILE *in)
+{
+	static char line[LINE_MAX_LEN];
+	struct telemetry_decoder d;
+	char header[ROW_MAX_LEN];
+	unsigned long lineno = 0;
+	unsigned long bad = 0;
+
+	telemetry_decoder_init(&d);
+	if (telemetry_record_csv_header(header, sizeof(header)) < 0) {
+		return 1;
+	}
+	puts(header);
+
+	while (fgets(line, sizeof(line), in)) {
+		size_t len = strcspn(line, "\r\n");
+		int n = (int)len;
+
+		lineno++;
+		line[len] = '\0';
+		if (len == 0 || line[0] == '#') {
+			continue;
+		}
+		if (line[0] != '{' && line[0] != '[') {
+			n = hex_decode(line, len);
+		}
+		if (n <= 0 || telemetry_decoder_feed(&d, (const uint8_t *)line, (size_t)n, print_row,
+						     NULL) < 0) {
+			fprintf(stderr, "line %lu: malformed frame\n", lineno);
+			bad++;
+		}
+	}
+	fprintf(stderr, "%lu line(s), %u record(s), %lu malformed\n", lineno, d.records, bad);
+	return bad ? 2 : 0;
+}
+
+/* [TELEMETRY] Synthetic corpus: the frame mix a site produces over a day. */
+struct corpus {
+	uint8_t *buf;
+	size_t len;
+	size_t cap;
+	size_t *off;
+	size_t count;
+};
+
+static uint8_t *corpus_slot(struct corpus *c, size_t *avail)
+{
+	if (c->cap - c->len < 1024) {
+		c->cap = c->cap * 2 + 4096;
+		c->buf = realloc(c->buf, c->cap);
+		if (!c->buf) {
+			exit(1);
+		}
+	}
+	*avail = c->cap - c->len;
+	return c->buf + c->len;
+}
+
+static void corpus_commit(struct corpus *c, int len)
+{
+	if (len <= 0) {
+		fprintf(stderr, "bench: frame build failed\n");
+		exit(1);
+	}
+	c->off[c->count++] = c->len;
+	c->len += (size_t)len;
+}
+
+static int build_one(int i, enum telemetry_encoding enc, const struct telemetry_envelope *env,
+		     void *buf, size_t cap)
+{
+	static const struct line_current_event line = { .current_a = 12.345f,
+							.event_type = "current_change" };
+	struct evse_event evse = {
+		.pilot_state = (enum evse_pilot_state)(i % 3),
+		.proximity_detected = true,
+		.pwm_duty_cycle = 53.33f,
+		.current_draw_a = (float)(i % 320) / 10.0f,
+		.energy_kwh = (float)i / 1000.0f,
+		.event_type = "state_change",
+		.session_id = "0a1b2c3d-4e5f-6071-8293-a4b5c6d7e8f9",
+	};
+	int64_t ts = 1704067200000LL + (int64_t)i * 250;
+
+	switch (i % 3) {
+	case 0:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_gpio_payload_bin(buf, cap, "hvac", i & 1,
+								GPIO_EDGE_RISING, ts, NULL,
+								"0123456789abcdef", false) :
+			       telemetry_build_gpio_payload_env(buf, cap, env, "hvac", i & 1,
+								GPIO_EDGE_RISING, ts, NULL,
+								"0123456789abcdef", false);
+	case 1:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_evse_payload_bin(buf, cap, ts, &evse,
+								"0123456789abcdf0", false) :
+			       telemetry_build_evse_payload_env(buf, cap, env, ts, &evse,
+								"0123456789abcdf0", false);
+	default:
+		return enc == TELEMETRY_ENCODING_BINARY ?
+			       telemetry_build_line_current_payload_bin(
+				       buf, cap, ts, &line, "0123456789abcdf1", false) :
+			       telemetry_build_line_current_payload_env(
+				       buf, cap, env, ts, &line, "0123456789abcdf1", false);
+	}
+}
+
+static void corpus_build(struct corpus *c, size_t frames)
+{
+	struct telemetry_envelope full;
+	struct telemetry_envelope elided;
+	struct telemetry_batch batch;
+	size_t avail;
+
+	(void)telemetry_envelope_init(&full, "dev123", "evse", TELEMETRY_ENVELOPE_FULL);
+	(void)telemetry_envelope_init(&elided, "dev123", "evse", TELEMETRY_ENVELOPE_ELIDED);
+	c->off = malloc((frames + 1) * sizeof(*c->off));
+	if (!c->off) {
+		exit(1);
+	}
+
+	for (size_t i = 0; i < frames; i++) {
+		uint8_t *slot = corpus_slot(c, &avail);
+		enum telemetry_encoding enc = (i % 4) < 2 ? TELEMETRY_ENCODING_JSON :
+							     TELEMETRY_ENCODING_BINARY;
+
+		if (i % 4 == 3) {
+			/* Coalesced binary frame of three records. */
+			telemetry_batch_open(&batch, enc, slot, 255);
+			for (int r = 0; r < 3; r++) {
+				size_t rec_avail;
+				void *rec = telemetry_batch_slot(&batch, &rec_avail);
+				int len = build_one((int)i + r, enc, NULL, rec, rec_avail);
+				(void)telemetry_batch_commit(&batch, (size_t)len);
+			}
+			corpus_commit(c, telemetry_batch_close(&batch));
+		} else {
+			corpus_commit(c, build_one((int)i, enc, (i % 4) == 0 ? &full : &elided,
+						   slot, avail));
+		}
+	}
+	c->off[c->count] = c->len;
+}
+
+static double now_s(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void count_cb(const struct telemetry_record *r, void *ctx)
+{
+	char row[ROW_MAX_LEN];
+	size_t *bytes = ctx;
+	int n = telemetry_record_csv(r, row, sizeof(row));
+
+	*bytes += n > 0 ? (size_t)n : 0;
+}
+
+static int bench(size_t frames)
+{
+	struct corpus c = { 0 };
+	struct telemetry_decoder d;
+	size_t csv_bytes = 0;
+
+	corpus_build(&c, frames);
+	telemetry_decoder_init(&d);
+
+	double t0 = now_s();
+	for (size_t i = 0; i < c.count; i++) {
+		(void)telemetry_decoder_feed(&d, c.buf + c.off[i], c.off[i + 1] - c.off[i], NULL,
+					     NULL);
+	}
+	double t1 = now_s();
+	for (size_t i = 0; i < c.count; i++) {
+		(void)telemetry_decoder_feed(&d, c.buf + c.off[i], c.off[i + 1] - c.off[i],
+					     count_cb, &csv_bytes);
+	}
+	double t2 = now_s();
+
+	double decode = t1 - t0 > 0 ? t1 - t0 : 1e-9;
+	double csv = t2 - t1 > 0 ? t2 - t1 : 1e-9;
+	printf("telemetry decode: %zu frames (%zu bytes), %u records/pass, %u errors\n", c.count,
+	       c.len, d.records / 2, d.errors);
+	printf("telemetry decode: %.0f frames/s, %.1f MB/s decode; %.0f frames/s with CSV\n",
+	       (double)c.count / decode, (double)c.len / decode / 1e6, (double)c.count / csv);
+	free(c.buf);
+	free(c.off);
+	return d.errors ? 2 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 3 && strcmp(argv[1], "--bench") == 0) {
+		long n = strtol(argv[2], NULL, 10);
+		return n > 0 ? bench((size_t)n) : 1;
+	}
+	if (argc != 1) {
+		fprintf(stderr, "usage: %s [--bench FRAMES] < frames.txt > records.csv\n",
+			argv[0]);
+		return 1;
+	}
+	return decode_stream(stdin);
+}